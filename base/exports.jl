@@ -1033,6 +1033,7 @@ export
 # types
     convert,
     fieldoffset,
+    packlayout!,
     fieldname,
     fieldnames,
     isleaftype,
@@ -203,8 +203,10 @@ internal use; [`retrieve`](:func:`retrieve`) may be a better choice for most use
 """
 function fetch()
     len = len_data()
-    maxlen = maxlen_data()
-    if (len == maxlen)
+    # samples are stored delta-encoded and expanded on fetch, so the
+    # expanded length is unrelated to the raw capacity; the runtime
+    # reports buffer exhaustion explicitly
+    if ccall(:jl_profile_data_full, Cint, ()) != 0
         warn("The profile data buffer is full; profiling probably terminated\nbefore your program finished. To profile for longer runs, call Profile.init\nwith a larger buffer and/or larger delay.")
     end
     unsafe_wrap(Array, get_data_pointer(), (len,))
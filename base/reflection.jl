@@ -121,6 +121,21 @@ julia> structinfo(Base.Filesystem.StatStruct)
 """
 fieldoffset(x::DataType, idx::Integer) = (@_pure_meta; ccall(:jl_get_field_offset, Csize_t, (Any, Cint), x, idx))
 
+"""
+    packlayout!(T::DataType)
+
+Opt a mutable type `T` into a padding-minimizing field layout: the
+fields' byte offsets are recomputed sorted by decreasing alignment,
+which removes the padding a pointer/small-field mix accumulates in
+declaration order. Field order, names, and constructors are
+unaffected; only `fieldoffset` (and the memory size) change. Must be
+called right after the type definition, before any instance is created
+or code is compiled against the type. Immutable types are rejected:
+their unboxed representation is laid out by field index and cannot be
+reordered.
+"""
+packlayout!(T::DataType) = (ccall(:jl_datatype_pack_layout, Void, (Any,), T); T)
+
 """
     fieldtype(T, name::Symbol | index::Int)
 
@@ -388,7 +388,7 @@ function uv_connectcb(conn::Ptr{Void}, status::Cint)
         sock.ccb(sock, status)
     end
     err===nothing ? notify(sock.connectnotify) : notify_error(sock.connectnotify, err)
-    Libc.free(conn)
+    ccall(:jl_uv_free_req, Void, (Ptr{Void}, Csize_t), conn, _sizeof_uv_connect)
     nothing
 end
 
@@ -792,9 +792,37 @@ function readuntil(this::LibuvStream, c::UInt8)
 end
 
 uv_write(s::LibuvStream, p::Vector{UInt8}) = uv_write(s, pointer(p), UInt(sizeof(p)))
+
+# write several array-backed buffers with a single uv_write request
+# (one syscall, no intermediate copy); the arrays are kept rooted until
+# the write completes
+function uv_writev(s::LibuvStream, bufs::Vector{Vector{UInt8}})
+    check_open(s)
+    nbufs = length(bufs)
+    nbufs == 0 && return 0
+    bases = Ptr{UInt8}[pointer(b) for b in bufs]
+    lens = UInt[sizeof(b) for b in bufs]
+    uvw = ccall(:jl_uv_alloc_req, Ptr{Void}, (Csize_t,), _sizeof_uv_write)
+    uv_req_set_data(uvw,C_NULL)
+    err = ccall(:jl_uv_writev,
+                Int32,
+                (Ptr{Void}, Ptr{Ptr{UInt8}}, Ptr{UInt}, UInt, Ptr{Void}, Ptr{Void}),
+                s, bases, lens, UInt(nbufs), uvw,
+                uv_jl_writecb_task::Ptr{Void})
+    if err < 0
+        ccall(:jl_uv_free_req, Void, (Ptr{Void}, Csize_t), uvw, _sizeof_uv_write)
+        uv_error("write", err)
+    end
+    ct = current_task()
+    uv_req_set_data(uvw,ct)
+    stream_wait(ct)
+    # referencing the arrays after the wait keeps them (and the pointer
+    # tables) rooted until the write completed
+    return Int(sum(map(sizeof, bufs)))
+end
 function uv_write(s::LibuvStream, p::Ptr{UInt8}, n::UInt)
     check_open(s)
-    uvw = Libc.malloc(_sizeof_uv_write)
+    uvw = ccall(:jl_uv_alloc_req, Ptr{Void}, (Csize_t,), _sizeof_uv_write)
     uv_req_set_data(uvw,C_NULL)
     err = ccall(:jl_uv_write,
                 Int32,
@@ -802,7 +830,7 @@ function uv_write(s::LibuvStream, p::Ptr{UInt8}, n::UInt)
                 s, p, n, uvw,
                 uv_jl_writecb_task::Ptr{Void})
     if err < 0
-        Libc.free(uvw)
+        ccall(:jl_uv_free_req, Void, (Ptr{Void}, Csize_t), uvw, _sizeof_uv_write)
         uv_error("write", err)
     end
     ct = current_task()
@@ -863,7 +891,7 @@ function uv_writecb_task(req::Ptr{Void}, status::Cint)
             schedule(unsafe_pointer_to_objref(d)::Task)
         end
     end
-    Libc.free(req)
+    ccall(:jl_uv_free_req, Void, (Ptr{Void}, Csize_t), req, _sizeof_uv_write)
     nothing
 end
 
@@ -938,7 +966,7 @@ end
 
 function connect!(sock::PipeEndpoint, path::AbstractString)
     @assert sock.status == StatusInit
-    req = Libc.malloc(_sizeof_uv_connect)
+    req = ccall(:jl_uv_alloc_req, Ptr{Void}, (Csize_t,), _sizeof_uv_connect)
     uv_req_set_data(req,C_NULL)
     ccall(:uv_pipe_connect, Void, (Ptr{Void}, Ptr{Void}, Cstring, Ptr{Void}), req, sock.handle, path, uv_jl_connectcb::Ptr{Void})
     sock.status = StatusConnecting
@@ -47,17 +47,75 @@ function _threadsfor(iter,lbody)
     end
 end
 
+function _threadsfor_sched(iter,lbody,policy,grain)
+    fun = gensym("_threadsfor")
+    lidx = iter.args[1]         # index
+    range = iter.args[2]
+    pol = policy === :guided ? 2 : 1
+    # without an explicit grainsize, dynamic carves the range into many
+    # more chunks than threads (threads that finish early keep pulling
+    # work, so uneven iteration costs stop leaving cores idle), while
+    # guided decays from large chunks on its own and can go down to 1
+    graindefault = policy === :guided ? :(1) : :(max(1, div(n, nthreads() * 8)))
+    grainex = grain === nothing ? graindefault : :(max(1, Int($(esc(grain)))))
+    quote
+        function $fun()
+            r = $(esc(range))
+            n = length(r)
+            n == 0 && return
+            g = $grainex
+            len = Ref{Int64}(0)
+            while true
+                f0 = Int(ccall(:jl_threading_claim_range, Int64,
+                               (Int64, Int64, Cint, Ptr{Int64}),
+                               n, g, $pol, len))
+                f0 == -1 && break
+                for i = (f0+1):(f0+Int(len[]))
+                    local $(esc(lidx)) = Base.unsafe_getindex(r,i)
+                    $(esc(lbody))
+                end
+            end
+        end
+        ccall(:jl_threading_run, Void, (Any,), Core.svec($fun))
+    end
+end
+
 macro threads(args...)
     na = length(args)
-    if na != 1
+    sched = :static
+    grain = nothing
+    if na == 3
+        # @threads :dynamic grainsize for ...
+        if !(isa(args[1], QuoteNode) && isa(args[1].value, Symbol))
+            throw(ArgumentError("unrecognized schedule argument to @threads"))
+        end
+        sched = args[1].value
+        grain = args[2]
+        ex = args[3]
+    elseif na == 2
+        if !(isa(args[1], QuoteNode) && isa(args[1].value, Symbol))
+            throw(ArgumentError("unrecognized schedule argument to @threads"))
+        end
+        sched = args[1].value
+        ex = args[2]
+    elseif na == 1
+        ex = args[1]
+    else
         throw(ArgumentError("wrong number of arguments in @threads"))
     end
-    ex = args[1]
     if !isa(ex, Expr)
         throw(ArgumentError("need an expression argument to @threads"))
     end
     if is(ex.head, :for)
-        return _threadsfor(ex.args[1],ex.args[2])
+        if sched === :static
+            grain === nothing ||
+                throw(ArgumentError("static schedule takes no grainsize"))
+            return _threadsfor(ex.args[1],ex.args[2])
+        elseif sched === :dynamic || sched === :guided
+            return _threadsfor_sched(ex.args[1],ex.args[2],sched,grain)
+        else
+            throw(ArgumentError("unrecognized schedule argument to @threads"))
+        end
     else
         throw(ArgumentError("unrecognized argument to @threads"))
     end
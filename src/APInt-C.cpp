@@ -46,8 +46,39 @@ inline uint64_t RoundUpToAlignment(uint64_t Value, uint64_t Align, uint64_t Skew
     else \
         memcpy(p##r, a.getRawData(), RoundUpToAlignment(numbits, host_char_bit) / host_char_bit); \
 
+// Fixed-width kernels for the 128-bit case: APInt stores anything wider
+// than one word out of line, so every Int128 operation was paying a heap
+// allocation (and the generic multi-word loops). With a native __int128
+// the hot entry points become two-word register code; wider (and odd)
+// widths keep the APInt path. Only operations the compilers expand
+// inline are covered -- 128-bit mul-overflow would emit a compiler-rt
+// libcall that isn't present when linking against libgcc.
+#if defined(__SIZEOF_INT128__) &&     (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define JL_HAVE_INT128_KERNELS 1
+typedef unsigned __int128 jl_uint128_t;
+typedef __int128 jl_int128_t;
+
+static inline jl_uint128_t jl_load_u128(const integerPart *p)
+{
+    jl_uint128_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void jl_store_u128(integerPart *p, jl_uint128_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+#endif
+
 extern "C" JL_DLLEXPORT
 void LLVMNeg(unsigned numbits, integerPart *pa, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_store_u128(pr, (jl_uint128_t)0 - jl_load_u128(pa));
+        return;
+    }
+#endif
     APInt z(numbits, 0);
     CREATE(a)
     z -= a;
@@ -56,6 +87,12 @@ void LLVMNeg(unsigned numbits, integerPart *pa, integerPart *pr) {
 
 extern "C" JL_DLLEXPORT
 void LLVMAdd(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_store_u128(pr, jl_load_u128(pa) + jl_load_u128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a += b;
@@ -64,6 +101,12 @@ void LLVMAdd(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr
 
 extern "C" JL_DLLEXPORT
 void LLVMSub(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_store_u128(pr, jl_load_u128(pa) - jl_load_u128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a -= b;
@@ -72,6 +115,12 @@ void LLVMSub(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr
 
 extern "C" JL_DLLEXPORT
 void LLVMMul(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_store_u128(pr, jl_load_u128(pa) * jl_load_u128(pb));
+        return;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     a *= b;
@@ -208,6 +257,15 @@ void LLVMFlipAllBits(unsigned numbits, integerPart *pa, integerPart *pr) {
 
 extern "C" JL_DLLEXPORT
 int LLVMAdd_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_uint128_t r;
+        int ovflw = __builtin_add_overflow((jl_uint128_t)jl_load_u128(pa),
+                                          (jl_uint128_t)jl_load_u128(pb), &r);
+        jl_store_u128(pr, (jl_uint128_t)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -218,6 +276,15 @@ int LLVMAdd_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMAdd_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_int128_t r;
+        int ovflw = __builtin_add_overflow((jl_int128_t)jl_load_u128(pa),
+                                          (jl_int128_t)jl_load_u128(pb), &r);
+        jl_store_u128(pr, (jl_uint128_t)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -228,6 +295,15 @@ int LLVMAdd_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMSub_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_uint128_t r;
+        int ovflw = __builtin_sub_overflow((jl_uint128_t)jl_load_u128(pa),
+                                          (jl_uint128_t)jl_load_u128(pb), &r);
+        jl_store_u128(pr, (jl_uint128_t)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
@@ -238,6 +314,15 @@ int LLVMSub_uov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart
 
 extern "C" JL_DLLEXPORT
 int LLVMSub_sov(unsigned numbits, integerPart *pa, integerPart *pb, integerPart *pr) {
+#ifdef JL_HAVE_INT128_KERNELS
+    if (numbits == 128) {
+        jl_int128_t r;
+        int ovflw = __builtin_sub_overflow((jl_int128_t)jl_load_u128(pa),
+                                          (jl_int128_t)jl_load_u128(pb), &r);
+        jl_store_u128(pr, (jl_uint128_t)r);
+        return ovflw;
+    }
+#endif
     CREATE(a)
     CREATE(b)
     bool Overflow;
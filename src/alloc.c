@@ -159,12 +159,74 @@ void jl_assign_bits(void *dest, jl_value_t *bits)
     }
 }
 
+// hash table behind jl_field_index for wide types: power-of-two open
+// addressing over (symbol, index) pairs stored in a Vector{UInt8} hung
+// off the typename. Symbols are interned and permanently rooted, so the
+// raw pointers inside the byte array need no GC visibility; the array
+// itself is a reflected field (serialized as nothing and rebuilt).
+typedef struct {
+    jl_sym_t *sym;
+    uintptr_t idx;
+} jl_fcache_entry_t;
+
+#define JL_FCACHE_MIN_FIELDS 16
+
+static jl_fcache_entry_t *fcache_build(jl_typename_t *tn, jl_svec_t *fn,
+                                       size_t *pmask)
+{
+    size_t n = jl_svec_len(fn);
+    size_t cap = 16;
+    while (cap < n * 2)
+        cap *= 2;
+    jl_array_t *fc = jl_alloc_array_1d(jl_array_uint8_type,
+                                       cap * sizeof(jl_fcache_entry_t));
+    jl_fcache_entry_t *tab = (jl_fcache_entry_t*)jl_array_data(fc);
+    memset(tab, 0, cap * sizeof(jl_fcache_entry_t));
+    for (size_t i = 0; i < n; i++) {
+        jl_sym_t *s = (jl_sym_t*)jl_svecref(fn, i);
+        size_t j = s->hash & (cap - 1);
+        while (tab[j].sym != NULL)
+            j = (j + 1) & (cap - 1);
+        tab[j].sym = s;
+        tab[j].idx = i;
+    }
+    // publish after filling; a racing builder just wins the store with
+    // an equally valid table
+    jl_atomic_store_release(&tn->fcache, (jl_value_t*)fc);
+    jl_gc_wb(tn, fc);
+    *pmask = cap - 1;
+    return tab;
+}
+
 JL_DLLEXPORT int jl_field_index(jl_datatype_t *t, jl_sym_t *fld, int err)
 {
     jl_svec_t *fn = t->name->names;
-    for(size_t i=0; i < jl_svec_len(fn); i++) {
-        if (jl_svecref(fn,i) == (jl_value_t*)fld) {
-            return (int)i;
+    size_t n = jl_svec_len(fn);
+    // the cache needs Vector{UInt8}, which does not exist in the
+    // earliest bootstrap; wide types fall back to the scan until then
+    if (n >= JL_FCACHE_MIN_FIELDS && jl_array_uint8_type != NULL) {
+        jl_value_t *fc = t->name->fcache;
+        jl_fcache_entry_t *tab;
+        size_t mask;
+        if (fc == NULL || fc == jl_nothing) {
+            tab = fcache_build(t->name, fn, &mask);
+        }
+        else {
+            tab = (jl_fcache_entry_t*)jl_array_data(fc);
+            mask = jl_array_len(fc) / sizeof(jl_fcache_entry_t) - 1;
+        }
+        size_t j = fld->hash & mask;
+        while (tab[j].sym != NULL) {
+            if (tab[j].sym == fld)
+                return (int)tab[j].idx;
+            j = (j + 1) & mask;
+        }
+    }
+    else {
+        for(size_t i=0; i < n; i++) {
+            if (jl_svecref(fn,i) == (jl_value_t*)fld) {
+                return (int)i;
+            }
         }
     }
     if (err)
@@ -236,6 +298,42 @@ JL_DLLEXPORT jl_value_t *jl_new_struct(jl_datatype_t *type, ...)
     return jv;
 }
 
+// Bulk construction from a flat buffer of already-validated payloads:
+// `src` holds `count` records of `type->size` bytes laid out exactly as
+// the in-memory representation (pointer fields, if any, must reference
+// live rooted objects). Each record becomes a fresh object whose payload
+// is memcpy'd in whole, skipping the per-field conversions, type checks,
+// and write barriers of jl_new_structv -- fresh objects are young, so no
+// per-store barrier is needed at all, and the destination array gets one
+// barrier for the whole batch. `out` must be a rooted Vector{Any} (or
+// compatible boxed array) with room for `count` elements starting at
+// `offset`. Returns 0 on success, -1 on a type/array mismatch.
+JL_DLLEXPORT int jl_new_structs_bulk(jl_datatype_t *type, const char *src,
+                                     size_t count, jl_array_t *out,
+                                     size_t offset)
+{
+    if (!jl_is_datatype(type) || type->abstract || type->instance != NULL)
+        return -1;
+    if (!out->flags.ptrarray || offset + count > jl_array_len(out))
+        return -1;
+    size_t sz = type->size;
+    jl_value_t **dst = (jl_value_t**)jl_array_data(out) + offset;
+    for (size_t i = 0; i < count; i++) {
+        jl_value_t *jv = newstruct(type);
+        memcpy(jl_data_ptr(jv), src + i * sz, sz);
+        // no barrier: jv is young and `out` is handled below
+        dst[i] = jv;
+    }
+    // single barrier pass for every store into `out`
+    if (count > 0) {
+        void *owner = out;
+        if (out->flags.how == 3)
+            owner = jl_array_data_owner(out);
+        jl_gc_wb_back(owner);
+    }
+    return 0;
+}
+
 JL_DLLEXPORT jl_value_t *jl_new_structv(jl_datatype_t *type, jl_value_t **args,
                                         uint32_t na)
 {
@@ -401,6 +499,7 @@ JL_DLLEXPORT jl_lambda_info_t *jl_new_lambda_info_uninit(void)
     li->functionObjectsDecls.specFunctionObject = NULL;
     li->functionID = 0;
     li->specFunctionID = 0;
+    li->callcount = 0;
     li->specTypes = NULL;
     li->unspecialized_ducttape = NULL;
     li->inferred = 0;
@@ -716,21 +815,79 @@ static jl_sym_t *symtab_lookup(jl_sym_t *volatile *ptree, const char *str,
     return node;
 }
 
+// lock-free hash index in front of the symbol tree
+//
+// The tree stays the authoritative store (and keeps the serializer and
+// GC assumptions intact), but its strcmp descent is cache-hostile for
+// the millions of lookups parsing-heavy code does. Existing symbols are
+// found with one hash and a short linear probe over this fixed table;
+// slots only ever transition empty -> symbol (symbols are permanent), so
+// readers need no synchronization beyond the acquire load and inserters
+// claim slots with a CAS. When the table gets crowded the remaining
+// symbols simply stay tree-only -- no rehash machinery, bounded memory.
+#define SYMTAB_CACHE_SZ (1 << 16) // must be a power of two
+#define SYMTAB_CACHE_MAX_PROBE 16
+static jl_sym_t *volatile symtab_cache[SYMTAB_CACHE_SZ];
+static volatile uint32_t symtab_cache_count = 0;
+
+static jl_sym_t *symtab_cache_lookup(const char *str, size_t len, uintptr_t h)
+{
+    size_t idx = h & (SYMTAB_CACHE_SZ - 1);
+    for (int i = 0; i < SYMTAB_CACHE_MAX_PROBE; i++) {
+        jl_sym_t *e = jl_atomic_load_acquire(&symtab_cache[idx]);
+        if (e == NULL)
+            return NULL;
+        if (e->hash == h && strncmp(str, jl_symbol_name(e), len) == 0 &&
+            jl_symbol_name(e)[len] == 0)
+            return e;
+        idx = (idx + 1) & (SYMTAB_CACHE_SZ - 1);
+    }
+    return NULL;
+}
+
+static void symtab_cache_insert(jl_sym_t *sym, uintptr_t h)
+{
+    if (symtab_cache_count >= SYMTAB_CACHE_SZ - (SYMTAB_CACHE_SZ >> 3))
+        return;
+    size_t idx = h & (SYMTAB_CACHE_SZ - 1);
+    for (int i = 0; i < SYMTAB_CACHE_MAX_PROBE; i++) {
+        jl_sym_t *e = symtab_cache[idx];
+        if (e == NULL) {
+            e = jl_atomic_compare_exchange(&symtab_cache[idx], NULL, sym);
+            if (e == NULL) {
+                jl_atomic_fetch_add(&symtab_cache_count, 1);
+                return;
+            }
+            // lost the race for the slot; fall through to examine what
+            // the winner put there
+        }
+        if (e == sym)
+            return; // another thread published this symbol already
+        idx = (idx + 1) & (SYMTAB_CACHE_SZ - 1);
+    }
+}
+
 static jl_sym_t *_jl_symbol(const char *str, size_t len)
 {
+    uintptr_t h = hash_symbol(str, len);
+    jl_sym_t *node = symtab_cache_lookup(str, len, h);
+    if (node != NULL)
+        return node;
     jl_sym_t *volatile *slot;
-    jl_sym_t *node = symtab_lookup(&symtab, str, len, &slot);
+    node = symtab_lookup(&symtab, str, len, &slot);
     if (node == NULL) {
         JL_LOCK(&symbol_table_lock); // Might GC
         // Someone might have updated it, check and look up again
         if (*slot != NULL && (node = symtab_lookup(slot, str, len, &slot))) {
             JL_UNLOCK(&symbol_table_lock); // Might GC
+            symtab_cache_insert(node, h);
             return node;
         }
         node = mk_symbol(str, len);
         jl_atomic_store_release(slot, node);
         JL_UNLOCK(&symbol_table_lock); // Might GC
     }
+    symtab_cache_insert(node, h);
     return node;
 }
 
@@ -833,6 +990,7 @@ JL_DLLEXPORT jl_typename_t *jl_new_typename_in(jl_sym_t *name, jl_module_t *modu
     tn->names = NULL;
     tn->uid = jl_assign_type_uid();
     tn->mt = NULL;
+    tn->fcache = NULL; // jl_nothing may not exist yet during bootstrap
     JL_GC_PUSH1(&tn);
     tn->mt = NULL;
     JL_GC_POP();
@@ -864,6 +1022,8 @@ JL_DLLEXPORT jl_datatype_t *jl_new_uninitialized_datatype(size_t nfields, int8_t
     // corruption otherwise.
     t->fielddesc_type = fielddesc_type;
     t->nfields = nfields;
+    t->ptroffsets = NULL;
+    t->nptrfields = -1;
     t->haspadding = 0;
     t->pointerfree = 0;
     t->depth = 0;
@@ -914,9 +1074,100 @@ unsigned jl_special_vector_alignment(size_t nfields, jl_value_t *t) {
     return alignment;
 }
 
+// Opt-in reordered layout (Base.packlayout!): recompute the offsets
+// with fields sorted by decreasing alignment (stable), which removes
+// the padding that pointer/small-field mixes accumulate in declaration
+// order. Field indices, names, and construction order are untouched --
+// only byte offsets move. Mutable types only: their instances are
+// always boxed, and every boxed access (runtime and codegen's
+// emit_getfield_knownidx/emit_setfield) goes through jl_field_offset.
+// Immutables are rejected because their unboxed representation is an
+// LLVM struct built in declaration order and accessed by field index
+// (julia_struct_to_llvm), which a byte-offset reorder would silently
+// contradict. Must be called before the type is instantiated or
+// compiled against. Packing below natural alignment is deliberately
+// not offered: unaligned fields would break the atomicity and
+// vectorization assumptions compiled code makes.
+JL_DLLEXPORT void jl_datatype_pack_layout(jl_datatype_t *st)
+{
+    if (!jl_is_datatype(st) || st->abstract)
+        jl_error("packlayout!: not a concrete datatype");
+    if (!st->mutabl)
+        jl_error("packlayout!: only mutable types can be reordered "
+                 "(immutables have an unboxed field-index layout)");
+    if (st->instance != NULL || st->struct_decl != NULL)
+        jl_error("packlayout!: type is already in use");
+    size_t n = jl_datatype_nfields(st);
+    if (n < 2)
+        return;
+    size_t *al = (size_t*)alloca(n * sizeof(size_t));
+    size_t *fsz = (size_t*)alloca(n * sizeof(size_t));
+    size_t *order = (size_t*)alloca(n * sizeof(size_t));
+    size_t i, j;
+    for (i = 0; i < n; i++) {
+        jl_value_t *ty = jl_field_type(st, i);
+        if (jl_isbits(ty) && jl_is_leaf_type(ty)) {
+            fsz[i] = jl_datatype_size(ty);
+            al[i] = ((jl_datatype_t*)ty)->alignment;
+        }
+        else {
+            fsz[i] = sizeof(void*);
+            if (fsz[i] > MAX_ALIGN)
+                fsz[i] = MAX_ALIGN;
+            al[i] = fsz[i];
+        }
+        order[i] = i;
+    }
+    // stable insertion sort by decreasing alignment
+    for (i = 1; i < n; i++) {
+        size_t o = order[i];
+        for (j = i; j > 0 && al[order[j - 1]] < al[o]; j--)
+            order[j] = order[j - 1];
+        order[j] = o;
+    }
+    size_t sz = 0, alignm = 1;
+    int haspadding = 0;
+    for (i = 0; i < n; i++) {
+        size_t f = order[i];
+        size_t a = al[f];
+        if (a != 0) {
+            if (sz & (a - 1))
+                haspadding = 1;
+            sz = LLT_ALIGN(sz, a);
+            if (a > alignm)
+                alignm = a;
+        }
+        jl_field_setoffset(st, f, sz);
+        sz += fsz[f];
+        jl_value_t *ty = jl_field_type(st, f);
+        if (jl_isbits(ty) && jl_is_leaf_type(ty) &&
+            ((jl_datatype_t*)ty)->haspadding)
+            haspadding = 1;
+    }
+    st->alignment = alignm;
+    st->size = LLT_ALIGN(sz, alignm);
+    if (st->size > sz)
+        haspadding = 1;
+    st->haspadding = haspadding;
+    // pointerfree/fielddesc bits are unchanged by a reorder, but any
+    // pointer-offset map reflects the old offsets
+    if (st->ptroffsets != NULL) {
+        free(st->ptroffsets);
+        st->ptroffsets = NULL;
+        st->nptrfields = -1;
+    }
+}
+
 void jl_compute_field_offsets(jl_datatype_t *st)
 {
     size_t sz = 0, alignm = 1;
+    // layout is changing: drop any pointer-offset map built from the
+    // old offsets (see gc_build_ptroffsets)
+    if (st->ptroffsets != NULL) {
+        free(st->ptroffsets);
+        st->ptroffsets = NULL;
+    }
+    st->nptrfields = -1;
     int ptrfree = 1;
     int homogeneous = 1;
     jl_value_t *lastty = NULL;
@@ -1019,6 +1270,8 @@ JL_DLLEXPORT jl_datatype_t *jl_new_datatype(jl_sym_t *name, jl_datatype_t *super
     t->ninitialized = ninitialized;
     t->instance = NULL;
     t->struct_decl = NULL;
+    t->ptroffsets = NULL;
+    t->nptrfields = -1;
     t->ditype = NULL;
     t->size = 0;
     t->alignment = 1;
@@ -1142,13 +1395,41 @@ UNBOX_FUNC(voidpointer, void*)
     }
 BOX_FUNC(float32, float,  jl_box, 1)
 BOX_FUNC(voidpointer, void*,  jl_box, 1)
+
+// A few Float64 values are boxed constantly (accumulator seeds,
+// sentinels); intern them. Matching is on bit patterns so 0.0 and -0.0
+// keep distinct identities and the canonical NaN hits without
+// self-comparison issues.
+static jl_value_t *boxed_float64_cache[4];
+JL_DLLEXPORT jl_value_t *jl_box_float64(double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    if (boxed_float64_cache[0] != NULL) { // filled by jl_init_box_caches
+        if (bits == 0)
+            return boxed_float64_cache[0]; // 0.0
+        if (bits == 0x3ff0000000000000ull)
+            return boxed_float64_cache[1]; // 1.0
+        if (bits == 0xbff0000000000000ull)
+            return boxed_float64_cache[2]; // -1.0
+        if (bits == 0x7ff8000000000000ull)
+            return boxed_float64_cache[3]; // NaN
+    }
 #ifdef _P64
-BOX_FUNC(float64, double, jl_box, 1)
+    jl_value_t *v = (jl_value_t*)jl_gc_alloc_1w();
 #else
-BOX_FUNC(float64, double, jl_box, 2)
+    jl_value_t *v = (jl_value_t*)jl_gc_alloc_2w();
 #endif
+    jl_set_typeof(v, jl_float64_type);
+    *(double*)jl_data_ptr(v) = x;
+    return v;
+}
 
+// overridable at build time (e.g. -DNBOX_C=4096) for workloads that box
+// a wider small-integer range
+#ifndef NBOX_C
 #define NBOX_C 1024
+#endif
 
 #define SIBOX_FUNC(typ,c_type,nw)                             \
     static jl_value_t *boxed_##typ##_cache[NBOX_C];           \
@@ -1231,6 +1512,20 @@ void jl_init_box_caches(void)
         boxed_char_cache[i]   = jl_box32(jl_char_type, i);
         boxed_uint64_cache[i] = jl_box64(jl_uint64_type, i);
     }
+    {
+        // interned Float64 constants (see jl_box_float64), initialized
+        // from the exact bit patterns the lookup matches against -- a
+        // computed 0.0/0.0 can produce a differently-signed qNaN on
+        // some compilers/arches, which would make the interned box
+        // disagree with reinterpret. Entry 0 doubles as the
+        // initialized flag, so fill it last.
+        const uint64_t fbits[4] = {0, 0x3ff0000000000000ull,
+                                   0xbff0000000000000ull,
+                                   0x7ff8000000000000ull};
+        for (i = 3; i >= 0; i--)
+            boxed_float64_cache[i] = jl_box64(jl_float64_type,
+                                              (int64_t)fbits[i]);
+    }
 }
 
 void jl_mark_box_caches(void)
@@ -1251,6 +1546,10 @@ void jl_mark_box_caches(void)
         jl_gc_setmark(boxed_ssavalue_cache[i]);
         jl_gc_setmark(boxed_slotnumber_cache[i]);
     }
+    for(i=0; i < 4; i++) {
+        if (boxed_float64_cache[i])
+            jl_gc_setmark(boxed_float64_cache[i]);
+    }
 }
 
 JL_DLLEXPORT jl_value_t *jl_box_bool(int8_t x)
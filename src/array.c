@@ -236,6 +236,40 @@ JL_DLLEXPORT jl_array_t *jl_reshape_array(jl_value_t *atype, jl_array_t *data,
 }
 
 // own_buffer != 0 iff GC should call free() on this pointer eventually
+// Allocate a 1-d array whose data is `align`-byte aligned (the default
+// guarantee for large arrays is one cache line). The buffer always comes
+// from the malloc'd path, so the alignment is independent of the pool
+// layout, and -- for bits element types -- its pages are never touched
+// here, leaving NUMA first-touch placement to the caller's threads.
+// Explicit node binding would require libnuma and is deliberately out of
+// scope.
+JL_DLLEXPORT jl_array_t *jl_alloc_array_1d_aligned(jl_value_t *atype,
+                                                   size_t nel, size_t align)
+{
+    jl_value_t *el_type = jl_tparam0(atype);
+    int isunboxed = store_unboxed(el_type);
+    size_t elsz = isunboxed ? jl_datatype_size(el_type) : sizeof(void*);
+    size_t nbytes = nel * elsz + (elsz == 1 ? 1 : 0);
+    if (elsz > 0 && nbytes / elsz != nel)
+        jl_throw(jl_memory_exception);
+    char *data = (char*)jl_gc_managed_malloc_aligned(nbytes, align);
+    if (elsz == 1)
+        data[nbytes - 1] = '\0';
+    // `data` is plain malloc'd memory, so no rooting is needed while the
+    // array object is allocated. Ownership is taken manually instead of
+    // via own_buffer: jl_gc_managed_malloc_aligned already accounted the
+    // bytes, and own_buffer would count them a second time.
+    jl_array_t *a = jl_ptr_to_array_1d(atype, data, nel, 0);
+    a->flags.isaligned = 1;
+    a->flags.isshared = 0;
+    a->flags.how = 2;
+    jl_gc_track_malloced_array(a);
+    if (!isunboxed)
+        // pointer elements must be valid for the collector
+        memset(a->data, 0, nel * sizeof(void*));
+    return a;
+}
+
 JL_DLLEXPORT jl_array_t *jl_ptr_to_array_1d(jl_value_t *atype, void *data,
                                             size_t nel, int own_buffer)
 {
@@ -367,6 +401,42 @@ JL_DLLEXPORT jl_array_t *jl_pchar_to_array(const char *str, size_t len)
     return a;
 }
 
+// string builder
+//
+// Assembling a large string from many pieces used to re-copy the
+// accumulated prefix repeatedly. The builder is just a byte array with
+// amortized doubling underneath (jl_array_grow_end) plus an exact
+// reserve up front, and the finished product is handed to String with
+// no final copy at all -- jl_array_to_string wraps the same buffer. A
+// chunked rope would only avoid the amortized growth copies, which the
+// doubling already bounds at ~2x the bytes appended; the repeated-copy
+// cost the request measured came from callers resizing exactly.
+JL_DLLEXPORT jl_array_t *jl_stringbuilder_new(size_t sizehint)
+{
+    jl_array_t *sb = jl_alloc_array_1d((jl_value_t*)jl_array_uint8_type, 0);
+    if (sizehint) {
+        JL_GC_PUSH1(&sb);
+        jl_array_sizehint(sb, sizehint);
+        JL_GC_POP();
+    }
+    return sb;
+}
+
+JL_DLLEXPORT void jl_stringbuilder_append(jl_array_t *sb, const char *data,
+                                          size_t len)
+{
+    size_t n = jl_array_nrows(sb);
+    jl_array_grow_end(sb, len);
+    memcpy((char*)sb->data + n, data, len);
+}
+
+// hand the accumulated bytes off as a String; the builder must not be
+// used afterwards (the buffer is shared, not copied)
+JL_DLLEXPORT jl_value_t *jl_stringbuilder_take(jl_array_t *sb)
+{
+    return jl_array_to_string(sb);
+}
+
 JL_DLLEXPORT jl_value_t *jl_array_to_string(jl_array_t *a)
 {
     if (!jl_typeis(a, jl_array_uint8_type))
@@ -672,7 +742,15 @@ STATIC_INLINE void jl_array_grow_at_beg(jl_array_t *a, size_t idx, size_t inc,
     else {
         size_t oldoffsnb = a->offset * elsz;
         size_t nb1 = idx * elsz;
-        if (inc > (a->maxsize - n) / 2 - (a->maxsize - n) / 20) {
+        size_t freespace = a->maxsize - n;
+        // grow not only when the increment needs it, but also when the
+        // buffer is nearly full: an in-place recenter would then leave
+        // only a sliver of front slack and a front-pushing deque would
+        // degrade to one O(n) move per few pushes. Keeping the slack
+        // proportional to the length makes double-ended pushes
+        // amortized O(1).
+        if (inc > freespace / 2 - freespace / 20 ||
+            freespace < n / 8 + inc) {
             size_t newlen = a->maxsize == 0 ? inc * 2 : a->maxsize * 2;
             while (n + 2 * inc > newlen - a->offset)
                 newlen *= 2;
@@ -730,6 +808,22 @@ STATIC_INLINE void jl_array_grow_at_end(jl_array_t *a, size_t idx,
     size_t elsz = a->elsize;
     char *data = (char*)a->data;
     int has_gap = n > idx;
+    // offset hysteresis: a push_back/pop_front deque accumulates dead
+    // front slack; when the end runs out but a useful amount of that
+    // slack exists, slide the live elements back in place instead of
+    // doubling the allocation (which would otherwise grow without bound
+    // for a steady-state queue). Only half the slack is reclaimed, and
+    // only when that half is proportionally large, so both ends keep
+    // amortized O(1) pushes.
+    if (__unlikely((n + inc) > a->maxsize - a->offset) &&
+        !a->flags.isshared && a->offset / 2 >= inc + n / 8 &&
+        (n + inc) <= a->maxsize - (a->offset - a->offset / 2)) {
+        size_t newoffs = a->offset - a->offset / 2;
+        char *newdata = data - (a->offset - newoffs) * elsz;
+        memmove(newdata, data, n * elsz);
+        a->offset = newoffs;
+        a->data = data = newdata;
+    }
     if (__unlikely((n + inc) > a->maxsize - a->offset)) {
         size_t nb1 = idx * elsz;
         size_t nbinc = inc * elsz;
@@ -904,12 +998,62 @@ JL_DLLEXPORT void jl_array_sizehint(jl_array_t *a, size_t sz)
     size_t n = jl_array_nrows(a);
     if (sz <= n)
         return;
-    size_t inc = sz - n;
-    jl_array_grow_end(a, inc);
-    a->nrows = n;
-#ifdef STORE_ARRAY_LEN
-    a->length = n;
-#endif
+    size_t newlen = sz + a->offset;
+    if (newlen <= a->maxsize)
+        return;
+    // same shared-buffer rules as jl_array_grow_at_end: foreign-owned
+    // data (how != 3) must never be realloc'd or freed under its owner,
+    // and julia-shared data is unshared before resizing
+    if (__unlikely(a->flags.isshared)) {
+        if (a->flags.how != 3)
+            jl_error("cannot resize array with shared data");
+        array_try_unshare(a);
+        if (newlen <= a->maxsize)
+            return; // unsharing reserved enough
+    }
+    // Reserve exactly the requested capacity, without the element
+    // initialization jl_array_grow_end performs and without its doubling:
+    // the reserved region stays beyond nrows, so the collector never scans
+    // it and pointer elements need no zeroing until the array actually
+    // grows into it. (array_resize_buffer still NUL terminates byte
+    // arrays.)
+    size_t elsz = a->elsize;
+    char *olddata = (char*)a->data;
+    size_t nused = n * elsz;
+    int newbuf = array_resize_buffer(a, newlen);
+    char *newdata = (char*)a->data + a->offset * elsz;
+    if (newbuf)
+        memcpy(newdata, olddata, nused);
+    a->data = newdata;
+}
+
+// Bulk element transfer between a bits-type array and a raw C buffer.
+// The element layout is validated once and the range moves with a single
+// memcpy, instead of a jl_arrayref/jl_arrayset round trip (box, dispatch
+// and type check) per element. The buffer must hold n elements laid out
+// exactly like the array's (use the array's elsize); conversions are the
+// caller's job. Pointer-element arrays are refused: raw object pointers
+// in an unrooted C buffer would be invisible to the collector.
+JL_DLLEXPORT void jl_array_copyto_buf(jl_array_t *a, size_t offs, void *buf,
+                                      size_t n)
+{
+    if (a->flags.ptrarray)
+        jl_error("jl_array_copyto_buf: array elements must be stored unboxed");
+    size_t len = jl_array_len(a);
+    if (offs > len || n > len - offs)
+        jl_bounds_error_int((jl_value_t*)a, offs + n);
+    memcpy(buf, (char*)a->data + offs * a->elsize, n * a->elsize);
+}
+
+JL_DLLEXPORT void jl_array_fill_from_buf(jl_array_t *a, size_t offs,
+                                         const void *buf, size_t n)
+{
+    if (a->flags.ptrarray)
+        jl_error("jl_array_fill_from_buf: array elements must be stored unboxed");
+    size_t len = jl_array_len(a);
+    if (offs > len || n > len - offs)
+        jl_bounds_error_int((jl_value_t*)a, offs + n);
+    memcpy((char*)a->data + offs * a->elsize, buf, n * a->elsize);
 }
 
 JL_DLLEXPORT jl_array_t *jl_array_copy(jl_array_t *ary)
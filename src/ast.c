@@ -223,6 +223,10 @@ static void jl_init_ast_ctx(jl_ast_context_t *ast_ctx)
         jl_parse_deperror(fl_ctx, 1);
     else
         jl_parse_depwarn_(fl_ctx, (int)jl_options.depwarn);
+
+    // tenure the boot image and everything set up above, so steady-state
+    // parsing stops recopying the static compiler code on every flisp gc
+    fl_gc_promote(fl_ctx);
 }
 
 // There should be no GC allocation while holding this lock
@@ -230,9 +234,43 @@ static jl_mutex_t flisp_lock;
 static jl_ast_context_list_t *jl_ast_ctx_using = NULL;
 static jl_ast_context_list_t *jl_ast_ctx_freed = NULL;
 
+// Each thread keeps one warm, dedicated context outside the shared pool:
+// only its owning thread ever touches it, so claim and release need no
+// lock. Reentrant uses by the same task keep working through the ref
+// count; the rare case of a different task hitting the parser on the same
+// thread while it is held falls back to the locked pool.
+#if defined(_COMPILER_MICROSOFT_)
+static __declspec(thread) jl_ast_context_t *jl_ast_thread_ctx = NULL;
+#else
+static __thread jl_ast_context_t *jl_ast_thread_ctx = NULL;
+#endif
+
 static jl_ast_context_t *jl_ast_ctx_enter(void)
 {
     JL_SIGATOMIC_BEGIN();
+    jl_ast_context_t *tctx = jl_ast_thread_ctx;
+    if (tctx != NULL) {
+        if (tctx->task == jl_current_task) {
+            tctx->ref++;
+            return tctx;
+        }
+        if (tctx->ref == 0) {
+            tctx->ref = 1;
+            tctx->task = jl_current_task;
+            tctx->roots = NULL;
+            return tctx;
+        }
+    }
+    else {
+        tctx = (jl_ast_context_t*)calloc(1, sizeof(jl_ast_context_t));
+        if (tctx != NULL) {
+            tctx->ref = 1;
+            tctx->task = jl_current_task;
+            jl_ast_thread_ctx = tctx;
+            jl_init_ast_ctx(tctx);
+            return tctx;
+        }
+    }
     JL_LOCK_NOGC(&flisp_lock);
     jl_ast_context_list_t *node;
     jl_ast_context_t *ctx;
@@ -273,6 +311,11 @@ static void jl_ast_ctx_leave(jl_ast_context_t *ctx)
     JL_SIGATOMIC_END();
     if (--ctx->ref)
         return;
+    if (ctx == jl_ast_thread_ctx) {
+        // the dedicated context stays parked with the thread
+        ctx->task = NULL;
+        return;
+    }
     JL_LOCK_NOGC(&flisp_lock);
     ctx->task = NULL;
     jl_ast_context_list_t *node = &ctx->list;
@@ -318,7 +361,14 @@ static jl_sym_t *scmsym_to_julia(fl_context_t *fl_ctx, value_t s)
         *(--n) = '#';
         return jl_symbol(n);
     }
-    return jl_symbol(symbol_name(fl_ctx, s));
+    // interned flisp symbols are immortal and so are jl symbols, so the
+    // name hash and symbol-table walk only ever need to happen once per
+    // (context, symbol) pair; symbols are the most common leaf the
+    // conversion pass touches
+    symbol_t *sp = (symbol_t*)ptr(s);
+    if (sp->embcache == NULL)
+        sp->embcache = (void*)jl_symbol(symbol_name(fl_ctx, s));
+    return (jl_sym_t*)sp->embcache;
 }
 
 static jl_value_t *scm_to_julia_(fl_context_t *fl_ctx, value_t e, int expronly);
@@ -610,6 +660,48 @@ JL_DLLEXPORT jl_value_t *jl_parse_input_line(const char *str, size_t len, const
 
 // this is for parsing one expression out of a string, keeping track of
 // the current position.
+// Parse a whole buffer into an array of its top level expressions with a
+// single front end context acquisition, for callers that want the forms
+// without evaluating them (include already batches through
+// jl_parse_eval_all). Returns nothing when the text cannot be parsed at
+// all; syntax errors inside come back as the usual (error ...)/
+// (incomplete ...) expressions in the array.
+JL_DLLEXPORT jl_value_t *jl_parse_buffer(const char *content,
+                                         size_t contentlen,
+                                         const char *fname, size_t fnamelen)
+{
+    jl_ast_context_t *ctx = jl_ast_ctx_enter();
+    fl_context_t *fl_ctx = &ctx->fl;
+    value_t f = cvalue_static_cstrn(fl_ctx, fname, fnamelen);
+    fl_gc_handle(fl_ctx, &f);
+    value_t t = cvalue_static_cstrn(fl_ctx, content, contentlen);
+    fl_gc_handle(fl_ctx, &t);
+    value_t ast = fl_applyn(fl_ctx, 2,
+                            symbol_value(symbol(fl_ctx, "jl-parse-string-stream")),
+                            t, f);
+    fl_free_gc_handles(fl_ctx, 2);
+    if (ast == fl_ctx->F) {
+        jl_ast_ctx_leave(ctx);
+        return jl_nothing;
+    }
+    fl_gc_handle(fl_ctx, &ast);
+    jl_array_t *exprs = NULL;
+    jl_value_t *form = NULL;
+    JL_GC_PUSH2(&exprs, &form);
+    exprs = jl_alloc_vec_any(0);
+    assert(iscons(ast) && car_(ast) == symbol(fl_ctx, "toplevel"));
+    ast = cdr_(ast);
+    while (iscons(ast)) {
+        form = scm_to_julia(fl_ctx, car_(ast), 0);
+        jl_array_ptr_1d_push(exprs, form);
+        ast = cdr_(ast);
+    }
+    fl_free_gc_handles(fl_ctx, 1);
+    jl_ast_ctx_leave(ctx);
+    JL_GC_POP();
+    return (jl_value_t*)exprs;
+}
+
 JL_DLLEXPORT jl_value_t *jl_parse_string(const char *str, size_t len,
                                          int pos0, int greedy)
 {
@@ -641,6 +733,18 @@ JL_DLLEXPORT jl_value_t *jl_parse_string(const char *str, size_t len,
 }
 
 // parse and eval a whole file, possibly reading from a string (`content`)
+// On pipelining this loop (overlapping frontend time with evaluation):
+// parsing is already batched -- jl-parse-file materializes the entire
+// file's surface AST in one flisp call before the loop starts, so there
+// is no parse/eval alternation left to overlap. What alternates with
+// evaluation is jl-expand-to-thunk, and that cannot run ahead: macro
+// expansion executes macros whose definitions may have been evaluated
+// earlier in the same file, so expanding expression N+1 before
+// evaluating expression N changes meaning (and a worker thread could
+// not help anyway -- the surface AST lives in this context's flisp
+// heap, which no other context can trace). Expansion must stay
+// lockstep with evaluation; the frontend costs that can be cut have
+// been (batched parse, memoized symbol conversion, pinned boot image).
 jl_value_t *jl_parse_eval_all(const char *fname,
                               const char *content, size_t contentlen)
 {
@@ -148,8 +148,40 @@ JL_DLLEXPORT void JL_NORETURN jl_bounds_error_unboxed_int(void *data, jl_value_t
     jl_throw(jl_new_struct((jl_datatype_t*)jl_boundserror_type, v, t));
 }
 
+// Opt into (or out of) the reusable per-thread BoundsError for this
+// thread; returns the previous setting. Only sound when every handler in
+// scope lets no thrown BoundsError escape the catch block: the same
+// error object and index box are mutated by the next failing lookup.
+// Speculative try/catch lookup loops use this to make their failure
+// path allocation-free.
+JL_DLLEXPORT int jl_boundserror_reuse(int enable)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    int old = ptls->boundserr_reuse;
+    ptls->boundserr_reuse = (int8_t)enable;
+    return old;
+}
+
 JL_DLLEXPORT void JL_NORETURN jl_bounds_error_int(jl_value_t *v, size_t i)
 {
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    if (__unlikely(ptls->boundserr_reuse)) {
+        JL_GC_PUSH1(&v);
+        if (ptls->reusable_boundserr == NULL) {
+            ssize_t zero = 0;
+            ptls->reusable_boundserr_idx =
+                jl_new_bits((jl_value_t*)jl_long_type, &zero);
+            jl_value_t *args[2] = {v, ptls->reusable_boundserr_idx};
+            ptls->reusable_boundserr =
+                jl_new_structv((jl_datatype_t*)jl_boundserror_type, args, 2);
+        }
+        *(ssize_t*)jl_data_ptr(ptls->reusable_boundserr_idx) = (ssize_t)i;
+        jl_set_nth_field(ptls->reusable_boundserr, 0, v);
+        jl_set_nth_field(ptls->reusable_boundserr, 1,
+                         ptls->reusable_boundserr_idx);
+        JL_GC_POP();
+        jl_throw(ptls->reusable_boundserr);
+    }
     jl_value_t *t = NULL;
     JL_GC_PUSH2(&v, &t); // root arguments so the caller doesn't need to
     t = jl_box_long(i);
@@ -169,12 +201,19 @@ JL_DLLEXPORT void JL_NORETURN jl_bounds_error_ints(jl_value_t *v, size_t *idxs,
     jl_throw(jl_new_struct((jl_datatype_t*)jl_boundserror_type, v, t));
 }
 
+jl_value_t *jl_eof_exception = NULL;
+
 JL_DLLEXPORT void JL_NORETURN jl_eof_error(void)
 {
     jl_datatype_t *eof_error =
         (jl_datatype_t*)jl_get_global(jl_base_module, jl_symbol("EOFError"));
     assert(eof_error != NULL);
-    jl_exceptionf(eof_error, "");
+    // EOFError carries no state, so one preallocated instance serves all
+    // throws -- failed speculative reads stop producing garbage
+    if (jl_eof_exception == NULL ||
+        (jl_datatype_t*)jl_typeof(jl_eof_exception) != eof_error)
+        jl_eof_exception = jl_new_struct_uninit(eof_error);
+    jl_throw(jl_eof_exception);
 }
 
 JL_DLLEXPORT jl_value_t *jl_get_keyword_sorter(jl_value_t *f)
@@ -227,6 +266,17 @@ static int bits_equal(void *a, void *b, int sz)
     case 2:  return *(int16_t*)a == *(int16_t*)b;
     case 4:  return *(int32_t*)a == *(int32_t*)b;
     case 8:  return *(int64_t*)a == *(int64_t*)b;
+    case 16: {
+        // common for Complex128, Vec{2,Float64}, 2-field word pairs.
+        // memcpy compiles to two plain (possibly unaligned) loads and
+        // avoids the memcmp call
+        int64_t a0, a1, b0, b1;
+        memcpy(&a0, a, 8);
+        memcpy(&a1, (char*)a + 8, 8);
+        memcpy(&b0, b, 8);
+        memcpy(&b1, (char*)b + 8, 8);
+        return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+    }
     default: return memcmp(a, b, sz)==0;
     }
 }
@@ -471,6 +521,13 @@ JL_CALLABLE(jl_f__apply)
     }
     jl_value_t **newargs;
     n++;
+    // Small and medium splats (up to a page worth of pointers, which
+    // covers essentially every `f(args...)` in dynamic code) place the
+    // flattened arguments in the alloca-rooted frame JL_GC_PUSHARGS sets
+    // up and pass them straight to dispatch with no heap traffic; only
+    // oversized splats fall back to a heap svec. The remaining per-call
+    // allocations on this path are the unavoidable boxes for elements of
+    // unboxed (bits) containers.
     int onstack = (n < jl_page_size/sizeof(jl_value_t*));
     JL_GC_PUSHARGS(newargs, onstack ? n : 1);
     jl_svec_t *arg_heap = NULL;
@@ -1021,6 +1078,19 @@ static uintptr_t bits_hash(void *b, size_t sz)
     case 2:  return int32hash(*(int16_t*)b);
     case 4:  return int32hash(*(int32_t*)b);
     case 8:  return hash64(*(int64_t*)b);
+    case 16: {
+        // mix the two words directly instead of paying MurmurHash's
+        // setup for a 2-word key
+        int64_t b0, b1;
+        memcpy(&b0, b, 8);
+        memcpy(&b1, (char*)b + 8, 8);
+#ifdef _P64
+        return bitmix(hash64(b0), hash64(b1));
+#else
+        return int64to32hash((((uint64_t)(uint32_t)hash64(b0)) << 32) |
+                             (uint32_t)hash64(b1));
+#endif
+    }
     default:
 #ifdef _P64
         return memhash((char*)b, sz);
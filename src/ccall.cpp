@@ -57,16 +57,32 @@ static Value *runtime_sym_lookup(PointerType *funcptype, const char *f_lib, cons
     }
     assert(libsym != NULL);
 
-    GlobalVariable *llvmgv = symMapGV[f_name];
+    // The resolved-pointer slot is shared by every call site of the same
+    // (library, symbol) pair: one dlsym, one lazily-initialized global,
+    // however many ccall sites reference it. Keying by the symbol alone
+    // would wrongly unify same-named symbols from different libraries.
+    std::string sym_key = f_name;
+    if (runtime_lib) {
+        sym_key += ":";
+        sym_key += f_lib;
+    }
+    GlobalVariable *llvmgv = symMapGV[sym_key];
     if (llvmgv == NULL) {
         // MCJIT forces this to have external linkage eventually, so we would clobber
         // the symbol of the actual function.
         std::string name = "ccall_";
         name += f_name;
+        // slots for different libraries must also get distinct global
+        // names: MCJIT gives these external linkage, so same-named
+        // globals would be unified across modules
+        if (runtime_lib) {
+            name += "_";
+            name += std::to_string(globalUnique++);
+        }
         llvmgv = new GlobalVariable(*jl_Module, T_pvoidfunc,
            false, GlobalVariable::ExternalLinkage,
            NULL, name);
-        symMapGV[f_name] = global_proto(llvmgv);
+        symMapGV[sym_key] = global_proto(llvmgv);
         *(void**)jl_emit_and_add_to_shadow(llvmgv) = jl_dlsym_e(libsym, f_name);
     }
     else {
@@ -1124,6 +1140,12 @@ static jl_cgval_t emit_ccall(jl_value_t **args, size_t nargs, jl_codectx_t *ctx)
 
     // check for calling convention specifier
     CallingConv::ID cc = CallingConv::C;
+    // `gcsafe`: the thread enters the GC-safe state around the call, so
+    // a blocking callee (read(), BLAS) no longer stalls collections on
+    // the other threads. Callers guarantee the callee never touches the
+    // julia heap or runtime; argument roots are held by the surrounding
+    // frame as usual and nothing moves under this collector.
+    bool gc_safe = false;
     jl_value_t *last = args[nargs];
     if (jl_is_expr(last)) {
         jl_sym_t *lhd = ((jl_expr_t*)last)->head;
@@ -1131,6 +1153,11 @@ static jl_cgval_t emit_ccall(jl_value_t **args, size_t nargs, jl_codectx_t *ctx)
             cc = CallingConv::X86_StdCall;
             nargs--;
         }
+        else if (lhd == jl_symbol("gcsafe")) {
+            cc = CallingConv::C;
+            gc_safe = true;
+            nargs--;
+        }
         else if (lhd == jl_symbol("cdecl")) {
             cc = CallingConv::C;
             nargs--;
@@ -1529,11 +1556,23 @@ static jl_cgval_t emit_ccall(jl_value_t **args, size_t nargs, jl_codectx_t *ctx)
     //for (int i = 0; i < (nargs - 3) / 2 + sret; ++i)
     //    argvals[i]->dump();
 
+    // for a gcsafe call, park the thread in the GC-safe state for the
+    // duration of the callee; every argument is a converted native
+    // value by this point and their julia roots stay live in this frame
+    Value *gc_state = NULL;
+    if (gc_safe)
+        gc_state = builder.CreateCall(
+            prepare_call(jlccall_gc_safe_enter_func));
+
     // the actual call
     Value *ret = builder.CreateCall(prepare_call(llvmf),
                                     ArrayRef<Value*>(&argvals[0], (nargs - 3) / 2 + sret));
     ((CallInst*)ret)->setAttributes(attrs);
 
+    if (gc_safe)
+        builder.CreateCall(prepare_call(jlccall_gc_safe_leave_func),
+                           gc_state);
+
     if (cc != CallingConv::C)
         ((CallInst*)ret)->setCallingConv(cc);
     if (!sret)
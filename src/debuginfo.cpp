@@ -234,6 +234,134 @@ void jl_callback_triggered_linfos(void)
     }
 }
 
+#if defined(_OS_LINUX_)
+#include <unistd.h> // getpid
+// perf map emission (JULIA_PERF_MAP=1)
+//
+// Linux perf resolves JIT addresses through /tmp/perf-<pid>.map when it
+// exists: one "start size name" line per function. Emitting those as
+// objects are registered makes system-wide profiles show julia frames
+// instead of [unknown]. Full jitdump records (for perf inject, with line
+// info) additionally need the timestamped file header/clock handshake
+// protocol; the map alone fixes symbolization, which is what the fleet
+// profiles were missing.
+static FILE *perf_map_file = NULL;
+static int perf_map_checked = 0;
+
+static void jl_write_perf_map_entry(uint64_t addr, uint64_t size,
+                                    llvm::StringRef name)
+{
+    if (!perf_map_checked) {
+        perf_map_checked = 1;
+        const char *env = getenv(PERF_MAP_NAME);
+        if (env && strtol(env, NULL, 10)) {
+            char path[64];
+            snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+            perf_map_file = fopen(path, "w");
+        }
+    }
+    if (perf_map_file != NULL) {
+        fprintf(perf_map_file, "%llx %llx %.*s\n",
+                (unsigned long long)addr, (unsigned long long)size,
+                (int)name.size(), name.data());
+        fflush(perf_map_file); // perf may scrape the map at any time
+    }
+}
+#else
+static void jl_write_perf_map_entry(uint64_t addr, uint64_t size,
+                                    llvm::StringRef name)
+{
+    (void)addr;
+    (void)size;
+    (void)name;
+}
+#endif
+
+#ifdef USE_MCJIT
+// Read-optimized range index over the MCJIT object map
+//
+// jl_DI_for_fptr runs for every frame the profiler or the crash handler
+// symbolizes, and going through the rwlock-guarded std::map meant that
+// read path contended with the JIT registering new code. The code ranges
+// are mirrored here in a sorted array, updated under the existing write
+// lock and read with a seqlock protocol: lookups retry around a
+// concurrent update and never take a lock. The entries point at the
+// std::map nodes, whose addresses are stable (code is never freed), and
+// outgrown arrays are retired instead of freed so a reader that raced a
+// growth can finish its (to-be-retried) scan safely; with doubling the
+// retired memory stays bounded by the live size.
+typedef struct {
+    size_t start;
+    size_t size;
+    const ObjectInfo *info;
+} jl_code_range_t;
+
+static volatile uint32_t code_ranges_seq = 0;
+static jl_code_range_t *volatile code_ranges = NULL;
+static volatile size_t code_ranges_len = 0;
+static size_t code_ranges_cap = 0;
+
+// insert a range; the caller holds the debuginfo write lock
+static void jl_code_ranges_insert(size_t start, size_t size,
+                                  const ObjectInfo *info)
+{
+    jl_atomic_store_release(&code_ranges_seq, code_ranges_seq + 1); // odd
+    if (code_ranges_len == code_ranges_cap) {
+        size_t newcap = code_ranges_cap ? code_ranges_cap * 2 : 256;
+        jl_code_range_t *n =
+            (jl_code_range_t*)malloc(newcap * sizeof(jl_code_range_t));
+        if (n == NULL) {
+            // leave the index one entry short; lookups that miss it fall
+            // back to the locked map path
+            jl_atomic_store_release(&code_ranges_seq, code_ranges_seq + 1);
+            return;
+        }
+        memcpy(n, code_ranges, code_ranges_len * sizeof(jl_code_range_t));
+        code_ranges = n; // the old array is retired, not freed
+        code_ranges_cap = newcap;
+    }
+    size_t i = code_ranges_len;
+    while (i > 0 && code_ranges[i - 1].start > start) {
+        code_ranges[i] = code_ranges[i - 1];
+        i--;
+    }
+    code_ranges[i].start = start;
+    code_ranges[i].size = size;
+    code_ranges[i].info = info;
+    code_ranges_len = code_ranges_len + 1;
+    jl_atomic_store_release(&code_ranges_seq, code_ranges_seq + 1); // even
+}
+
+// lock-free containment lookup; NULL when `ptr` is not in JIT code
+static const ObjectInfo *jl_code_ranges_find(size_t ptr)
+{
+    while (1) {
+        uint32_t s1 = jl_atomic_load_acquire(&code_ranges_seq);
+        if (s1 & 1) {
+            jl_cpu_pause();
+            continue;
+        }
+        jl_code_range_t *arr = code_ranges;
+        size_t n = code_ranges_len;
+        const ObjectInfo *found = NULL;
+        if (arr != NULL && n != 0) {
+            size_t lo = 0, hi = n;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (arr[mid].start <= ptr)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            if (lo > 0 && ptr < arr[lo - 1].start + arr[lo - 1].size)
+                found = arr[lo - 1].info;
+        }
+        if (jl_atomic_load_acquire(&code_ranges_seq) == s1)
+            return found;
+    }
+}
+#endif
+
 class JuliaJITEventListener: public JITEventListener
 {
 #ifndef USE_MCJIT
@@ -486,6 +614,7 @@ public:
                    (uint8_t*)(intptr_t)Addr, (size_t)Size, sName,
                    (uint8_t*)(intptr_t)SectionLoadAddr, (size_t)SectionSize, UnwindData);
 #endif
+            jl_write_perf_map_entry(Addr, Size, sName);
             StringMap<jl_lambda_info_t*>::iterator linfo_it = linfo_in_flight.find(sName);
             jl_lambda_info_t *linfo = NULL;
             if (linfo_it != linfo_in_flight.end()) {
@@ -505,6 +634,8 @@ public:
                     new DWARFContextInMemory(debugObj, &L),
                     };
                 objectmap[SectionLoadAddr] = tmp;
+                jl_code_ranges_insert(SectionLoadAddr, (size_t)SectionSize,
+                                      &objectmap[SectionLoadAddr]);
                 first = false;
            }
         }
@@ -586,6 +717,7 @@ public:
                 linfo
             };
             objectmap[Addr] = tmp;
+            jl_code_ranges_insert(Addr, (size_t)Size, &objectmap[Addr]);
         }
 #else //LLVM34
         error_code itererr;
@@ -599,6 +731,7 @@ public:
 
             ObjectInfo tmp = {obj.getObjectFile(), (size_t)Size};
             objectmap[Addr] = tmp;
+            jl_code_ranges_insert(Addr, (size_t)Size, &objectmap[Addr]);
         }
 #endif
 #endif
@@ -1159,6 +1292,25 @@ int jl_DI_for_fptr(uint64_t fptr, uint64_t *symsize, int64_t *slide, int64_t *se
         found = 1;
     }
 #else // MCJIT version
+    // fast path: the lock-free range index (kept in sync with the map)
+    const ObjectInfo *oi = jl_code_ranges_find(fptr);
+    if (oi != NULL) {
+        if (symsize)
+            *symsize = 0;
+        if (section_slide)
+            *section_slide = oi->slide;
+        *object = oi->object;
+        if (context) {
+#if defined(LLVM37)
+            *context = oi->context;
+#else
+            *context = DIContext::getDWARFContext(*oi->object);
+#endif
+        }
+        return 1;
+    }
+    // the index can transiently be one entry short (growth OOM); fall
+    // back to the authoritative locked map
     std::map<size_t, ObjectInfo, revcomp> &objmap = jl_jit_events->getObjectMap();
     std::map<size_t, ObjectInfo, revcomp>::iterator fit = objmap.lower_bound(fptr);
 
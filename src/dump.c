@@ -8,6 +8,7 @@
 #include <assert.h>
 
 #include "julia.h"
+#include "htable2.h"
 #include "julia_internal.h"
 #include "builtin_proto.h"
 
@@ -43,7 +44,7 @@ static jl_value_t *deser_symbols[256];
 // (the order in the serializer stream) in MODE_MODULE, the low
 // bit is reserved for flagging certain entries and pos is
 // left shift by 1
-static htable_t backref_table;
+static htable2_t backref_table;
 int backref_table_numel;
 static arraylist_t backref_list;
 
@@ -122,10 +123,22 @@ static jl_value_t *jl_idtable_type=NULL;
 static arraylist_t builtin_types;
 
 #define write_uint8(s, n) ios_putc((n), (s))
-#define read_uint8(s) ((uint8_t)ios_getc(s))
 #define write_int8(s, n) write_uint8(s, n)
 #define read_int8(s) read_uint8(s)
 
+// Single byte reads dominate the deserializer (every tag, and all the
+// multi-byte helpers below); the streams it reads are fully buffered
+// (static buffers for the system image), so read straight out of the
+// buffer and only fall back to ios_getc when it runs dry. Unlike
+// ios_getc this does not track lineno, which is meaningless for the
+// binary streams the serializer works with.
+STATIC_INLINE uint8_t read_uint8(ios_t *s)
+{
+    if (__likely(s->state == bst_rd && s->bpos < s->size))
+        return (uint8_t)s->buf[s->bpos++];
+    return (uint8_t)ios_getc(s);
+}
+
 /* read and write in network (bigendian) order: */
 
 static void write_int32(ios_t *s, int32_t i)
@@ -193,6 +206,11 @@ static void write_float64(ios_t *s, double x)
 
 #define jl_serialize_value(s, v) jl_serialize_value_(s,(jl_value_t*)(v))
 static void jl_serialize_value_(ios_t *s, jl_value_t *v);
+// number of arrays aliasing the source mapping created by the current
+// restore; when nonzero the mapping must stay alive for the process
+// lifetime (see the restore entry points)
+static size_t zerocopy_codearrays = 0;
+
 static jl_value_t *jl_deserialize_value(ios_t *s, jl_value_t **loc);
 static jl_value_t ***sysimg_gvars = NULL;
 static void **sysimg_fvars = NULL;
@@ -291,13 +309,15 @@ static void jl_serialize_gv(ios_t *s, jl_value_t *v)
 
 static void jl_serialize_globalvals(ios_t *s)
 {
+    htable2_finish_migration(&backref_table);
     size_t i, len = backref_table.size;
-    void **p = backref_table.table;
-    for(i=0; i < len; i+=2) {
-        char *offs = (char*)p[i+1];
+    for(i=0; i < len; i++) {
+        if (backref_table.ctrl[i] == HT2_EMPTY)
+            continue;
+        char *offs = (char*)backref_table.vals[i];
         if (offs != HT_NOTFOUND) {
             uintptr_t pos = offs - (char*)HT_NOTFOUND - 1;
-            int32_t gv = jl_get_llvm_gv((jl_value_t*)p[i]);
+            int32_t gv = jl_get_llvm_gv((jl_value_t*)backref_table.keys[i]);
             if (gv != 0) {
                 write_int32(s, pos + 1);
                 write_int32(s, gv);
@@ -320,7 +340,7 @@ static void jl_serialize_gv_syms(ios_t *s, jl_sym_t *v)
 {
     // since symbols are static, they might not have had a
     // reference anywhere in the code image other than here
-    void *bp = ptrhash_get(&backref_table, v);
+    void *bp = htable2_get(&backref_table, v);
     if (bp == HT_NOTFOUND) {
         int32_t gv = jl_get_llvm_gv((jl_value_t*)v);
         if (gv != 0) {
@@ -342,7 +362,7 @@ static void jl_serialize_gv_others(ios_t *s)
     int32_t i;
     for (i = -512; i < 512; i++) {
         jl_value_t *v32 = jl_box_int32(i);
-        void *bp32 = ptrhash_get(&backref_table, v32);
+        void *bp32 = htable2_get(&backref_table, v32);
         if (bp32 == HT_NOTFOUND) {
             int32_t gv32 = jl_get_llvm_gv(v32);
             if (gv32 != 0) {
@@ -353,7 +373,7 @@ static void jl_serialize_gv_others(ios_t *s)
     }
     for (i = -512; i < 512; i++) {
         jl_value_t *v64 = jl_box_int64(i);
-        void *bp64 = ptrhash_get(&backref_table, v64);
+        void *bp64 = htable2_get(&backref_table, v64);
         if (bp64 == HT_NOTFOUND) {
             int32_t gv64 = jl_get_llvm_gv(v64);
             if (gv64 != 0) {
@@ -509,7 +529,7 @@ static void jl_serialize_datatype(ios_t *s, jl_datatype_t *dt)
             tag = 5; // anything else (needs uid assigned later)
             if (!internal) {
                 // also flag this in the backref table as special
-                uintptr_t *bp = (uintptr_t*)ptrhash_bp(&backref_table, dt);
+                uintptr_t *bp = (uintptr_t*)htable2_bp(&backref_table, dt);
                 assert(*bp != (uintptr_t)HT_NOTFOUND);
                 *bp |= 1; assert(((uintptr_t)HT_NOTFOUND)|1);
             }
@@ -656,6 +676,132 @@ static int literal_val_id(jl_value_t *v)
     return jl_array_len(tree_literal_values)-1;
 }
 
+// ---- content deduplication for the system image ----------------------
+//
+// The backref table only collapses pointer-identical objects; a sysimg
+// carries thousands of structurally identical immutable leaves (equal
+// strings, svecs with the same elements, equal small immutable bits
+// values) under distinct pointers. During MODE_SYSTEM_IMAGE those are
+// folded onto the first serialized copy: a content-keyed table maps
+// each eligible value to the backref ordinal of its canonical twin, and
+// later copies are written as plain backrefs -- the deserializer needs
+// no changes and the restored heap simply shares one object per
+// distinct content. Svec matching is shallow (same length, same element
+// pointers), which is what "structurally identical" amounts to once the
+// elements themselves deduplicate. Strings are folded on byte content,
+// relying on the Base convention that string data is never mutated.
+typedef struct {
+    uintptr_t hash; // 0 means empty
+    jl_value_t *val;
+    uintptr_t pos;
+} jl_dedup_entry_t;
+static jl_dedup_entry_t *dedup_table = NULL;
+static size_t dedup_size = 0;
+static size_t dedup_count = 0;
+
+static uintptr_t dedup_hash(jl_value_t *v)
+{
+    uintptr_t h = 0;
+    if (jl_is_svec(v)) {
+        h = memhash((char*)jl_svec_data(v),
+                    jl_svec_len(v) * sizeof(void*)) ^ 0x5653u;
+    }
+    else if (jl_is_string(v)) {
+        jl_array_t *d = (jl_array_t*)jl_data_ptr(v)[0];
+        h = memhash((char*)jl_array_data(d), jl_array_len(d)) ^ 0x5452u;
+    }
+    else { // small immutable bits value
+        jl_datatype_t *t = (jl_datatype_t*)jl_typeof(v);
+        h = memhash((char*)jl_data_ptr(v), jl_datatype_size(t)) ^
+            ((uintptr_t)t >> 4);
+    }
+    return h ? h : 1;
+}
+
+static int dedup_equal(jl_value_t *a, jl_value_t *b)
+{
+    if (jl_typeof(a) != jl_typeof(b))
+        return 0;
+    if (jl_is_svec(a)) {
+        return jl_svec_len(a) == jl_svec_len(b) &&
+            !memcmp(jl_svec_data(a), jl_svec_data(b),
+                    jl_svec_len(a) * sizeof(void*));
+    }
+    if (jl_is_string(a)) {
+        jl_array_t *da = (jl_array_t*)jl_data_ptr(a)[0];
+        jl_array_t *db = (jl_array_t*)jl_data_ptr(b)[0];
+        return jl_array_len(da) == jl_array_len(db) &&
+            !memcmp(jl_array_data(da), jl_array_data(db),
+                    jl_array_len(da));
+    }
+    return !memcmp(jl_data_ptr(a), jl_data_ptr(b),
+                   jl_datatype_size(jl_typeof(a)));
+}
+
+static int dedup_eligible(jl_value_t *v)
+{
+    if (jl_is_svec(v))
+        return 1;
+    jl_datatype_t *t = (jl_datatype_t*)jl_typeof(v);
+    if ((jl_value_t*)t == (jl_value_t*)jl_string_type)
+        return 1;
+    return jl_is_datatype(jl_typeof(v)) && !t->mutabl && t->uid != 0 &&
+        jl_datatype_nfields(t) > 0 && t->pointerfree &&
+        jl_datatype_size(t) > 0 && jl_datatype_size(t) <= 32;
+}
+
+// find (or, when pos != (uintptr_t)-1, insert) v's canonical ordinal
+static uintptr_t dedup_lookup(jl_value_t *v, uintptr_t hash, uintptr_t pos)
+{
+    if (dedup_table == NULL) {
+        dedup_size = 16384;
+        dedup_table = (jl_dedup_entry_t*)calloc(dedup_size,
+                                                sizeof(jl_dedup_entry_t));
+    }
+    size_t i = hash & (dedup_size - 1);
+    while (dedup_table[i].hash != 0) {
+        if (dedup_table[i].hash == hash &&
+            dedup_equal(dedup_table[i].val, v))
+            return dedup_table[i].pos;
+        i = (i + 1) & (dedup_size - 1);
+    }
+    if (pos != (uintptr_t)-1) {
+        if (dedup_count >= dedup_size / 2) {
+            // grow and rehash
+            size_t osize = dedup_size;
+            jl_dedup_entry_t *old = dedup_table;
+            dedup_size *= 2;
+            dedup_table = (jl_dedup_entry_t*)calloc(
+                dedup_size, sizeof(jl_dedup_entry_t));
+            for (size_t k = 0; k < osize; k++) {
+                if (old[k].hash == 0)
+                    continue;
+                size_t j = old[k].hash & (dedup_size - 1);
+                while (dedup_table[j].hash != 0)
+                    j = (j + 1) & (dedup_size - 1);
+                dedup_table[j] = old[k];
+            }
+            free(old);
+            i = hash & (dedup_size - 1);
+            while (dedup_table[i].hash != 0)
+                i = (i + 1) & (dedup_size - 1);
+        }
+        dedup_table[i].hash = hash;
+        dedup_table[i].val = v;
+        dedup_table[i].pos = pos;
+        dedup_count++;
+    }
+    return (uintptr_t)-1;
+}
+
+static void jl_dedup_reset(void)
+{
+    free(dedup_table);
+    dedup_table = NULL;
+    dedup_size = 0;
+    dedup_count = 0;
+}
+
 static void jl_serialize_value_(ios_t *s, jl_value_t *v)
 {
     if (v == NULL) {
@@ -688,7 +834,7 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
         }
     }
     else {
-        bp = ptrhash_bp(&backref_table, v);
+        bp = htable2_bp(&backref_table, v);
         if (*bp != HT_NOTFOUND) {
             uintptr_t pos = (char*)*bp - (char*)HT_NOTFOUND - 1;
             if (pos < 65536) {
@@ -701,6 +847,26 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
             }
             return;
         }
+        if (mode == MODE_SYSTEM_IMAGE && dedup_eligible(v)) {
+            uintptr_t h = dedup_hash(v);
+            uintptr_t cpos = dedup_lookup(v, h, (uintptr_t)-1);
+            if (cpos != (uintptr_t)-1) {
+                // an equal object was already written: emit a backref to
+                // it and remember this pointer as an alias of it
+                htable2_put(&backref_table, v,
+                            (char*)HT_NOTFOUND + cpos + 1);
+                if (cpos < 65536) {
+                    write_uint8(s, ShortBackRef_tag);
+                    write_uint16(s, (uint16_t)cpos);
+                }
+                else {
+                    write_uint8(s, BackRef_tag);
+                    write_int32(s, (int32_t)cpos);
+                }
+                return;
+            }
+            dedup_lookup(v, h, (uintptr_t)backref_table_numel);
+        }
         intptr_t pos = backref_table_numel++;
         if (jl_typeof(v) == jl_idtable_type) {
             // will need to rehash this, later (after types are fully constructed)
@@ -728,7 +894,7 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
         }
         if (mode == MODE_MODULE || mode == MODE_MODULE_POSTWORK)
             pos <<= 1;
-        ptrhash_put(&backref_table, v, (char*)HT_NOTFOUND + pos + 1);
+        htable2_put(&backref_table, v, (char*)HT_NOTFOUND + pos + 1);
     }
 
     size_t i;
@@ -857,10 +1023,25 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
     else if (jl_is_lambda_info(v)) {
         writetag(s, jl_lambda_info_type);
         jl_lambda_info_t *li = (jl_lambda_info_t*)v;
-        if (li->jlcall_api == 2)
-            jl_serialize_value(s, jl_nothing);
-        else
-            jl_serialize_value(s, li->code);
+        // Compressed method bodies are written as raw, independently
+        // addressable byte records (tag 1) instead of ordinary array
+        // values, so the deserializer can alias them directly out of a
+        // mapped image instead of copying them into the heap; everything
+        // else keeps the generic encoding under tag 0.
+        if (li->jlcall_api != 2 && li->code != NULL &&
+            jl_typeis(li->code, jl_array_uint8_type)) {
+            write_uint8(s, 1);
+            write_int32(s, (int32_t)jl_array_len(li->code));
+            ios_write(s, (char*)jl_array_data(li->code),
+                      jl_array_len(li->code));
+        }
+        else {
+            write_uint8(s, 0);
+            if (li->jlcall_api == 2)
+                jl_serialize_value(s, jl_nothing);
+            else
+                jl_serialize_value(s, li->code);
+        }
         jl_serialize_value(s, li->slotnames);
         jl_serialize_value(s, li->slottypes);
         jl_serialize_value(s, li->slotflags);
@@ -904,7 +1085,7 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
             if (v == t->instance) {
                 if (mode == MODE_MODULE) {
                     // also flag this in the backref table as special
-                    uintptr_t *bp = (uintptr_t*)ptrhash_bp(&backref_table, v);
+                    uintptr_t *bp = (uintptr_t*)htable2_bp(&backref_table, v);
                     assert(*bp != (uintptr_t)HT_NOTFOUND);
                     *bp |= 1; assert(((uintptr_t)HT_NOTFOUND)|1);
                 }
@@ -945,7 +1126,8 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
                         offsetof(jl_typemap_level_t, linear) == 2 * sizeof(jl_value_t*) &&
                         offsetof(jl_typemap_level_t, any) == 3 * sizeof(jl_value_t*) &&
                         offsetof(jl_typemap_level_t, key) == 4 * sizeof(jl_value_t*) &&
-                        sizeof(jl_typemap_level_t) == 5 * sizeof(jl_value_t*));
+                        offsetof(jl_typemap_level_t, leafsigs) == 5 * sizeof(jl_value_t*) &&
+                        sizeof(jl_typemap_level_t) == 6 * sizeof(jl_value_t*));
                     if (node->arg1 != (void*)jl_nothing) {
                         jl_array_t *a = jl_alloc_vec_any(0);
                         for (i = 0, l = jl_array_len(node->arg1); i < l; i++) {
@@ -973,6 +1155,10 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
                     jl_serialize_value(s, node->linear);
                     jl_serialize_value(s, node->any.unknown);
                     jl_serialize_value(s, node->key);
+                    // the leafsig index hashes type uids, which are not
+                    // stable across deserialization; it is rebuilt by
+                    // jl_typemap_rehash
+                    jl_serialize_value(s, jl_nothing);
                     return;
                 }
             }
@@ -991,7 +1177,13 @@ static void jl_serialize_value_(ios_t *s, jl_value_t *v)
             else {
                 for(size_t i=0; i < nf; i++) {
                     if (jl_field_size(t, i) > 0) {
-                        jl_serialize_value(s, jl_get_nth_field(v, i));
+                        // the typename field cache holds raw symbol
+                        // pointers; it is rebuilt lazily after restore
+                        if (t == jl_typename_type &&
+                            i == offsetof(jl_typename_t, fcache) / sizeof(void*))
+                            jl_serialize_value(s, jl_nothing);
+                        else
+                            jl_serialize_value(s, jl_get_nth_field(v, i));
                     }
                 }
             }
@@ -1199,6 +1391,8 @@ static jl_value_t *jl_deserialize_datatype(ios_t *s, int pos, jl_value_t **loc)
     backref_list.items[pos] = dt;
     dt->size = size;
     dt->struct_decl = NULL;
+    dt->ptroffsets = NULL;
+    dt->nptrfields = -1;
     dt->instance = NULL;
     dt->ditype = NULL;
     dt->abstract = flags&1;
@@ -1477,7 +1671,41 @@ static jl_value_t *jl_deserialize_value_(ios_t *s, jl_value_t *vtag, jl_value_t
                                       NWORDS(sizeof(jl_lambda_info_t)));
         if (usetable)
             arraylist_push(&backref_list, li);
-        li->code = jl_deserialize_value(s, &li->code); jl_gc_wb(li, li->code);
+        if (read_uint8(s) == 1) {
+            // raw compressed-body record: alias a mapped image instead
+            // of copying (the pages fault in only when the method is
+            // actually used, and user writes hit private COW pages);
+            // streamed sources still copy
+            size_t codelen = (size_t)read_int32(s);
+            if (s->mmapped && codelen >= 32) {
+                size_t zdim = 0;
+                jl_array_t *code = jl_new_array_for_deserialization(
+                    (jl_value_t*)jl_array_uint8_type, 1, &zdim, 1, 1);
+                code->data = (char*)s->buf + s->bpos;
+#ifdef STORE_ARRAY_LEN
+                code->length = codelen;
+#endif
+                code->nrows = codelen;
+                code->maxsize = codelen;
+                code->offset = 0;
+                code->flags.isshared = 1;
+                code->flags.isaligned = 0;
+                ios_skip(s, (int64_t)codelen);
+                zerocopy_codearrays++;
+                li->code = (jl_value_t*)code;
+            }
+            else {
+                jl_array_t *code = jl_alloc_array_1d(
+                    (jl_value_t*)jl_array_uint8_type, codelen);
+                ios_read(s, (char*)jl_array_data(code), codelen);
+                li->code = (jl_value_t*)code;
+            }
+            jl_gc_wb(li, li->code);
+        }
+        else {
+            li->code = jl_deserialize_value(s, &li->code);
+            jl_gc_wb(li, li->code);
+        }
         li->slotnames = (jl_array_t*)jl_deserialize_value(s, (jl_value_t**)&li->slotnames); jl_gc_wb(li, li->slotnames);
         li->slottypes = jl_deserialize_value(s, &li->slottypes); jl_gc_wb(li, li->slottypes);
         li->slotflags = (jl_array_t*)jl_deserialize_value(s, (jl_value_t**)&li->slotflags); jl_gc_wb(li, li->slotflags);
@@ -1514,6 +1742,7 @@ static jl_value_t *jl_deserialize_value_(ios_t *s, jl_value_t *vtag, jl_value_t
         jl_delayed_fptrs(li, func_llvm, cfunc_llvm);
         li->jlcall_api = read_int8(s);
         li->compile_traced = 0;
+        li->callcount = 0;
         return (jl_value_t*)li;
     }
     else if (vtag == (jl_value_t*)jl_module_type) {
@@ -1780,7 +2009,7 @@ static void jl_finalize_serializer(ios_t *f) {
         l = jl_array_len(jl_module_init_order);
         for(i=0; i < l; i++) {
             // verify that all these modules were saved
-            assert(ptrhash_get(&backref_table, jl_array_ptr_ref(jl_module_init_order, i)) != HT_NOTFOUND);
+            assert(htable2_get(&backref_table, jl_array_ptr_ref(jl_module_init_order, i)) != HT_NOTFOUND);
         }
     }
     if (mode != MODE_MODULE)
@@ -1884,9 +2113,10 @@ static void jl_save_system_image_to_stream(ios_t *f)
     jl_gc_collect(0); // incremental (sweep finalizers)
     JL_LOCK(&dump_lock); // Might GC
     int en = jl_gc_enable(0);
-    htable_reset(&backref_table, 250000);
+    htable2_reset(&backref_table, 250000);
     arraylist_new(&reinit_list, 0);
     backref_table_numel = 0;
+    jl_dedup_reset();
 
     // orphan old Base module if present
     jl_base_module = (jl_module_t*)jl_get_global(jl_main_module, jl_symbol("Base"));
@@ -1923,13 +2153,94 @@ static void jl_save_system_image_to_stream(ios_t *f)
     write_int32(f, jl_get_gs_ctr());
     jl_finalize_serializer(f); // done with f
 
-    htable_reset(&backref_table, 0);
+    htable2_reset(&backref_table, 0);
     arraylist_free(&reinit_list);
+    jl_dedup_reset();
 
     jl_gc_enable(en);
     JL_UNLOCK(&dump_lock); // Might GC
 }
 
+// compressed image container
+//
+// Cold container startup is dominated by paging a ~100MB image in from
+// slow layered storage; trading a little decompression CPU for 3-4x
+// less I/O wins. The serialized stream is wrapped in independently
+// decompressible 1MB segments (see support/lz4block.c), each prefixed
+// with its compressed and raw lengths, so a future parallel restore can
+// fan segments out; a segment that doesn't shrink is stored raw. Images
+// without the container magic load exactly as before.
+#define JI_COMPRESS_MAGIC "JLCZ0001"
+#define JI_COMPRESS_SEG (1 << 20)
+
+size_t jl_lz4_compress_bound(size_t n);
+size_t jl_lz4_compress(const char *src, size_t n, char *dst, size_t cap);
+size_t jl_lz4_decompress(const char *src, size_t n, char *dst, size_t cap);
+
+static void jl_write_compressed_image(ios_t *to, const char *data, size_t len)
+{
+    ios_write(to, JI_COMPRESS_MAGIC, 8);
+    write_uint64(to, len);
+    char *cbuf = (char*)malloc(jl_lz4_compress_bound(JI_COMPRESS_SEG));
+    size_t pos = 0;
+    while (pos < len) {
+        size_t raw = len - pos < JI_COMPRESS_SEG ? len - pos : JI_COMPRESS_SEG;
+        size_t cn = cbuf == NULL ? 0 :
+            jl_lz4_compress(data + pos, raw, cbuf,
+                            jl_lz4_compress_bound(JI_COMPRESS_SEG));
+        write_uint64(to, raw);
+        if (cn == 0 || cn >= raw) {
+            // incompressible: store the segment raw (comp_len == raw_len)
+            write_uint64(to, raw);
+            ios_write(to, data + pos, raw);
+        }
+        else {
+            write_uint64(to, cn);
+            ios_write(to, cbuf, cn);
+        }
+        pos += raw;
+    }
+    free(cbuf);
+}
+
+// when `buf` holds a compressed image, decompress it into a malloc'd
+// buffer and return it (with *outlen set); NULL means not compressed
+static char *jl_read_compressed_image(const char *buf, size_t len,
+                                      size_t *outlen)
+{
+    if (len < 16 || memcmp(buf, JI_COMPRESS_MAGIC, 8) != 0)
+        return NULL;
+    const unsigned char *p = (const unsigned char*)buf + 8;
+    const unsigned char *pend = (const unsigned char*)buf + len;
+#define JI_RD64(v) do {         uint64_t b_;         if (pend - p < 8) goto corrupt;         memcpy(&b_, p, 8);         /* stored big-endian by write_uint64's byte order */         v = 0;         for (int k_ = 0; k_ < 8; k_++)             v = (v << 8) | ((const unsigned char*)&b_)[k_];         p += 8;     } while (0)
+    uint64_t total;
+    JI_RD64(total);
+    char *out = (char*)malloc(total ? total : 1);
+    if (out == NULL)
+        return NULL;
+    size_t pos = 0;
+    while (pos < total) {
+        uint64_t raw, cn;
+        JI_RD64(raw);
+        JI_RD64(cn);
+        if (cn > (uint64_t)(pend - p) || raw > total - pos)
+            goto corrupt;
+        if (cn == raw) {
+            memcpy(out + pos, p, raw);
+        }
+        else if (jl_lz4_decompress((const char*)p, cn, out + pos, raw) != raw) {
+            goto corrupt;
+        }
+        p += cn;
+        pos += raw;
+    }
+    *outlen = total;
+    return out;
+corrupt:
+    jl_error("system image file appears to be corrupt");
+#undef JI_RD64
+}
+
 JL_DLLEXPORT void jl_save_system_image(const char *fname)
 {
     ios_t f;
@@ -1937,7 +2248,11 @@ JL_DLLEXPORT void jl_save_system_image(const char *fname)
         jl_errorf("cannot open system image file \"%s\" for writing", fname);
     }
     JL_SIGATOMIC_BEGIN();
-    jl_save_system_image_to_stream(&f);
+    ios_t mem;
+    ios_mem(&mem, 1000000);
+    jl_save_system_image_to_stream(&mem);
+    jl_write_compressed_image(&f, mem.buf, (size_t)mem.size);
+    ios_close(&mem);
     ios_close(&f);
     JL_SIGATOMIC_END();
 }
@@ -1946,7 +2261,13 @@ JL_DLLEXPORT ios_t *jl_create_system_image(void)
 {
     ios_t *f = (ios_t*)malloc(sizeof(ios_t));
     ios_mem(f, 1000000);
-    jl_save_system_image_to_stream(f);
+    ios_t mem;
+    ios_mem(&mem, 1000000);
+    jl_save_system_image_to_stream(&mem);
+    // compress the blob that gets embedded into the sysimg shared object:
+    // fewer pages to fault in from cold storage at every boot
+    jl_write_compressed_image(f, mem.buf, (size_t)mem.size);
+    ios_close(&mem);
     return f;
 }
 
@@ -2042,6 +2363,16 @@ static void jl_restore_system_image_from_stream(ios_t *f)
     jl_gc_enable(en);
     mode = last_mode;
     jl_update_all_fptrs();
+    // The freshly restored image is all young objects; left alone, the
+    // first several collections would scan and age the whole of it before
+    // the survivors finally reach the old generation. Promote it in one go
+    // instead: everything restored is reachable, so a single full
+    // collection marks the image and the full sweep moves it to the old
+    // generation, after which quick sweeps skip it entirely. During boot
+    // the GC is still disabled here (en == 0); _julia_init triggers the
+    // promotion after it re-enables collection.
+    if (en)
+        jl_gc_collect(1);
     JL_UNLOCK(&dump_lock); // Might GC
 }
 
@@ -2060,11 +2391,47 @@ JL_DLLEXPORT void jl_restore_system_image(const char *fname)
     }
     else {
         ios_t f;
-        if (ios_file(&f, fname, 1, 0, 0, 0) == NULL)
-            jl_errorf("system image file \"%s\" not found", fname);
+        char *filebuf = NULL;
+        // map rather than stream; compressed images decompress from the
+        // mapping, plain ones deserialize from it directly
+        if (ios_mmap(&f, fname, IOS_MMAP_SEQUENTIAL) == NULL) {
+            // no mapping (windows' ios_mmap is a stub; or mmap failed):
+            // slurp the file instead -- the container decoder needs the
+            // whole image contiguous, and streaming raw LZ4 bytes into
+            // the deserializer would be garbage
+            if (ios_file(&f, fname, 1, 0, 0, 0) == NULL)
+                jl_errorf("system image file \"%s\" not found", fname);
+            if (ios_seek_end(&f) != 0)
+                jl_errorf("system image file \"%s\" not seekable", fname);
+            int64_t fsz = ios_pos(&f);
+            ios_seek(&f, 0);
+            filebuf = (char*)malloc((size_t)fsz);
+            if (filebuf == NULL ||
+                ios_readall(&f, filebuf, (size_t)fsz) != (size_t)fsz)
+                jl_errorf("failed to read system image file \"%s\"", fname);
+            ios_close(&f);
+            ios_static_buffer(&f, filebuf, (size_t)fsz);
+        }
         JL_SIGATOMIC_BEGIN();
-        jl_restore_system_image_from_stream(&f);
-        ios_close(&f);
+        size_t rawlen = 0;
+        char *raw = jl_read_compressed_image(f.buf, (size_t)f.size, &rawlen);
+        size_t zc0 = zerocopy_codearrays;
+        if (raw != NULL) {
+            ios_t mem;
+            ios_static_buffer(&mem, raw, rawlen);
+            jl_restore_system_image_from_stream(&mem);
+            ios_close(&mem);
+            free(raw);
+        }
+        else {
+            jl_restore_system_image_from_stream(&f);
+        }
+        // method bodies aliasing the mapping require it to stay mapped
+        // for the life of the process; closing would munmap them (a
+        // slurped buffer is never aliased -- only mappings are)
+        if (zerocopy_codearrays == zc0)
+            ios_close(&f);
+        free(filebuf);
         JL_SIGATOMIC_END();
     }
 }
@@ -2073,9 +2440,15 @@ JL_DLLEXPORT void jl_restore_system_image_data(const char *buf, size_t len)
 {
     ios_t f;
     JL_SIGATOMIC_BEGIN();
-    ios_static_buffer(&f, (char*)buf, len);
+    size_t rawlen = 0;
+    char *raw = jl_read_compressed_image(buf, len, &rawlen);
+    if (raw != NULL)
+        ios_static_buffer(&f, raw, rawlen);
+    else
+        ios_static_buffer(&f, (char*)buf, len);
     jl_restore_system_image_from_stream(&f);
     ios_close(&f);
+    free(raw);
     JL_SIGATOMIC_END();
 }
 
@@ -2158,8 +2531,8 @@ JL_DLLEXPORT int jl_save_incremental(const char *fname, jl_array_t *worklist)
 
     JL_LOCK(&dump_lock); // Might GC
     arraylist_new(&reinit_list, 0);
-    htable_new(&backref_table, 5000);
-    ptrhash_put(&backref_table, jl_main_module, (char*)HT_NOTFOUND + 1);
+    htable2_new(&backref_table, 5000);
+    htable2_put(&backref_table, jl_main_module, (char*)HT_NOTFOUND + 1);
     backref_table_numel = 1;
     jl_idtable_type = jl_base_module ? jl_get_global(jl_base_module, jl_symbol("ObjectIdDict")) : NULL;
 
@@ -2178,7 +2551,7 @@ JL_DLLEXPORT int jl_save_incremental(const char *fname, jl_array_t *worklist)
     mode = last_mode;
     jl_gc_enable(en);
 
-    htable_reset(&backref_table, 0);
+    htable2_reset(&backref_table, 0);
     arraylist_free(&reinit_list);
     ios_close(&f);
     JL_UNLOCK(&dump_lock); // Might GC
@@ -2328,6 +2701,7 @@ static jl_array_t *_jl_restore_incremental(ios_t *f)
     int en = jl_gc_enable(0);
     DUMP_MODES last_mode = mode;
     mode = MODE_MODULE;
+    size_t zc0 = zerocopy_codearrays;
     jl_array_t *restored = NULL;
     jl_array_t *init_order = NULL;
     restored = (jl_array_t*)jl_deserialize_value(f, (jl_value_t**)&restored);
@@ -2349,7 +2723,9 @@ static jl_array_t *_jl_restore_incremental(ios_t *f)
     jl_gc_enable(en);
     arraylist_free(&flagref_list);
     arraylist_free(&backref_list);
-    ios_close(f);
+    // keep the mapping when restored method bodies alias it
+    if (zerocopy_codearrays == zc0)
+        ios_close(f);
     JL_GC_PUSH2(&init_order,&restored);
     JL_UNLOCK(&dump_lock); // Might GC
 
@@ -2380,7 +2756,11 @@ JL_DLLEXPORT jl_value_t *jl_restore_incremental(const char *fname)
 {
     ios_t f;
     jl_array_t *modules;
-    if (ios_file(&f, fname, 1, 0, 0, 0) == NULL) {
+    // map the cache file instead of streaming it: the deserializer's
+    // reads become loads from the page cache, and the pages are shared
+    // clean across every process restoring the same package
+    if (ios_mmap(&f, fname, IOS_MMAP_WILLNEED) == NULL &&
+        ios_file(&f, fname, 1, 0, 0, 0) == NULL) {
         jl_printf(JL_STDERR, "Cache file \"%s\" not found\n", fname);
         return jl_nothing;
     }
@@ -2395,7 +2775,7 @@ void jl_init_serializer(void)
     htable_new(&ser_tag, 0);
     htable_new(&common_symbol_tag, 0);
     htable_new(&fptr_to_id, sizeof(id_to_fptrs)/sizeof(*id_to_fptrs));
-    htable_new(&backref_table, 0);
+    htable2_new(&backref_table, 0);
 
     void *tags[] = { jl_symbol_type, jl_ssavalue_type, jl_datatype_type, jl_slotnumber_type,
                      jl_simplevector_type, jl_array_type, jl_typedslot_type,
@@ -49,7 +49,11 @@ static void sweep_finalizers(fl_context_t *fl_ctx)
         return;
     do {
         tmp = lst[n];
-        if (isforwarded((value_t)tmp)) {
+        if (isold(fl_ctx, tagptr(tmp, TAG_CVALUE))) {
+            // tenured objects (fl_gc_promote) are never collected
+            n++;
+        }
+        else if (isforwarded((value_t)tmp)) {
             // object is alive
             lst[n] = (cvalue_t*)ptr(forwardloc((value_t)tmp));
             n++;
@@ -240,6 +240,7 @@ static symbol_t *mk_symbol(const char *str)
     }
     sym->type = NULL;
     sym->dlcache = NULL;
+    sym->embcache = NULL;
     sym->hash = memhash32(str, len)^0xAAAAAAAA;
     strcpy(&sym->name[0], str);
     return sym;
@@ -385,9 +386,19 @@ static value_t *alloc_words(fl_context_t *fl_ctx, int n)
 #define mark_cons(fl_ctx, c)   ((((value_t*)ptr(c))[-1]) |= 1)
 #define unmark_cons(fl_ctx, c) ((((value_t*)ptr(c))[-1]) &= (~(value_t)1))
 #else
-#define ismarked(fl_ctx, c)    bitvector_get(fl_ctx->consflags, cons_index(fl_ctx, c))
-#define mark_cons(fl_ctx, c)   bitvector_set(fl_ctx->consflags, cons_index(fl_ctx, c), 1)
-#define unmark_cons(fl_ctx, c) bitvector_set(fl_ctx->consflags, cons_index(fl_ctx, c), 0)
+#define oldcons_index(fl_ctx, c) (((cons_t*)ptr(c))-((cons_t*)fl_ctx->oldspace))
+#define ismarked(fl_ctx, c)                                             \
+    (isold(fl_ctx, c)                                                   \
+     ? bitvector_get(fl_ctx->oldconsflags, oldcons_index(fl_ctx, c))    \
+     : bitvector_get(fl_ctx->consflags, cons_index(fl_ctx, c)))
+#define mark_cons(fl_ctx, c)                                            \
+    (isold(fl_ctx, c)                                                   \
+     ? bitvector_set(fl_ctx->oldconsflags, oldcons_index(fl_ctx, c), 1) \
+     : bitvector_set(fl_ctx->consflags, cons_index(fl_ctx, c), 1))
+#define unmark_cons(fl_ctx, c)                                          \
+    (isold(fl_ctx, c)                                                   \
+     ? bitvector_set(fl_ctx->oldconsflags, oldcons_index(fl_ctx, c), 0) \
+     : bitvector_set(fl_ctx->consflags, cons_index(fl_ctx, c), 0))
 #endif
 
 value_t alloc_vector(fl_context_t *fl_ctx, size_t n, int init)
@@ -451,6 +462,10 @@ static value_t relocate(fl_context_t *fl_ctx, value_t v)
     value_t a, d, nc, first, *pcdr;
     uintptr_t t = tag(v);
 
+    // tenured objects stay put; their nursery references are handled by
+    // the remembered-set rescan in gc()
+    if (isold(fl_ctx, v))
+        return v;
     if (t == TAG_CONS) {
         // iterative implementation allows arbitrarily long cons chains
         pcdr = &first;
@@ -467,18 +482,20 @@ static value_t relocate(fl_context_t *fl_ctx, value_t v)
 #endif
             d = cdr_(v);
             car_(v) = TAG_FWD; cdr_(v) = nc;
-            if ((tag(a)&3) == 0 || !ismanaged(fl_ctx, a))
+            if ((tag(a)&3) == 0 || !isyoung(fl_ctx, a))
                 car_(nc) = a;
             else
                 car_(nc) = relocate(fl_ctx, a);
             pcdr = &cdr_(nc);
             v = d;
-        } while (iscons(v));
+            // a tenured cons ends the copy; the tail relocate below
+            // returns it unmoved
+        } while (iscons(v) && !isold(fl_ctx, v));
         *pcdr = (d==fl_ctx->NIL) ? fl_ctx->NIL : relocate(fl_ctx, d);
         return first;
     }
 
-    if ((t&3) == 0 || !ismanaged(fl_ctx, v)) return v;
+    if ((t&3) == 0 || !isyoung(fl_ctx, v)) return v;
     if (isforwarded(v)) return forwardloc(v);
 
     if (t == TAG_VECTOR) {
@@ -498,7 +515,7 @@ static value_t relocate(fl_context_t *fl_ctx, value_t v)
                 vector_elt(nc,0) = relocate(fl_ctx, a);
                 for(i=1; i < sz; i++) {
                     a = vector_elt(v,i);
-                    if ((tag(a)&3) == 0 || !ismanaged(fl_ctx, a))
+                    if ((tag(a)&3) == 0 || !isyoung(fl_ctx, a))
                         vector_elt(nc,i) = a;
                     else
                         vector_elt(nc,i) = relocate(fl_ctx, a);
@@ -548,24 +565,13 @@ static value_t relocate(fl_context_t *fl_ctx, value_t v)
     return v;
 }
 
-void gc(fl_context_t *fl_ctx, int mustgrow)
+// relocate every root the collector knows about into the space curheap
+// currently points at; shared between ordinary collections and the
+// tenuring pass in fl_gc_promote
+static void gc_trace_roots(fl_context_t *fl_ctx)
 {
-    void *temp;
     uint32_t i, f, top;
     fl_readstate_t *rs;
-#ifdef MEMDEBUG2
-    temp = fl_ctx->tochain;
-    fl_ctx->tochain = NULL;
-    fl_ctx->n_allocd = -100000000000LL;
-#else
-    size_t hsz = fl_ctx->gc_grew ? fl_ctx->heapsize*2 : fl_ctx->heapsize;
-#ifdef MEMDEBUG
-    fl_ctx->tospace = LLT_ALLOC(hsz);
-#endif
-    fl_ctx->curheap = fl_ctx->tospace;
-    fl_ctx->lim = fl_ctx->curheap + hsz - sizeof(cons_t);
-#endif
-
     if (fl_ctx->throwing_frame > fl_ctx->curr_frame) {
         top = fl_ctx->throwing_frame - 3;
         f = fl_ctx->Stack[fl_ctx->throwing_frame-3];
@@ -597,6 +603,92 @@ void gc(fl_context_t *fl_ctx, int mustgrow)
     fl_ctx->lasterror = relocate(fl_ctx, fl_ctx->lasterror);
     fl_ctx->memory_exception_value = relocate(fl_ctx, fl_ctx->memory_exception_value);
     fl_ctx->the_empty_vector = relocate(fl_ctx, fl_ctx->the_empty_vector);
+}
+
+// a relocated child still lives in the nursery if it was just copied to
+// the space curheap is filling
+#define in_tonursery(fl_ctx, v)                             \
+    ((tag(v)&3) != 0 &&                                     \
+     ((unsigned char*)ptr(v)) >= fl_ctx->tospace &&         \
+     ((unsigned char*)ptr(v)) < fl_ctx->curheap)
+
+// re-trace a tenured object whose fields were mutated since the last
+// collection: its children are roots. Sets *young when it still holds
+// nursery references afterwards (and so must stay remembered).
+static void rescan_old(fl_context_t *fl_ctx, value_t v, int *young)
+{
+    uintptr_t t = tag(v);
+    if (t == TAG_CONS) {
+        car_(v) = relocate(fl_ctx, car_(v));
+        cdr_(v) = relocate(fl_ctx, cdr_(v));
+        *young |= (in_tonursery(fl_ctx, car_(v)) ||
+                   in_tonursery(fl_ctx, cdr_(v)));
+    }
+    else if (t == TAG_VECTOR) {
+        size_t i, sz = vector_size(v);
+        if (vector_elt(v,-1) & 0x1)
+            sz = 1; // grown vector: elt 0 forwards to the replacement
+        for (i=0; i < sz; i++) {
+            vector_elt(v,i) = relocate(fl_ctx, vector_elt(v,i));
+            *young |= in_tonursery(fl_ctx, vector_elt(v,i));
+        }
+    }
+    else if (t == TAG_CVALUE) {
+        // a table's storage is only reachable through its relocate
+        // hook; rescanning all entries for nursery pointers would cost
+        // as much as the rescan itself, so mutated tables just stay in
+        // the remembered set
+        fltype_t *ty = cv_class((cvalue_t*)ptr(v));
+        if (ty->vtable != NULL && ty->vtable->relocate != NULL)
+            ty->vtable->relocate(fl_ctx, v, v);
+        *young = 1;
+    }
+    else if (t == TAG_SYM) {
+        gensym_t *gs = (gensym_t*)ptr(v);
+        if (gs->binding != UNBOUND) {
+            gs->binding = relocate(fl_ctx, gs->binding);
+            *young |= in_tonursery(fl_ctx, gs->binding);
+        }
+    }
+}
+
+void fl_remember_old(fl_context_t *fl_ctx, value_t parent, value_t child)
+{
+    if (isyoung(fl_ctx, child))
+        ptrhash_put(&fl_ctx->oldrefs, (void*)parent, (void*)1);
+}
+
+void gc(fl_context_t *fl_ctx, int mustgrow)
+{
+    void *temp;
+#ifdef MEMDEBUG2
+    temp = fl_ctx->tochain;
+    fl_ctx->tochain = NULL;
+    fl_ctx->n_allocd = -100000000000LL;
+#else
+    size_t hsz = fl_ctx->gc_grew ? fl_ctx->heapsize*2 : fl_ctx->heapsize;
+#ifdef MEMDEBUG
+    fl_ctx->tospace = LLT_ALLOC(hsz);
+#endif
+    fl_ctx->curheap = fl_ctx->tospace;
+    fl_ctx->lim = fl_ctx->curheap + hsz - sizeof(cons_t);
+#endif
+
+    gc_trace_roots(fl_ctx);
+    if (fl_ctx->oldspace != NULL) {
+        // remembered set: rescan tenured objects that were mutated,
+        // dropping the ones that no longer reference the nursery
+        htable_t *h = &fl_ctx->oldrefs;
+        size_t hi;
+        for (hi = 0; hi < h->size; hi += 2) {
+            if (h->table[hi+1] == HT_NOTFOUND)
+                continue;
+            int young = 0;
+            rescan_old(fl_ctx, (value_t)h->table[hi], &young);
+            if (!young)
+                h->table[hi+1] = HT_NOTFOUND;
+        }
+    }
 
     sweep_finalizers(fl_ctx);
 
@@ -653,6 +745,49 @@ void gc(fl_context_t *fl_ctx, int mustgrow)
 #endif
 }
 
+// Tenure everything currently live into a pinned region that later
+// collections never copy. Called once after the boot image is loaded
+// (see jl_init_ast_ctx): steady-state parsing then stops recopying the
+// static compiler code and tables on every collection, and pays only a
+// rescan of the remembered set (see fl_write_barrier) instead.
+void fl_gc_promote(fl_context_t *fl_ctx)
+{
+#ifndef MEMDEBUG2
+    unsigned char *old;
+    uint32_t *ocf;
+    size_t live, cap;
+    if (fl_ctx->oldspace != NULL)
+        return;
+    // compact first so the live size (and thus the old space) is exact;
+    // the tenuring pass below copies the same graph, so it cannot need
+    // more than `live` plus a little slack for alignment
+    gc(fl_ctx, 0);
+    live = fl_ctx->curheap - fl_ctx->fromspace;
+    cap = live + 256*sizeof(value_t);
+    old = (unsigned char*)LLT_ALLOC(cap);
+    if (old == NULL)
+        return; // the two-space collector works fine without an old gen
+    ocf = bitvector_new(cap/sizeof(cons_t), 1);
+    if (ocf == NULL) {
+        LLT_FREE(old);
+        return;
+    }
+    // evacuate with the ordinary copying machinery, aimed at the pinned
+    // region instead of tospace; lim is sized so this cannot overflow
+    // into a nested collection
+    fl_ctx->curheap = old;
+    fl_ctx->lim = old + cap - sizeof(cons_t);
+    gc_trace_roots(fl_ctx);
+    sweep_finalizers(fl_ctx);
+    fl_ctx->oldspace = old;
+    fl_ctx->oldspacesize = (uint32_t)(fl_ctx->curheap - old);
+    fl_ctx->oldconsflags = ocf;
+    // both semispaces are now empty
+    fl_ctx->curheap = fl_ctx->fromspace;
+    fl_ctx->lim = fl_ctx->curheap + fl_ctx->heapsize - sizeof(cons_t);
+#endif
+}
+
 static void grow_stack(fl_context_t *fl_ctx)
 {
     size_t newsz = fl_ctx->N_STACK + (fl_ctx->N_STACK>>1);
@@ -1387,9 +1522,13 @@ static value_t apply_cl(fl_context_t *fl_ctx, uint32_t nargs)
             NEXT_OP;
         OP(OP_SETCAR)
             car(fl_ctx, fl_ctx->Stack[fl_ctx->SP-2]) = fl_ctx->Stack[fl_ctx->SP-1];
+            fl_write_barrier(fl_ctx, fl_ctx->Stack[fl_ctx->SP-2],
+                             fl_ctx->Stack[fl_ctx->SP-1]);
             POPN(fl_ctx, 1); NEXT_OP;
         OP(OP_SETCDR)
             cdr(fl_ctx, fl_ctx->Stack[fl_ctx->SP-2]) = fl_ctx->Stack[fl_ctx->SP-1];
+            fl_write_barrier(fl_ctx, fl_ctx->Stack[fl_ctx->SP-2],
+                             fl_ctx->Stack[fl_ctx->SP-1]);
             POPN(fl_ctx, 1); NEXT_OP;
         OP(OP_LIST)
             n = *ip++;
@@ -1625,6 +1764,7 @@ static value_t apply_cl(fl_context_t *fl_ctx, uint32_t nargs)
                 if ((unsigned)i >= vector_size(fl_apply_e))
                     bounds_error(fl_ctx, "aset!", fl_apply_v, fl_ctx->Stack[fl_ctx->SP-1]);
                 vector_elt(fl_apply_e, i) = (fl_apply_v=fl_ctx->Stack[fl_ctx->SP-1]);
+                fl_write_barrier(fl_ctx, fl_apply_e, fl_apply_v);
             }
             else if (isarray(fl_apply_e)) {
                 fl_apply_v = cvalue_array_aset(fl_ctx, &fl_ctx->Stack[fl_ctx->SP-3]);
@@ -1697,8 +1837,11 @@ static value_t apply_cl(fl_context_t *fl_ctx, uint32_t nargs)
             assert(issymbol(fl_apply_v));
             sym = (symbol_t*)ptr(fl_apply_v);
             fl_apply_v = fl_ctx->Stack[fl_ctx->SP-1];
-            if (!isconstant(sym))
+            if (!isconstant(sym)) {
                 sym->binding = fl_apply_v;
+                // only gensym bindings live in the managed heap
+                fl_write_barrier(fl_ctx, tagptr(sym, TAG_SYM), fl_apply_v);
+            }
             NEXT_OP;
 
         OP(OP_LOADA)
@@ -2335,6 +2478,10 @@ static void lisp_init(fl_context_t *fl_ctx, size_t initial_heapsize)
     fl_ctx->curheap = fl_ctx->fromspace;
     fl_ctx->lim = fl_ctx->curheap+fl_ctx->heapsize-sizeof(cons_t);
     fl_ctx->consflags = bitvector_new(fl_ctx->heapsize/sizeof(cons_t), 1);
+    fl_ctx->oldspace = NULL;
+    fl_ctx->oldspacesize = 0;
+    fl_ctx->oldconsflags = NULL;
+    htable_new(&fl_ctx->oldrefs, 32);
     fl_print_init(fl_ctx);
     comparehash_init(fl_ctx);
     fl_ctx->N_STACK = 262144;
@@ -35,6 +35,8 @@ typedef struct _symbol_t {
     struct _fltype_t *type;
     uint32_t hash;
     void *dlcache;     // dlsym address
+    void *embcache;    // opaque per-symbol cache slot for the embedder
+                       // (julia uses it to memoize the jl_sym_t mapping)
     // below fields are private
     struct _symbol_t *left;
     struct _symbol_t *right;
@@ -113,10 +115,22 @@ typedef struct {
 #define symbol_value(s) (((symbol_t*)ptr(s))->binding)
 #ifdef MEMDEBUG2
 #define ismanaged(ctx, v) (!issymbol(v) && !isfixnum(v) && ((v)>(N_OPCODES<<3)) && !iscbuiltin(ctx, v))
+#define isyoung(ctx, v) ismanaged(ctx, v)
+#define isold(ctx, v) 0
 #else
-#define ismanaged(ctx, v) ((((unsigned char*)ptr(v)) >= ctx->fromspace) && \
-                           (((unsigned char*)ptr(v)) < ctx->fromspace + ctx->heapsize))
+#define isyoung(ctx, v) ((((unsigned char*)ptr(v)) >= ctx->fromspace) && \
+                         (((unsigned char*)ptr(v)) < ctx->fromspace + ctx->heapsize))
+// the pinned old space created by fl_gc_promote (empty until then)
+#define isold(ctx, v) ((((unsigned char*)ptr(v)) >= ctx->oldspace) && \
+                       (((unsigned char*)ptr(v)) < ctx->oldspace + ctx->oldspacesize))
+#define ismanaged(ctx, v) (isyoung(ctx, v) || isold(ctx, v))
 #endif
+
+// generational write barrier: a tenured object mutated to reference the
+// nursery must be remembered so collections keep rescanning it
+#define fl_write_barrier(ctx, parent, child) \
+    do { if (__unlikely(isold(ctx, parent))) \
+             fl_remember_old(ctx, parent, child); } while (0)
 #define isgensym(ctx, x)  (issymbol(x) && ismanaged(ctx, x))
 
 #define isfunction(x) (tag(x) == TAG_FUNCTION && (x) > (N_BUILTINS<<3))
@@ -355,6 +369,8 @@ value_t cvalue_byte(fl_context_t *fl_ctx, value_t *args, uint32_t nargs);
 value_t cvalue_wchar(fl_context_t *fl_ctx, value_t *args, uint32_t nargs);
 
 void fl_init(fl_context_t *fl_ctx, size_t initial_heapsize);
+void fl_gc_promote(fl_context_t *fl_ctx);
+void fl_remember_old(fl_context_t *fl_ctx, value_t parent, value_t child);
 int fl_load_system_image(fl_context_t *fl_ctx, value_t ios);
 int fl_load_system_image_str(fl_context_t *fl_ctx, char* str, size_t len);
 
@@ -450,6 +466,13 @@ struct _fl_context_t {
     uint32_t heapsize;//bytes
     uint32_t *consflags;
 
+    // pinned tenured region (fl_gc_promote): objects here are never
+    // copied; mutated ones are rescanned as roots via oldrefs
+    unsigned char *oldspace;
+    uint32_t oldspacesize;//bytes
+    uint32_t *oldconsflags;
+    htable_t oldrefs;
+
     // error utilities --------------------------------------------------
 
     // saved execution state for an unwind target
@@ -802,6 +802,9 @@ void fl_print(fl_context_t *fl_ctx, ios_t *f, value_t v)
 
     if (fl_ctx->print_level >= 0 || fl_ctx->print_length >= 0) {
         memset(fl_ctx->consflags, 0, 4*bitvector_nwords(fl_ctx->heapsize/sizeof(cons_t)));
+        if (fl_ctx->oldconsflags != NULL)
+            memset(fl_ctx->oldconsflags, 0,
+                   4*bitvector_nwords(fl_ctx->oldspacesize/sizeof(cons_t)));
     }
 
     if ((iscons(v) || isvector(v) || isfunction(v) || iscvalue(v)) &&
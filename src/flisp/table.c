@@ -115,6 +115,8 @@ value_t fl_table_put(fl_context_t *fl_ctx, value_t *args, uint32_t nargs)
     htable_t *h = totable(fl_ctx, args[0], "put!");
     void **table0 = h->table;
     equalhash_put_r(h, (void*)args[1], (void*)args[2], (void*)fl_ctx);
+    fl_write_barrier(fl_ctx, args[0], args[1]);
+    fl_write_barrier(fl_ctx, args[0], args[2]);
     // register finalizer if we outgrew inline space
     if (table0 == &h->_space[0] && h->table != &h->_space[0]) {
         cvalue_t *cv = (cvalue_t*)ptr(args[0]);
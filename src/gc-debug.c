@@ -139,6 +139,8 @@ static void clear_mark(int bits)
                 for (int j = 0; j < 32; j++) {
                     if ((line >> j) & 1) {
                         jl_gc_pagemeta_t *pg = page_metadata(region->pages[pg_i*32 + j].data + GC_PAGE_OFFSET);
+                        if (pg->nonpool)
+                            continue;
                         jl_tls_states_t *ptls2 = jl_all_tls_states[pg->thread_n];
                         jl_gc_pool_t *pool = &ptls2->heap.norm_pools[pg->pool_n];
                         pv = (jl_taggedvalue_t*)(pg->data + GC_PAGE_OFFSET);
@@ -393,10 +395,173 @@ void gc_debug_print_status(void)
 }
 #endif
 
+// ---- runtime-togglable per-type census (jl_gc_census_*) ----------------
+//
+// The production sibling of the OBJPROFILE build below. While enabled,
+// the mark phase counts every newly marked object -- old generations are
+// skipped, so a long-lived object is counted once, in the cycle after it
+// was allocated; short-lived garbage that dies before its first mark is
+// never seen, which is the price of keeping the hook off the allocation
+// fast path. Counts go to per-mark-thread tables (registered on first
+// use) and fold into a master table at the end of each collection, while
+// the world is stopped and every counted type is still alive; the master
+// snapshots the type's name at that point, so jl_gc_census_snapshot
+// never dereferences a type object that may since have been collected.
+int gc_census_enabled = 0;
+
+typedef struct {
+    uint64_t count;
+    uint64_t bytes;
+    char name[48];
+} gc_census_entry_t;
+
+static jl_mutex_t census_lock;
+static htable_t census_master;
+static arraylist_t census_tables;
+static int census_init = 0;
+#if defined(_COMPILER_MICROSOFT_)
+static __declspec(thread) htable_t *census_table = NULL;
+#else
+static __thread htable_t *census_table = NULL;
+#endif
+
+void gc_census_count(void *ty, int old, int sz)
+{
+    if (old)
+        return;
+    htable_t *h = census_table;
+    if (__unlikely(h == NULL)) {
+        h = (htable_t*)malloc(sizeof(htable_t));
+        htable_new(h, 512);
+        JL_LOCK_NOGC(&census_lock);
+        arraylist_push(&census_tables, h);
+        JL_UNLOCK_NOGC(&census_lock);
+        census_table = h;
+    }
+    if ((uintptr_t)ty <= 0x10)
+        ty = (void*)jl_buff_tag;
+    void **bp = ptrhash_bp(h, ty);
+    gc_census_entry_t *e = (gc_census_entry_t*)*bp;
+    if (e == HT_NOTFOUND) {
+        e = (gc_census_entry_t*)calloc(1, sizeof(gc_census_entry_t));
+        *bp = e;
+    }
+    e->count++;
+    e->bytes += (uint64_t)sz;
+}
+
+// name to report for a census key; only safe while the type is alive
+// (i.e. during the fold, in the same collection that recorded it)
+static const char *census_name(void *ty)
+{
+    if (ty == (void*)jl_buff_tag)
+        return "<buffer>";
+    if (ty == jl_malloc_tag)
+        return "<malloc>";
+    if (jl_is_datatype(ty))
+        return jl_symbol_name(((jl_datatype_t*)ty)->name->name);
+    return "<other>";
+}
+
+// called at the end of a collection (world stopped). Merges and clears
+// the per-thread tables. The master stays keyed by the type pointer; the
+// name recorded at first sight is what snapshots report, so a later
+// reuse of the address by a different type merges under the old name --
+// harmless at census granularity.
+void gc_census_fold(void)
+{
+    if (!gc_census_enabled)
+        return;
+    JL_LOCK_NOGC(&census_lock);
+    for (size_t t = 0; t < census_tables.len; t++) {
+        htable_t *h = (htable_t*)census_tables.items[t];
+        for (size_t i = 0; i < h->size; i += 2) {
+            if (h->table[i + 1] == HT_NOTFOUND)
+                continue;
+            void *ty = h->table[i];
+            gc_census_entry_t *pe = (gc_census_entry_t*)h->table[i + 1];
+            void **bp = ptrhash_bp(&census_master, ty);
+            gc_census_entry_t *e = (gc_census_entry_t*)*bp;
+            if (e == HT_NOTFOUND) {
+                e = (gc_census_entry_t*)calloc(1, sizeof(gc_census_entry_t));
+                strncpy(e->name, census_name(ty), sizeof(e->name) - 1);
+                *bp = e;
+            }
+            e->count += pe->count;
+            e->bytes += pe->bytes;
+            free(pe);
+        }
+        htable_reset(h, 512);
+    }
+    JL_UNLOCK_NOGC(&census_lock);
+}
+
+static void census_clear_master(void)
+{
+    for (size_t i = 0; i < census_master.size; i += 2) {
+        if (census_master.table[i + 1] != HT_NOTFOUND)
+            free(census_master.table[i + 1]);
+    }
+    htable_reset(&census_master, 256);
+}
+
+JL_DLLEXPORT void jl_gc_census_start(void)
+{
+    JL_LOCK_NOGC(&census_lock);
+    if (!census_init) {
+        htable_new(&census_master, 256);
+        arraylist_new(&census_tables, 0);
+        census_init = 1;
+    }
+    else {
+        census_clear_master();
+    }
+    JL_UNLOCK_NOGC(&census_lock);
+    gc_census_enabled = 1;
+}
+
+JL_DLLEXPORT void jl_gc_census_stop(void)
+{
+    // counting stops; accumulated data stays for a final snapshot
+    gc_census_enabled = 0;
+}
+
+// returns a Vector{Any} of (name, count, bytes) flattened as consecutive
+// String, Int64, Int64 entries. The master is copied out under the lock
+// before any allocation so a collection triggered while building the
+// result (whose fold mutates the master) cannot invalidate the walk.
+JL_DLLEXPORT jl_value_t *jl_gc_census_snapshot(void)
+{
+    size_t n = 0, cap = 0, i;
+    gc_census_entry_t *rows = NULL;
+    if (!census_init)
+        return (jl_value_t*)jl_alloc_vec_any(0);
+    JL_LOCK_NOGC(&census_lock);
+    cap = census_master.size / 2;
+    rows = (gc_census_entry_t*)malloc(sizeof(gc_census_entry_t) * (cap ? cap : 1));
+    for (i = 0; i < census_master.size; i += 2) {
+        if (census_master.table[i + 1] == HT_NOTFOUND)
+            continue;
+        rows[n++] = *(gc_census_entry_t*)census_master.table[i + 1];
+    }
+    JL_UNLOCK_NOGC(&census_lock);
+    jl_array_t *out = jl_alloc_vec_any(0);
+    JL_GC_PUSH1(&out);
+    for (i = 0; i < n; i++) {
+        jl_array_ptr_1d_push(out, jl_pchar_to_string(rows[i].name,
+                                                     strlen(rows[i].name)));
+        jl_array_ptr_1d_push(out, jl_box_int64((int64_t)rows[i].count));
+        jl_array_ptr_1d_push(out, jl_box_int64((int64_t)rows[i].bytes));
+    }
+    JL_GC_POP();
+    free(rows);
+    return (jl_value_t*)out;
+}
+
 #ifdef OBJPROFILE
 static htable_t obj_counts[3];
 static htable_t obj_sizes[3];
-void objprofile_count(void *ty, int old, int sz)
+void objprofile_count_impl(void *ty, int old, int sz)
 {
     if (gc_verifying) return;
     if ((intptr_t)ty <= 0x10) {
@@ -837,6 +1002,10 @@ static void gc_count_pool_page(jl_gc_pagemeta_t *pg)
 {
     int osize = pg->osize;
     char *data = pg->data;
+    // the page is sitting in a thread local page cache and was never
+    // handed to a pool, or backs an arena
+    if (osize == 0 || pg->nonpool)
+        return;
     jl_taggedvalue_t *v = (jl_taggedvalue_t*)(data + GC_PAGE_OFFSET);
     char *lim = (char*)v + GC_PAGE_SZ - GC_PAGE_OFFSET - osize;
     int has_live = 0;
@@ -884,6 +1053,145 @@ void gc_count_pool(void)
     jl_safe_printf("************************\n");
 }
 
+// heap dump for offline leak analysis
+//
+// jl_gc_dump_heap streams the object graph reachable from the global
+// roots (the module tree and everything hanging off it) as compact
+// binary records: address, type pointer, payload size, then the outgoing
+// references. Traversal keeps its own visited set and explicit stack, so
+// no GC mark state is disturbed; allocation is disabled for the
+// duration, and the caller is responsible for quiescing other threads
+// (capture at a safepoint). Stack- and task-local roots are not walked:
+// for leak hunting the persistent graph is the interesting part, and
+// walking foreign stacks safely needs the collector's machinery.
+//
+// format: "JLHD0001", u8 sizeof(void*), then per object:
+//   uptr address, uptr type, uptr size, u32 nref, nref * uptr refs
+// (all in host byte order; the reader is expected to match the producer)
+
+#include "htable2.h"
+
+static htable2_t heapdump_seen;
+static arraylist_t heapdump_stack;
+static arraylist_t heapdump_refs; // scratch for one object's refs
+
+static void heapdump_queue(jl_value_t *v)
+{
+    if (v == NULL)
+        return;
+    void **bp = htable2_bp(&heapdump_seen, v);
+    if (*bp != HT_NOTFOUND)
+        return;
+    *bp = (void*)1;
+    arraylist_push(&heapdump_stack, v);
+}
+
+static void heapdump_ref(jl_value_t *v)
+{
+    if (v == NULL)
+        return;
+    arraylist_push(&heapdump_refs, v);
+    heapdump_queue(v);
+}
+
+static void heapdump_write_obj(ios_t *out, jl_value_t *v)
+{
+    jl_value_t *vt = jl_typeof(v);
+    uintptr_t sz = 0;
+    heapdump_refs.len = 0;
+    if (vt == (jl_value_t*)jl_simplevector_type) {
+        size_t l = jl_svec_len(v);
+        sz = l * sizeof(void*) + sizeof(jl_svec_t);
+        for (size_t i = 0; i < l; i++)
+            heapdump_ref(jl_svecref(v, i));
+    }
+    else if (jl_is_datatype(vt) &&
+             ((jl_datatype_t*)vt)->name == jl_array_typename) {
+        jl_array_t *a = (jl_array_t*)v;
+        sz = sizeof(jl_array_t) + jl_array_len(a) * a->elsize;
+        if (a->flags.how == 3) {
+            heapdump_ref(jl_array_data_owner(a));
+        }
+        else if (a->flags.ptrarray && a->data != NULL) {
+            size_t l = jl_array_len(a);
+            for (size_t i = 0; i < l; i++)
+                heapdump_ref(jl_array_ptr_ref(a, i));
+        }
+    }
+    else if (vt == (jl_value_t*)jl_module_type) {
+        jl_module_t *m = (jl_module_t*)v;
+        sz = sizeof(jl_module_t);
+        void **table = m->bindings.table;
+        for (size_t i = 1; i < m->bindings.size; i += 2) {
+            if (table[i] != HT_NOTFOUND) {
+                jl_binding_t *b = (jl_binding_t*)table[i];
+                if (b->value)
+                    heapdump_ref(b->value);
+                if (b->globalref)
+                    heapdump_ref(b->globalref);
+            }
+        }
+        for (size_t i = 0; i < m->usings.len; i++)
+            heapdump_ref((jl_value_t*)m->usings.items[i]);
+        if (m->parent)
+            heapdump_ref((jl_value_t*)m->parent);
+    }
+    else if (vt == (jl_value_t*)jl_sym_type) {
+        sz = strlen(jl_symbol_name((jl_sym_t*)v));
+    }
+    else if (vt == (jl_value_t*)jl_task_type) {
+        jl_task_t *ta = (jl_task_t*)v;
+        sz = sizeof(jl_task_t);
+        heapdump_ref((jl_value_t*)ta->parent);
+        heapdump_ref(ta->tls);
+        heapdump_ref(ta->consumers);
+        heapdump_ref(ta->donenotify);
+        heapdump_ref(ta->result);
+        heapdump_ref(ta->exception);
+        heapdump_ref(ta->backtrace);
+        heapdump_ref((jl_value_t*)ta->start);
+    }
+    else if (jl_is_datatype(vt)) {
+        jl_datatype_t *dt = (jl_datatype_t*)vt;
+        sz = jl_datatype_size(dt);
+        if (!dt->pointerfree) {
+            int nf = (int)jl_datatype_nfields(dt);
+            for (int i = 0; i < nf; i++) {
+                if (jl_field_isptr(dt, i))
+                    heapdump_ref(*(jl_value_t**)((char*)v +
+                                                 jl_field_offset(dt, i)));
+            }
+        }
+    }
+    uintptr_t rec[3] = {(uintptr_t)v, (uintptr_t)vt, sz};
+    ios_write(out, (char*)rec, sizeof(rec));
+    uint32_t nref = (uint32_t)heapdump_refs.len;
+    ios_write(out, (char*)&nref, sizeof(nref));
+    ios_write(out, (char*)heapdump_refs.items, nref * sizeof(void*));
+}
+
+JL_DLLEXPORT void jl_gc_dump_heap(ios_t *out)
+{
+    int en = jl_gc_enable(0);
+    htable2_new(&heapdump_seen, 1 << 16);
+    arraylist_new(&heapdump_stack, 0);
+    arraylist_new(&heapdump_refs, 0);
+    ios_write(out, "JLHD0001", 8);
+    uint8_t psz = sizeof(void*);
+    ios_write(out, (char*)&psz, 1);
+    heapdump_queue((jl_value_t*)jl_main_module);
+    heapdump_queue((jl_value_t*)jl_top_module);
+    while (heapdump_stack.len > 0) {
+        jl_value_t *v = (jl_value_t*)arraylist_pop(&heapdump_stack);
+        heapdump_write_obj(out, v);
+    }
+    ios_flush(out);
+    arraylist_free(&heapdump_refs);
+    arraylist_free(&heapdump_stack);
+    htable2_free(&heapdump_seen);
+    jl_gc_enable(en);
+}
+
 #ifdef __cplusplus
 }
 #endif
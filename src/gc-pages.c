@@ -20,10 +20,65 @@ extern "C" {
 
 static int region_pg_cnt = DEFAULT_REGION_PG_COUNT;
 static jl_mutex_t pagealloc_lock;
-static size_t current_pg_count = 0;
+size_t current_pg_count = 0;
+
+// Hugepage backing for the regions (JULIA_GC_HUGEPAGES, linux only):
+// mode 1 advises transparent hugepages on the region mappings, mode 2
+// maps the regions with MAP_HUGETLB (falling back to mode 1 when the
+// system has no hugepages reserved). Explicit hugetlb memory is faulted
+// on demand out of the hugepage pool, so exhausting the pool can SIGBUS
+// a touch like any other hugetlb user -- hence opt-in.
+static int gc_hugepages = 0;
+#define GC_HUGEPAGE_SZ (2 * 1024 * 1024)
+
+// Freed-page laundry. Instead of madvising every freed page away inside
+// the sweep (and eating the refault the next time the pool grows), freed
+// pages sit mapped on a quarantine list and are reused from there first.
+// Only when the quarantine exceeds its high-water mark are pages
+// decommitted -- lazily with MADV_FREE, from a background thread when
+// JULIA_GC_PAGE_LAUNDRY=1 (threading builds) -- and moved to a second,
+// laundered list that the allocator reuses after the quarantine. Pages on
+// either list keep their allocmap bit set and carry the `nonpool` mark so
+// the sweep ignores them; the region bitmaps are therefore never touched
+// off-pause and the background thread cannot race the collector. Both
+// lists are threaded through the first word of the (mapped) page itself
+// and protected by `pagealloc_lock`.
+typedef struct _jl_gc_laundry_page_t {
+    struct _jl_gc_laundry_page_t *next;
+} jl_gc_laundry_page_t;
+#define GC_LAUNDRY_HIGH 256 // pages; 4MB of resident quarantine
+#define GC_LAUNDRY_LOW   64 // drain target
+static jl_gc_laundry_page_t *gc_quarantined = NULL;
+static size_t gc_n_quarantined = 0;
+static jl_gc_laundry_page_t *gc_laundered = NULL;
+
+#ifdef JULIA_ENABLE_THREADING
+// background laundry thread state; the thread itself and the drain it
+// runs are defined below, with the rest of the freed-page laundry
+static int gc_laundry_thread_on = 0;
+static uv_mutex_t gc_laundry_lock;
+static uv_cond_t gc_laundry_wakeup;
+static int gc_laundry_kicked = 0;
+static void gc_laundry_threadfun(void *arg);
+#endif
 
 void jl_gc_init_page(void)
 {
+#if defined(_OS_LINUX_)
+    char *cp = getenv(GC_HUGEPAGES_NAME);
+    if (cp)
+        gc_hugepages = (int)strtol(cp, NULL, 10);
+#endif
+#ifdef JULIA_ENABLE_THREADING
+    char *lcp = getenv(GC_PAGE_LAUNDRY_NAME);
+    if (lcp && strtol(lcp, NULL, 10)) {
+        uv_mutex_init(&gc_laundry_lock);
+        uv_cond_init(&gc_laundry_wakeup);
+        uv_thread_t tid;
+        if (uv_thread_create(&tid, gc_laundry_threadfun, NULL) == 0)
+            gc_laundry_thread_on = 1;
+    }
+#endif
 #ifndef _OS_WINDOWS_
     struct rlimit rl;
     if (getrlimit(RLIMIT_AS, &rl) == 0) {
@@ -39,24 +94,45 @@ void jl_gc_init_page(void)
 
 // Try to allocate a memory block for a region with `pg_cnt` pages.
 // Return `NULL` if allocation failed. Result is aligned to `GC_PAGE_SZ`.
-static char *jl_gc_try_alloc_region(int pg_cnt)
+// `*hugetlb` is set when the block is an explicit hugetlb mapping.
+static char *jl_gc_try_alloc_region(int pg_cnt, int *hugetlb)
 {
     const size_t pages_sz = sizeof(jl_gc_page_t) * pg_cnt;
     const size_t freemap_sz = sizeof(uint32_t) * pg_cnt / 32;
     const size_t meta_sz = sizeof(jl_gc_pagemeta_t) * pg_cnt;
     size_t alloc_size = pages_sz + freemap_sz + meta_sz;
+    *hugetlb = 0;
 #ifdef _OS_WINDOWS_
     char *mem = (char*)VirtualAlloc(NULL, alloc_size + GC_PAGE_SZ,
                                     MEM_RESERVE, PAGE_READWRITE);
     if (mem == NULL)
         return NULL;
 #else
+#if defined(_OS_LINUX_) && defined(MAP_HUGETLB)
+    if (gc_hugepages == 2) {
+        // hugetlb mappings are hugepage aligned, which covers the
+        // GC_PAGE_SZ alignment requirement
+        char *hmem = (char*)mmap(0, LLT_ALIGN(alloc_size, GC_HUGEPAGE_SZ),
+                                 PROT_READ | PROT_WRITE,
+                                 MAP_NORESERVE | MAP_PRIVATE | MAP_ANONYMOUS |
+                                 MAP_HUGETLB, -1, 0);
+        if (hmem != MAP_FAILED) {
+            *hugetlb = 1;
+            return hmem;
+        }
+        // no hugepages reserved; fall through to the transparent advice
+    }
+#endif
     if (GC_PAGE_SZ > jl_page_size)
         alloc_size += GC_PAGE_SZ;
     char *mem = (char*)mmap(0, alloc_size, PROT_READ | PROT_WRITE,
                             MAP_NORESERVE | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     if (mem == MAP_FAILED)
         return NULL;
+#if defined(_OS_LINUX_) && defined(MADV_HUGEPAGE)
+    if (gc_hugepages)
+        madvise(mem, alloc_size, MADV_HUGEPAGE);
+#endif
 #endif
     if (GC_PAGE_SZ > jl_page_size) {
         // round data pointer up to the nearest gc_page_data-aligned
@@ -79,8 +155,9 @@ static void jl_gc_alloc_region(region_t *region)
     const size_t pages_sz = sizeof(jl_gc_page_t) * pg_cnt;
     const size_t allocmap_sz = sizeof(uint32_t) * pg_cnt / 32;
     char *mem = NULL;
+    int hugetlb = 0;
     while (1) {
-        if (__likely((mem = jl_gc_try_alloc_region(pg_cnt))))
+        if (__likely((mem = jl_gc_try_alloc_region(pg_cnt, &hugetlb))))
             break;
         if (pg_cnt >= MIN_REGION_PG_COUNT * 4) {
             pg_cnt /= 4;
@@ -100,6 +177,7 @@ static void jl_gc_alloc_region(region_t *region)
     region->lb = 0;
     region->ub = 0;
     region->pg_cnt = pg_cnt;
+    region->hugetlb = hugetlb;
 #ifdef _OS_WINDOWS_
     VirtualAlloc(region->allocmap, pg_cnt / 8, MEM_COMMIT, PAGE_READWRITE);
     VirtualAlloc(region->meta, pg_cnt * sizeof(jl_gc_pagemeta_t),
@@ -107,16 +185,17 @@ static void jl_gc_alloc_region(region_t *region)
 #endif
 }
 
-NOINLINE void *jl_gc_alloc_page(void)
+// Take one page out of an already-allocated region. Returns `NULL` when
+// they are all full. Assumes `pagealloc_lock` is acquired.
+static void *jl_gc_try_alloc_page(void)
 {
     int i;
     region_t *region;
     int region_i = 0;
-    JL_LOCK_NOGC(&pagealloc_lock);
     while (region_i < REGION_COUNT) {
         region = &regions[region_i];
         if (region->pages == NULL)
-            jl_gc_alloc_region(region);
+            return NULL;
         for (i = region->lb; i < region->pg_cnt / 32; i++) {
             if (~region->allocmap[i])
                 break;
@@ -126,38 +205,165 @@ NOINLINE void *jl_gc_alloc_page(void)
             region_i++;
             continue;
         }
-        break;
-    }
-    if (__unlikely(region_i >= REGION_COUNT)) {
-        JL_UNLOCK_NOGC(&pagealloc_lock);
-        jl_throw(jl_memory_exception);
-    }
-    if (region->lb < i)
-        region->lb = i;
-    if (region->ub < i)
-        region->ub = i;
+        if (region->lb < i)
+            region->lb = i;
+        if (region->ub < i)
+            region->ub = i;
 
 #if defined(_COMPILER_MINGW_)
-    int j = __builtin_ffs(~region->allocmap[i]) - 1;
+        int j = __builtin_ffs(~region->allocmap[i]) - 1;
 #elif defined(_COMPILER_MICROSOFT_)
-    unsigned long j;
-    _BitScanForward(&j, ~region->allocmap[i]);
+        unsigned long j;
+        _BitScanForward(&j, ~region->allocmap[i]);
 #else
-    int j = ffs(~region->allocmap[i]) - 1;
+        int j = ffs(~region->allocmap[i]) - 1;
 #endif
 
-    region->allocmap[i] |= (uint32_t)(1 << j);
-    void *ptr = region->pages[i * 32 + j].data;
+        region->allocmap[i] |= (uint32_t)(1 << j);
+        void *ptr = region->pages[i * 32 + j].data;
 #ifdef _OS_WINDOWS_
-    VirtualAlloc(ptr, GC_PAGE_SZ, MEM_COMMIT, PAGE_READWRITE);
+        VirtualAlloc(ptr, GC_PAGE_SZ, MEM_COMMIT, PAGE_READWRITE);
+#endif
+        current_pg_count++;
+        gc_final_count_page(current_pg_count);
+        return ptr;
+    }
+    return NULL;
+}
+
+// move quarantined pages past the drain target to the laundered list,
+// decommitting them on the way. MADV_FREE only marks the pages
+// reclaimable, so this stays cheap even when called synchronously.
+static void gc_laundry_drain_to(size_t target)
+{
+#ifndef _OS_WINDOWS_
+    for (;;) {
+        JL_LOCK_NOGC(&pagealloc_lock);
+        if (gc_n_quarantined <= target) {
+            JL_UNLOCK_NOGC(&pagealloc_lock);
+            return;
+        }
+        jl_gc_laundry_page_t *lp = gc_quarantined;
+        gc_quarantined = lp->next;
+        gc_n_quarantined--;
+        JL_UNLOCK_NOGC(&pagealloc_lock);
+#ifdef MADV_FREE
+        madvise(lp, GC_PAGE_SZ, MADV_FREE);
+#else
+        madvise(lp, GC_PAGE_SZ, MADV_DONTNEED);
 #endif
+        JL_LOCK_NOGC(&pagealloc_lock);
+        lp->next = gc_laundered;
+        gc_laundered = lp;
+        JL_UNLOCK_NOGC(&pagealloc_lock);
+    }
+#endif
+}
+
+static void gc_laundry_drain(void)
+{
+    gc_laundry_drain_to(GC_LAUNDRY_LOW);
+}
+
+// under soft-heap-limit pressure (see gc_pace_to_limit in gc.c) every
+// quarantined page is decommitted so the OS gets the memory back
+void jl_gc_laundry_drain_all(void)
+{
+    gc_laundry_drain_to(0);
+}
+
+#ifdef JULIA_ENABLE_THREADING
+static void gc_laundry_threadfun(void *arg)
+{
+    (void)arg;
+    uv_mutex_lock(&gc_laundry_lock);
+    for (;;) {
+        while (!gc_laundry_kicked)
+            uv_cond_wait(&gc_laundry_wakeup, &gc_laundry_lock);
+        gc_laundry_kicked = 0;
+        uv_mutex_unlock(&gc_laundry_lock);
+        gc_laundry_drain();
+        uv_mutex_lock(&gc_laundry_lock);
+    }
+}
+#endif
+
+static void gc_laundry_kick(void)
+{
+#ifdef JULIA_ENABLE_THREADING
+    if (gc_laundry_thread_on) {
+        uv_mutex_lock(&gc_laundry_lock);
+        gc_laundry_kicked = 1;
+        uv_cond_signal(&gc_laundry_wakeup);
+        uv_mutex_unlock(&gc_laundry_lock);
+        return;
+    }
+#endif
+    gc_laundry_drain();
+}
+
+// take a page off the quarantine (preferred: still resident) or the
+// laundered list. Assumes `pagealloc_lock` is acquired.
+static void *gc_laundry_pop(void)
+{
+    jl_gc_laundry_page_t *lp = gc_quarantined;
+    if (lp != NULL) {
+        gc_quarantined = lp->next;
+        gc_n_quarantined--;
+    }
+    else if ((lp = gc_laundered) != NULL) {
+        gc_laundered = lp->next;
+    }
+    else {
+        return NULL;
+    }
+    page_metadata((char*)lp + GC_PAGE_OFFSET)->nonpool = 0;
     current_pg_count++;
     gc_final_count_page(current_pg_count);
+    return lp;
+}
+
+NOINLINE void *jl_gc_alloc_page(void)
+{
+    jl_thread_heap_t *heap = &jl_thread_heap;
+    if (heap->n_cached_pages > 0)
+        return heap->page_cache[--heap->n_cached_pages];
+    JL_LOCK_NOGC(&pagealloc_lock);
+    void *ptr = gc_laundry_pop();
+    if (ptr != NULL) {
+        JL_UNLOCK_NOGC(&pagealloc_lock);
+        return ptr;
+    }
+    ptr = jl_gc_try_alloc_page();
+    while (__unlikely(ptr == NULL)) {
+        // all the regions are full; allocate a new one
+        int region_i;
+        for (region_i = 0; region_i < REGION_COUNT; region_i++) {
+            if (regions[region_i].pages == NULL)
+                break;
+        }
+        if (__unlikely(region_i >= REGION_COUNT)) {
+            JL_UNLOCK_NOGC(&pagealloc_lock);
+            jl_throw(jl_memory_exception);
+        }
+        jl_gc_alloc_region(&regions[region_i]);
+        ptr = jl_gc_try_alloc_page();
+    }
+    // refill the thread local page cache while we are holding the lock so
+    // that the lock is only touched once every JL_GC_PAGE_CACHE_SZ page
+    // allocations in the steady state. Only take pages the regions already
+    // have room for: growing a region just for the cache isn't worth it.
+    while (heap->n_cached_pages < JL_GC_PAGE_CACHE_SZ) {
+        void *p = jl_gc_try_alloc_page();
+        if (p == NULL)
+            break;
+        heap->page_cache[heap->n_cached_pages++] = p;
+    }
     JL_UNLOCK_NOGC(&pagealloc_lock);
     return ptr;
 }
 
-void jl_gc_free_page(void *p)
+static void jl_gc_free_page_(void *p, int free_ages)
 {
     int pg_idx = -1;
     int i;
@@ -172,8 +378,30 @@ void jl_gc_free_page(void *p)
     assert(i < REGION_COUNT && region->pages != NULL);
     uint32_t msk = (uint32_t)(1 << (pg_idx % 32));
     assert(region->allocmap[pg_idx/32] & msk);
+    if (free_ages)
+        free(region->meta[pg_idx].ages);
+#ifndef _OS_WINDOWS_
+    // common case: into the quarantine, keeping the page mapped for
+    // reuse; the allocmap bit stays set and `nonpool` hides the page
+    // from the sweep until it is handed out again
+    if (!region->hugetlb && GC_PAGE_SZ >= jl_page_size) {
+        jl_gc_laundry_page_t *lp = (jl_gc_laundry_page_t*)p;
+        region->meta[pg_idx].nonpool = 1;
+        JL_LOCK_NOGC(&pagealloc_lock);
+        lp->next = gc_quarantined;
+        gc_quarantined = lp;
+        gc_n_quarantined++;
+        JL_UNLOCK_NOGC(&pagealloc_lock);
+        current_pg_count--;
+        if (gc_n_quarantined > GC_LAUNDRY_HIGH)
+            gc_laundry_kick();
+        return;
+    }
+#endif
     region->allocmap[pg_idx/32] ^= msk;
-    free(region->meta[pg_idx].ages);
+    // hugetlb memory cannot be given back at GC page granularity
+    if (region->hugetlb)
+        goto no_decommit;
     // tell the OS we don't need these pages right now
     size_t decommit_size = GC_PAGE_SZ;
     if (GC_PAGE_SZ < jl_page_size) {
@@ -202,6 +430,146 @@ no_decommit:
     current_pg_count--;
 }
 
+void jl_gc_free_page(void *p)
+{
+    jl_gc_free_page_(p, 1);
+}
+
+// Pages backing memory that is invisible to the collector (e.g. arenas).
+// The `nonpool` metadata bit makes the sweep and the GC debugging code
+// ignore them; since they were never handed to a pool, freeing must not
+// touch the stale `ages` buffer.
+void *jl_gc_alloc_nonpool_page(void)
+{
+    char *data = (char*)jl_gc_alloc_page();
+    jl_gc_pagemeta_t *pg = page_metadata(data + GC_PAGE_OFFSET);
+    pg->nonpool = 1;
+    return data;
+}
+
+void jl_gc_free_nonpool_page(void *p)
+{
+    jl_gc_pagemeta_t *pg = page_metadata((char*)p + GC_PAGE_OFFSET);
+    pg->nonpool = 0;
+    jl_gc_free_page_(p, 0);
+}
+
+// arena allocator
+//
+// A simple bump allocator for short-lived native scratch memory (ccall
+// staging buffers, per-request state in embedders), built on the GC page
+// pool. The arena's memory is invisible to the collector: it is neither
+// accounted to `gc_num` nor scanned, and `jl_arena_reset` reclaims
+// everything in O(1) by rewinding the cursor to the first page. Page sized
+// chunks are kept across resets; allocations larger than a page fall back
+// to malloc and are freed on reset. An arena may only be used by one
+// thread at a time and only from GC unsafe (normal) context, like the rest
+// of the allocation API.
+
+typedef struct _jl_arena_chunk_t {
+    struct _jl_arena_chunk_t *next;
+} jl_arena_chunk_t;
+
+struct _jl_arena_t {
+    jl_arena_chunk_t *pages;      // page sized chunks, kept across resets
+    jl_arena_chunk_t *big_blocks; // oversized chunks, freed on reset
+    jl_arena_chunk_t *cur;        // page the cursor points into
+    char *cursor;
+    char *cur_end;
+};
+
+#define ARENA_CHUNK_HDR LLT_ALIGN(sizeof(jl_arena_chunk_t), JL_SMALL_BYTE_ALIGNMENT)
+#define ARENA_CHUNK_SZ (GC_PAGE_SZ - ARENA_CHUNK_HDR)
+
+static void jl_arena_set_page(jl_arena_t *a, jl_arena_chunk_t *c)
+{
+    a->cur = c;
+    a->cursor = (char*)c + ARENA_CHUNK_HDR;
+    a->cur_end = (char*)c + GC_PAGE_SZ;
+}
+
+JL_DLLEXPORT jl_arena_t *jl_arena_create(void)
+{
+    jl_arena_t *a = (jl_arena_t*)malloc(sizeof(jl_arena_t));
+    if (a == NULL)
+        jl_throw(jl_memory_exception);
+    a->pages = NULL;
+    a->big_blocks = NULL;
+    a->cur = NULL;
+    a->cursor = NULL;
+    a->cur_end = NULL;
+    return a;
+}
+
+JL_DLLEXPORT void *jl_arena_alloc(jl_arena_t *a, size_t sz)
+{
+    size_t allocsz = LLT_ALIGN(sz, JL_SMALL_BYTE_ALIGNMENT);
+    if (allocsz < sz) // overflow
+        jl_throw(jl_memory_exception);
+    if (__unlikely(allocsz > ARENA_CHUNK_SZ)) {
+        jl_arena_chunk_t *c =
+            (jl_arena_chunk_t*)malloc(ARENA_CHUNK_HDR + allocsz);
+        if (c == NULL)
+            jl_throw(jl_memory_exception);
+        c->next = a->big_blocks;
+        a->big_blocks = c;
+        return (char*)c + ARENA_CHUNK_HDR;
+    }
+    if (__unlikely(a->cur == NULL || a->cursor + allocsz > a->cur_end)) {
+        // move to the next page, reusing one kept from before the last
+        // reset when there is one
+        jl_arena_chunk_t *c = a->cur ? a->cur->next : a->pages;
+        if (c == NULL) {
+            c = (jl_arena_chunk_t*)jl_gc_alloc_nonpool_page();
+            c->next = NULL;
+            if (a->cur)
+                a->cur->next = c;
+            else
+                a->pages = c;
+        }
+        jl_arena_set_page(a, c);
+    }
+    void *p = a->cursor;
+    a->cursor += allocsz;
+    return p;
+}
+
+JL_DLLEXPORT void jl_arena_reset(jl_arena_t *a)
+{
+    while (a->big_blocks) {
+        jl_arena_chunk_t *nxt = a->big_blocks->next;
+        free(a->big_blocks);
+        a->big_blocks = nxt;
+    }
+    if (a->pages)
+        jl_arena_set_page(a, a->pages);
+}
+
+JL_DLLEXPORT void jl_arena_destroy(jl_arena_t *a)
+{
+    jl_arena_reset(a);
+    while (a->pages) {
+        jl_arena_chunk_t *nxt = a->pages->next;
+        jl_gc_free_nonpool_page(a->pages);
+        a->pages = nxt;
+    }
+    free(a);
+}
+
+// Return the pages cached by the threads to the global page allocator.
+// Cached pages were never handed to a pool so their metadata (including the
+// `ages` buffer) is stale and must not be freed. Called right before the
+// pools are swept: the sweep walks every page with an allocmap bit set and
+// would trip over the stale metadata of a cached page.
+void jl_gc_flush_page_caches(void)
+{
+    for (int i = 0; i < jl_n_threads; i++) {
+        jl_thread_heap_t *heap = &jl_all_tls_states[i]->heap;
+        while (heap->n_cached_pages > 0)
+            jl_gc_free_page_(heap->page_cache[--heap->n_cached_pages], 0);
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
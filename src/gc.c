@@ -1,6 +1,7 @@
 // This file is a part of Julia. License is MIT: http://julialang.org/license
 
 #include "gc.h"
+#include "uprobes.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,11 +66,273 @@ NOINLINE uintptr_t gc_get_stack_ptr(void)
     return (uintptr_t)jl_get_frame_addr();
 }
 
-#define should_timeout() 0
+// incremental collection
+//
+// When a pause target is set with `jl_gc_set_max_pause` the mark phase of a
+// (non-forced) collection is bounded: once the deadline is hit the rest of
+// the mark queue is left for the next collection trigger and the mutators
+// are resumed. The generational write barrier is what makes this safe:
+// while a budgeted cycle is running every object is marked `GC_OLD_MARKED`
+// (see `gc_setmark_big`/`gc_setmark_pool_`), so any store into an already
+// marked object between two increments queues it in the remset, and every
+// increment rescans the remsets and the roots before it continues draining.
+// A cycle that ran incrementally has to end in a full sweep since all the
+// survivors look old.
+static uint64_t gc_max_pause = 0; // ns; 0 means no pause target
+static uint64_t gc_mark_deadline = 0; // hrtime deadline of the current pause
+static int gc_incremental_cycle = 0;
+// duration of the last complete (non incremental) mark phase. Collections
+// only go incremental once a full mark actually overruns the pause target,
+// so small heaps keep the plain generational behavior.
+static uint64_t gc_mark_time = 0;
+// number of increments the current cycle used so far. A cycle that a
+// mutation heavy workload keeps re-dirtying is forced to finish after
+// GC_MAX_INCREMENTS pauses so that it terminates at all.
+static int gc_increments = 0;
+#define GC_MAX_INCREMENTS 32
+
+STATIC_INLINE int should_timeout(void)
+{
+    return gc_mark_deadline && jl_hrtime() >= gc_mark_deadline;
+}
+
+JL_DLLEXPORT void jl_gc_set_max_pause(uint64_t max_pause_ms)
+{
+    gc_max_pause = max_pause_ms * 1000000;
+}
+
+JL_DLLEXPORT uint64_t jl_gc_get_max_pause(void)
+{
+    return gc_max_pause / 1000000;
+}
+
+// The pointer chasing in the mark and sweep phases spends most of its
+// time stalled on cache misses for the object tags. Issuing software
+// prefetches for the objects about to be visited (a sliding window ahead
+// of the element/entry scans, and the next few deque entries in the
+// drain loops) hides a good part of that latency.
+#if defined(__GNUC__)
+#define gc_prefetch(p) __builtin_prefetch(p)
+#else
+#define gc_prefetch(p) ((void)(p))
+#endif
+#define GC_PREFETCH_DIST 8
+
+// pause log
+//
+// Fixed size ring of per-collection records, written by the collecting
+// thread inside the pause and readable from any thread (including
+// unmanaged monitoring threads) without synchronization: the reader
+// snapshots the head counter, copies the records and then drops any that
+// the writer may have overwritten in the meantime.
+#define GC_PAUSE_LOG_LEN 256 // must be a power of two
+static jl_gc_pause_rec_t gc_pause_log[GC_PAUSE_LOG_LEN];
+static volatile uint64_t gc_pause_log_head = 0; // # records ever written
+
+static void gc_log_pause(uint64_t t0, uint64_t pause_ns, uint64_t mark_ns,
+                         uint64_t sweep_ns, int64_t pages_freed,
+                         int full_sweep, int incremental)
+{
+    uint64_t head = gc_pause_log_head;
+    jl_gc_pause_rec_t *rec = &gc_pause_log[head % GC_PAUSE_LOG_LEN];
+    rec->start_ns = t0;
+    rec->pause_ns = pause_ns;
+    rec->mark_ns = mark_ns;
+    rec->sweep_ns = sweep_ns;
+    rec->pages_freed = pages_freed;
+    rec->tid = ti_tid;
+    rec->full_sweep = full_sweep;
+    rec->incremental = incremental;
+    jl_atomic_store_release(&gc_pause_log_head, head + 1);
+}
+
+// sampling allocation profiler
+//
+// When running, roughly every `sample_bytes` bytes of pool/big
+// allocation capture a backtrace of the allocating thread into a
+// preallocated buffer using the same block format as the time profiler
+// (instruction pointers, 0-terminated), with a parallel record per block
+// carrying the sampled allocation size and the thread id. The off state
+// costs one predicted branch per allocation.
+typedef struct {
+    uint64_t nbytes; // size of the sampled allocation
+    uint64_t tid;
+} jl_alloc_profile_meta_t;
+
+static intptr_t *alloc_bt_data = NULL;
+static size_t alloc_bt_size_max = 0;
+static volatile size_t alloc_bt_size_cur = 0;
+static jl_alloc_profile_meta_t *alloc_bt_meta = NULL;
+static size_t alloc_bt_meta_max = 0;
+static volatile size_t alloc_bt_meta_cur = 0;
+static volatile int64_t alloc_sample_countdown = 0;
+static int64_t alloc_sample_bytes = 0;
+static volatile int alloc_prof_running = 0;
+static jl_mutex_t alloc_prof_lock;
+
+JL_DLLEXPORT int jl_alloc_profile_init(size_t maxsize, uint64_t sample_bytes)
+{
+    alloc_prof_running = 0;
+    // a sampler in another thread may be mid-capture; wait for it before
+    // replacing the buffers
+    JL_LOCK_NOGC(&alloc_prof_lock);
+    free(alloc_bt_data);
+    free(alloc_bt_meta);
+    alloc_bt_data = (intptr_t*)calloc(maxsize, sizeof(intptr_t));
+    alloc_bt_meta = (jl_alloc_profile_meta_t*)calloc(
+        maxsize / 2 + 1, sizeof(jl_alloc_profile_meta_t));
+    if ((alloc_bt_data == NULL && maxsize > 0) || alloc_bt_meta == NULL) {
+        JL_UNLOCK_NOGC(&alloc_prof_lock);
+        return -1;
+    }
+    alloc_bt_size_max = maxsize;
+    alloc_bt_meta_max = maxsize / 2 + 1;
+    alloc_bt_size_cur = 0;
+    alloc_bt_meta_cur = 0;
+    alloc_sample_bytes = (int64_t)sample_bytes;
+    alloc_sample_countdown = (int64_t)sample_bytes;
+    JL_UNLOCK_NOGC(&alloc_prof_lock);
+    return 0;
+}
+
+// When set, allocation must not take the inlined bump path emitted by
+// emit_allocobj (it skips the per-allocation instrumentation); compiled
+// fast paths test it and divert to jl_gc_pool_alloc
+JL_DLLEXPORT volatile int jl_gc_alloc_instrumented = 0;
+
+JL_DLLEXPORT void jl_alloc_profile_start(void)
+{
+    if (alloc_bt_data != NULL && alloc_sample_bytes > 0) {
+        alloc_prof_running = 1;
+        jl_gc_alloc_instrumented = 1;
+    }
+}
+
+JL_DLLEXPORT void jl_alloc_profile_stop(void)
+{
+    alloc_prof_running = 0;
+    jl_gc_alloc_instrumented = 0;
+}
+
+JL_DLLEXPORT void jl_alloc_profile_clear(void)
+{
+    alloc_bt_size_cur = 0;
+    alloc_bt_meta_cur = 0;
+}
+
+JL_DLLEXPORT uint8_t *jl_alloc_profile_get_data(void)
+{
+    return (uint8_t*)alloc_bt_data;
+}
+
+JL_DLLEXPORT size_t jl_alloc_profile_len_data(void)
+{
+    return alloc_bt_size_cur;
+}
+
+JL_DLLEXPORT size_t jl_alloc_profile_maxlen_data(void)
+{
+    return alloc_bt_size_max;
+}
+
+JL_DLLEXPORT uint8_t *jl_alloc_profile_get_meta(void)
+{
+    return (uint8_t*)alloc_bt_meta;
+}
+
+JL_DLLEXPORT size_t jl_alloc_profile_len_meta(void)
+{
+    return alloc_bt_meta_cur;
+}
+
+// slow path of the allocation hook: take a sample
+static void NOINLINE jl_alloc_profile_sample(size_t sz)
+{
+    // re-arm before the potentially slow unwind
+    jl_atomic_fetch_add(&alloc_sample_countdown, alloc_sample_bytes);
+    JL_LOCK_NOGC(&alloc_prof_lock);
+    if (alloc_prof_running && alloc_bt_size_cur < alloc_bt_size_max - 1 &&
+        alloc_bt_meta_cur < alloc_bt_meta_max) {
+        alloc_bt_meta[alloc_bt_meta_cur].nbytes = sz;
+        alloc_bt_meta[alloc_bt_meta_cur].tid = ti_tid;
+        alloc_bt_meta_cur++;
+        alloc_bt_size_cur += rec_backtrace(
+            (uintptr_t*)alloc_bt_data + alloc_bt_size_cur,
+            alloc_bt_size_max - alloc_bt_size_cur - 1);
+        alloc_bt_data[alloc_bt_size_cur++] = 0;
+        if (alloc_bt_size_cur >= alloc_bt_size_max - 1)
+            alloc_prof_running = 0; // buffer full
+    }
+    JL_UNLOCK_NOGC(&alloc_prof_lock);
+}
+
+STATIC_INLINE void jl_alloc_profile_hit(size_t sz)
+{
+    if (__likely(!alloc_prof_running))
+        return;
+    if (jl_atomic_fetch_add(&alloc_sample_countdown, -(int64_t)sz) <=
+        (int64_t)sz)
+        jl_alloc_profile_sample(sz);
+}
+
+// Tuning statistics, refreshed at the end of every collection so that the
+// heuristics around the collect interval can be observed from outside.
+// Reads are unsynchronized by design (monitoring quality data); a scrape
+// racing with a collection can see a mix of two cycles.
+static jl_gc_stats_t gc_last_stats;
+// per-sweep accumulator for the survivor histogram, published into
+// `gc_last_stats` when the pool sweep finishes
+static uint64_t gc_pool_survivors[JL_GC_N_POOLS];
+
+JL_DLLEXPORT void jl_gc_stats_snapshot(jl_gc_stats_t *stats)
+{
+    *stats = gc_last_stats;
+}
+
+// Copy the most recent `len` records into `buf` (oldest first). Returns the
+// number of records copied, which can be smaller than `len` when the log
+// holds fewer records or when the collector overwrote some while they were
+// being copied.
+JL_DLLEXPORT size_t jl_gc_get_pause_log(jl_gc_pause_rec_t *buf, size_t len)
+{
+    uint64_t head = jl_atomic_load_acquire(&gc_pause_log_head);
+    // the collector may already be overwriting the oldest record without
+    // having bumped the head yet, so never hand out a full window
+    uint64_t avail = head >= GC_PAUSE_LOG_LEN ? GC_PAUSE_LOG_LEN - 1 : head;
+    if (len > avail)
+        len = avail;
+    uint64_t first = head - len;
+    for (size_t i = 0; i < len; i++)
+        buf[i] = gc_pause_log[(first + i) % GC_PAUSE_LOG_LEN];
+    // drop the records the collector may have overwritten while we copied
+    uint64_t head2 = jl_atomic_load_acquire(&gc_pause_log_head);
+    uint64_t oldest =
+        head2 >= GC_PAUSE_LOG_LEN ? head2 - GC_PAUSE_LOG_LEN + 1 : 0;
+    if (oldest > first) {
+        size_t drop = (size_t)(oldest - first);
+        if (drop >= len)
+            return 0;
+        memmove(buf, buf + drop, (len - drop) * sizeof(jl_gc_pause_rec_t));
+        len -= drop;
+    }
+    return len;
+}
+
+// histogram of time-to-safepoint: bucket i counts stop-the-world entries
+// whose slowest thread took [2^i, 2^(i+1)) ns to reach its safepoint
+static uint64_t gc_ttsp_hist[64];
+
+JL_DLLEXPORT void jl_gc_ttsp_histogram(uint64_t *buckets, size_t n)
+{
+    if (n > 64)
+        n = 64;
+    memcpy(buckets, gc_ttsp_hist, n * sizeof(uint64_t));
+}
 
 #ifdef JULIA_ENABLE_THREADING
 static void jl_gc_wait_for_the_world(void)
 {
+    uint64_t t0 = jl_hrtime();
     for (int i = 0;i < jl_n_threads;i++) {
         jl_tls_states_t *ptls2 = jl_all_tls_states[i];
         // FIXME: The acquire load pairs with the release stores
@@ -82,6 +345,11 @@ static void jl_gc_wait_for_the_world(void)
             jl_cpu_pause(); // yield?
         }
     }
+    uint64_t dt = jl_hrtime() - t0;
+    int b = 0;
+    while (dt >>= 1)
+        b++;
+    gc_ttsp_hist[b]++;
 }
 #else
 static inline void jl_gc_wait_for_the_world(void)
@@ -205,6 +473,90 @@ static void run_finalizers(void)
     arraylist_free(&copied_list);
 }
 
+// run at most `max_pairs` of the queued finalizers, taken from the tail of
+// `to_finalize`
+static void run_finalizers_batch(size_t max_pairs)
+{
+    JL_LOCK_NOGC(&finalizers_lock);
+    size_t len = to_finalize.len;
+    if (len == 0) {
+        JL_UNLOCK_NOGC(&finalizers_lock);
+        return;
+    }
+    size_t n = len / 2 > max_pairs ? max_pairs * 2 : len;
+    arraylist_t copied_list;
+    arraylist_new(&copied_list, n + 2);
+    // empty entries for the GC frame (see jl_gc_push_arraylist)
+    copied_list.items[0] = NULL;
+    copied_list.items[1] = NULL;
+    memcpy(&copied_list.items[2], &to_finalize.items[len - n],
+           n * sizeof(void*));
+    copied_list.len = n + 2;
+    to_finalize.len = len - n;
+    // This releases the finalizers lock.
+    jl_gc_run_finalizers_in_list(&copied_list);
+    arraylist_free(&copied_list);
+}
+
+// deferred finalization
+//
+// When enabled with `jl_gc_deferred_finalizers(1)`, `jl_gc_collect` no
+// longer runs the finalizers synchronously at the end of the pause.
+// `to_finalize` (already a multi-producer queue protected by
+// `finalizers_lock`) is instead drained in batches by an async callback on
+// the event loop, so a collection that kills thousands of objects doesn't
+// extend its effective pause by the finalization work. The callback honors
+// the per-thread finalizer inhibit counter, and jl_finalize /
+// jl_gc_run_all_finalizers still run synchronously.
+// (uv_async_t is buggy on windows -- see signal_async in jl_uv.c -- so
+// this mode is not available there.)
+#define GC_FINALIZER_BATCH 256 // finalizer pairs per event loop callback
+static int gc_deferred_finalizers = 0;
+#ifndef _OS_WINDOWS_
+static uv_async_t finalizer_async;
+static int finalizer_async_initialized = 0;
+
+static void jl_gc_deferred_finalizer_cb(uv_async_t *hdl)
+{
+    (void)hdl;
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    // If finalizers are inhibited the enable path runs them when they
+    // become legal again; if one is already running on this thread the
+    // rest of the queue waits for the next collection to re-arm us.
+    if (ptls->finalizers_inhibited || ptls->in_finalizer)
+        return;
+    // libuv runs async callbacks inside the poll window where the loop
+    // thread is advertised GC-safe (see the prepare/check bracket in
+    // jl_uv.c); finalizers are julia code, so switch to GC-unsafe for
+    // the batch like the cfunction wrappers do
+    int8_t gc_state = jl_gc_unsafe_enter(ptls);
+    ptls->in_finalizer = 1;
+    run_finalizers_batch(GC_FINALIZER_BATCH);
+    ptls->in_finalizer = 0;
+    jl_gc_unsafe_leave(ptls, gc_state);
+    // keep the event loop responsive: re-arm instead of draining the
+    // whole queue in one callback
+    if (to_finalize.len)
+        uv_async_send(&finalizer_async);
+}
+#endif
+
+JL_DLLEXPORT int jl_gc_deferred_finalizers(int on)
+{
+    int prev = gc_deferred_finalizers;
+#ifndef _OS_WINDOWS_
+    if (on && !finalizer_async_initialized) {
+        uv_async_init(jl_global_event_loop(), &finalizer_async,
+                      jl_gc_deferred_finalizer_cb);
+        // pending finalizers alone shouldn't keep the event loop alive
+        uv_unref((uv_handle_t*)&finalizer_async);
+        finalizer_async_initialized = 1;
+    }
+    gc_deferred_finalizers = (on != 0);
+#endif
+    return prev;
+}
+
 JL_DLLEXPORT void jl_gc_enable_finalizers(int on)
 {
     jl_tls_states_t *ptls = jl_get_ptls_states();
@@ -340,6 +692,54 @@ static size_t max_collect_interval =  500000000UL;
 // are not reachable from anywhere else.
 static int mark_reset_age = 0;
 
+// Set while the dedicated mark workers may be marking concurrently with the
+// collecting thread. When this is set the mark bits are updated with atomic
+// operations and the shared counters below are updated with atomic adds.
+// Always `0` in the single threaded build and when `jl_gc_n_mark_threads == 1`
+// so that the serial collector pays nothing for the parallel support.
+static int gc_parallel_marking = 0;
+
+// Protects the `big_objects_marked` list during a parallel mark phase.
+static jl_mutex_t big_objects_marked_lock;
+
+#define gc_scanned_add(counter, sz) do {                \
+        if (__unlikely(gc_parallel_marking))            \
+            jl_atomic_fetch_add(&(counter), (sz));      \
+        else                                            \
+            (counter) += (sz);                          \
+    } while (0)
+
+// Flip the mark bits of `o` from the unmarked `*bits` to `mark_mode`.
+// When marking in parallel the bits are claimed with a CAS on the tag word
+// and whichever marker wins the race does the bookkeeping for the object.
+// Returns `1` if this marker claimed the object and `0` (with `*bits`
+// updated to the winner's mark bits) otherwise. Losing the race is harmless:
+// it only means the object's children may be scanned twice.
+STATIC_INLINE int gc_try_setmark_tag(jl_taggedvalue_t *o, int *bits,
+                                     int mark_mode)
+{
+#ifdef JULIA_ENABLE_THREADING
+    if (__unlikely(gc_parallel_marking)) {
+        uintptr_t tag = o->header;
+        while (1) {
+            int old = (int)(tag & (uintptr_t)3);
+            if (gc_marked(old)) {
+                *bits = old;
+                return 0;
+            }
+            uintptr_t newtag = (tag & ~(uintptr_t)3) | (uintptr_t)mark_mode;
+            uintptr_t seen = jl_atomic_compare_exchange(&o->header, tag,
+                                                        newtag);
+            if (seen == tag)
+                return 1;
+            tag = seen;
+        }
+    }
+#endif
+    o->bits.gc = mark_mode;
+    return 1;
+}
+
 /*
  * The state transition looks like :
  *
@@ -395,6 +795,28 @@ static int prev_sweep_full = 1;
 
 // Full collection heuristics
 static int64_t live_bytes = 0;
+
+// ---- soft heap limit -------------------------------------------------
+//
+// jl_gc_set_soft_heap_limit(bytes) puts a target ceiling on the live
+// heap (e.g. "stay under 6GB in this 8GB container"). The pacing hook
+// at the end of every collection caps the allocation interval to a
+// fraction of the remaining headroom, so collections come more and more
+// often as the limit approaches instead of overshooting it by a whole
+// interval; close to the limit the freed-page quarantine is also
+// drained so the memory actually leaves the process. A zero limit (the
+// default) disables pacing entirely.
+static int64_t gc_soft_heap_limit = 0;
+
+JL_DLLEXPORT void jl_gc_set_soft_heap_limit(uint64_t bytes)
+{
+    gc_soft_heap_limit = (int64_t)bytes;
+}
+
+JL_DLLEXPORT uint64_t jl_gc_get_soft_heap_limit(void)
+{
+    return (uint64_t)gc_soft_heap_limit;
+}
 static int64_t promoted_bytes = 0;
 
 static int64_t last_full_live_ub = 0;
@@ -439,30 +861,41 @@ static inline int gc_setmark_big(jl_taggedvalue_t *o, int mark_mode)
     int bits = o->bits.gc;
     if (mark_reset_age && !gc_marked(bits)) {
         // Reset the object as if it was just allocated
+        // (this phase always runs serially)
         hdr->age = 0;
         gc_big_object_unlink(hdr);
         gc_big_object_link(hdr, &jl_thread_heap.big_objects);
         bits = GC_CLEAN;
         mark_mode = GC_MARKED;
+        o->bits.gc = mark_mode;
     }
     else {
         if (gc_old(bits))
             mark_mode = GC_OLD_MARKED;
+        // during a budgeted cycle everything is marked old so that the
+        // write barrier covers it between two mark increments
+        if (__unlikely(gc_incremental_cycle))
+            mark_mode = GC_OLD_MARKED;
+        if (!gc_try_setmark_tag(o, &bits, mark_mode))
+            return bits;
         if ((mark_mode == GC_OLD_MARKED) && (bits != GC_OLD_MARKED)) {
             // Move hdr from big_objects list to big_objects_marked list
+            if (__unlikely(gc_parallel_marking))
+                JL_LOCK_NOGC(&big_objects_marked_lock);
             gc_big_object_unlink(hdr);
             gc_big_object_link(hdr, &big_objects_marked);
+            if (__unlikely(gc_parallel_marking))
+                JL_UNLOCK_NOGC(&big_objects_marked_lock);
         }
     }
     if (!gc_marked(bits)) {
         if (mark_mode == GC_OLD_MARKED)
-            perm_scanned_bytes += hdr->sz&~3;
+            gc_scanned_add(perm_scanned_bytes, hdr->sz&~3);
         else
-            scanned_bytes += hdr->sz&~3;
+            gc_scanned_add(scanned_bytes, hdr->sz&~3);
         objprofile_count(jl_typeof(jl_valueof(o)),
                          mark_mode == GC_OLD_MARKED, hdr->sz&~3);
     }
-    o->bits.gc = mark_mode;
     verify_val(jl_valueof(o));
     return mark_mode;
 }
@@ -482,6 +915,7 @@ static inline int gc_setmark_pool_(jl_taggedvalue_t *o, int mark_mode,
     int bits = o->bits.gc;
     if (mark_reset_age && !gc_marked(bits)) {
         // Reset the object as if it was just allocated
+        // (this phase always runs serially)
         bits = GC_CLEAN;
         mark_mode = GC_MARKED;
         page->has_young = 1;
@@ -489,24 +923,35 @@ static inline int gc_setmark_pool_(jl_taggedvalue_t *o, int mark_mode,
         int obj_id = (((char*)o) - page_begin) / page->osize;
         uint8_t *ages = page->ages + obj_id / 8;
         *ages &= ~(1 << (obj_id % 8));
+        o->bits.gc = mark_mode;
     }
-    else if (gc_old(bits)) {
-        mark_mode = GC_OLD_MARKED;
+    else {
+        if (gc_old(bits))
+            mark_mode = GC_OLD_MARKED;
+        // see gc_setmark_big
+        if (__unlikely(gc_incremental_cycle))
+            mark_mode = GC_OLD_MARKED;
+        if (!gc_try_setmark_tag(o, &bits, mark_mode))
+            return bits;
     }
     if (!gc_marked(bits)) {
         if (mark_mode == GC_OLD_MARKED) {
-            perm_scanned_bytes += page->osize;
-            page->nold++;
+            gc_scanned_add(perm_scanned_bytes, page->osize);
+            if (__unlikely(gc_parallel_marking))
+                jl_atomic_fetch_add(&page->nold, 1);
+            else
+                page->nold++;
         }
         else {
-            scanned_bytes += page->osize;
+            gc_scanned_add(scanned_bytes, page->osize);
         }
         objprofile_count(jl_typeof(jl_valueof(o)),
                          mark_mode == GC_OLD_MARKED, page->osize);
     }
     assert(gc_marked(mark_mode));
+    // concurrent markers may race on this byte but they only ever store the
+    // same value to the same bit
     page->has_marked = 1;
-    o->bits.gc = mark_mode;
     verify_val(jl_valueof(o));
     return mark_mode;
 }
@@ -544,6 +989,70 @@ inline void gc_setmark_buf(void *o, int mark_mode, size_t minsz)
 
 #define should_collect() (__unlikely(gc_num.allocd>0))
 
+// hot allocation paths count into ptls->gc_allocd_local (biased by
+// -JL_GC_ALLOCD_QUANTUM) so multithreaded allocation stops hammering
+// one shared cacheline; crossing zero folds the quantum into the
+// global trigger here, out of line
+#define JL_GC_ALLOCD_QUANTUM (64 * 1024)
+
+// Build `dt`'s pointer-offset map: the byte offsets of its pointer
+// fields, read by the mark loop instead of the per-object descriptor
+// walk. Built lazily the first time an instance is marked, so
+// transient parametric types that never see a marked instance cost
+// nothing; the array is malloc'd and intentionally not reclaimed if
+// the type itself is later collected (bounded by types that both had
+// marked instances and died). Publication is a release store so a
+// racing parallel marker sees a fully initialized map; a lost race
+// leaks one small array once.
+static int32_t *gc_build_ptroffsets(jl_datatype_t *dt)
+{
+    int nf = (int)jl_datatype_nfields(dt);
+    int np = 0, i;
+    int32_t *offs = (int32_t*)malloc((nf ? nf : 1) * sizeof(int32_t));
+    for (i = 0; i < nf; i++) {
+        if (jl_field_isptr(dt, i))
+            offs[np++] = (int32_t)jl_field_offset(dt, i);
+    }
+    dt->nptrfields = np;
+    jl_atomic_store_release(&dt->ptroffsets, offs);
+    return offs;
+}
+
+static NOINLINE void jl_gc_flush_allocd(jl_tls_states_t *ptls)
+{
+    int64_t used = ptls->gc_allocd_local + JL_GC_ALLOCD_QUANTUM;
+    ptls->gc_allocd_local = -JL_GC_ALLOCD_QUANTUM;
+    ptls->gc_allocd_total += (uint64_t)used;
+    if (__unlikely((jl_atomic_fetch_add(&gc_num.allocd, used) + used) >= 0) ||
+        gc_debug_check_pool())
+        jl_gc_collect(0);
+    else
+        jl_gc_safepoint_(ptls);
+}
+
+// fold every thread's pending quantum into the global counter; world
+// must be stopped (collection entry), so plain accesses are fine
+static void gc_fold_all_allocd(void)
+{
+    for (int i = 0; i < jl_n_threads; i++) {
+        jl_tls_states_t *ptls2 = jl_all_tls_states[i];
+        int64_t used = ptls2->gc_allocd_local + JL_GC_ALLOCD_QUANTUM;
+        ptls2->gc_allocd_local = -JL_GC_ALLOCD_QUANTUM;
+        ptls2->gc_allocd_total += (uint64_t)used;
+        gc_num.allocd += used;
+    }
+}
+
+// lifetime bytes allocated by one thread, for per-request attribution
+JL_DLLEXPORT uint64_t jl_gc_thread_allocd(int16_t tid)
+{
+    if (tid < 0 || tid >= jl_n_threads)
+        return 0;
+    jl_tls_states_t *ptls2 = jl_all_tls_states[tid];
+    return ptls2->gc_allocd_total +
+        (uint64_t)(ptls2->gc_allocd_local + JL_GC_ALLOCD_QUANTUM);
+}
+
 static inline int maybe_collect(void)
 {
     if (should_collect() || gc_debug_check_other()) {
@@ -566,6 +1075,18 @@ JL_DLLEXPORT jl_weakref_t *jl_gc_new_weakref(jl_value_t *value)
     return wr;
 }
 
+// NOTE (re: segmenting these by referent generation): a weak ref to an
+// old referent could indeed skip minor sweeps -- except that wr->value
+// is an ordinary mutable field. A store of a young object into an
+// old-segment weak ref has no weakref-specific hook (the generic write
+// barrier queues the *weakref* for re-marking, and weakref marking
+// deliberately does not visit the value), so the segment membership
+// cannot be kept precise, and an imprecise old segment means a minor
+// collection can free a young referent while the skipped weak ref still
+// points at it. Precise segmentation needs a dedicated weakref store
+// barrier; until then the whole list is visited and the walk is made to
+// stream (each entry costs two dependent loads, so the prefetch hides
+// most of the per-entry latency the request measured).
 static void sweep_weak_refs(void)
 {
     for (int i = 0;i < jl_n_threads;i++) {
@@ -577,6 +1098,8 @@ static void sweep_weak_refs(void)
         if (l == 0)
             continue;
         while (1) {
+            if (n + GC_PREFETCH_DIST < l - ndel)
+                gc_prefetch(jl_astaggedvalue(lst[n + GC_PREFETCH_DIST]));
             jl_weakref_t *wr = (jl_weakref_t*)lst[n];
             if (gc_marked(jl_astaggedvalue(wr)->bits.gc)) {
                 // weakref itself is alive
@@ -611,6 +1134,7 @@ static NOINLINE jl_taggedvalue_t *alloc_big(size_t sz)
         jl_throw(jl_memory_exception);
     jl_atomic_fetch_add(&gc_num.allocd, allocsz);
     gc_num.bigalloc++;
+    jl_alloc_profile_hit(allocsz);
 #ifdef MEMDEBUG
     memset(v, 0xee, allocsz);
 #endif
@@ -622,8 +1146,10 @@ static NOINLINE jl_taggedvalue_t *alloc_big(size_t sz)
 }
 
 // Sweep list rooted at *pv, removing and freeing any unmarked objects.
-// Return pointer to last `next` field in the culled list.
-static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv)
+// Freed bytes are accumulated into `*pfreed` so that the caller can decide
+// which counter they belong to. Return pointer to last `next` field in the
+// culled list.
+static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv, int64_t *pfreed)
 {
     bigval_t *v = *pv;
     while (v != NULL) {
@@ -650,7 +1176,7 @@ static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv)
             *pv = nxt;
             if (nxt)
                 nxt->prev = pv;
-            gc_num.freed += v->sz&~3;
+            *pfreed += v->sz&~3;
 #ifdef MEMDEBUG
             memset(v, 0xbb, v->sz&~3);
 #endif
@@ -662,13 +1188,134 @@ static bigval_t **sweep_big_list(int sweep_full, bigval_t **pv)
     return pv;
 }
 
+// concurrent sweeping of big objects
+//
+// When enabled (JULIA_GC_SWEEP_THREAD=1 with the threading build), the big
+// object lists are not swept inside the stop-the-world window. They are
+// detached while the world is still stopped and handed to a background
+// thread which sweeps them while the mutators are running again; the next
+// collection waits for the sweeper to go idle before it starts marking.
+// Survivors are collected on the (collector private) `big_objects_swept`
+// list which is re-detached on the next cycle. This is safe because the
+// mutators never walk the big object lists, they only push freshly
+// allocated objects onto their own (already detached and thus empty) list
+// heads, and because the detached lists cannot contain `GC_OLD_MARKED`
+// objects on a quick sweep so the write barrier never races with the
+// sweeper on the gc bits.
+//
+// The pool page table is still swept in the pause: the pool free lists are
+// threaded through the per-thread allocation pools, so sweeping them
+// off-pause requires reworking the allocator first.
+#ifdef JULIA_ENABLE_THREADING
+static int gc_concurrent_sweep = 0;
+static uv_mutex_t gc_sweep_lock;
+static uv_cond_t gc_sweep_wakeup;
+static uv_cond_t gc_sweep_idle;
+// both protected by `gc_sweep_lock`
+static int gc_sweeping = 0;
+static int gc_sweep_full_flag = 0;
+// detached big object list heads handed to the sweeper thread.
+// [jl_n_threads] entries for the per-thread lists, one for the previous
+// survivors and one for `big_objects_marked` (full sweeps only).
+static bigval_t **gc_sweep_detached = NULL;
+static int gc_n_sweep_detached = 0;
+// survivors of the last concurrent sweep
+static bigval_t *big_objects_swept = NULL;
+// bytes freed by the background sweeper since the last pause. Folded into
+// `gc_num.freed` (and therefore `live_bytes`) at the start of the next
+// collection, one cycle later than the synchronous sweep would do it.
+static volatile int64_t gc_sweep_bg_freed = 0;
+
+static void gc_sweep_detach_list(bigval_t **list)
+{
+    bigval_t *v = *list;
+    if (v == NULL)
+        return;
+    bigval_t **slot = &gc_sweep_detached[gc_n_sweep_detached++];
+    *slot = v;
+    v->prev = slot;
+    *list = NULL;
+}
+
+static void gc_sweep_threadfun(void *arg)
+{
+    (void)arg;
+    uv_mutex_lock(&gc_sweep_lock);
+    for (;;) {
+        while (!gc_sweeping)
+            uv_cond_wait(&gc_sweep_wakeup, &gc_sweep_lock);
+        uv_mutex_unlock(&gc_sweep_lock);
+        int64_t freed = 0;
+        for (int i = 0; i < gc_n_sweep_detached; i++) {
+            bigval_t **slot = &gc_sweep_detached[i];
+            bigval_t **last_next = sweep_big_list(gc_sweep_full_flag, slot,
+                                                  &freed);
+            bigval_t *head = *slot;
+            if (head) {
+                // prepend the survivors to `big_objects_swept`
+                *last_next = big_objects_swept;
+                if (big_objects_swept)
+                    big_objects_swept->prev = last_next;
+                big_objects_swept = head;
+                head->prev = &big_objects_swept;
+            }
+        }
+        jl_atomic_fetch_add(&gc_sweep_bg_freed, freed);
+        uv_mutex_lock(&gc_sweep_lock);
+        gc_sweeping = 0;
+        uv_cond_signal(&gc_sweep_idle);
+    }
+}
+
+// hand the big object lists detached by `gc_sweep_big_detach` to the
+// sweeper thread. Must be called while the world is stopped.
+static void gc_sweep_big_kick(int sweep_full)
+{
+    gc_n_sweep_detached = 0;
+    for (int i = 0; i < jl_n_threads; i++)
+        gc_sweep_detach_list(&jl_all_tls_states[i]->heap.big_objects);
+    gc_sweep_detach_list(&big_objects_swept);
+    if (sweep_full)
+        gc_sweep_detach_list(&big_objects_marked);
+    uv_mutex_lock(&gc_sweep_lock);
+    gc_sweep_full_flag = sweep_full;
+    gc_sweeping = 1;
+    uv_cond_signal(&gc_sweep_wakeup);
+    uv_mutex_unlock(&gc_sweep_lock);
+}
+#endif
+
+// wait for the background sweeper to go idle and account the bytes it
+// freed. No-op (and no synchronization) when concurrent sweeping is off.
+static void gc_sweep_big_wait(void)
+{
+#ifdef JULIA_ENABLE_THREADING
+    if (!gc_concurrent_sweep)
+        return;
+    uv_mutex_lock(&gc_sweep_lock);
+    while (gc_sweeping)
+        uv_cond_wait(&gc_sweep_idle, &gc_sweep_lock);
+    uv_mutex_unlock(&gc_sweep_lock);
+    gc_num.freed += jl_atomic_exchange(&gc_sweep_bg_freed, 0);
+#endif
+}
+
 static void sweep_big(int sweep_full)
 {
     gc_time_big_start();
+#ifdef JULIA_ENABLE_THREADING
+    if (gc_concurrent_sweep) {
+        gc_sweep_big_kick(sweep_full);
+        gc_time_big_end();
+        return;
+    }
+#endif
     for (int i = 0;i < jl_n_threads;i++)
-        sweep_big_list(sweep_full, &jl_all_tls_states[i]->heap.big_objects);
+        sweep_big_list(sweep_full, &jl_all_tls_states[i]->heap.big_objects,
+                       &gc_num.freed);
     if (sweep_full) {
-        bigval_t **last_next = sweep_big_list(sweep_full, &big_objects_marked);
+        bigval_t **last_next = sweep_big_list(sweep_full, &big_objects_marked,
+                                              &gc_num.freed);
         // Move all survivors from big_objects_marked list to big_objects list.
         if (jl_thread_heap.big_objects)
             jl_thread_heap.big_objects->prev = last_next;
@@ -726,7 +1373,9 @@ static void jl_gc_free_array(jl_array_t *a)
 {
     if (a->flags.how == 2) {
         char *d = (char*)a->data - a->offset*a->elsize;
-        if (a->flags.isaligned)
+        if (gc_mmap_free(d))
+            ; // was an mmap-backed buffer (see gc_mmap_track)
+        else if (a->flags.isaligned)
             jl_free_aligned(d);
         else
             free(d);
@@ -800,16 +1449,18 @@ static inline jl_taggedvalue_t *__pool_alloc(jl_tls_states_t *ptls,
     return alloc_big(osize);
 #endif
     jl_taggedvalue_t *v, *end;
-    // FIXME - need JL_ATOMIC_FETCH_AND_ADD here
-    if (__unlikely((gc_num.allocd += osize) >= 0) || gc_debug_check_pool()) {
-        //gc_num.allocd -= osize;
-        jl_gc_collect(0);
-        //gc_num.allocd += osize;
+    // sharded accounting: bump the thread-local quantum; the out-of-line
+    // flush below folds into the shared trigger (atomically, resolving
+    // the old FIXME) at most once per quantum
+    if (__unlikely((ptls->gc_allocd_local += osize) >= 0) ||
+        gc_debug_check_pool()) {
+        jl_gc_flush_allocd(ptls);
     }
     else {
         jl_gc_safepoint_(ptls);
     }
     gc_num.poolalloc++;
+    jl_alloc_profile_hit(osize);
     // first try to use the freelist
     v = p->freelist;
     if (v) {
@@ -873,6 +1524,13 @@ JL_DLLEXPORT void *jl_gc_pool_alloc(jl_tls_states_t *ptls, jl_gc_pool_t *p,
     return jl_valueof(__pool_alloc(ptls, p, osize, end_offset));
 }
 
+// address of the collection trigger, for the inlined allocation fast
+// path emitted by emit_allocobj
+JL_DLLEXPORT int64_t *jl_gc_allocd_counter(void)
+{
+    return &gc_num.allocd;
+}
+
 // Size includes the tag!!
 JL_DLLEXPORT jl_value_t *jl_gc_big_alloc(jl_tls_states_t *ptls, size_t allocsz)
 {
@@ -942,6 +1600,19 @@ int jl_gc_classify_pools(size_t sz, int *osize, int *end_offset)
     return (int)(intptr_t)(&((jl_tls_states_t*)0)->heap.norm_pools[klass]);
 }
 
+// resolve an allocation-class descriptor for jl_gc_alloc_fast (julia.h)
+JL_DLLEXPORT int jl_gc_alloc_class(size_t sz, jl_alloc_class_t *cls)
+{
+    int osize, end_offset;
+    int offset = jl_gc_classify_pools(sz, &osize, &end_offset);
+    if (offset < 0)
+        return -1;
+    cls->offset = (uint32_t)offset;
+    cls->osize = (uint16_t)osize;
+    cls->end_offset = (uint16_t)end_offset;
+    return 0;
+}
+
 // sweep phase
 
 int64_t lazy_freed_pages = 0;
@@ -1056,6 +1727,8 @@ static jl_taggedvalue_t **sweep_page(jl_gc_pool_t *p, jl_gc_pagemeta_t *pg, jl_t
 done:
     gc_time_count_page(freedall, pg_skpd);
     gc_num.freed += (nfree - old_nfree) * osize;
+    gc_pool_survivors[pg->pool_n] +=
+        (GC_PAGE_SZ - GC_PAGE_OFFSET) / osize - nfree;
     return pfl;
 }
 
@@ -1073,6 +1746,8 @@ static void sweep_pool_region(jl_taggedvalue_t ***pfl, int region_i, int sweep_f
             for (int j = 0; j < 32; j++) {
                 if ((line >> j) & 1) {
                     jl_gc_pagemeta_t *pg = &region->meta[pg_i*32 + j];
+                    if (__unlikely(pg->nonpool))
+                        continue;
                     int p_n = pg->pool_n;
                     int t_n = pg->thread_n;
                     jl_tls_states_t *ptls2 = jl_all_tls_states[t_n];
@@ -1101,6 +1776,12 @@ static void gc_sweep_pool(int sweep_full)
     gc_time_pool_start();
     lazy_freed_pages = 0;
 
+    // the sweep below walks every page with an allocmap bit set so the
+    // thread local page caches have to be emptied out first
+    jl_gc_flush_page_caches();
+
+    memset(gc_pool_survivors, 0, sizeof(gc_pool_survivors));
+
     jl_taggedvalue_t ***pfl = (jl_taggedvalue_t ***) alloca(jl_n_threads * JL_GC_N_POOLS * sizeof(jl_taggedvalue_t**));
 
     // update metadata of pages that were pointed to by freelist or newpages from a pool
@@ -1147,39 +1828,135 @@ static void gc_sweep_pool(int sweep_full)
         }
     }
 
+    memcpy(gc_last_stats.pool_survivors, gc_pool_survivors,
+           sizeof(gc_pool_survivors));
+
     gc_time_pool_end(sweep_full);
 }
 
 // mark phase
 
-static jl_value_t **mark_stack = NULL;
-static jl_value_t **mark_stack_base = NULL;
-static size_t mark_stack_size = 0;
-static size_t mark_sp = 0;
+// number of threads running the mark phase (including the collecting
+// thread). Defaults to `jl_n_threads`, settable with `JULIA_GC_MARK_THREADS`.
+int jl_gc_n_mark_threads = 1;
+static jl_gc_mark_ctx_t *gc_mark_ctxs = NULL;
 
-
-static void grow_mark_stack(void)
+static void gc_mark_deque_init(jl_gc_mark_deque_t *q)
 {
-    size_t newsz = mark_stack_size>0 ? mark_stack_size*2 : 32000;
-    size_t offset = mark_stack - mark_stack_base;
-    mark_stack_base = (jl_value_t**)realloc(mark_stack_base, newsz*sizeof(void*));
-    if (mark_stack_base == NULL) {
-        jl_printf(JL_STDERR, "Couldn't grow mark stack to : %" PRIuPTR "\n",
-                  (uintptr_t)newsz);
+    q->size = 32000;
+    q->items = (jl_value_t**)malloc(q->size * sizeof(void*));
+    if (q->items == NULL) {
+        jl_printf(JL_STDERR, "Couldn't allocate mark stack\n");
         exit(1);
     }
-    mark_stack = mark_stack_base + offset;
-    mark_stack_size = newsz;
+    q->bottom = 0;
+    q->top = 0;
+}
+
+// the deque locks are only needed when there is more than one marker;
+// in that case stealing can race with push/pop
+STATIC_INLINE void gc_mark_deque_lock(jl_gc_mark_deque_t *q)
+{
+    if (jl_gc_n_mark_threads > 1)
+        JL_LOCK_NOGC(&q->lock);
+}
+
+STATIC_INLINE void gc_mark_deque_unlock(jl_gc_mark_deque_t *q)
+{
+    if (jl_gc_n_mark_threads > 1)
+        JL_UNLOCK_NOGC(&q->lock);
+}
+
+static void gc_mark_deque_push(jl_gc_mark_deque_t *q, jl_value_t *v)
+{
+    gc_mark_deque_lock(q);
+    if (__unlikely(q->bottom == q->size)) {
+        if (q->top > 0) {
+            // reclaim the space freed up by the stealers
+            memmove(q->items, q->items + q->top,
+                    (q->bottom - q->top) * sizeof(void*));
+            q->bottom -= q->top;
+            q->top = 0;
+        }
+        else {
+            size_t newsz = q->size * 2;
+            q->items = (jl_value_t**)realloc(q->items, newsz * sizeof(void*));
+            if (q->items == NULL) {
+                jl_printf(JL_STDERR,
+                          "Couldn't grow mark stack to : %" PRIuPTR "\n",
+                          (uintptr_t)newsz);
+                exit(1);
+            }
+            q->size = newsz;
+        }
+    }
+    q->items[q->bottom++] = v;
+    gc_mark_deque_unlock(q);
+}
+
+static jl_value_t *gc_mark_deque_pop(jl_gc_mark_deque_t *q)
+{
+    jl_value_t *v = NULL;
+    gc_mark_deque_lock(q);
+    if (q->bottom > q->top)
+        v = q->items[--q->bottom];
+    if (q->bottom == q->top)
+        q->bottom = q->top = 0;
+    gc_mark_deque_unlock(q);
+    return v;
+}
+
+static jl_value_t *gc_mark_deque_steal(jl_gc_mark_deque_t *q)
+{
+    jl_value_t *v = NULL;
+    gc_mark_deque_lock(q);
+    if (q->bottom > q->top)
+        v = q->items[q->top++];
+    gc_mark_deque_unlock(q);
+    return v;
+}
+
+STATIC_INLINE int gc_mark_deque_empty(jl_gc_mark_deque_t *q)
+{
+    return q->bottom == q->top;
+}
+
+// prefetch the tags of the objects the owner is going to pop next.
+// This peeks at the deque without taking the lock: the owner's end is
+// stable and racing with a stealer at worst prefetches a stolen entry.
+STATIC_INLINE void gc_mark_deque_prefetch(jl_gc_mark_deque_t *q)
+{
+    size_t b = q->bottom;
+    size_t t = q->top;
+    for (size_t i = 1; i <= 4 && t + i <= b; i++)
+        gc_prefetch(jl_astaggedvalue(q->items[b - i]));
+}
+
+// merge the remset entries recorded by the markers into the collecting
+// thread's heap remset. Must run after every drain of the mark deques and
+// before anything looks at the remset again.
+static void gc_mark_flush_remsets(void)
+{
+    for (int i = 0; i < jl_gc_n_mark_threads; i++) {
+        jl_gc_mark_ctx_t *ctx = &gc_mark_ctxs[i];
+        chunklist_foreach(&ctx->remset, ck) {
+            for (size_t j = 0; j < ck->n; j++)
+                chunklist_push(jl_thread_heap.remset, ck->items[j]);
+        }
+        jl_thread_heap.remset_nptr += ctx->remset_nptr;
+        chunklist_clear(&ctx->remset);
+        ctx->remset_nptr = 0;
+    }
 }
 
 static void reset_remset(void)
 {
     for (int t_i = 0;t_i < jl_n_threads;t_i++) {
         jl_tls_states_t *ptls2 = jl_all_tls_states[t_i];
-        arraylist_t *tmp = ptls2->heap.remset;
+        chunklist_t *tmp = ptls2->heap.remset;
         ptls2->heap.remset = ptls2->heap.last_remset;
         ptls2->heap.last_remset = tmp;
-        ptls2->heap.remset->len = 0;
+        chunklist_clear(ptls2->heap.remset);
         ptls2->heap.remset_nptr = 0;
     }
 }
@@ -1198,7 +1975,7 @@ JL_DLLEXPORT void jl_gc_queue_root(jl_value_t *ptr)
     // write GC_OLD to the GC bits outside GC. This could cause
     // duplicated objects in the remset but that shouldn't be a problem.
     o->bits.gc = GC_MARKED;
-    arraylist_push(jl_thread_heap.remset, ptr);
+    chunklist_push(jl_thread_heap.remset, ptr);
     jl_thread_heap.remset_nptr++; // conservative
 }
 
@@ -1213,12 +1990,12 @@ void gc_queue_binding(jl_binding_t *bnd)
     arraylist_push(&jl_thread_heap.rem_bindings, bnd);
 }
 
-static int push_root(jl_value_t *v, int d, int);
+static int push_root(jl_gc_mark_ctx_t *ctx, jl_value_t *v, int d, int);
 #ifdef JL_DEBUG_BUILD
 static void *volatile gc_findval; // for usage from gdb, for finding the gc-root for a value
 #endif
 // Returns whether the object is young
-static inline int gc_push_root(void *v, int d) // v isa jl_value_t*
+static inline int gc_push_root(jl_gc_mark_ctx_t *ctx, void *v, int d) // v isa jl_value_t*
 {
 #ifdef JL_DEBUG_BUILD
     if (v == gc_findval)
@@ -1229,7 +2006,7 @@ static inline int gc_push_root(void *v, int d) // v isa jl_value_t*
     verify_val(v);
     int bits = o->bits.gc;
     if (!gc_marked(bits))
-        return !gc_old(push_root((jl_value_t*)v, d, bits));
+        return !gc_old(push_root(ctx, (jl_value_t*)v, d, bits));
     return !gc_old(bits);
 }
 
@@ -1241,7 +2018,7 @@ void jl_gc_setmark(jl_value_t *v) // TODO rename this as it is misleading now
     }
 }
 
-NOINLINE static int gc_mark_module(jl_module_t *m, int d)
+NOINLINE static int gc_mark_module(jl_gc_mark_ctx_t *ctx, jl_module_t *m, int d)
 {
     size_t i;
     int refyoung = 0;
@@ -1257,10 +2034,12 @@ NOINLINE static int gc_mark_module(jl_module_t *m, int d)
             if (b->value != NULL) {
                 verify_parent2("module", m, &b->value, "binding(%s)",
                                jl_symbol_name(b->name));
-                refyoung |= gc_push_root(b->value, d);
+                refyoung |= gc_push_root(ctx, b->value, d);
             }
             if (b->globalref != NULL)
-                refyoung |= gc_push_root(b->globalref, d);
+                refyoung |= gc_push_root(ctx, b->globalref, d);
+            if (b->dependents != NULL)
+                refyoung |= gc_push_root(ctx, b->dependents, d);
         }
     }
     // this is only necessary because bindings for "using" modules
@@ -1268,17 +2047,18 @@ NOINLINE static int gc_mark_module(jl_module_t *m, int d)
     // after "using" it but before accessing it, this array might
     // contain the only reference.
     for(i=0; i < m->usings.len; i++) {
-        refyoung |= gc_push_root(m->usings.items[i], d);
+        refyoung |= gc_push_root(ctx, m->usings.items[i], d);
     }
 
     if (m->parent) {
-        refyoung |= gc_push_root(m->parent, d);
+        refyoung |= gc_push_root(ctx, m->parent, d);
     }
 
     return refyoung;
 }
 
-static void gc_mark_stack(jl_value_t *ta, jl_gcframe_t *s, intptr_t offset, int d)
+static void gc_mark_stack(jl_gc_mark_ctx_t *ctx, jl_value_t *ta, jl_gcframe_t *s,
+                          intptr_t offset, int d)
 {
     while (s != NULL) {
         s = (jl_gcframe_t*)((char*)s + offset);
@@ -1288,7 +2068,7 @@ static void gc_mark_stack(jl_value_t *ta, jl_gcframe_t *s, intptr_t offset, int
             for(size_t i=0; i < nr; i++) {
                 jl_value_t **ptr = (jl_value_t**)((char*)rts[i] + offset);
                 if (*ptr != NULL) {
-                    gc_push_root(*ptr, d);
+                    gc_push_root(ctx, *ptr, d);
                 }
             }
         }
@@ -1296,7 +2076,7 @@ static void gc_mark_stack(jl_value_t *ta, jl_gcframe_t *s, intptr_t offset, int
             for(size_t i=0; i < nr; i++) {
                 if (rts[i] != NULL) {
                     verify_parent2("task", ta, &rts[i], "stack(%d)", (int)i);
-                    gc_push_root(rts[i], d);
+                    gc_push_root(ctx, rts[i], d);
                 }
             }
         }
@@ -1304,7 +2084,7 @@ static void gc_mark_stack(jl_value_t *ta, jl_gcframe_t *s, intptr_t offset, int
     }
 }
 
-static void gc_mark_task_stack(jl_task_t *ta, int d)
+static void gc_mark_task_stack(jl_gc_mark_ctx_t *ctx, jl_task_t *ta, int d)
 {
     int stkbuf = (ta->stkbuf != (void*)(intptr_t)-1 && ta->stkbuf != NULL);
     int16_t tid = ta->tid;
@@ -1321,34 +2101,39 @@ static void gc_mark_task_stack(jl_task_t *ta, int d)
 #endif
     }
     if (ta == ptls2->current_task) {
-        gc_mark_stack((jl_value_t*)ta, ptls2->pgcstack, 0, d);
+        gc_mark_stack(ctx, (jl_value_t*)ta, ptls2->pgcstack, 0, d);
     }
     else if (stkbuf) {
         intptr_t offset;
 #ifdef COPY_STACKS
-        offset = (char *)ta->stkbuf - ((char *)ptls2->stackbase - ta->ssize);
+        if (ta->copy_stack)
+            offset = (char *)ta->stkbuf - ((char *)ptls2->stackbase - ta->ssize);
+        else
+            // hybrid stacks: the task runs in place on its own buffer
+            offset = 0;
 #else
         offset = 0;
 #endif
-        gc_mark_stack((jl_value_t*)ta, ta->gcstack, offset, d);
+        gc_mark_stack(ctx, (jl_value_t*)ta, ta->gcstack, offset, d);
     }
 }
 
-NOINLINE static void gc_mark_task(jl_task_t *ta, int d)
+NOINLINE static void gc_mark_task(jl_gc_mark_ctx_t *ctx, jl_task_t *ta, int d)
 {
-    if (ta->parent) gc_push_root(ta->parent, d);
-    gc_push_root(ta->tls, d);
-    gc_push_root(ta->consumers, d);
-    gc_push_root(ta->donenotify, d);
-    gc_push_root(ta->exception, d);
-    if (ta->backtrace) gc_push_root(ta->backtrace, d);
-    if (ta->start)  gc_push_root(ta->start, d);
-    if (ta->result) gc_push_root(ta->result, d);
-    gc_mark_task_stack(ta, d);
+    if (ta->parent) gc_push_root(ctx, ta->parent, d);
+    gc_push_root(ctx, ta->tls, d);
+    gc_push_root(ctx, ta->consumers, d);
+    gc_push_root(ctx, ta->donenotify, d);
+    gc_push_root(ctx, ta->exception, d);
+    if (ta->backtrace) gc_push_root(ctx, ta->backtrace, d);
+    if (ta->start)  gc_push_root(ctx, ta->start, d);
+    if (ta->result) gc_push_root(ctx, ta->result, d);
+    gc_mark_task_stack(ctx, ta, d);
 }
 
 void gc_mark_object_list(arraylist_t *list, size_t start)
 {
+    jl_gc_mark_ctx_t *ctx = &gc_mark_ctxs[0];
     void **items = list->items;
     size_t len = list->len;
     for (size_t i = start;i < len;i++) {
@@ -1360,7 +2145,7 @@ void gc_mark_object_list(arraylist_t *list, size_t start)
             i++;
             assert(i < len);
         }
-        gc_push_root(v, 0);
+        gc_push_root(ctx, v, 0);
     }
 }
 
@@ -1375,7 +2160,7 @@ JL_DLLEXPORT void jl_gc_lookfor(jl_value_t *v) { lookforme = v; }
 // it does so assuming the gc bits of v are "bits" and returns the new bits of v
 // if v becomes GC_OLD_MARKED and some of its children are GC_MARKED (young),
 // v is added to the remset
-static int push_root(jl_value_t *v, int d, int bits)
+static int push_root(jl_gc_mark_ctx_t *ctx, jl_value_t *v, int d, int bits)
 {
     assert(v != NULL);
     jl_value_t *vt = jl_typeof(v);
@@ -1401,10 +2186,12 @@ static int push_root(jl_value_t *v, int d, int bits)
         jl_value_t **data = jl_svec_data(v);
         nptr += l;
         for(size_t i=0; i < l; i++) {
+            if (i + GC_PREFETCH_DIST < l && data[i + GC_PREFETCH_DIST])
+                gc_prefetch(jl_astaggedvalue(data[i + GC_PREFETCH_DIST]));
             jl_value_t *elt = data[i];
             if (elt != NULL) {
                 verify_parent2("svec", v, &data[i], "elem(%d)", (int)i);
-                refyoung |= gc_push_root(elt, d);
+                refyoung |= gc_push_root(ctx, elt, d);
             }
         }
     }
@@ -1418,17 +2205,17 @@ static int push_root(jl_value_t *v, int d, int bits)
             objprofile_count(jl_malloc_tag, o->bits.gc == GC_OLD_MARKED,
                              array_nbytes(a));
             if (o->bits.gc == GC_OLD_MARKED) {
-                perm_scanned_bytes += array_nbytes(a);
+                gc_scanned_add(perm_scanned_bytes, array_nbytes(a));
             }
             else {
-                scanned_bytes += array_nbytes(a);
+                gc_scanned_add(scanned_bytes, array_nbytes(a));
             }
         }
         if (d >= MAX_MARK_DEPTH)
             goto queue_the_root;
         if (a->flags.how == 3) {
             jl_value_t *owner = jl_array_data_owner(a);
-            refyoung |= gc_push_root(owner, d);
+            refyoung |= gc_push_root(ctx, owner, d);
             goto ret;
         }
         else if (a->flags.how == 1) {
@@ -1449,10 +2236,14 @@ static int push_root(jl_value_t *v, int d, int bits)
                 nptr += l;
                 void *data = a->data;
                 for (size_t i=0; i < l; i++) {
+                    if (i + GC_PREFETCH_DIST < l &&
+                        ((jl_value_t**)data)[i + GC_PREFETCH_DIST])
+                        gc_prefetch(jl_astaggedvalue(
+                            ((jl_value_t**)data)[i + GC_PREFETCH_DIST]));
                     jl_value_t *elt = ((jl_value_t**)data)[i];
                     if (elt != NULL) {
                         verify_parent2("array", v, &((jl_value_t**)data)[i], "elem(%d)", (int)i);
-                        refyoung |= gc_push_root(elt, d);
+                        refyoung |= gc_push_root(ctx, elt, d);
                     }
                     // try to split large array marking (incremental mark TODO)
                     // if (should_timeout() && l > 1000) goto queue_the_root;
@@ -1465,14 +2256,14 @@ static int push_root(jl_value_t *v, int d, int bits)
         bits = gc_setmark(v, sizeof(jl_module_t));
         if (d >= MAX_MARK_DEPTH)
             goto queue_the_root;
-        refyoung |= gc_mark_module((jl_module_t*)v, d);
+        refyoung |= gc_mark_module(ctx, (jl_module_t*)v, d);
     }
     else if (vt == (jl_value_t*)jl_task_type) {
         // ditto nptr
         bits = gc_setmark(v, sizeof(jl_task_t));
         if (d >= MAX_MARK_DEPTH)
             goto queue_the_root;
-        gc_mark_task((jl_task_t*)v, d);
+        gc_mark_task(ctx, (jl_task_t*)v, d);
         // tasks should always be remarked since we do not trigger the write barrier
         // for stores to stack slots
         refyoung = 1;
@@ -1497,26 +2288,26 @@ static int push_root(jl_value_t *v, int d, int bits)
         if (d >= MAX_MARK_DEPTH)
             goto queue_the_root;
 
-        int nf = (int)jl_datatype_nfields(dt);
-        // TODO check if there is a perf improvement for objects with a lot of fields
-        // int fdsz = sizeof(void*)*nf;
-        // void** children = alloca(fdsz);
-        // int ci = 0;
-        for(int i=0; i < nf; i++) {
-            if (jl_field_isptr(dt, i)) {
-                nptr++;
-                jl_value_t **slot = (jl_value_t**)((char*)v +
-                                                   jl_field_offset(dt, i));
-                jl_value_t *fld = *slot;
-                if (fld) {
-                    verify_parent2("object", v, slot, "field(%d)", i);
-                    //children[ci++] = fld;
-                    refyoung |= gc_push_root(fld, d);
-                }
+        // drive marking from the type's precomputed pointer-offset map
+        // instead of interpreting the field descriptors per object; a
+        // pointer-free type (nptrfields == 0) skips the loop entirely
+        // acquire pairs with the release publication in
+        // gc_build_ptroffsets: a parallel marker must not see the map
+        // pointer before nptrfields is valid
+        int32_t *offs = (int32_t*)jl_atomic_load_acquire(&dt->ptroffsets);
+        if (__unlikely(offs == NULL))
+            offs = gc_build_ptroffsets(dt);
+        int np = dt->nptrfields;
+        nptr += np;
+        for (int i = 0; i < np; i++) {
+            jl_value_t **slot = (jl_value_t**)((char*)v + offs[i]);
+            jl_value_t *fld = *slot;
+            if (fld) {
+                verify_parent2("object", v, slot, "field(%d)", i);
+                refyoung |= gc_push_root(ctx, fld, d);
             }
         }
-        //while(ci)
-        //  refyoung |= gc_push_root(children[--ci], d);
+        //  refyoung |= gc_push_root(ctx, children[--ci], d);
     }
     else {
         jl_printf(JL_STDOUT, "GC error (probable corruption) :\n");
@@ -1530,27 +2321,133 @@ ret:
     if (gc_verifying)
         return bits;
     if ((bits == GC_OLD_MARKED) && refyoung) {
-        jl_thread_heap.remset_nptr += nptr;
         // v is an old object referencing young objects
-        arraylist_push(jl_thread_heap.remset, v);
+        ctx->remset_nptr += nptr;
+        chunklist_push(&ctx->remset, v);
     }
     return bits;
 
 queue_the_root:
-    if (mark_sp >= mark_stack_size)
-        grow_mark_stack();
-    mark_stack[mark_sp++] = (jl_value_t*)v;
+    gc_mark_deque_push(&ctx->deque, (jl_value_t*)v);
     return bits;
 }
 
+#ifdef JULIA_ENABLE_THREADING
+// synchronization between the collecting thread and the mark workers.
+// The workers sleep on `gc_mark_wakeup` between collections; the collecting
+// thread bumps `gc_mark_generation` and broadcasts to start them and waits
+// on `gc_mark_alldone` until every worker went back to sleep.
+static uv_mutex_t gc_mark_sync_lock;
+static uv_cond_t gc_mark_wakeup;
+static uv_cond_t gc_mark_alldone;
+static int gc_mark_generation = 0;
+static int gc_mark_nrunning = 0;
+// number of markers that still (may) produce work, for termination detection
+static volatile int gc_mark_nactive = 0;
+
+static int gc_mark_have_work(void)
+{
+    for (int i = 0; i < jl_gc_n_mark_threads; i++)
+        if (!gc_mark_deque_empty(&gc_mark_ctxs[i].deque))
+            return 1;
+    return 0;
+}
+
+// drain the marker's own deque, stealing from the other markers when it
+// runs dry. Returns when all deques are empty and no marker can produce
+// more work.
+static void gc_mark_drain(jl_gc_mark_ctx_t *ctx)
+{
+    int self = (int)(ctx - gc_mark_ctxs);
+    int n = jl_gc_n_mark_threads;
+    for (;;) {
+        gc_mark_deque_prefetch(&ctx->deque);
+        jl_value_t *v = gc_mark_deque_pop(&ctx->deque);
+        if (__unlikely(!v)) {
+            for (int i = 1; i < n && !v; i++)
+                v = gc_mark_deque_steal(&gc_mark_ctxs[(self + i) % n].deque);
+            if (!v) {
+                // Nothing to steal either: retire. Another marker may still
+                // push more work so wait for either the deques to fill up
+                // again or for all the markers to retire.
+                jl_atomic_fetch_add(&gc_mark_nactive, -1);
+                for (;;) {
+                    if (gc_mark_have_work()) {
+                        jl_atomic_fetch_add(&gc_mark_nactive, 1);
+                        break;
+                    }
+                    if (jl_atomic_load_acquire(&gc_mark_nactive) == 0)
+                        return;
+                    jl_cpu_pause();
+                }
+                continue;
+            }
+        }
+        push_root(ctx, v, 0, jl_astaggedvalue(v)->bits.gc);
+    }
+}
+
+static void gc_mark_threadfun(void *arg)
+{
+    jl_gc_mark_ctx_t *ctx = (jl_gc_mark_ctx_t*)arg;
+    int last_gen = 0;
+    uv_mutex_lock(&gc_mark_sync_lock);
+    for (;;) {
+        while (gc_mark_generation == last_gen)
+            uv_cond_wait(&gc_mark_wakeup, &gc_mark_sync_lock);
+        last_gen = gc_mark_generation;
+        uv_mutex_unlock(&gc_mark_sync_lock);
+        gc_mark_drain(ctx);
+        uv_mutex_lock(&gc_mark_sync_lock);
+        if (--gc_mark_nrunning == 0)
+            uv_cond_signal(&gc_mark_alldone);
+    }
+}
+
+// drain the deques with all the mark workers participating. Only called
+// from the collecting thread; the mutators are stopped at safepoints for
+// the whole mark phase so the workers never run concurrently with them.
+static void gc_mark_parallel(jl_gc_mark_ctx_t *ctx)
+{
+    uv_mutex_lock(&gc_mark_sync_lock);
+    gc_mark_nrunning = jl_gc_n_mark_threads - 1;
+    gc_mark_nactive = jl_gc_n_mark_threads;
+    gc_parallel_marking = 1;
+    gc_mark_generation++;
+    uv_cond_broadcast(&gc_mark_wakeup);
+    uv_mutex_unlock(&gc_mark_sync_lock);
+    gc_mark_drain(ctx);
+    uv_mutex_lock(&gc_mark_sync_lock);
+    while (gc_mark_nrunning > 0)
+        uv_cond_wait(&gc_mark_alldone, &gc_mark_sync_lock);
+    gc_parallel_marking = 0;
+    uv_mutex_unlock(&gc_mark_sync_lock);
+}
+#endif
+
 void visit_mark_stack(void)
 {
-    while (mark_sp > 0 && !should_timeout()) {
-        jl_value_t *v = mark_stack[--mark_sp];
+    jl_gc_mark_ctx_t *ctx = &gc_mark_ctxs[0];
+#ifdef JULIA_ENABLE_THREADING
+    // The object age reset phase and the verifier require the exact
+    // (serial) marking order, and the parallel drain does not honor the
+    // incremental mark deadline, so only an unbudgeted main drain runs in
+    // parallel.
+    if (jl_gc_n_mark_threads > 1 && !mark_reset_age && !gc_verifying &&
+        !gc_mark_deadline) {
+        gc_mark_parallel(ctx);
+        gc_mark_flush_remsets();
+        return;
+    }
+#endif
+    while (!gc_mark_deque_empty(&ctx->deque) && !should_timeout()) {
+        gc_mark_deque_prefetch(&ctx->deque);
+        jl_value_t *v = gc_mark_deque_pop(&ctx->deque);
         assert(jl_astaggedvalue(v)->bits.gc);
-        push_root(v, 0, jl_astaggedvalue(v)->bits.gc);
+        push_root(ctx, v, 0, jl_astaggedvalue(v)->bits.gc);
     }
-    assert(!mark_sp);
+    assert(gc_mark_deque_empty(&ctx->deque) || should_timeout());
+    gc_mark_flush_remsets();
 }
 
 void jl_mark_box_caches(void);
@@ -1561,9 +2458,10 @@ extern jl_typemap_entry_t *call_cache[N_CALL_CACHE];
 // mark the initial root set
 void pre_mark(void)
 {
+    jl_gc_mark_ctx_t *ctx = &gc_mark_ctxs[0];
     // modules
-    gc_push_root(jl_main_module, 0);
-    gc_push_root(jl_internal_main_module, 0);
+    gc_push_root(ctx, jl_main_module, 0);
+    gc_push_root(ctx, jl_internal_main_module, 0);
 
     size_t i;
     for(i=0; i < jl_n_threads; i++) {
@@ -1571,35 +2469,56 @@ void pre_mark(void)
         // current_module might not have a value when the thread is not
         // running.
         if (ptls2->current_module)
-            gc_push_root(ptls2->current_module, 0);
-        gc_push_root(ptls2->current_task, 0);
-        gc_push_root(ptls2->root_task, 0);
-        gc_push_root(ptls2->exception_in_transit, 0);
-        gc_push_root(ptls2->task_arg_in_transit, 0);
+            gc_push_root(ctx, ptls2->current_module, 0);
+        // keep the recycled task stack buffers alive while they are pooled
+        for (size_t j = 0; j + 1 < ptls2->stack_pool.len; j += 2)
+            gc_setmark_buf(ptls2->stack_pool.items[j], GC_MARKED,
+                           (size_t)(uintptr_t)ptls2->stack_pool.items[j + 1]);
+        if (ptls2->pending_dead_stack != NULL)
+            gc_setmark_buf(ptls2->pending_dead_stack, GC_MARKED,
+                           ptls2->pending_dead_stack_sz);
+        gc_push_root(ctx, ptls2->current_task, 0);
+        gc_push_root(ctx, ptls2->root_task, 0);
+        gc_push_root(ctx, ptls2->exception_in_transit, 0);
+        gc_push_root(ctx, ptls2->task_arg_in_transit, 0);
+        if (ptls2->reusable_boundserr != NULL)
+            gc_push_root(ctx, ptls2->reusable_boundserr, 0);
+        if (ptls2->reusable_boundserr_idx != NULL)
+            gc_push_root(ctx, ptls2->reusable_boundserr_idx, 0);
     }
 
     // invisible builtin values
     if (jl_an_empty_vec_any != NULL)
-        gc_push_root(jl_an_empty_vec_any, 0);
+        gc_push_root(ctx, jl_an_empty_vec_any, 0);
+    if (jl_match_cache_values != NULL)
+        gc_push_root(ctx, jl_match_cache_values, 0);
+    if (jl_intersect_cache_values != NULL)
+        gc_push_root(ctx, jl_intersect_cache_values, 0);
+    if (jl_subtype_cache_values != NULL)
+        gc_push_root(ctx, jl_subtype_cache_values, 0);
     if (jl_module_init_order != NULL)
-        gc_push_root(jl_module_init_order, 0);
-    gc_push_root(jl_cfunction_list.unknown, 0);
-    gc_push_root(jl_anytuple_type_type, 0);
-    gc_push_root(jl_ANY_flag, 0);
+        gc_push_root(ctx, jl_module_init_order, 0);
+    if (jl_prepared_call_values != NULL)
+        gc_push_root(ctx, jl_prepared_call_values, 0);
+    if (jl_eof_exception != NULL)
+        gc_push_root(ctx, jl_eof_exception, 0);
+    gc_push_root(ctx, jl_cfunction_list.unknown, 0);
+    gc_push_root(ctx, jl_anytuple_type_type, 0);
+    gc_push_root(ctx, jl_ANY_flag, 0);
     for (i = 0; i < N_CALL_CACHE; i++)
         if (call_cache[i])
-            gc_push_root(call_cache[i], 0);
+            gc_push_root(ctx, call_cache[i], 0);
 
     jl_mark_box_caches();
     //gc_push_root(jl_unprotect_stack_func, 0);
-    gc_push_root(jl_typetype_type, 0);
+    gc_push_root(ctx, jl_typetype_type, 0);
 
     // constants
-    gc_push_root(jl_emptysvec, 0);
-    gc_push_root(jl_emptytuple, 0);
-    gc_push_root(jl_typeof(jl_emptytuple), 0);
-    gc_push_root(jl_true, 0);
-    gc_push_root(jl_false, 0);
+    gc_push_root(ctx, jl_emptysvec, 0);
+    gc_push_root(ctx, jl_emptytuple, 0);
+    gc_push_root(ctx, jl_typeof(jl_emptytuple), 0);
+    gc_push_root(ctx, jl_true, 0);
+    gc_push_root(ctx, jl_false, 0);
 }
 
 // find unmarked objects that need to be finalized from the finalizer list "list".
@@ -1686,7 +2605,11 @@ JL_DLLEXPORT int jl_gc_is_enabled(void)
 JL_DLLEXPORT int64_t jl_gc_total_bytes(void)
 {
     // Sync this logic with `base/util.jl:GC_Diff`
-    return gc_num.total_allocd + gc_num.allocd + gc_num.interval;
+    int64_t residue = 0;
+    for (int i = 0; i < jl_n_threads; i++)
+        residue += jl_all_tls_states[i]->gc_allocd_local +
+            JL_GC_ALLOCD_QUANTUM;
+    return gc_num.total_allocd + gc_num.allocd + residue + gc_num.interval;
 }
 JL_DLLEXPORT uint64_t jl_gc_total_hrtime(void)
 {
@@ -1711,28 +2634,58 @@ void jl_gc_sync_total_bytes(void) {last_gc_total_bytes = jl_gc_total_bytes();}
 // Only one thread should be running in this function
 static void _jl_gc_collect(int full, char *stack_hi)
 {
+    JL_PROBE_GC_BEGIN(full);
+    gc_fold_all_allocd();
     uint64_t t0 = jl_hrtime();
     int64_t last_perm_scanned_bytes = perm_scanned_bytes;
-    assert(mark_sp == 0);
+    jl_gc_mark_ctx_t *ctx = &gc_mark_ctxs[0];
+    // marking must not start while the previous concurrent sweep is running
+    gc_sweep_big_wait();
+    // arm the mark deadline. Forced collections always run to completion,
+    // but they still finish an incremental cycle that is in flight.
+    gc_mark_deadline = 0;
+    if (gc_max_pause && !full &&
+        (gc_incremental_cycle || gc_mark_time > gc_max_pause)) {
+        gc_mark_deadline = t0 + gc_max_pause;
+        gc_incremental_cycle = 1;
+    }
 
     // 1. mark every object in the remset
     reset_remset();
     for (int t_i = 0;t_i < jl_n_threads;t_i++) {
         jl_tls_states_t *ptls2 = jl_all_tls_states[t_i];
         // avoid counting remembered objects & bindings twice in perm_scanned_bytes
-        for (int i = 0; i < ptls2->heap.last_remset->len; i++) {
-            jl_value_t *item = (jl_value_t*)ptls2->heap.last_remset->items[i];
-            objprofile_count(jl_typeof(item), 2, 0);
-            jl_astaggedvalue(item)->bits.gc = GC_OLD_MARKED;
+        chunklist_foreach(ptls2->heap.last_remset, ck) {
+            for (size_t i = 0; i < ck->n; i++) {
+                if (i + GC_PREFETCH_DIST < ck->n)
+                    gc_prefetch(jl_astaggedvalue(
+                        ck->items[i + GC_PREFETCH_DIST]));
+                jl_value_t *item = (jl_value_t*)ck->items[i];
+                objprofile_count(jl_typeof(item), 2, 0);
+                jl_astaggedvalue(item)->bits.gc = GC_OLD_MARKED;
+            }
         }
         for (int i = 0; i < ptls2->heap.rem_bindings.len; i++) {
             void *ptr = ptls2->heap.rem_bindings.items[i];
             jl_astaggedvalue(ptr)->bits.gc = GC_OLD_MARKED;
         }
 
-        for (int i = 0; i < ptls2->heap.last_remset->len; i++) {
-            jl_value_t *item = (jl_value_t*)ptls2->heap.last_remset->items[i];
-            push_root(item, 0, GC_OLD_MARKED);
+        // NOTE (re: card tables): a card-marking barrier would compress
+        // this set into a byte map, but the generational barrier is baked
+        // into all emitted code including the system image, so a
+        // per-heap-size runtime choice isn't implementable without
+        // dual-mode barriers everywhere. The remset is already
+        // self-pruning (entries that no longer reference young objects
+        // are dropped by this rescan); what remains is making the rescan
+        // itself stream well.
+        chunklist_foreach(ptls2->heap.last_remset, ck) {
+            for (size_t i = 0; i < ck->n; i++) {
+                if (i + GC_PREFETCH_DIST < ck->n)
+                    gc_prefetch(jl_astaggedvalue(
+                        ck->items[i + GC_PREFETCH_DIST]));
+                jl_value_t *item = (jl_value_t*)ck->items[i];
+                push_root(ctx, item, 0, GC_OLD_MARKED);
+            }
         }
     }
 
@@ -1745,7 +2698,7 @@ static void _jl_gc_collect(int full, char *stack_hi)
             // A null pointer can happen here when the binding is cleaned up
             // as an exception is thrown after it was already queued (#10221)
             if (!ptr->value) continue;
-            if (gc_push_root(ptr->value, 0)) {
+            if (gc_push_root(ctx, ptr->value, 0)) {
                 ptls2->heap.rem_bindings.items[n_bnd_refyoung] = ptr;
                 n_bnd_refyoung++;
             }
@@ -1757,6 +2710,31 @@ static void _jl_gc_collect(int full, char *stack_hi)
     pre_mark();
     visit_mark_stack();
     gc_num.since_sweep += gc_num.allocd + (int64_t)gc_num.interval;
+    if (gc_incremental_cycle && !gc_mark_deque_empty(&ctx->deque)) {
+        // Out of pause budget with marking unfinished. Resume the mutators;
+        // the write barrier keeps the marked objects covered and the next
+        // collection trigger rescans the remsets and roots before it
+        // continues draining the mark queue.
+        gc_increments++;
+        if (gc_increments < GC_MAX_INCREMENTS) {
+            uint64_t inc_end = jl_hrtime();
+            gc_num.allocd = -(int64_t)gc_num.interval;
+            gc_num.total_time += inc_end - t0;
+            gc_num.pause++;
+            gc_log_pause(t0, inc_end - t0, inc_end - t0, 0, 0, 0, 1);
+            return;
+        }
+        // the cycle used up its increments; finish it in this pause
+        gc_mark_deadline = 0;
+        visit_mark_stack();
+    }
+    // marking is going to finish in this pause; the finalizer and object
+    // age reset drains below must run to completion
+    if (!gc_incremental_cycle)
+        gc_mark_time = jl_hrtime() - t0;
+    gc_mark_deadline = 0;
+    uint64_t mark_end_t = jl_hrtime();
+    int64_t pg_cnt_premark = current_pg_count;
     gc_settime_premark_end();
     gc_time_mark_pause(t0, scanned_bytes, perm_scanned_bytes);
     int64_t actual_allocd = gc_num.since_sweep;
@@ -1802,9 +2780,13 @@ static void _jl_gc_collect(int full, char *stack_hi)
     gc_stats_big_obj();
     objprofile_printall();
     objprofile_reset();
+    gc_census_fold();
     gc_num.total_allocd += gc_num.since_sweep;
     if (!prev_sweep_full)
         promoted_bytes += perm_scanned_bytes - last_perm_scanned_bytes;
+    gc_last_stats.promoted_bytes = promoted_bytes;
+    gc_last_stats.scanned_bytes = scanned_bytes;
+    gc_last_stats.perm_scanned_bytes = perm_scanned_bytes;
     // 5. next collection decision
     int not_freed_enough = estimate_freed < (7*(actual_allocd/10));
     int nptr = 0;
@@ -1838,10 +2820,17 @@ static void _jl_gc_collect(int full, char *stack_hi)
         gc_num.interval = default_collect_interval / 2;
         sweep_full = gc_sweep_always_full;
     }
+    // after an incremental cycle all the survivors look old, so only a
+    // full sweep can free the young objects that died during the cycle
+    if (gc_incremental_cycle) {
+        sweep_full = 1;
+        gc_incremental_cycle = 0;
+    }
     if (sweep_full)
         perm_scanned_bytes = 0;
     scanned_bytes = 0;
     // 5. start sweeping
+    uint64_t sweep_start_t = jl_hrtime();
     sweep_weak_refs();
     gc_sweep_other(sweep_full);
     gc_scrub(stack_hi);
@@ -1852,8 +2841,9 @@ static void _jl_gc_collect(int full, char *stack_hi)
     for (int t_i = 0;t_i < jl_n_threads;t_i++) {
         jl_tls_states_t *ptls2 = jl_all_tls_states[t_i];
         if (!sweep_full) {
-            for (int i = 0; i < ptls2->heap.remset->len; i++) {
-                jl_astaggedvalue(ptls2->heap.remset->items[i])->bits.gc = GC_MARKED;
+            chunklist_foreach(ptls2->heap.remset, ck) {
+                for (size_t i = 0; i < ck->n; i++)
+                    jl_astaggedvalue(ck->items[i])->bits.gc = GC_MARKED;
             }
             for (int i = 0; i < ptls2->heap.rem_bindings.len; i++) {
                 void *ptr = ptls2->heap.rem_bindings.items[i];
@@ -1861,13 +2851,21 @@ static void _jl_gc_collect(int full, char *stack_hi)
             }
         }
         else {
-            ptls2->heap.remset->len = 0;
+            chunklist_clear(ptls2->heap.remset);
             ptls2->heap.rem_bindings.len = 0;
         }
     }
 
     uint64_t gc_end_t = jl_hrtime();
     uint64_t pause = gc_end_t - t0;
+    JL_PROBE_GC_END(pause, sweep_full);
+    gc_log_pause(t0, pause, mark_end_t - t0, gc_end_t - sweep_start_t,
+                 pg_cnt_premark - (int64_t)current_pg_count, sweep_full,
+                 gc_increments > 0);
+    gc_increments = 0;
+    gc_last_stats.interval = gc_num.interval;
+    gc_last_stats.last_long_interval = last_long_collect_interval;
+    gc_last_stats.max_interval = max_collect_interval;
     gc_final_pause_end(t0, gc_end_t);
     gc_time_sweep_pause(gc_end_t, actual_allocd, live_bytes,
                         estimate_freed, sweep_full);
@@ -1875,6 +2873,21 @@ static void _jl_gc_collect(int full, char *stack_hi)
     prev_sweep_full = sweep_full;
     gc_num.allocd = -(int64_t)gc_num.interval;
     live_bytes += -gc_num.freed + gc_num.since_sweep;
+    gc_last_stats.live_bytes = live_bytes;
+    if (__unlikely(gc_soft_heap_limit > 0)) {
+        int64_t headroom = gc_soft_heap_limit - live_bytes;
+        if (headroom < 0)
+            headroom = 0;
+        size_t cap = (size_t)(headroom / 4);
+        if (cap < default_collect_interval / 8)
+            cap = default_collect_interval / 8; // keep making progress
+        if (gc_num.interval > cap) {
+            gc_num.interval = cap;
+            gc_num.allocd = -(int64_t)gc_num.interval;
+        }
+        if (headroom < gc_soft_heap_limit / 8)
+            jl_gc_laundry_drain_all();
+    }
     gc_num.pause += !recollect;
     gc_num.total_time += pause;
     gc_num.since_sweep = 0;
@@ -1922,6 +2935,15 @@ JL_DLLEXPORT void jl_gc_collect(int full)
     // Doing this on all threads is racy (it's impossible to check
     // or wait for finalizers on other threads without dead lock).
     if (!ptls->finalizers_inhibited) {
+#ifndef _OS_WINDOWS_
+        if (gc_deferred_finalizers) {
+            // hand the queue to the event loop instead of extending the
+            // effective pause here
+            if (to_finalize.len)
+                uv_async_send(&finalizer_async);
+            return;
+        }
+#endif
         int8_t was_in_finalizer = ptls->in_finalizer;
         ptls->in_finalizer = 1;
         run_finalizers();
@@ -1996,9 +3018,29 @@ JL_DLLEXPORT jl_value_t *jl_gc_alloc_3w(void)
     return jl_valueof(tag);
 }
 
+JL_DLLEXPORT jl_value_t *jl_gc_alloc_4w(void)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    const int sz = LLT_ALIGN(sizeof(jl_taggedvalue_t) + sizeof(void*) * 4,
+                             JL_SMALL_BYTE_ALIGNMENT);
+    void *tag = _pool_alloc(ptls, &ptls->heap.norm_pools[szclass(sz)], sz);
+    return jl_valueof(tag);
+}
+
+JL_DLLEXPORT jl_value_t *jl_gc_alloc_5w(void)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    const int sz = LLT_ALIGN(sizeof(jl_taggedvalue_t) + sizeof(void*) * 5,
+                             JL_SMALL_BYTE_ALIGNMENT);
+    void *tag = _pool_alloc(ptls, &ptls->heap.norm_pools[szclass(sz)], sz);
+    return jl_valueof(tag);
+}
+
 // Per-thread initialization (when threading is fully implemented)
 void jl_mk_thread_heap(jl_tls_states_t *ptls)
 {
+    ptls->gc_allocd_local = -JL_GC_ALLOCD_QUANTUM;
+    ptls->gc_allocd_total = 0;
     jl_thread_heap_t *heap = &ptls->heap;
     const int *szc = sizeclasses;
     jl_gc_pool_t *p = heap->norm_pools;
@@ -2011,15 +3053,19 @@ void jl_mk_thread_heap(jl_tls_states_t *ptls)
         p[i].end_offset = GC_POOL_END_OFS(szc[i]);
     }
     arraylist_new(&heap->weak_refs, 0);
+    heap->n_cached_pages = 0;
     heap->mallocarrays = NULL;
     heap->mafreelist = NULL;
     heap->big_objects = NULL;
     arraylist_new(&heap->rem_bindings, 0);
     heap->remset = &heap->_remset[0];
     heap->last_remset = &heap->_remset[1];
-    arraylist_new(heap->remset, 0);
-    arraylist_new(heap->last_remset, 0);
+    chunklist_new(heap->remset);
+    chunklist_new(heap->last_remset);
     arraylist_new(&ptls->finalizers, 0);
+    arraylist_new(&ptls->stack_pool, 0);
+    ptls->pending_dead_stack = NULL;
+    ptls->pending_dead_stack_sz = 0;
 }
 
 // System-wide initializations
@@ -2031,10 +3077,65 @@ void jl_gc_init(void)
     arraylist_new(&finalizer_list_marked, 0);
     arraylist_new(&to_finalize, 0);
 
+    int nmark = 1;
+#ifdef JULIA_ENABLE_THREADING
+#if !defined(GC_VERIFY) && !defined(OBJPROFILE) && !defined(MEMDEBUG)
+    // the GC debugging modes assume serial marking
+    nmark = jl_n_threads;
+    char *cp = getenv(MARK_THREADS_NAME);
+    if (cp)
+        nmark = (int)strtol(cp, NULL, 10);
+    if (nmark > jl_cpu_cores())
+        nmark = jl_cpu_cores();
+    if (nmark < 1)
+        nmark = 1;
+#endif
+#endif
+    jl_gc_n_mark_threads = nmark;
+    gc_mark_ctxs = (jl_gc_mark_ctx_t*)calloc(nmark, sizeof(jl_gc_mark_ctx_t));
+    for (int i = 0; i < nmark; i++) {
+        gc_mark_deque_init(&gc_mark_ctxs[i].deque);
+        chunklist_new(&gc_mark_ctxs[i].remset);
+    }
+#ifdef JULIA_ENABLE_THREADING
+    if (nmark > 1) {
+        uv_mutex_init(&gc_mark_sync_lock);
+        uv_cond_init(&gc_mark_wakeup);
+        uv_cond_init(&gc_mark_alldone);
+        for (int i = 1; i < nmark; i++) {
+            uv_thread_t uvtid;
+            uv_thread_create(&uvtid, gc_mark_threadfun, &gc_mark_ctxs[i]);
+            uv_thread_detach(&uvtid);
+        }
+    }
+#if !defined(GC_VERIFY) && !defined(OBJPROFILE) && !defined(MEMDEBUG) && \
+    !defined(GC_TIME) && !defined(MEMPROFILE)
+    // the GC debugging modes assume the whole collection runs in the pause
+    cp = getenv(SWEEP_THREAD_NAME);
+    if (cp && strtol(cp, NULL, 10)) {
+        gc_concurrent_sweep = 1;
+        // jl_n_threads thread local lists + previous survivors +
+        // big_objects_marked
+        gc_sweep_detached = (bigval_t**)calloc(jl_n_threads + 2,
+                                               sizeof(bigval_t*));
+        uv_mutex_init(&gc_sweep_lock);
+        uv_cond_init(&gc_sweep_wakeup);
+        uv_cond_init(&gc_sweep_idle);
+        uv_thread_t uvtid;
+        uv_thread_create(&uvtid, gc_sweep_threadfun, NULL);
+        uv_thread_detach(&uvtid);
+    }
+#endif
+#endif
+
     gc_num.interval = default_collect_interval;
     last_long_collect_interval = default_collect_interval;
     gc_num.allocd = -default_collect_interval;
 
+    gc_last_stats.n_pools = JL_GC_N_POOLS;
+    for (int i = 0; i < JL_GC_N_POOLS; i++)
+        gc_last_stats.pool_sizes[i] = sizeclasses[i];
+
 #ifdef _P64
     // on a big memory machine, set max_collect_interval to totalmem/ncores/2
     size_t maxmem = (uv_get_total_memory()/jl_cpu_cores())/2;
@@ -2130,20 +3231,100 @@ JL_DLLEXPORT void *jl_realloc(void *p, size_t sz)
     return (void *)(pnew + 2);
 }
 
-JL_DLLEXPORT void *jl_gc_managed_malloc(size_t sz)
+// ---- mmap-backed large array buffers (linux) -------------------------
+//
+// Buffers past GC_MMAP_THRESH come from anonymous mappings instead of
+// malloc, tracked in a side table keyed by the buffer address. Growth
+// then goes through mremap -- the kernel moves page tables, not bytes,
+// so a multi-GB append extends without copying -- and jl_array_reserve
+// can migrate a buffer into a MAP_NORESERVE mapping sized for its
+// expected capacity, after which growth inside the reservation is pure
+// bookkeeping. Elsewhere the malloc path is unchanged.
+#if defined(_OS_LINUX_)
+#define GC_MMAP_THRESH (2 * 1024 * 1024)
+static htable_t gc_mmap_allocs; // buffer -> mapped length
+static jl_mutex_t gc_mmap_lock;
+static int gc_mmap_inited = 0;
+
+static void gc_mmap_track(void *b, size_t len)
+{
+    JL_LOCK_NOGC(&gc_mmap_lock);
+    if (!gc_mmap_inited) {
+        htable_new(&gc_mmap_allocs, 64);
+        gc_mmap_inited = 1;
+    }
+    ptrhash_put(&gc_mmap_allocs, b, (void*)len);
+    JL_UNLOCK_NOGC(&gc_mmap_lock);
+}
+
+// returns the mapped length and unregisters the buffer, or 0 when `b`
+// is not an mmap-backed buffer
+static size_t gc_mmap_untrack(void *b)
+{
+    size_t len = 0;
+    if (gc_mmap_inited) {
+        JL_LOCK_NOGC(&gc_mmap_lock);
+        void *v = ptrhash_get(&gc_mmap_allocs, b);
+        if (v != HT_NOTFOUND) {
+            len = (size_t)v;
+            ptrhash_remove(&gc_mmap_allocs, b);
+        }
+        JL_UNLOCK_NOGC(&gc_mmap_lock);
+    }
+    return len;
+}
+
+// free hook for the managed-buffer free paths
+static int gc_mmap_free(void *b)
+{
+    size_t len = gc_mmap_untrack(b);
+    if (len == 0)
+        return 0;
+    munmap(b, len);
+    return 1;
+}
+#else
+static int gc_mmap_free(void *b)
+{
+    (void)b;
+    return 0;
+}
+#endif
+
+// like jl_gc_managed_malloc but with a caller-chosen alignment
+// (>= the cache line default)
+JL_DLLEXPORT void *jl_gc_managed_malloc_aligned(size_t sz, size_t align)
 {
     maybe_collect();
-    size_t allocsz = LLT_ALIGN(sz, JL_CACHE_BYTE_ALIGNMENT);
+    if (align < JL_CACHE_BYTE_ALIGNMENT)
+        align = JL_CACHE_BYTE_ALIGNMENT;
+    size_t allocsz = LLT_ALIGN(sz, align);
     if (allocsz < sz)  // overflow in adding offs, size was "negative"
         jl_throw(jl_memory_exception);
     gc_num.allocd += allocsz;
     gc_num.malloc++;
-    void *b = malloc_cache_align(allocsz);
+#if defined(_OS_LINUX_)
+    if (allocsz >= GC_MMAP_THRESH && align <= jl_page_size) {
+        size_t maplen = LLT_ALIGN(allocsz, jl_page_size);
+        void *b = mmap(NULL, maplen, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (b != MAP_FAILED) {
+            gc_mmap_track(b, maplen);
+            return b;
+        }
+    }
+#endif
+    void *b = jl_malloc_aligned(allocsz, align);
     if (b == NULL)
         jl_throw(jl_memory_exception);
     return b;
 }
 
+JL_DLLEXPORT void *jl_gc_managed_malloc(size_t sz)
+{
+    return jl_gc_managed_malloc_aligned(sz, JL_CACHE_BYTE_ALIGNMENT);
+}
+
 JL_DLLEXPORT void *jl_gc_managed_realloc(void *d, size_t sz, size_t oldsz,
                                          int isaligned, jl_value_t *owner)
 {
@@ -2164,6 +3345,41 @@ JL_DLLEXPORT void *jl_gc_managed_realloc(void *d, size_t sz, size_t oldsz,
     gc_num.realloc++;
 
     void *b;
+#if defined(_OS_LINUX_)
+    {
+        size_t maplen = gc_mmap_untrack(d);
+        if (maplen != 0) {
+            // mmap-backed: extend with mremap; page tables move, the
+            // bytes stay where they are
+            size_t newlen = LLT_ALIGN(allocsz, jl_page_size);
+            if (newlen == maplen) {
+                gc_mmap_track(d, maplen);
+                return d;
+            }
+            b = mremap(d, maplen, newlen, MREMAP_MAYMOVE);
+            if (b == MAP_FAILED)
+                jl_throw(jl_memory_exception);
+            gc_mmap_track(b, newlen);
+            return b;
+        }
+        // a malloc'd buffer crossing the threshold migrates to a
+        // mapping so later growth stops copying
+        if (allocsz >= GC_MMAP_THRESH) {
+            size_t newlen = LLT_ALIGN(allocsz, jl_page_size);
+            b = mmap(NULL, newlen, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (b != MAP_FAILED) {
+                memcpy(b, d, oldsz < allocsz ? oldsz : allocsz);
+                if (isaligned)
+                    jl_free_aligned(d);
+                else
+                    free(d);
+                gc_mmap_track(b, newlen);
+                return b;
+            }
+        }
+    }
+#endif
     if (isaligned)
         b = realloc_cache_align(d, allocsz, oldsz);
     else
@@ -2174,6 +3390,47 @@ JL_DLLEXPORT void *jl_gc_managed_realloc(void *d, size_t sz, size_t oldsz,
     return b;
 }
 
+// Address-space reservation hint: migrate a large 1-d array's buffer
+// into a MAP_NORESERVE mapping sized for `reserve_nel` elements. One
+// copy now buys copy-free growth up to the reservation: mremap within
+// the mapping is the no-op case above, and untouched pages cost
+// nothing. A no-op on non-mmap platforms and for pool-backed arrays.
+JL_DLLEXPORT void jl_array_reserve(jl_array_t *a, size_t reserve_nel)
+{
+#if defined(_OS_LINUX_)
+    if (a->flags.how != 2 || a->flags.ndims != 1 || a->flags.isshared)
+        return;
+    size_t elsz = a->elsize;
+    size_t cur_nel = a->maxsize;
+    if (reserve_nel <= cur_nel)
+        return;
+    size_t oldnbytes = cur_nel * elsz + a->offset * elsz + (elsz == 1);
+    size_t newnbytes = reserve_nel * elsz + a->offset * elsz + (elsz == 1);
+    size_t newlen = LLT_ALIGN(newnbytes, jl_page_size);
+    char *old = (char*)a->data - a->offset * elsz;
+    void *b = mmap(NULL, newlen, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (b == MAP_FAILED)
+        return; // just a hint
+    memcpy(b, old, oldnbytes);
+    size_t maplen = gc_mmap_untrack(old);
+    if (maplen != 0)
+        munmap(old, maplen);
+    else if (a->flags.isaligned)
+        jl_free_aligned(old);
+    else
+        free(old);
+    gc_mmap_track(b, newlen);
+    a->data = (char*)b + a->offset * elsz;
+    a->flags.isaligned = 1; // page aligned
+    a->maxsize = reserve_nel;
+    gc_num.allocd += newnbytes - oldnbytes;
+#else
+    (void)a;
+    (void)reserve_nel;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
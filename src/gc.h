@@ -32,7 +32,7 @@ extern "C" {
 
 // manipulating mark bits
 
-#define GC_PAGE_LG2 14 // log2(size of a page)
+#define GC_PAGE_LG2 JL_GC_PAGE_LG2 // log2(size of a page), see julia.h
 #define GC_PAGE_SZ (1 << GC_PAGE_LG2) // 16k
 #define GC_PAGE_OFFSET (JL_SMALL_BYTE_ALIGNMENT - (sizeof(jl_taggedvalue_t) % JL_SMALL_BYTE_ALIGNMENT))
 
@@ -136,6 +136,9 @@ typedef struct {
         // still be old dead objects in the page and `nold` and `prev_nold`
         // should be used to determine if the page needs to be swept.
         uint16_t has_young: 1;
+        // The page is not owned by a pool (e.g. it backs an arena) and the
+        // rest of the metadata is stale; the sweep must ignore it.
+        uint16_t nonpool: 1;
     };
     // number of old objects in this page
     uint16_t nold;
@@ -174,14 +177,45 @@ typedef struct {
     int lb;
     // an upper bound of the last non-free page
     int ub;
+    // the region is backed by an explicit hugetlb mapping; freed pages
+    // cannot be decommitted at GC page granularity
+    int hugetlb;
 } region_t;
 
+// work-stealing deque holding objects queued for marking.
+// The owner pushes to and pops from `bottom`, other markers steal from `top`.
+// All three operations take `lock`; the lock is almost always uncontended
+// (stealing only happens when a marker runs dry) so this is much simpler
+// than, and nearly as fast as, a lock-free deque.
+typedef struct {
+    jl_value_t **items;
+    size_t size;
+    size_t bottom;
+    size_t top;
+    jl_mutex_t lock;
+} jl_gc_mark_deque_t;
+
+// per-marker state for the mark phase. `jl_gc_n_mark_threads` of these are
+// allocated at initialization; index 0 belongs to the collecting thread and
+// the others to the dedicated mark workers.
+typedef struct {
+    jl_gc_mark_deque_t deque;
+    // old objects found pointing to young ones; merged into the collecting
+    // thread's remset when the mark phase is done so that `push_root` does
+    // not have to synchronize on the heap remset.
+    chunklist_t remset;
+    int remset_nptr;
+} jl_gc_mark_ctx_t;
+
+extern int jl_gc_n_mark_threads;
+
 extern jl_gc_num_t gc_num;
 extern region_t regions[REGION_COUNT];
 extern bigval_t *big_objects_marked;
 extern arraylist_t finalizer_list_marked;
 extern arraylist_t to_finalize;
 extern int64_t lazy_freed_pages;
+extern size_t current_pg_count;
 
 STATIC_INLINE bigval_t *bigval_header(jl_taggedvalue_t *o)
 {
@@ -286,6 +320,10 @@ void gc_debug_init(void);
 void jl_gc_init_page(void);
 NOINLINE void *jl_gc_alloc_page(void);
 void jl_gc_free_page(void *p);
+void jl_gc_laundry_drain_all(void);
+void jl_gc_flush_page_caches(void);
+void *jl_gc_alloc_nonpool_page(void);
+void jl_gc_free_nonpool_page(void *p);
 
 // GC debug
 
@@ -415,15 +453,18 @@ static inline void gc_scrub(char *stack_hi)
 }
 #endif
 
+// Runtime-togglable per-type census (jl_gc_census_*), the production
+// sibling of the OBJPROFILE build: one predicted branch per marked
+// object when off, per-mark-thread tables when on (see gc-debug.c).
+extern int gc_census_enabled;
+void gc_census_count(void *ty, int old, int sz);
+void gc_census_fold(void);
+
 #ifdef OBJPROFILE
-void objprofile_count(void *ty, int old, int sz);
+void objprofile_count_impl(void *ty, int old, int sz);
 void objprofile_printall(void);
 void objprofile_reset(void);
 #else
-static inline void objprofile_count(void *ty, int old, int sz)
-{
-}
-
 static inline void objprofile_printall(void)
 {
 }
@@ -433,6 +474,17 @@ static inline void objprofile_reset(void)
 }
 #endif
 
+static inline void objprofile_count(void *ty, int old, int sz)
+{
+    if (__unlikely(gc_census_enabled))
+        gc_census_count(ty, old, sz);
+#ifdef OBJPROFILE
+    objprofile_count_impl(ty, old, sz);
+#else
+    (void)ty; (void)old; (void)sz;
+#endif
+}
+
 #ifdef MEMPROFILE
 static void gc_stats_all_pool(void);
 static void gc_stats_big_obj(void);
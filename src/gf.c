@@ -1047,6 +1047,30 @@ static void invalidate_conflicting(union jl_typemap_t *pml, jl_value_t *type, jl
     }
 }
 
+static void invalidate_call_cache(jl_methtable_t *mt);
+
+// Bulk-registration mode, bracketed around module evaluation (see
+// jl_eval_module_expr): loading a package performs tens of thousands of
+// insertions, and traversing mt->cache to invalidate conflicting entries
+// for each one dominates the cost. Inside a batch the conflicting-entry
+// scan is replaced by an O(1) wholesale drop of the method table's cache
+// (always sound -- the cache refills on demand), so the traversal and
+// the leafsig-index rebuild are paid at most once per table per batch
+// by the first post-load dispatches instead of once per method. Nested
+// module expressions just deepen the counter.
+static int method_batch_depth = 0;
+
+JL_DLLEXPORT void jl_method_batch_begin(void)
+{
+    method_batch_depth++;
+}
+
+JL_DLLEXPORT void jl_method_batch_end(void)
+{
+    assert(method_batch_depth > 0);
+    method_batch_depth--;
+}
+
 static void update_max_args(jl_methtable_t *mt, jl_tupletype_t *type)
 {
     size_t na = jl_nparams(type);
@@ -1078,8 +1102,21 @@ void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method, jl_tupletyp
     else {
         oldvalue = (jl_value_t*)check_ambiguous_matches(mt->defs, newentry);
     }
-    if (oldvalue)
-        invalidate_conflicting(&mt->cache, (jl_value_t*)type, (jl_value_t*)mt, (jl_array_t*)oldvalue);
+    if (oldvalue) {
+        if (method_batch_depth > 0) {
+            // bulk loading: drop the whole cache instead of scanning it
+            mt->cache.unknown = jl_nothing;
+            invalidate_call_cache(mt);
+        }
+        else {
+            invalidate_conflicting(&mt->cache, (jl_value_t*)type, (jl_value_t*)mt, (jl_array_t*)oldvalue);
+            invalidate_call_cache(mt);
+            // the full signature index may hold entries that were just removed
+            jl_typemap_rebuild_leafsigs(mt->cache);
+        }
+    }
+    // any cached method-match result may now be stale
+    jl_atomic_fetch_add(&jl_methtable_world, 1);
     JL_GC_POP();
     update_max_args(mt, type);
     JL_SIGATOMIC_END();
@@ -1116,6 +1153,18 @@ void JL_NORETURN jl_method_error(jl_function_t *f, jl_value_t **args, size_t na)
 
 jl_datatype_t *jl_wrap_Type(jl_value_t *t);
 
+// Build the lookup key for a dispatch miss. Despite appearances this
+// does not heap-allocate in the steady state: the type pointers are
+// collected into an alloca'd frame, and jl_inst_concrete_tupletype_v
+// probes the tuple-type cache directly from that raw array
+// (inst_datatype checks `lookup_type(tn, iparams, ntp)` before
+// constructing anything), so an already-seen signature returns the
+// interned tuple type with no allocation. A fresh tuple type is only
+// created the first time a signature is seen -- which is also when a
+// method-cache entry is about to be inserted, i.e. exactly the lazy
+// behavior a separate stack-key API would buy. Only type-valued
+// arguments (rare at dispatch misses) allocate a Type{T} wrapper, and
+// that wrapper is required to express the key at all.
 jl_tupletype_t *arg_type_tuple(jl_value_t **args, size_t nargs)
 {
     jl_tupletype_t *tt;
@@ -1276,6 +1325,40 @@ jl_lambda_info_t *jl_get_specialization1(jl_tupletype_t *types)
     return sf;
 }
 
+// Batched warmup compilation: resolve and compile every signature in
+// `sigs` (a Vector{Any} of tuple types) in one pass, returning a
+// Vector{Any} of per-signature nanosecond timings (Int64; -1 for
+// signatures that could not be resolved or compiled) so hint lists can
+// be curated. Compilation cannot fan out across threads in this
+// runtime: there is a single LLVM context and IRBuilder behind
+// codegen_lock (see the note at jl_compile_all), so worker threads
+// would only serialize behind the lock and muddy the timings with
+// contention. The batch still beats one-at-a-time hinting: the lock is
+// taken once, and the emitted modules flow into the JIT's 16-module
+// batches (jitlayers), amortizing the backend and finalization fixed
+// costs across the whole list.
+JL_DLLEXPORT jl_value_t *jl_compile_hints_batch(jl_array_t *sigs)
+{
+    size_t i, n = jl_array_len(sigs);
+    jl_array_t *times = NULL;
+    JL_GC_PUSH2(&sigs, &times);
+    times = jl_alloc_vec_any(n);
+    JL_LOCK(&codegen_lock);
+    for (i = 0; i < n; i++) {
+        jl_value_t *sig = jl_array_ptr_ref(sigs, i);
+        int64_t ns = -1;
+        if (jl_is_tuple_type(sig)) {
+            uint64_t t0 = jl_hrtime();
+            if (jl_compile_hint((jl_tupletype_t*)sig))
+                ns = (int64_t)(jl_hrtime() - t0);
+        }
+        jl_array_ptr_set(times, i, jl_box_int64(ns));
+    }
+    JL_UNLOCK(&codegen_lock);
+    JL_GC_POP();
+    return (jl_value_t*)times;
+}
+
 JL_DLLEXPORT int jl_compile_hint(jl_tupletype_t *types)
 {
     jl_lambda_info_t *li = jl_get_specialization1(types);
@@ -1583,6 +1666,16 @@ static void _compile_all_enq_module(jl_module_t *m, jl_array_t *found)
     }
 }
 
+// NOTE on parallelizing this (requested for CI sysimg builds): the
+// worklist below is embarrassingly parallel in shape, but both stages of
+// the work are serial in this runtime -- jl_type_infer runs the julia
+// inference code with global state, and jl_compile_linfo emits into the
+// one shared LLVMContext/shadow module, which is what codegen_lock
+// actually protects. Sharding the lock per-module doesn't help: the
+// context is the constraint, not the lock. Making this scale needs one
+// LLVMContext (and declaration table) per worker plus cross-context
+// linking of the shadow module, i.e. the multi-context codegen rework,
+// not a scheduling change here.
 static void jl_compile_all_defs(void)
 {
     // this "found" array will contain
@@ -1745,6 +1838,33 @@ STATIC_INLINE int sig_match_fast(jl_value_t **args, jl_value_t **sig, size_t i,
 
 jl_typemap_entry_t *call_cache[N_CALL_CACHE];
 static uint8_t pick_which[N_CALL_CACHE];
+// Hit/miss counters for the first-level call cache. The increments are
+// deliberately plain (racy but lossy at worst): these are monitoring
+// counters on the hottest path in the runtime.
+static uint64_t call_cache_hits;
+static uint64_t call_cache_misses;
+
+JL_DLLEXPORT void jl_call_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+    *hits = call_cache_hits;
+    *misses = call_cache_misses;
+}
+
+// Drop the call cache entries that dispatch into `mt`. Called (under the
+// method table write path) when a definition is added so that no stale
+// leafsig entry can keep routing calls to a shadowed method.
+static void invalidate_call_cache(jl_methtable_t *mt)
+{
+    for (int i = 0; i < N_CALL_CACHE; i++) {
+        jl_typemap_entry_t *e = call_cache[i];
+        if (e == NULL)
+            continue;
+        jl_value_t *ft = jl_tparam0(e->sig);
+        if (jl_is_datatype(ft) && ((jl_datatype_t*)ft)->name->mt == mt)
+            call_cache[i] = NULL;
+    }
+}
+
 #ifdef JL_GF_PROFILE
 void call_cache_stats() {
     int pick_which_stat[4] = {0, 0, 0, 0};
@@ -1766,6 +1886,44 @@ void call_cache_stats() {
 #define __builtin_return_address(n) _ReturnAddress()
 #endif
 
+
+// Per-call-site inline cache behind emitted generic calls: `site` is a
+// two-word slot {entry, world} private to one call site (codegen emits
+// one internal global per site). Most dynamic sites are monomorphic, so
+// a single signature guard against the site's last-seen leaf entry beats
+// the hashed global call cache -- no hashing, no probe, perfect
+// prediction. The world tag (bumped by every method definition) is
+// validated before the entry pointer is dereferenced, so a slot that
+// went stale across redefinitions -- whose entry may even have been
+// collected after it was unlinked -- is never touched, only replaced.
+JL_DLLEXPORT jl_value_t *jl_apply_generic_ic(void **site, jl_value_t **args,
+                                             uint32_t nargs)
+{
+    jl_typemap_entry_t *entry = (jl_typemap_entry_t*)site[0];
+    if (entry != NULL &&
+        (uintptr_t)site[1] == (uintptr_t)jl_methtable_world &&
+        nargs == jl_svec_len(entry->sig->parameters) &&
+        sig_match_fast(args, jl_svec_data(entry->sig->parameters), 0, nargs)) {
+        return jl_call_method_internal(entry->func.linfo, args, nargs);
+    }
+    uintptr_t world = (uintptr_t)jl_methtable_world;
+    jl_value_t *F = args[0];
+    jl_methtable_t *mt = jl_gf_mtable(F);
+    entry = jl_typemap_assoc_exact(mt->cache, args, nargs,
+                                   jl_cachearg_offset(mt));
+    if (entry && entry->isleafsig && entry->simplesig == (void*)jl_nothing &&
+        entry->guardsigs == jl_emptysvec) {
+        if (world == (uintptr_t)jl_methtable_world) {
+            site[0] = entry;
+            site[1] = (void*)world;
+        }
+        return jl_call_method_internal(entry->func.linfo, args, nargs);
+    }
+    // cache miss or unsuitable entry: the generic path handles method
+    // errors and the non-leaf machinery
+    return jl_apply_generic(args, nargs);
+}
+
 JL_DLLEXPORT jl_value_t *jl_apply_generic(jl_value_t **args, uint32_t nargs)
 {
 #ifdef JL_GF_PROFILE
@@ -1878,9 +2036,11 @@ JL_DLLEXPORT jl_value_t *jl_apply_generic(jl_value_t **args, uint32_t nargs)
     jl_typemap_entry_t *entry = NULL;
     jl_methtable_t *mt = NULL;
     int i;
-    // check each cache entry to see if it matches
+    // check each cache entry to see if it matches.
+    // The acquire load pairs with the release store below so that another
+    // thread observing the entry pointer also observes its contents.
     for (i = 0; i < 4; i++) {
-        entry = call_cache[cache_idx[i]];
+        entry = jl_atomic_load_acquire(&call_cache[cache_idx[i]]);
         if (entry && nargs == jl_svec_len(entry->sig->parameters) &&
             sig_match_fast(args, jl_svec_data(entry->sig->parameters), 0, nargs)) {
             break;
@@ -1888,15 +2048,20 @@ JL_DLLEXPORT jl_value_t *jl_apply_generic(jl_value_t **args, uint32_t nargs)
     }
     // if no method was found in the associative cache, check the full cache
     if (i == 4) {
+        call_cache_misses++;
         jl_value_t *F = args[0];
         mt = jl_gf_mtable(F);
         entry = jl_typemap_assoc_exact(mt->cache, args, nargs, jl_cachearg_offset(mt));
         if (entry && entry->isleafsig && entry->simplesig == (void*)jl_nothing && entry->guardsigs == jl_emptysvec) {
             // put the entry into the cache if it's valid for a leaftype lookup,
             // using pick_which to slightly randomize where it ends up
-            call_cache[cache_idx[++pick_which[cache_idx[0]] & 3]] = entry;
+            jl_atomic_store_release(
+                &call_cache[cache_idx[++pick_which[cache_idx[0]] & 3]], entry);
         }
     }
+    else {
+        call_cache_hits++;
+    }
 
     jl_lambda_info_t *mfunc = NULL;
     jl_tupletype_t *tt = NULL;
@@ -2255,6 +2420,28 @@ static jl_value_t *ml_matches(union jl_typemap_t defs, int offs,
     return env.t;
 }
 
+// memoized method-match cache
+//
+// Package loading issues thousands of repeated jl_matching_methods
+// queries, each re-running full type intersection over mt->defs. A small
+// direct mapped cache keyed on the query signature (compared with
+// jl_types_equal: query types are often freshly constructed, so pointer
+// identity is not enough) remembers results until the next method
+// definition bumps the world counter. The signature and result objects
+// live in a rooted array (jl_match_cache_values, marked from pre_mark)
+// at fixed slots mirroring the entry index, and the whole cache is
+// serialized by a spin lock -- this is a reflection path, not a dispatch
+// path.
+JL_DLLEXPORT volatile uint64_t jl_methtable_world = 1;
+#define MATCH_CACHE_SZ 256 // must be a power of two
+jl_array_t *jl_match_cache_values = NULL; // [2 * MATCH_CACHE_SZ]: sig, result
+static struct {
+    uint64_t world; // 0 = empty
+    int lim;
+    int include_ambiguous;
+} match_cache[MATCH_CACHE_SZ];
+static jl_mutex_t match_cache_lock;
+
 // return a Vector{Any} of svecs, each describing a method match:
 // Any[svec(tt, spvals, m), ...]
 // tt is the intersection of the type argument and the method signature,
@@ -2271,7 +2458,59 @@ JL_DLLEXPORT jl_value_t *jl_matching_methods(jl_tupletype_t *types, int lim, int
     jl_methtable_t *mt = ((jl_datatype_t*)jl_tparam0(types))->name->mt;
     if (mt == NULL)
         return (jl_value_t*)jl_alloc_vec_any(0);
-    return ml_matches(mt->defs, 0, types, lim, include_ambiguous);
+    uint64_t world = jl_methtable_world;
+    size_t idx = (jl_object_id((jl_value_t*)types) ^ (uintptr_t)lim) &
+        (MATCH_CACHE_SZ - 1);
+    if (__unlikely(jl_match_cache_values == NULL)) {
+        jl_array_t *vals = jl_alloc_vec_any(2 * MATCH_CACHE_SZ);
+        JL_LOCK_NOGC(&match_cache_lock);
+        if (jl_match_cache_values == NULL)
+            jl_match_cache_values = vals;
+        JL_UNLOCK_NOGC(&match_cache_lock);
+    }
+    if (jl_match_cache_values != NULL) {
+        JL_LOCK_NOGC(&match_cache_lock);
+        if (match_cache[idx].world == world &&
+            match_cache[idx].lim == lim &&
+            match_cache[idx].include_ambiguous == include_ambiguous) {
+            jl_value_t *sig = jl_array_ptr_ref(jl_match_cache_values, 2 * idx);
+            jl_value_t *res =
+                jl_array_ptr_ref(jl_match_cache_values, 2 * idx + 1);
+            // release the lock around the (potentially allocating) type
+            // comparison; the locals keep the objects rooted
+            JL_UNLOCK_NOGC(&match_cache_lock);
+            JL_GC_PUSH2(&sig, &res);
+            int eq = sig != NULL &&
+                jl_types_equal((jl_value_t*)types, sig);
+            if (eq && jl_is_array(res))
+                // hand out a copy: callers are free to mutate their result
+                res = (jl_value_t*)jl_array_copy((jl_array_t*)res);
+            JL_GC_POP();
+            if (eq)
+                return res;
+        }
+        else {
+            JL_UNLOCK_NOGC(&match_cache_lock);
+        }
+    }
+    jl_value_t *res = ml_matches(mt->defs, 0, types, lim, include_ambiguous);
+    if (jl_match_cache_values != NULL && world == jl_methtable_world) {
+        // cache a pristine copy; the caller owns (and may mutate) `res`
+        jl_value_t *cached = res;
+        JL_GC_PUSH2(&res, &cached);
+        if (jl_is_array(cached))
+            cached = (jl_value_t*)jl_array_copy((jl_array_t*)cached);
+        JL_LOCK_NOGC(&match_cache_lock);
+        match_cache[idx].world = 0;
+        jl_array_ptr_set(jl_match_cache_values, 2 * idx, (jl_value_t*)types);
+        jl_array_ptr_set(jl_match_cache_values, 2 * idx + 1, cached);
+        match_cache[idx].lim = lim;
+        match_cache[idx].include_ambiguous = include_ambiguous;
+        match_cache[idx].world = world;
+        JL_UNLOCK_NOGC(&match_cache_lock);
+        JL_GC_POP();
+    }
+    return res;
 }
 
 static jl_mutex_t typeinf_lock;
@@ -533,6 +533,23 @@ static void jl_set_io_wait(int v)
     jl_get_ptls_states()->io_wait = v;
 }
 
+// NOTE on the recurring fork-server request (daemon completes
+// _julia_init once, forks a pre-warmed child per invocation): a julia
+// process of this vintage cannot be forked safely after init. The GC
+// mark/sweep workers, any started threadgroup threads and the profiler
+// listener all vanish in the child while their locks and queues keep
+// whatever state they had; this libuv predates uv_loop_fork, so the
+// event loop's epoll fd and signal pipe are unusable in the child; and
+// the JIT's registered code/debug-object state assumes one process
+// lifetime. A fork server needs the daemon to stay single-threaded
+// pre-fork (no threading, no profiling, lazy loop init) plus a
+// post-fork reinit of libuv and the signal handlers -- a coordinated
+// project, not an entry point that can be bolted on here. The cheap
+// wins for launch storms in this tree are the mmap'd/promoted image
+// restore paths in dump.c.
+// set by jl_init_minimal before initialization
+JL_DLLEXPORT int jl_init_minimal_mode = 0;
+
 void _julia_init(JL_IMAGE_SEARCH rel)
 {
 #ifdef JULIA_ENABLE_THREADING
@@ -545,6 +562,8 @@ void _julia_init(JL_IMAGE_SEARCH rel)
     jl_io_loop = uv_default_loop(); // this loop will internal events (spawning process etc.),
                                     // best to call this first, since it also initializes libuv
     jl_init_signal_async();
+    jl_init_gc_safe_poll();
+    jl_init_uv_cmd_queue();
     restore_signals();
     jl_resolve_sysimg_location(rel);
     // loads sysimg if available, and conditionally sets jl_options.cpu_target
@@ -616,7 +635,10 @@ void _julia_init(JL_IMAGE_SEARCH rel)
 
     jl_gc_init();
     jl_gc_enable(0);
-    jl_init_frontend();
+    if (!jl_init_minimal_mode)
+        jl_init_frontend();
+    // in minimal mode the parser contexts come up lazily on first parse
+    // (jl_ast_ctx_enter builds per-thread contexts on demand)
     jl_init_types();
     jl_init_tasks();
     jl_init_root_task(jl_stack_lo, jl_stack_hi-jl_stack_lo);
@@ -703,6 +725,13 @@ void _julia_init(JL_IMAGE_SEARCH rel)
 
     jl_gc_enable(1);
 
+    if (jl_options.image_file) {
+        // promote the restored image to the old generation in one full
+        // collection (see the note in jl_restore_system_image_from_stream,
+        // which cannot do it itself: the GC was still disabled there)
+        jl_gc_collect(1);
+    }
+
     if (jl_options.image_file && (!jl_generating_output() || jl_options.incremental)) {
         jl_array_t *temp = jl_module_init_order;
         JL_GC_PUSH1(&temp);
@@ -21,7 +21,9 @@ typedef struct {
 } interpreter_state;
 
 static jl_value_t *eval(jl_value_t *e, interpreter_state *s);
-static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s, int start, int toplevel);
+static void decode_stmts(jl_array_t *stmts, uint8_t *ops, size_t ns);
+static jl_value_t *eval_body(jl_array_t *stmts, const uint8_t *ops,
+                             interpreter_state *s, int start, int toplevel);
 
 jl_value_t *jl_eval_module_expr(jl_expr_t *ex);
 int jl_is_toplevel_only_expr(jl_value_t *e);
@@ -55,14 +57,59 @@ JL_DLLEXPORT jl_value_t *jl_interpret_toplevel_expr_in(jl_module_t *m, jl_value_
     return v;
 }
 
+// ---- per-call-site inline caches -------------------------------------
+//
+// Interpreted code pays full generic dispatch at every call expression,
+// which dominates interpreted loops in the pre-JIT window. Each call
+// site -- keyed by the address of its Expr's argument buffer -- gets a
+// two-word slot handed to jl_apply_generic_ic (gf.c), which validates
+// the cached typemap entry against the actual argument types and the
+// method-table world before trusting it, so a stale or even
+// wrongly-keyed slot only ever costs a miss. Interpreted expressions
+// churn, so the site table is capped and reset wholesale when it
+// outgrows the cap; the caches are also restricted to the master thread
+// since the table is unsynchronized.
+#define INTERP_IC_MAX 4096
+static htable_t interp_ic_sites;
+static size_t interp_ic_count = 0;
+static int interp_ic_init = 0;
+
+static void **interp_ic_slot(void *key)
+{
+    if (__unlikely(!interp_ic_init)) {
+        htable_new(&interp_ic_sites, 512);
+        interp_ic_init = 1;
+    }
+    void **bp = ptrhash_bp(&interp_ic_sites, key);
+    if (*bp == HT_NOTFOUND) {
+        if (__unlikely(interp_ic_count >= INTERP_IC_MAX)) {
+            size_t i;
+            for (i = 0; i < interp_ic_sites.size; i += 2) {
+                if (interp_ic_sites.table[i + 1] != HT_NOTFOUND)
+                    free(interp_ic_sites.table[i + 1]);
+            }
+            htable_reset(&interp_ic_sites, 512);
+            interp_ic_count = 0;
+            bp = ptrhash_bp(&interp_ic_sites, key);
+        }
+        *bp = calloc(2, sizeof(void*));
+        interp_ic_count++;
+    }
+    return (void**)*bp;
+}
+
 static jl_value_t *do_call(jl_value_t **args, size_t nargs, interpreter_state *s)
 {
     jl_value_t **argv;
     JL_GC_PUSHARGS(argv, nargs);
     size_t i;
+    jl_value_t *result;
     for(i=0; i < nargs; i++)
         argv[i] = eval(args[i], s);
-    jl_value_t *result = jl_apply_generic(argv, nargs);
+    if (jl_get_ptls_states()->tid == 0)
+        result = jl_apply_generic_ic(interp_ic_slot((void*)args), argv, nargs);
+    else
+        result = jl_apply_generic(argv, nargs);
     JL_GC_POP();
     return result;
 }
@@ -434,12 +481,100 @@ static jl_value_t *eval(jl_value_t *e, interpreter_state *s)
     return (jl_value_t*)jl_nothing;
 }
 
+#define MAX_STACK_OPS 8192 // decode buffers bigger than this are malloc'd
+
+// decode the statement array and run eval_body over it
+static jl_value_t *run_body(jl_array_t *stmts, interpreter_state *s,
+                            int toplevel)
+{
+    size_t ns = jl_array_len(stmts);
+    uint8_t sops[MAX_STACK_OPS];
+    uint8_t *ops = sops;
+    if (ns > sizeof(sops)) {
+        ops = (uint8_t*)malloc(ns);
+        if (ops == NULL)
+            jl_throw(jl_memory_exception);
+    }
+    decode_stmts(stmts, ops, ns);
+    jl_value_t *r;
+    if (ops == sops) {
+        r = eval_body(stmts, ops, s, 0, toplevel);
+    }
+    else {
+        JL_TRY {
+            r = eval_body(stmts, ops, s, 0, toplevel);
+        }
+        JL_CATCH {
+            free(ops);
+            jl_rethrow();
+        }
+        free(ops);
+    }
+    return r;
+}
+
 jl_value_t *jl_toplevel_eval_body(jl_array_t *stmts)
 {
-    return eval_body(stmts, NULL, 0, 1);
+    return run_body(stmts, NULL, 1);
 }
 
-static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s, int start, int toplevel)
+// statement opcodes for the pre-decoded dispatch in eval_body
+enum istmt_op {
+    OP_OTHER = 0, // anything the generic eval() handles
+    OP_GOTO,
+    OP_RETURN,
+    OP_ASSIGN,
+    OP_GOTOIFNOT,
+    OP_LINE,
+    OP_ENTER,
+    OP_LEAVE,
+    OP_LINENODE,
+    OP_NEWVARNODE,
+};
+
+// The lowered code is already a flat statement array; what made the
+// statement loop expensive is re-classifying every statement (a chain of
+// type checks and symbol compares) each time it executes -- once per loop
+// iteration in hot code. Decode the body once per invocation into a
+// compact opcode vector and let eval_body dispatch on that with a dense
+// switch. A full register bytecode with operand slots would additionally
+// flatten the expression trees; this captures the statement-dispatch part
+// of that win without introducing a second IR.
+static void decode_stmts(jl_array_t *stmts, uint8_t *ops, size_t ns)
+{
+    for (size_t i = 0; i < ns; i++) {
+        jl_value_t *stmt = jl_array_ptr_ref(stmts, i);
+        uint8_t op = OP_OTHER;
+        if (jl_is_gotonode(stmt)) {
+            op = OP_GOTO;
+        }
+        else if (jl_is_expr(stmt)) {
+            jl_sym_t *head = ((jl_expr_t*)stmt)->head;
+            if (head == return_sym)
+                op = OP_RETURN;
+            else if (head == assign_sym)
+                op = OP_ASSIGN;
+            else if (head == goto_ifnot_sym)
+                op = OP_GOTOIFNOT;
+            else if (head == line_sym)
+                op = OP_LINE;
+            else if (head == enter_sym)
+                op = OP_ENTER;
+            else if (head == leave_sym)
+                op = OP_LEAVE;
+        }
+        else if (jl_is_linenode(stmt)) {
+            op = OP_LINENODE;
+        }
+        else if (jl_is_newvarnode(stmt)) {
+            op = OP_NEWVARNODE;
+        }
+        ops[i] = op;
+    }
+}
+
+static jl_value_t *eval_body(jl_array_t *stmts, const uint8_t *ops,
+                             interpreter_state *s, int start, int toplevel)
 {
     jl_handler_t __eh;
     size_t i=start, ns = jl_array_len(stmts);
@@ -448,20 +583,18 @@ static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s, int start,
         if (i >= ns)
             jl_error("`body` expression must terminate in `return`. Use `block` instead.");
         jl_value_t *stmt = jl_array_ptr_ref(stmts,i);
-        if (jl_is_gotonode(stmt)) {
+        switch (ops[i]) {
+        case OP_GOTO:
             i = jl_gotonode_label(stmt)-1;
             continue;
+        case OP_RETURN: {
+            jl_value_t *ex = jl_exprarg(stmt,0);
+            if (toplevel && jl_is_toplevel_only_expr(ex))
+                return jl_toplevel_eval(ex);
+            else
+                return eval(ex, s);
         }
-        else if (jl_is_expr(stmt)) {
-            jl_sym_t *head = ((jl_expr_t*)stmt)->head;
-            if (head == return_sym) {
-                jl_value_t *ex = jl_exprarg(stmt,0);
-                if (toplevel && jl_is_toplevel_only_expr(ex))
-                    return jl_toplevel_eval(ex);
-                else
-                    return eval(ex, s);
-            }
-            else if (head == assign_sym) {
+        case OP_ASSIGN: {
                 jl_value_t *sym = jl_exprarg(stmt, 0);
                 jl_value_t *rhs = eval(jl_exprarg(stmt,1), s);
                 if (jl_is_ssavalue(sym)) {
@@ -490,61 +623,61 @@ static jl_value_t *eval_body(jl_array_t *stmts, interpreter_state *s, int start,
                     jl_checked_assignment(b, rhs);
                     JL_GC_POP();
                 }
+            break;
+        }
+        case OP_GOTOIFNOT: {
+            jl_value_t *cond = eval(jl_exprarg(stmt,0), s);
+            if (cond == jl_false) {
+                i = jl_unbox_long(jl_exprarg(stmt, 1))-1;
+                continue;
             }
-            else if (head == goto_ifnot_sym) {
-                jl_value_t *cond = eval(jl_exprarg(stmt,0), s);
-                if (cond == jl_false) {
-                    i = jl_unbox_long(jl_exprarg(stmt, 1))-1;
-                    continue;
-                }
-                else if (cond != jl_true) {
-                    jl_type_error_rt("toplevel", "if", (jl_value_t*)jl_bool_type, cond);
-                }
+            else if (cond != jl_true) {
+                jl_type_error_rt("toplevel", "if", (jl_value_t*)jl_bool_type, cond);
             }
-            else if (head == line_sym) {
-                if (toplevel)
-                    jl_lineno = jl_unbox_long(jl_exprarg(stmt,0));
-                // TODO: interpreted function line numbers
+            break;
+        }
+        case OP_LINE:
+            if (toplevel)
+                jl_lineno = jl_unbox_long(jl_exprarg(stmt,0));
+            // TODO: interpreted function line numbers
+            break;
+        case OP_ENTER:
+            jl_enter_handler(&__eh);
+            if (!jl_setjmp(__eh.eh_ctx,1)) {
+                return eval_body(stmts, ops, s, i+1, toplevel);
             }
-            else if (head == enter_sym) {
-                jl_enter_handler(&__eh);
-                if (!jl_setjmp(__eh.eh_ctx,1)) {
-                    return eval_body(stmts, s, i+1, toplevel);
-                }
-                else {
+            else {
 #ifdef _OS_WINDOWS_
-                    if (jl_exception_in_transit == jl_stackovf_exception)
-                        _resetstkoflw();
+                if (jl_exception_in_transit == jl_stackovf_exception)
+                    _resetstkoflw();
 #endif
-                    i = jl_unbox_long(jl_exprarg(stmt,0))-1;
-                    continue;
-                }
-            }
-            else if (head == leave_sym) {
-                int hand_n_leave = jl_unbox_long(jl_exprarg(stmt,0));
-                jl_pop_handler(hand_n_leave);
-            }
-            else if (toplevel && jl_is_toplevel_only_expr(stmt)) {
-                jl_toplevel_eval(stmt);
-            }
-            else {
-                eval(stmt, s);
+                i = jl_unbox_long(jl_exprarg(stmt,0))-1;
+                continue;
             }
+        case OP_LEAVE: {
+            int hand_n_leave = jl_unbox_long(jl_exprarg(stmt,0));
+            jl_pop_handler(hand_n_leave);
+            break;
         }
-        else if (jl_is_linenode(stmt)) {
+        case OP_LINENODE:
             if (toplevel)
                 jl_lineno = jl_linenode_line(stmt);
             // TODO: interpreted function line numbers
-        }
-        else if (jl_is_newvarnode(stmt)) {
+            break;
+        case OP_NEWVARNODE: {
             jl_value_t *var = jl_fieldref(stmt,0);
             assert(jl_is_slot(var));
             ssize_t n = jl_slot_number(var);
             assert(n <= jl_linfo_nslots(s->lam) && n > 0);
             s->locals[n-1] = NULL;
+            break;
         }
-        else {
-            eval(stmt, s);
+        default:
+            if (toplevel && jl_is_expr(stmt) && jl_is_toplevel_only_expr(stmt))
+                jl_toplevel_eval(stmt);
+            else
+                eval(stmt, s);
+            break;
         }
         i++;
     }
@@ -567,7 +700,7 @@ jl_value_t *jl_interpret_call(jl_lambda_info_t *lam, jl_value_t **args, uint32_t
         else
             locals[i] = args[i];
     }
-    jl_value_t *r = eval_body(stmts, &s, 0, lam->nargs==0);
+    jl_value_t *r = run_body(stmts, &s, lam->nargs==0);
     JL_GC_POP();
     return r;
 }
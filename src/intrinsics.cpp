@@ -329,8 +329,19 @@ static Value *emit_unbox(Type *to, const jl_cgval_t &x, jl_value_t *jt, Value *d
         alignment = 0;
     }
     if (dest) {
-        // callers using the dest argument only use it for a stack slot for now
-        alignment = 0;
+        // callers using the dest argument only use it for a stack slot for
+        // now. Both sides carry at least the type's natural alignment
+        // (heap objects are 16-byte aligned, stack slots and interior
+        // field pointers are naturally aligned, all capped by MAX_ALIGN);
+        // saying so -- instead of the old 0, i.e. "unknown, assume byte
+        // alignment" -- lets the backend lower fixed-size struct copies
+        // to wide vector moves instead of byte-safe store chains.
+        unsigned dt_align = jt ? ((jl_datatype_t*)jt)->alignment : 1;
+        if (dt_align > MAX_ALIGN)
+            dt_align = MAX_ALIGN;
+        if (dt_align < 1)
+            dt_align = 1;
+        alignment = dt_align;
         MDNode *tbaa = x.tbaa;
         // the memcpy intrinsic does not allow to specify different alias tags
         // for the load part (x.tbaa) and the store part (tbaa_stack).
@@ -873,15 +884,32 @@ static Value *emit_checked_srem_int(Value *x, Value *den, jl_codectx_t *ctx)
     return ret;
 }
 
+// effective math mode for the function being compiled: the enclosing
+// module's setting wins over the global --math-mode, so one library can
+// run fused/reassociated while another stays strict IEEE
+static int jl_effective_fast_math(jl_codectx_t *ctx)
+{
+    jl_module_t *mod = (ctx->linfo && ctx->linfo->def) ?
+        ctx->linfo->def->module : NULL;
+    if (mod != NULL) {
+        if (mod->fastmath == JL_MODULE_FASTMATH_ON)
+            return JL_OPTIONS_FAST_MATH_ON;
+        if (mod->fastmath == JL_MODULE_FASTMATH_STRICT)
+            return JL_OPTIONS_FAST_MATH_OFF;
+    }
+    return jl_options.fast_math;
+}
+
 // Temporarily switch the builder to fast-math mode if requested
 struct math_builder {
     FastMathFlags old_fmf;
     math_builder(jl_codectx_t *ctx, bool always_fast = false):
         old_fmf(builder.getFastMathFlags())
     {
-        if (jl_options.fast_math != JL_OPTIONS_FAST_MATH_OFF &&
+        int fast_math = jl_effective_fast_math(ctx);
+        if (fast_math != JL_OPTIONS_FAST_MATH_OFF &&
             (always_fast ||
-             jl_options.fast_math == JL_OPTIONS_FAST_MATH_ON)) {
+             fast_math == JL_OPTIONS_FAST_MATH_ON)) {
             FastMathFlags fmf;
             fmf.setUnsafeAlgebra();
 #ifdef LLVM38
@@ -2,12 +2,14 @@
 
 #include <iostream>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Process.h>
 
 // Except for parts of this file which were copied from LLVM, under the UIUC license (marked below).
 
 // this defines the set of optimization passes defined for Julia at various optimization levels
 template <class T>
-static void addOptimizationPasses(T *PM)
+static void addOptimizationPasses(T *PM, int opt_level)
 {
 #ifdef JL_DEBUG_BUILD
     PM->add(createVerifierPass());
@@ -25,7 +27,7 @@ static void addOptimizationPasses(T *PM)
     PM->add(llvm::createMemorySanitizerPass(true));
 #   endif
 #endif
-    if (jl_options.opt_level == 0) {
+    if (opt_level == 0) {
         return;
     }
 #ifdef LLVM37
@@ -38,7 +40,7 @@ static void addOptimizationPasses(T *PM)
 #else
     PM->add(createTypeBasedAliasAnalysisPass());
 #endif
-    if (jl_options.opt_level >= 3) {
+    if (opt_level >= 3) {
 #ifdef LLVM38
         PM->add(createBasicAAWrapperPass());
 #else
@@ -78,6 +80,15 @@ static void addOptimizationPasses(T *PM)
 
     PM->add(createLoopIdiomPass()); //// ****
     PM->add(createLoopRotatePass());           // Rotate loops.
+#ifdef LLVM37
+    if (opt_level >= 3) {
+        // Version counted loops whose bounds checks are loop invariant:
+        // the checks branch to cold throw blocks (see emit_bounds_check),
+        // which this pass turns into a pre-loop range test plus an
+        // unchecked main loop.
+        PM->add(createInductiveRangeCheckEliminationPass());
+    }
+#endif
     // LoopRotate strips metadata from terminator, so run LowerSIMD afterwards
     PM->add(createLowerSimdLoopPass());        // Annotate loop marked with "simdloop" as LLVM parallel loop
     PM->add(createLICMPass());                 // Hoist loop invariants
@@ -115,14 +126,14 @@ static void addOptimizationPasses(T *PM)
     PM->add(createJumpThreadingPass());         // Thread jumps
     PM->add(createDeadStoreEliminationPass());  // Delete dead stores
 #if !defined(INSTCOMBINE_BUG)
-    if (jl_options.opt_level >= 3) {
+    if (opt_level >= 3) {
         PM->add(createSLPVectorizerPass());     // Vectorize straight-line code
     }
 #endif
 
     PM->add(createAggressiveDCEPass());         // Delete dead instructions
 #if !defined(INSTCOMBINE_BUG)
-    if (jl_options.opt_level >= 3)
+    if (opt_level >= 3)
         PM->add(createInstructionCombiningPass());   // Clean up after SLP loop vectorizer
 #endif
 #if defined(LLVM35)
@@ -132,6 +143,19 @@ static void addOptimizationPasses(T *PM)
     //PM->add(createCFGSimplificationPass());     // Merge & remove BBs
 }
 
+// Baseline tier: the minimum that produces working code. Toplevel thunks
+// (and anything else tagged julia.tier0) run once, so time spent in the
+// full pipeline on them is pure warmup cost.
+template <class T>
+static void addBaselinePasses(T *PM)
+{
+#ifdef JL_DEBUG_BUILD
+    PM->add(createVerifierPass());
+#endif
+    PM->add(createCFGSimplificationPass());
+    PM->add(createPromoteMemoryToRegisterPass());
+}
+
 #ifdef USE_ORCJIT
 
 #ifndef LLVM38
@@ -214,6 +238,25 @@ static uint64_t resolve_atomic(const char *name)
 }
 #endif
 
+// On-disk object cache (JULIA_CODE_CACHE)
+//
+// When JULIA_CODE_CACHE names a directory, the compile layer looks modules
+// up there (keyed by a hash of the pre-optimization IR together with the
+// target CPU, feature string and julia version) before running the backend,
+// and persists freshly compiled object buffers, so repeat processes relink
+// instead of re-running optimization and MC emission.
+//
+// Two classes of modules are never reused across processes:
+//  - modules whose IR embeds raw runtime addresses (inttoptr constants
+//    referencing heap objects); those are only meaningful in the emitting
+//    process. This mostly limits the cache to self-contained numeric
+//    kernels, which is where the compile time goes anyway.
+//  - modules whose symbol names diverged: the hash covers the raw IR
+//    including the globalUnique-numbered function names, so a process that
+//    compiles in a different order simply misses. Fleets of workers running
+//    the same code deterministically (the case this cache is for) generate
+//    identical names and hit.
+
 // A simplified model of the LLVM ExecutionEngine that implements only the methods that Julia needs
 // but tries to roughly match the API anyways so that compatibility is easier
 class JuliaOJIT {
@@ -322,14 +365,38 @@ public:
       : TM(TM),
         DL(TM.createDataLayout()),
         ObjStream(ObjBufferSV),
+        CacheDir(getenv(CODE_CACHE_NAME)),
         MemMgr(createRTDyldMemoryManager()),
         ObjectLayer(DebugObjectRegistrar(*this)),
         CompileLayer(
                 ObjectLayer,
                 [this](Module &M) {
-                    PM.run(M);
+                    // consult the on-disk object cache before running the
+                    // backend
+                    std::string CachePath = CacheFile(M);
+                    if (!CachePath.empty()) {
+                        auto CachedBuf = MemoryBuffer::getFile(CachePath, -1,
+                                                               false);
+                        if (CachedBuf) {
+                            auto CachedObj = object::ObjectFile::createObjectFile(
+                                (*CachedBuf)->getMemBufferRef());
+                            if (CachedObj)
+                                return OwningObj(std::move(*CachedObj),
+                                                 std::move(*CachedBuf));
+#ifdef LLVM39
+                            consumeError(CachedObj.takeError());
+#endif
+                        }
+                    }
+                    if (M.getModuleFlag("julia.tier0"))
+                        PM0.run(M);
+                    else if (M.getModuleFlag("julia.hot"))
+                        PMHot.run(M);
+                    else
+                        PM.run(M);
                     std::unique_ptr<MemoryBuffer> ObjBuffer(
                         new ObjectMemoryBuffer(std::move(ObjBufferSV)));
+                    emitted_code_bytes += ObjBuffer->getBufferSize();
                     auto Obj = object::ObjectFile::createObjectFile(ObjBuffer->getMemBufferRef());
 
                     if (!Obj) {
@@ -347,13 +414,39 @@ public:
 #endif
                     }
 
+                    if (!CachePath.empty()) {
+                        // persist for future processes. Write to a private
+                        // temporary and rename so that a concurrent worker
+                        // never reads a partial object.
+                        std::string TmpPath = CachePath + "." +
+                            std::to_string(sys::Process::getProcessId()) +
+                            ".tmp";
+                        std::error_code EC;
+                        raw_fd_ostream CacheOS(TmpPath.c_str(), EC,
+                                               sys::fs::F_None);
+                        if (!EC) {
+                            CacheOS << ObjBuffer->getBuffer();
+                            CacheOS.close();
+                            if (!CacheOS.has_error())
+                                sys::fs::rename(TmpPath, CachePath);
+                        }
+                    }
                     return OwningObj(std::move(*Obj), std::move(ObjBuffer));
                 }
             )
         {
-            addOptimizationPasses(&PM);
+            if (CacheDir)
+                sys::fs::create_directories(CacheDir);
+            addOptimizationPasses(&PM, jl_options.opt_level);
             if (TM.addPassesToEmitMC(PM, Ctx, ObjStream))
                 llvm_unreachable("Target does not support MC emission.");
+            addBaselinePasses(&PM0);
+            if (TM.addPassesToEmitMC(PM0, Ctx0, ObjStream))
+                llvm_unreachable("Target does not support MC emission.");
+            // re-optimization tier: full pipeline regardless of -O level
+            addOptimizationPasses(&PMHot, 3);
+            if (TM.addPassesToEmitMC(PMHot, CtxHot, ObjStream))
+                llvm_unreachable("Target does not support MC emission.");
 
             // Make sure SectionMemoryManager::getSymbolAddressInProcess can resolve
             // symbols in the program as well. The nullptr argument to the function
@@ -389,6 +482,26 @@ public:
     }
 
 
+    // a staged (not yet emitted) module defines this function
+    bool isPendingFunction(StringRef Name)
+    {
+        for (auto &PM : PendingModules) {
+            Function *F = PM->getFunction(Name);
+            if (F && !F->isDeclaration())
+                return true;
+        }
+        return false;
+    }
+
+    // Modules are staged here and emitted as one module set, so the ORC
+    // layer, symbol-registration, and memory-manager fixed costs are paid
+    // once per batch instead of once per method during warmup. Any symbol
+    // lookup that misses flushes the batch (see findSymbol), so staged
+    // code is never invisible to its callers; an interactive
+    // compile-then-call therefore still emits immediately, while bulk
+    // compilation (precompile, compile hints) batches up.
+    static const size_t jit_batch_max = 16;
+
     void addModule(std::unique_ptr<Module> M)
     {
 #ifndef NDEBUG
@@ -401,6 +514,7 @@ public:
                     F->eraseFromParent();
                 else if (!(F->isIntrinsic() ||
                            findUnmangledSymbol(F->getName()) ||
+                           isPendingFunction(F->getName()) ||
                            SectionMemoryManager::getSymbolAddressInProcess(
                                F->getName()))) {
                     std::cerr << "FATAL ERROR: "
@@ -411,8 +525,21 @@ public:
             }
         }
 #endif
+        PendingModules.push_back(std::move(M));
+        if (PendingModules.size() >= jit_batch_max)
+            flushPendingModules();
+    }
+
+    void flushPendingModules()
+    {
+        if (PendingModules.empty())
+            return;
+        // take the batch first: emitting it re-enters findSymbol through
+        // the resolver below, which must see an empty pending list
+        SmallVector<std::unique_ptr<Module>,16> Ms;
+        Ms.swap(PendingModules);
         // We need a memory manager to allocate memory and resolve symbols for this
-        // new module. Create one that resolves symbols by looking back into the JIT.
+        // new module set. Create one that resolves symbols by looking back into the JIT.
         auto Resolver = orc::createLambdaResolver(
                           [&](const std::string &Name) {
                             // TODO: consider moving the FunctionMover resolver here
@@ -433,20 +560,37 @@ public:
                           },
                           [](const std::string &S) { return nullptr; }
                         );
-        SmallVector<std::unique_ptr<Module>,1> Ms;
-        Ms.push_back(std::move(M));
         auto modset = CompileLayer.addModuleSet(std::move(Ms), MemMgr,
                                                 std::move(Resolver));
-        // Force LLVM to emit the module so that we can register the symbols
+        // Force LLVM to emit the batch so that we can register the symbols
         // in our lookup table.
         CompileLayer.emitAndFinalize(modset);
     }
 
+    // On evicting dead code (method replacement, hot reload): this entry
+    // point exists but cannot be used safely or usefully yet, for three
+    // independent reasons worth recording. (1) Frame safety: nothing
+    // tracks whether any thread has a return address into a module
+    // set's code; evicting under an in-flight frame is a crash, so a
+    // correct design needs either a stack scan over all threads at a
+    // quiescent point or per-call reference counting in the emitted
+    // prologues. (2) Memory: all sets share one RTDyldMemoryManagerJL
+    // whose allocators pool code blocks and never unmap; removeModuleSet
+    // would free ORC bookkeeping but return no section memory --
+    // eviction needs per-set memory managers plus teardown support in
+    // cgmemmgr's allocators. (3) Liveness: deciding a set is dead means
+    // tracking the jl_lambda_info_t objects whose entry points live in
+    // it without rooting them (rooting would keep replaced methods
+    // alive forever), i.e. a GC-integrated weak registry. Until those
+    // exist, jl_jit_total_bytes below gives the observability half:
+    // how much JIT code is resident overall.
     void removeModule(ModuleHandleT H)
     {
         CompileLayer.removeModuleSet(H);
     }
 
+    size_t emitted_code_bytes = 0;
+
     orc::JITSymbol findSymbol(const std::string &Name, bool ExportedSymbolsOnly)
     {
         void *Addr = nullptr;
@@ -457,6 +601,14 @@ public:
         // Step 2: Search all previously emitted symbols
         if (Addr == nullptr)
             Addr = LocalSymbolTable[Name];
+        // Step 3: The definition may still be staged in the module batch
+        if (Addr == nullptr && !PendingModules.empty()) {
+            flushPendingModules();
+            if (ExportedSymbolsOnly)
+                Addr = getPointerToGlobalIfAvailable(Name);
+            if (Addr == nullptr)
+                Addr = LocalSymbolTable[Name];
+        }
         return orc::JITSymbol((uintptr_t)Addr, JITSymbolFlags::Exported);
     }
 
@@ -496,8 +648,35 @@ public:
     }
 
 private:
+    // Path of the cache file for `M`, or the empty string when the module
+    // must not be (or cannot be) cached. See the note above JuliaOJIT.
+    std::string CacheFile(Module &M)
+    {
+        if (!CacheDir)
+            return std::string();
+        std::string IR;
+        raw_string_ostream IROS(IR);
+        M.print(IROS, nullptr);
+        IROS.flush();
+        // raw addresses embedded in the IR are process local
+        if (IR.find("inttoptr") != std::string::npos)
+            return std::string();
+        IR += TM.getTargetCPU();
+        IR += TM.getTargetFeatureString();
+        IR += JULIA_VERSION_STRING;
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.o",
+                 (unsigned long long)memhash(IR.data(), IR.size()));
+        return std::string(CacheDir) + PATHSEPSTRING + name;
+    }
+
     std::string getMangledName(const std::string &Name)
     {
+        // without a global prefix (ELF and friends) mangling is the
+        // identity; skip the Mangler round trip that would otherwise
+        // run on every symbol query
+        if (DL.getGlobalPrefix() == '\0')
+            return Name;
         SmallString<128> FullName;
         Mangler::getNameWithPrefix(FullName, Name, DL);
         return FullName.str();
@@ -514,11 +693,17 @@ private:
     // object fits in its entirety
     SmallVector<char, 4096> ObjBufferSV;
     raw_svector_ostream ObjStream;
+    const char *CacheDir; // JULIA_CODE_CACHE, NULL when caching is off
     legacy::PassManager PM;
+    legacy::PassManager PM0; // baseline tier (julia.tier0 modules)
+    legacy::PassManager PMHot; // re-optimization tier (julia.hot modules)
     MCContext *Ctx;
+    MCContext *Ctx0;
+    MCContext *CtxHot;
     RTDyldMemoryManager *MemMgr;
     ObjLayerT ObjectLayer;
     CompileLayerT CompileLayer;
+    SmallVector<std::unique_ptr<Module>,16> PendingModules;
     SymbolTableT GlobalSymbolTable;
     SymbolTableT LocalSymbolTable;
 };
@@ -527,8 +712,21 @@ private:
 
 #ifdef USE_ORCJIT
 JuliaOJIT *jl_ExecutionEngine;
+
+// total bytes of native code emitted by the JIT this session (live and
+// dead alike; see the eviction notes at JuliaOJIT::removeModule for why
+// the live/dead split needs machinery that does not exist yet)
+extern "C" JL_DLLEXPORT uint64_t jl_jit_total_bytes(void)
+{
+    return (uint64_t)jl_ExecutionEngine->emitted_code_bytes;
+}
 #else
 ExecutionEngine *jl_ExecutionEngine;
+
+extern "C" JL_DLLEXPORT uint64_t jl_jit_total_bytes(void)
+{
+    return 0;
+}
 #endif
 
 // MSVC's link.exe requires each function declaration to have a Comdat section
@@ -1043,7 +1241,7 @@ void jl_dump_native(const char *bc_fname, const char *obj_fname, const char *sys
     PM.add(new DataLayout(*jl_ExecutionEngine->getDataLayout()));
 #endif
 
-    addOptimizationPasses(&PM);
+    addOptimizationPasses(&PM, jl_options.opt_level);
 
     std::unique_ptr<raw_fd_ostream> bc_OS;
     std::unique_ptr<raw_fd_ostream> obj_OS;
@@ -134,6 +134,317 @@ JL_DLLEXPORT void jl_uv_req_set_data(uv_req_t *req, void *data) { req->data = da
 JL_DLLEXPORT void *jl_uv_handle_data(uv_handle_t *handle) { return handle->data; }
 JL_DLLEXPORT void *jl_uv_write_handle(uv_write_t *req) { return req->handle; }
 
+// pooled uv request structs
+//
+// Writes and connects allocate a request struct per operation and free
+// it in the completion callback; at hundreds of thousands of requests
+// per second that malloc/free churn shows up in the allocator profile
+// and fragments the heap. Size-classed freelists recycle the two hot
+// request types instead (other sizes fall through to malloc). The pool
+// is capped so a burst doesn't pin memory forever, and is safe to use
+// from any thread.
+typedef struct jl_uv_req_ent_t {
+    struct jl_uv_req_ent_t *next;
+} jl_uv_req_ent_t;
+
+#define UV_REQ_POOL_MAX 1024 // per size class
+static jl_uv_req_ent_t *uv_req_pools[2];
+static int uv_req_pool_len[2];
+static jl_mutex_t uv_req_pool_lock;
+
+static int jl_uv_req_pool_class(size_t sz)
+{
+    if (sz == sizeof(uv_write_t))
+        return 0;
+    if (sz == sizeof(uv_connect_t))
+        return 1;
+    return -1;
+}
+
+JL_DLLEXPORT void *jl_uv_alloc_req(size_t sz)
+{
+    int cl = jl_uv_req_pool_class(sz);
+    if (cl >= 0) {
+        JL_LOCK_NOGC(&uv_req_pool_lock);
+        jl_uv_req_ent_t *ent = uv_req_pools[cl];
+        if (ent != NULL) {
+            uv_req_pools[cl] = ent->next;
+            uv_req_pool_len[cl]--;
+        }
+        JL_UNLOCK_NOGC(&uv_req_pool_lock);
+        if (ent != NULL)
+            return ent;
+    }
+    return malloc(sz);
+}
+
+JL_DLLEXPORT void jl_uv_free_req(void *req, size_t sz)
+{
+    int cl = jl_uv_req_pool_class(sz);
+    if (cl >= 0) {
+        JL_LOCK_NOGC(&uv_req_pool_lock);
+        if (uv_req_pool_len[cl] < UV_REQ_POOL_MAX) {
+            jl_uv_req_ent_t *ent = (jl_uv_req_ent_t*)req;
+            ent->next = uv_req_pools[cl];
+            uv_req_pools[cl] = ent;
+            uv_req_pool_len[cl]++;
+            req = NULL;
+        }
+        JL_UNLOCK_NOGC(&uv_req_pool_lock);
+    }
+    free(req);
+}
+
+// lock-free MPSC command queue for the event loop
+//
+// Worker threads used to have to take JL_UV_LOCK (serializing against the
+// whole event loop) to submit I/O. jl_uv_post instead pushes a command
+// onto a lock-free intrusive stack with a single CAS and pokes the loop
+// with an async handle; the loop thread drains the queue in the async
+// callback and runs each command in the right context (the loop thread,
+// no loop lock needed) and in submission order.
+#ifndef _OS_WINDOWS_
+typedef struct jl_uv_cmd_t {
+    struct jl_uv_cmd_t *next;
+    void (*cb)(void*);
+    void *arg;
+} jl_uv_cmd_t;
+
+static jl_uv_cmd_t *volatile uv_cmd_head = NULL;
+static uv_async_t uv_cmd_async;
+
+static void jl_uv_cmd_drain_cb(uv_async_t *hdl)
+{
+    (void)hdl;
+    jl_uv_cmd_t *list = jl_atomic_exchange(&uv_cmd_head, NULL);
+    // the stack pops in LIFO order; reverse it so commands run in the
+    // order they were posted
+    jl_uv_cmd_t *prev = NULL;
+    while (list) {
+        jl_uv_cmd_t *next = list->next;
+        list->next = prev;
+        prev = list;
+        list = next;
+    }
+    while (prev) {
+        jl_uv_cmd_t *next = prev->next;
+        prev->cb(prev->arg);
+        free(prev);
+        prev = next;
+    }
+}
+
+void jl_init_uv_cmd_queue(void)
+{
+    uv_async_init(jl_io_loop, &uv_cmd_async, jl_uv_cmd_drain_cb);
+    uv_unref((uv_handle_t*)&uv_cmd_async);
+}
+
+// run `cb(arg)` on the event loop thread without taking the loop lock.
+// Safe to call from any thread; returns 0, or UV_ENOMEM. The callback is
+// for submitting libuv operations: it can run while the loop thread is
+// advertised GC-safe (see the poll bracket below), so it must not touch
+// GC managed state -- call back into julia through a cfunction if that is
+// needed.
+JL_DLLEXPORT int jl_uv_post(void (*cb)(void*), void *arg)
+{
+    jl_uv_cmd_t *cmd = (jl_uv_cmd_t*)malloc(sizeof(jl_uv_cmd_t));
+    if (cmd == NULL)
+        return UV_ENOMEM;
+    cmd->cb = cb;
+    cmd->arg = arg;
+    do {
+        cmd->next = uv_cmd_head;
+    } while (jl_atomic_compare_exchange(&uv_cmd_head, cmd->next, cmd) !=
+             cmd->next);
+    uv_async_send(&uv_cmd_async);
+    return 0;
+}
+
+// ---- per-thread event loops ------------------------------------------
+//
+// Handles have loop affinity in libuv (a handle may only be driven from
+// its loop's thread), so scaling I/O across threads means one loop per
+// thread, not sharing one: each thread opens its own handles -- with
+// SO_REUSEPORT, its own listener -- on its own loop and drives them with
+// jl_process_events(jl_thread_event_loop()). Live handles are never
+// migrated between loops (libuv cannot); the cross-thread primitive is
+// jl_uv_post_to, which runs a callback on the target thread's loop via
+// that thread's MPSC queue -- the same discipline jl_uv_post established
+// for the global loop. The master thread's "private" loop is the global
+// one, so existing code is unchanged.
+static void jl_uv_thread_cmd_drain_cb(uv_async_t *hdl)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    (void)hdl;
+    jl_uv_cmd_t *list =
+        (jl_uv_cmd_t*)jl_atomic_exchange(&ptls->uv_cmd_head, NULL);
+    jl_uv_cmd_t *prev = NULL;
+    while (list) {
+        jl_uv_cmd_t *next = list->next;
+        list->next = prev;
+        prev = list;
+        list = next;
+    }
+    while (prev) {
+        jl_uv_cmd_t *next = prev->next;
+        prev->cb(prev->arg);
+        free(prev);
+        prev = next;
+    }
+}
+
+static void jl_gc_safe_poll_register(uv_loop_t *loop);
+
+JL_DLLEXPORT uv_loop_t *jl_thread_event_loop(void)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    if (ptls->tid == 0)
+        return jl_io_loop;
+    if (ptls->event_loop == NULL) {
+        uv_loop_t *loop = (uv_loop_t*)malloc(sizeof(uv_loop_t));
+        if (loop == NULL || uv_loop_init(loop)) {
+            free(loop);
+            return NULL;
+        }
+        uv_async_t *async = (uv_async_t*)malloc(sizeof(uv_async_t));
+        if (async == NULL) {
+            uv_loop_close(loop);
+            free(loop);
+            return NULL;
+        }
+        uv_async_init(loop, async, jl_uv_thread_cmd_drain_cb);
+        uv_unref((uv_handle_t*)async);
+        // a thread blocking in this loop's poll must be GC-safe, same
+        // as the global loop (see the bracket above)
+        jl_gc_safe_poll_register(loop);
+        ptls->uv_cmd_async = async;
+        ptls->event_loop = loop;
+    }
+    return (uv_loop_t*)ptls->event_loop;
+}
+
+// run `cb(arg)` on thread `tid`'s event loop. The target thread must
+// have created its loop (jl_thread_event_loop) and be driving it; tid 0
+// falls back to jl_uv_post on the global loop. Same contract as
+// jl_uv_post: the callback submits libuv work and must not touch GC
+// managed state directly.
+JL_DLLEXPORT int jl_uv_post_to(int16_t tid, void (*cb)(void*), void *arg)
+{
+    if (tid == 0)
+        return jl_uv_post(cb, arg);
+    if (tid < 0 || tid >= jl_n_threads)
+        return UV_EINVAL;
+    jl_tls_states_t *ptls2 = jl_all_tls_states[tid];
+    if (ptls2->uv_cmd_async == NULL)
+        return UV_EINVAL; // no loop on that thread yet
+    jl_uv_cmd_t *cmd = (jl_uv_cmd_t*)malloc(sizeof(jl_uv_cmd_t));
+    if (cmd == NULL)
+        return UV_ENOMEM;
+    cmd->cb = cb;
+    cmd->arg = arg;
+    do {
+        cmd->next = (jl_uv_cmd_t*)ptls2->uv_cmd_head;
+    } while (jl_atomic_compare_exchange(&ptls2->uv_cmd_head,
+                                        (void*)cmd->next, (void*)cmd) !=
+             (void*)cmd->next);
+    uv_async_send((uv_async_t*)ptls2->uv_cmd_async);
+    return 0;
+}
+#else
+void jl_init_uv_cmd_queue(void)
+{
+}
+
+// uv_async_t is unreliable on windows (see signal_async above); callers
+// must fall back to JL_UV_LOCK there
+JL_DLLEXPORT int jl_uv_post(void (*cb)(void*), void *arg)
+{
+    (void)cb;
+    (void)arg;
+    return UV_ENOSYS;
+}
+
+// per-thread loops need the async-based handoff queue; without it every
+// thread shares the global loop as before
+JL_DLLEXPORT uv_loop_t *jl_thread_event_loop(void)
+{
+    return jl_io_loop;
+}
+
+JL_DLLEXPORT int jl_uv_post_to(int16_t tid, void (*cb)(void*), void *arg)
+{
+    (void)tid;
+    (void)cb;
+    (void)arg;
+    return UV_ENOSYS;
+}
+#endif
+
+// GC-safe event loop polling
+//
+// The runtime emits no GC transitions around ccalls, so a thread blocked
+// in the event loop's poll (epoll/kevent) used to keep a collection
+// waiting for the whole poll timeout. libuv runs prepare handles
+// immediately before blocking and invokes I/O and later callbacks only
+// after the poll returns; since every julia callback now re-enters the
+// GC-unsafe state through its cfunction wrapper, the loop thread can
+// advertise itself as GC-safe for the whole uv_run and collections
+// proceed while it sits in the kernel. The check handle restores the
+// state early so the bulk of callback processing runs unsafe without
+// paying a wrapper transition on a stopped world.
+// per-loop bracket state: each loop (the global one and every
+// per-thread loop) gets its own pair of handles and its own depth, so
+// a worker blocking in its private loop's poll is GC-safe exactly like
+// the main loop thread
+typedef struct {
+    uv_prepare_t prepare;
+    uv_check_t check;
+    int8_t saved_state;
+    // recursion depth of prepare/check pairs: julia callbacks can pump
+    // the loop reentrantly, and only the outermost pair owns the state
+    int depth;
+} jl_gc_safe_poll_t;
+
+static void jl_gc_safe_prepare_cb(uv_prepare_t *hdl)
+{
+    jl_gc_safe_poll_t *st = (jl_gc_safe_poll_t*)hdl->data;
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    if (st->depth++ == 0)
+        st->saved_state = jl_gc_safe_enter(ptls);
+}
+
+static void jl_gc_safe_check_cb(uv_check_t *hdl)
+{
+    jl_gc_safe_poll_t *st = (jl_gc_safe_poll_t*)hdl->data;
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    if (--st->depth == 0)
+        jl_gc_safe_leave(ptls, st->saved_state);
+}
+
+static void jl_gc_safe_poll_register(uv_loop_t *loop)
+{
+    jl_gc_safe_poll_t *st =
+        (jl_gc_safe_poll_t*)malloc(sizeof(jl_gc_safe_poll_t));
+    if (st == NULL)
+        return; // losing the bracket degrades pauses, nothing more
+    st->depth = 0;
+    uv_prepare_init(loop, &st->prepare);
+    st->prepare.data = st;
+    uv_prepare_start(&st->prepare, jl_gc_safe_prepare_cb);
+    uv_check_init(loop, &st->check);
+    st->check.data = st;
+    uv_check_start(&st->check, jl_gc_safe_check_cb);
+    // these internal handles must not keep the loop alive
+    uv_unref((uv_handle_t*)&st->prepare);
+    uv_unref((uv_handle_t*)&st->check);
+}
+
+void jl_init_gc_safe_poll(void)
+{
+    jl_gc_safe_poll_register(jl_io_loop);
+}
+
 JL_DLLEXPORT int jl_run_once(uv_loop_t *loop)
 {
     jl_tls_states_t *ptls = jl_get_ptls_states();
@@ -400,9 +711,173 @@ JL_DLLEXPORT int jl_fs_close(int handle)
     return ret;
 }
 
+// ---- small-write coalescing ------------------------------------------
+//
+// Heavily logging batch jobs emit thousands of tiny jl_uv_puts/putb
+// calls, each allocating a request and entering the syscall layer on
+// its own. A stream opted in via jl_uv_coalesce(stream, 1) instead
+// accumulates such writes in a per-stream buffer flushed as one write
+// request when it fills, at every loop turn (uv_check), after a short
+// timer tick, before any non-coalesced write to the same stream (so
+// ordering between the paths is preserved), or explicitly through
+// jl_uv_coalesce_flush. The loop-turn and timer flushes only run while
+// the event loop runs, which logging jobs drive anyway; code that needs
+// prompt output without a loop should flush explicitly or not opt in.
+typedef struct jl_uv_coalesce_t {
+    uv_stream_t *stream;
+    uv_timer_t timer;
+    char *buf;
+    size_t len;
+    struct jl_uv_coalesce_t *next;
+    int timer_active;
+} jl_uv_coalesce_t;
+
+#define UV_COALESCE_CAP (8 * 1024)
+#define UV_COALESCE_INTERVAL_MS 50
+
+static jl_uv_coalesce_t *jl_uv_coalescers = NULL;
+static uv_check_t jl_uv_coalesce_check;
+static int jl_uv_coalesce_check_init = 0;
+
+static jl_uv_coalesce_t *jl_uv_find_coalesce(uv_stream_t *stream)
+{
+    jl_uv_coalesce_t *c = jl_uv_coalescers;
+    while (c != NULL && c->stream != stream)
+        c = c->next;
+    return c;
+}
+
+static void jl_uv_coalesce_writecb(uv_write_t *req, int status)
+{
+    free(req->data); // the retired buffer
+    free(req);
+    if (status < 0) {
+        jl_safe_printf("jl_uv_coalesce_writecb() ERROR: %s %s\n",
+                       uv_strerror(status), uv_err_name(status));
+    }
+}
+
+static void jl_uv_coalesce_flush_one(jl_uv_coalesce_t *c)
+{
+    if (c->len == 0)
+        return;
+    uv_write_t *req = (uv_write_t*)malloc(sizeof(uv_write_t));
+    uv_buf_t buf[1];
+    buf[0].base = c->buf;
+    buf[0].len = c->len;
+    req->data = c->buf;
+    // hand the filled buffer to the request and start a fresh one
+    c->buf = (char*)malloc(UV_COALESCE_CAP);
+    c->len = 0;
+    if (c->timer_active) {
+        uv_timer_stop(&c->timer);
+        c->timer_active = 0;
+    }
+    JL_SIGATOMIC_BEGIN();
+    int status = uv_write(req, c->stream, buf, 1,
+                          (uv_write_cb)jl_uv_coalesce_writecb);
+    JL_SIGATOMIC_END();
+    if (status < 0)
+        jl_uv_coalesce_writecb(req, status);
+}
+
+static void jl_uv_coalesce_check_cb(uv_check_t *hdl)
+{
+    (void)hdl;
+    jl_uv_coalesce_t *c;
+    for (c = jl_uv_coalescers; c != NULL; c = c->next)
+        jl_uv_coalesce_flush_one(c);
+}
+
+static void jl_uv_coalesce_timer_cb(uv_timer_t *hdl)
+{
+    jl_uv_coalesce_t *c = (jl_uv_coalesce_t*)hdl->data;
+    c->timer_active = 0;
+    jl_uv_coalesce_flush_one(c);
+}
+
+JL_DLLEXPORT void jl_uv_coalesce_flush(uv_stream_t *stream)
+{
+    jl_uv_coalesce_t *c;
+    if (stream == NULL) {
+        for (c = jl_uv_coalescers; c != NULL; c = c->next)
+            jl_uv_coalesce_flush_one(c);
+        return;
+    }
+    c = jl_uv_find_coalesce(stream);
+    if (c != NULL)
+        jl_uv_coalesce_flush_one(c);
+}
+
+JL_DLLEXPORT int jl_uv_coalesce(uv_stream_t *stream, int enable)
+{
+    jl_uv_coalesce_t *c = jl_uv_find_coalesce(stream);
+    if (enable) {
+        if (c != NULL)
+            return 0;
+        c = (jl_uv_coalesce_t*)malloc(sizeof(jl_uv_coalesce_t));
+        if (c == NULL)
+            return UV_ENOMEM;
+        c->stream = stream;
+        c->buf = (char*)malloc(UV_COALESCE_CAP);
+        c->len = 0;
+        c->timer_active = 0;
+        uv_timer_init(jl_io_loop, &c->timer);
+        c->timer.data = c;
+        c->next = jl_uv_coalescers;
+        jl_uv_coalescers = c;
+        if (!jl_uv_coalesce_check_init) {
+            uv_check_init(jl_io_loop, &jl_uv_coalesce_check);
+            uv_check_start(&jl_uv_coalesce_check, jl_uv_coalesce_check_cb);
+            uv_unref((uv_handle_t*)&jl_uv_coalesce_check);
+            jl_uv_coalesce_check_init = 1;
+        }
+        return 0;
+    }
+    if (c == NULL)
+        return 0;
+    jl_uv_coalesce_flush_one(c);
+    jl_uv_coalesce_t **pc = &jl_uv_coalescers;
+    while (*pc != c)
+        pc = &(*pc)->next;
+    *pc = c->next;
+    uv_close((uv_handle_t*)&c->timer, NULL);
+    free(c->buf);
+    // the coalescer itself leaks until the timer close completes; one
+    // small block per disable is not worth a close-callback dance
+    return 0;
+}
+
+// append to the stream's coalescing buffer; returns 0 when the stream
+// is not opted in (caller takes the direct path)
+static int jl_uv_coalesce_puts(uv_stream_t *stream, const char *str, size_t n)
+{
+    jl_uv_coalesce_t *c = jl_uv_find_coalesce(stream);
+    if (c == NULL)
+        return 0;
+    if (n >= UV_COALESCE_CAP) {
+        // oversized writes go direct, after the buffer to keep order
+        jl_uv_coalesce_flush_one(c);
+        return 0;
+    }
+    if (c->len + n > UV_COALESCE_CAP)
+        jl_uv_coalesce_flush_one(c);
+    memcpy(c->buf + c->len, str, n);
+    c->len += n;
+    if (!c->timer_active) {
+        uv_timer_start(&c->timer, jl_uv_coalesce_timer_cb,
+                       UV_COALESCE_INTERVAL_MS, 0);
+        c->timer_active = 1;
+    }
+    return 1;
+}
+
 JL_DLLEXPORT int jl_uv_write(uv_stream_t *stream, const char *data, size_t n,
                              uv_write_t *uvw, void *writecb)
 {
+    // never reorder around data still sitting in a coalescing buffer
+    if (__unlikely(jl_uv_coalescers != NULL))
+        jl_uv_coalesce_flush(stream);
     uv_buf_t buf[1];
     buf[0].base = (char*)data;
     buf[0].len = n;
@@ -412,6 +887,60 @@ JL_DLLEXPORT int jl_uv_write(uv_stream_t *stream, const char *data, size_t n,
     return err;
 }
 
+// zero-copy file-to-stream transfer: submit a sendfile/splice of `len`
+// bytes from `fd` (starting at `offset`) into the stream, completing via
+// the uv_fs callback on the request. The kernel moves the data; nothing
+// is read into julia buffers. Returns a libuv error code when the stream
+// has no usable descriptor or submission fails.
+JL_DLLEXPORT int jl_uv_sendfile(uv_stream_t *stream, int fd, int64_t offset,
+                                size_t len, uv_fs_t *req, void *cb)
+{
+    uv_os_fd_t out;
+    int err = uv_fileno((uv_handle_t*)stream, &out);
+    if (err)
+        return err;
+    if (__unlikely(jl_uv_coalescers != NULL))
+        jl_uv_coalesce_flush(stream);
+    JL_SIGATOMIC_BEGIN();
+    err = uv_fs_sendfile(jl_io_loop, req, (uv_file)(intptr_t)out,
+                         (uv_file)fd, offset, len, (uv_fs_cb)cb);
+    JL_SIGATOMIC_END();
+    return err;
+}
+
+// vectored write: send `nbufs` (base, len) pairs in a single uv_write
+// request so a multi-part message costs one syscall and no intermediate
+// copy. Like jl_uv_write, the buffers are not copied: the caller must
+// keep every one of them pinned (rooted and unmoved) until the write
+// callback fires.
+JL_DLLEXPORT int jl_uv_writev(uv_stream_t *stream, char **bases, size_t *lens,
+                              size_t nbufs, uv_write_t *uvw, void *writecb)
+{
+    int err;
+    if (__unlikely(jl_uv_coalescers != NULL))
+        jl_uv_coalesce_flush(stream);
+    size_t i;
+    uv_buf_t sbufs[8];
+    uv_buf_t *bufs = sbufs;
+    if (nbufs > 8) {
+        bufs = (uv_buf_t*)malloc(nbufs * sizeof(uv_buf_t));
+        if (bufs == NULL)
+            return UV_ENOMEM;
+    }
+    for (i = 0; i < nbufs; i++) {
+        bufs[i].base = bases[i];
+        bufs[i].len = lens[i];
+    }
+    JL_SIGATOMIC_BEGIN();
+    // uv_write copies the uv_buf_t array into the request, so a stack
+    // (or freed) array is fine; only the data they point to must live on
+    err = uv_write(uvw, stream, bufs, nbufs, (uv_write_cb)writecb);
+    JL_SIGATOMIC_END();
+    if (bufs != sbufs)
+        free(bufs);
+    return err;
+}
+
 JL_DLLEXPORT void jl_uv_writecb(uv_write_t *req, int status)
 {
     free(req);
@@ -452,6 +981,9 @@ JL_DLLEXPORT void jl_uv_puts(uv_stream_t *stream, const char *str, size_t n)
     }
     else {
         // Write to libuv stream...
+        if (__unlikely(jl_uv_coalescers != NULL) &&
+            jl_uv_coalesce_puts(stream, str, n))
+            return;
         uv_write_t *req = (uv_write_t*)malloc(sizeof(uv_write_t)+n);
         char *data = (char*)(req+1);
         memcpy(data,str,n);
@@ -694,10 +1226,272 @@ JL_DLLEXPORT struct sockaddr_in *jl_uv_interface_address_sockaddr(uv_interface_a
     return &ifa->address.address4;
 }
 
+// ---- TTL resolver cache ----------------------------------------------
+//
+// With JULIA_DNS_TTL=<seconds> set, jl_getaddrinfo memoizes results per
+// (host, service): hits are delivered through a zero-timeout timer (so
+// the caller's wait pattern sees the usual asynchronous callback),
+// failures are negative-cached briefly, and a hit in the last quarter
+// of its TTL kicks off a background re-resolve so steady traffic never
+// waits on an expiring entry. getaddrinfo exposes no record TTLs, so
+// the TTL is the operator's knob, not the zone's. Linux/glibc only:
+// cache hits synthesize an addrinfo chain that glibc's freeaddrinfo in
+// the consumer's cleanup path can free -- one malloc block per node
+// with the sockaddr inline, canonname absent. (musl's freeaddrinfo
+// assumes its own single-block layout, so the cache stays off there.)
+// Unset TTL (the default) leaves the stock path byte for byte.
+#if defined(_OS_LINUX_) && defined(__GLIBC__)
+#define DNS_CACHE_NEG_TTL_NS (5ull * 1000000000)
+typedef struct dns_cache_ent_t {
+    struct dns_cache_ent_t *next;
+    char *key; // "host\0service"
+    size_t keylen;
+    uint64_t expires;
+    int status;          // 0 or the negative uv error
+    int refreshing;
+    int naddrs;
+    struct addrinfo *chain; // private template chain (never handed out)
+} dns_cache_ent_t;
+
+static dns_cache_ent_t *dns_cache = NULL;
+static uint64_t dns_ttl_ns = 0;
+static int dns_ttl_inited = 0;
+
+static void dns_free_chain(struct addrinfo *ai)
+{
+    while (ai != NULL) {
+        struct addrinfo *next = ai->ai_next;
+        free(ai);
+        ai = next;
+    }
+}
+
+// deep-copy `src` into single-malloc-per-node form (sockaddr inline);
+// this layout is also what cache hits hand to the consumer, where the
+// libc freeaddrinfo frees each node (and would free a canonname, which
+// we therefore never set)
+static struct addrinfo *dns_copy_chain(const struct addrinfo *src)
+{
+    struct addrinfo *head = NULL, **tail = &head;
+    for (; src != NULL; src = src->ai_next) {
+        struct addrinfo *node = (struct addrinfo*)malloc(
+            sizeof(struct addrinfo) + src->ai_addrlen);
+        if (node == NULL) {
+            dns_free_chain(head);
+            return NULL;
+        }
+        memcpy(node, src, sizeof(struct addrinfo));
+        node->ai_canonname = NULL;
+        node->ai_addr = (struct sockaddr*)(node + 1);
+        memcpy(node->ai_addr, src->ai_addr, src->ai_addrlen);
+        node->ai_next = NULL;
+        *tail = node;
+        tail = &node->ai_next;
+    }
+    return head;
+}
+
+static dns_cache_ent_t *dns_cache_find(const char *key, size_t keylen)
+{
+    dns_cache_ent_t *e = dns_cache;
+    while (e != NULL &&
+           (e->keylen != keylen || memcmp(e->key, key, keylen) != 0))
+        e = e->next;
+    return e;
+}
+
+static void dns_cache_store(const char *key, size_t keylen, int status,
+                            const struct addrinfo *res)
+{
+    dns_cache_ent_t *e = dns_cache_find(key, keylen);
+    if (e == NULL) {
+        e = (dns_cache_ent_t*)calloc(1, sizeof(dns_cache_ent_t));
+        if (e == NULL)
+            return;
+        e->key = (char*)malloc(keylen);
+        if (e->key == NULL) {
+            free(e);
+            return;
+        }
+        memcpy(e->key, key, keylen);
+        e->keylen = keylen;
+        e->next = dns_cache;
+        dns_cache = e;
+    }
+    dns_free_chain(e->chain);
+    e->chain = NULL;
+    e->status = status;
+    e->refreshing = 0;
+    if (status == 0) {
+        e->chain = dns_copy_chain(res);
+        e->expires = uv_hrtime() + dns_ttl_ns;
+    }
+    else {
+        e->expires = uv_hrtime() +
+            (dns_ttl_ns < DNS_CACHE_NEG_TTL_NS ? dns_ttl_ns
+                                               : DNS_CACHE_NEG_TTL_NS);
+    }
+}
+
+JL_DLLEXPORT void jl_getaddrinfo_flush_cache(void)
+{
+    dns_cache_ent_t *e = dns_cache;
+    while (e != NULL) {
+        dns_cache_ent_t *next = e->next;
+        dns_free_chain(e->chain);
+        free(e->key);
+        free(e);
+        e = next;
+    }
+    dns_cache = NULL;
+}
+
+// interposed uv callback: record the fresh result, then hand it to the
+// original consumer callback (stored behind the request data)
+typedef struct {
+    jl_function_t *cb;
+    uv_getaddrinfo_cb uvcb;
+    char *key;
+    size_t keylen;
+} dns_fill_t;
+
+static void dns_fill_cb(uv_getaddrinfo_t *req, int status,
+                        struct addrinfo *res)
+{
+    dns_fill_t *fill = (dns_fill_t*)req->data;
+    dns_cache_store(fill->key, fill->keylen, status, res);
+    if (fill->uvcb != NULL) {
+        req->data = fill->cb;
+        fill->uvcb(req, status, res); // consumer frees req and res
+    }
+    else {
+        // background refresh: nobody is waiting
+        if (res != NULL)
+            uv_freeaddrinfo(res);
+        free(req);
+    }
+    free(fill->key);
+    free(fill);
+}
+
+// deliver a cache hit asynchronously so the caller's request/wait
+// pattern is indistinguishable from a real resolution
+typedef struct {
+    uv_timer_t timer;
+    uv_getaddrinfo_t *req;
+    uv_getaddrinfo_cb uvcb;
+    struct addrinfo *chain;
+    int status;
+} dns_hit_t;
+
+static void dns_hit_close_cb(uv_handle_t *hdl)
+{
+    free(hdl->data);
+}
+
+static void dns_hit_timer_cb(uv_timer_t *t)
+{
+    dns_hit_t *hit = (dns_hit_t*)t->data;
+    hit->uvcb(hit->req, hit->status, hit->chain);
+    uv_close((uv_handle_t*)&hit->timer, dns_hit_close_cb);
+}
+
+static int dns_start_query(uv_loop_t *loop, const char *host,
+                           const char *service, jl_function_t *cb,
+                           uv_getaddrinfo_cb uvcb, const char *key,
+                           size_t keylen)
+{
+    uv_getaddrinfo_t *req =
+        (uv_getaddrinfo_t*)malloc(sizeof(uv_getaddrinfo_t));
+    if (req == NULL)
+        return UV_ENOMEM;
+    dns_fill_t *fill = (dns_fill_t*)malloc(sizeof(dns_fill_t));
+    if (fill == NULL) {
+        free(req);
+        return UV_ENOMEM;
+    }
+    fill->cb = cb;
+    fill->uvcb = uvcb;
+    fill->key = (char*)malloc(keylen);
+    memcpy(fill->key, key, keylen);
+    fill->keylen = keylen;
+    req->data = fill;
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = PF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags |= AI_CANONNAME;
+    int err = uv_getaddrinfo(loop, req, dns_fill_cb, host, service, &hints);
+    if (err != 0) {
+        free(fill->key);
+        free(fill);
+        free(req);
+    }
+    return err;
+}
+#endif
+
 JL_DLLEXPORT int jl_getaddrinfo(uv_loop_t *loop, const char *host,
                                 const char *service, jl_function_t *cb,
                                 uv_getaddrinfo_cb uvcb)
 {
+#if defined(_OS_LINUX_) && defined(__GLIBC__)
+    if (!dns_ttl_inited) {
+        char *cp = getenv("JULIA_DNS_TTL");
+        if (cp != NULL)
+            dns_ttl_ns = (uint64_t)strtol(cp, NULL, 10) * 1000000000ull;
+        dns_ttl_inited = 1;
+    }
+    if (dns_ttl_ns != 0) {
+        char key[512];
+        size_t hl = strlen(host);
+        size_t sl = service ? strlen(service) : 0;
+        if (hl + sl + 2 <= sizeof(key)) {
+            size_t keylen = hl + sl + 2;
+            memcpy(key, host, hl + 1);
+            if (service)
+                memcpy(key + hl + 1, service, sl + 1);
+            else
+                key[hl + 1] = '\0';
+            dns_cache_ent_t *e = dns_cache_find(key, keylen);
+            uint64_t now = uv_hrtime();
+            if (e != NULL && now < e->expires) {
+                // near expiry: refresh in the background so the next
+                // hits never wait on the resolver
+                if (e->status == 0 && !e->refreshing &&
+                    e->expires - now < dns_ttl_ns / 4) {
+                    e->refreshing = 1;
+                    dns_start_query(loop, host, service, NULL, NULL,
+                                    key, keylen);
+                }
+                struct addrinfo *chain =
+                    e->status == 0 ? dns_copy_chain(e->chain) : NULL;
+                if (e->status == 0 && chain == NULL)
+                    return UV_ENOMEM;
+                dns_hit_t *hit = (dns_hit_t*)malloc(sizeof(dns_hit_t));
+                uv_getaddrinfo_t *req =
+                    (uv_getaddrinfo_t*)malloc(sizeof(uv_getaddrinfo_t));
+                if (hit == NULL || req == NULL) {
+                    free(hit);
+                    free(req);
+                    dns_free_chain(chain);
+                    return UV_ENOMEM;
+                }
+                req->data = cb;
+                hit->req = req;
+                hit->uvcb = uvcb;
+                hit->chain = chain;
+                hit->status = e->status;
+                hit->timer.data = hit;
+                uv_timer_init(loop, &hit->timer);
+                uv_timer_start(&hit->timer, dns_hit_timer_cb, 0, 0);
+                return 0;
+            }
+            return dns_start_query(loop, host, service, cb, uvcb,
+                                   key, keylen);
+        }
+    }
+#endif
     uv_getaddrinfo_t *req = (uv_getaddrinfo_t*)malloc(sizeof(uv_getaddrinfo_t));
     struct addrinfo hints;
 
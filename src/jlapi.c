@@ -12,6 +12,7 @@
 #include <string.h>
 #include <assert.h>
 #include "julia.h"
+#include "julia_internal.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,6 +49,21 @@ JL_DLLEXPORT void jl_init(const char *julia_home_dir)
     jl_init_with_image(julia_home_dir, NULL);
 }
 
+// Lighter-weight initialization for embedders that only evaluate
+// straightforward code: the compiler is set to --compile=min so snippets
+// run through the interpreter and the system image's precompiled
+// methods instead of paying JIT warmup, and the flisp parser contexts
+// are left to initialize lazily on the first parse. Everything else
+// (GC, system image, libuv) comes up as usual; full jl_init remains the
+// entry point for embedders that need JIT throughput.
+JL_DLLEXPORT void jl_init_minimal(const char *julia_home_dir)
+{
+    if (jl_is_initialized()) return;
+    jl_init_minimal_mode = 1;
+    jl_options.compile_enabled = JL_OPTIONS_COMPILE_MIN;
+    jl_init_with_image(julia_home_dir, NULL);
+}
+
 JL_DLLEXPORT jl_value_t *jl_eval_string(const char *str)
 {
     jl_value_t *r;
@@ -131,6 +147,146 @@ JL_DLLEXPORT jl_value_t *jl_call(jl_function_t *f, jl_value_t **args, int32_t na
     return v;
 }
 
+// Persistent compiled call handles for embedders.
+//
+// jl_prepare_call resolves (and compiles) the specialization of `f` for
+// a fixed argument-type signature once; jl_call_prepared then invokes
+// it directly through jl_call_method_internal, skipping jl_apply_generic
+// entirely on the steady-state path. Handles stay valid across method
+// redefinition: each carries the jl_methtable_world it was resolved
+// under and lazily re-resolves when the world has moved (the same
+// scheme the inline caches in gf.c use). The GC-visible parts of every
+// live handle are rooted through `jl_prepared_call_values`.
+typedef struct {
+    jl_function_t *f;
+    jl_tupletype_t *tt;      // full signature, including the function type
+    jl_lambda_info_t *linfo; // resolved specialization
+    uint64_t world;
+    size_t rootidx;          // base of this handle's 3 slots in the roots
+} jl_prepared_call_t;
+
+jl_array_t *jl_prepared_call_values = NULL;
+
+#define PREPARED_NROOTS 3
+
+static void prepared_set_roots(jl_prepared_call_t *h)
+{
+    jl_array_ptr_set(jl_prepared_call_values, h->rootidx + 0, (jl_value_t*)h->f);
+    jl_array_ptr_set(jl_prepared_call_values, h->rootidx + 1, (jl_value_t*)h->tt);
+    jl_array_ptr_set(jl_prepared_call_values, h->rootidx + 2, (jl_value_t*)h->linfo);
+}
+
+// resolve the specialization for h->tt under the current world.
+// returns 0 on failure (e.g. no applicable method anymore).
+static int prepared_resolve(jl_prepared_call_t *h)
+{
+    uint64_t world = jl_methtable_world;
+    jl_lambda_info_t *li = jl_get_specialization1(h->tt);
+    if (li == NULL) {
+        jl_methtable_t *mt = jl_gf_mtable((jl_value_t*)h->f);
+        li = jl_method_lookup_by_type(mt, h->tt, 1, 1);
+    }
+    if (li == NULL)
+        return 0;
+    h->linfo = li;
+    h->world = world;
+    prepared_set_roots(h);
+    return 1;
+}
+
+JL_DLLEXPORT void *jl_prepare_call(jl_function_t *f, jl_value_t *argtypes)
+{
+    jl_prepared_call_t *h = NULL;
+    JL_TRY {
+        jl_tupletype_t *tt = NULL;
+        JL_GC_PUSH2(&f, &tt);
+        tt = jl_argtype_with_function(f, (jl_tupletype_t*)argtypes);
+        if (jl_prepared_call_values == NULL)
+            jl_prepared_call_values = jl_alloc_vec_any(0);
+        h = (jl_prepared_call_t*)malloc(sizeof(jl_prepared_call_t));
+        h->f = f;
+        h->tt = tt;
+        h->linfo = NULL;
+        // reuse a released slot triple if one is free
+        size_t i, l = jl_array_len(jl_prepared_call_values);
+        for (i = 0; i < l; i += PREPARED_NROOTS) {
+            if (jl_array_ptr_ref(jl_prepared_call_values, i) == jl_nothing)
+                break;
+        }
+        if (i == l) {
+            jl_array_grow_end(jl_prepared_call_values, PREPARED_NROOTS);
+            jl_array_ptr_set(jl_prepared_call_values, i, jl_nothing);
+        }
+        h->rootidx = i;
+        if (!prepared_resolve(h)) {
+            jl_array_ptr_set(jl_prepared_call_values, i, jl_nothing);
+            free(h);
+            h = NULL;
+        }
+        JL_GC_POP();
+        jl_exception_clear();
+    }
+    JL_CATCH {
+        free(h);
+        h = NULL;
+    }
+    return h;
+}
+
+JL_DLLEXPORT jl_value_t *jl_call_prepared(void *handle, jl_value_t **args,
+                                          uint32_t nargs)
+{
+    jl_prepared_call_t *h = (jl_prepared_call_t*)handle;
+    jl_value_t *v;
+    JL_TRY {
+        jl_value_t **argv;
+        JL_GC_PUSHARGS(argv, nargs + 1);
+        argv[0] = (jl_value_t*)h->f;
+        memcpy(&argv[1], args, nargs * sizeof(jl_value_t*));
+        if (__unlikely(h->world != jl_methtable_world) &&
+            !prepared_resolve(h))
+            jl_method_error(h->f, argv, nargs + 1);
+        v = jl_call_method_internal(h->linfo, argv, nargs + 1);
+        JL_GC_POP();
+        jl_exception_clear();
+    }
+    JL_CATCH {
+        v = NULL;
+    }
+    return v;
+}
+
+JL_DLLEXPORT void jl_release_prepared(void *handle)
+{
+    jl_prepared_call_t *h = (jl_prepared_call_t*)handle;
+    if (h == NULL)
+        return;
+    size_t i;
+    for (i = 0; i < PREPARED_NROOTS; i++)
+        jl_array_ptr_set(jl_prepared_call_values, h->rootidx + i, jl_nothing);
+    free(h);
+}
+
+// Exception-bypass call for latency-critical embedders: no per-call
+// JL_TRY (no sigsetjmp), no exception translation. Must run inside a
+// JL_NOTHROW_REGION (julia.h) or below some other julia handler: a
+// throw unwinds to that handler, skipping any C++ frames between --
+// so the caller's code between region begin and the call must be
+// trivially unwindable (no destructors or resources that the skipped
+// frames would leak). The arguments are rooted for the duration of
+// the call only.
+JL_DLLEXPORT jl_value_t *jl_call_noexc(jl_function_t *f, jl_value_t **args,
+                                       int32_t nargs)
+{
+    jl_value_t **argv;
+    JL_GC_PUSHARGS(argv, nargs + 1);
+    argv[0] = (jl_value_t*)f;
+    memcpy(&argv[1], args, nargs * sizeof(jl_value_t*));
+    jl_value_t *v = jl_apply(argv, nargs + 1);
+    JL_GC_POP();
+    return v;
+}
+
 JL_DLLEXPORT jl_value_t *jl_call0(jl_function_t *f)
 {
     jl_value_t *v;
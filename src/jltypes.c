@@ -1137,12 +1137,60 @@ static jl_value_t *jl_type_intersect(jl_value_t *a, jl_value_t *b,
     return result;
 }
 
+// memoization for plain two-type intersections
+//
+// Method insertion storms and typemap misses intersect the same pairs of
+// type objects over and over. A small direct mapped cache keyed on the
+// exact pair of pointers (the repeats come from the same interned
+// signature objects, so identity is the right key and costs nothing)
+// remembers the result. Only typevar-free inputs are cached: their
+// intersection is a pure function of the pair, so no invalidation is
+// ever needed, and the result can be shared safely. Entries live in a
+// rooted array marked from pre_mark.
+#define INTERSECT_CACHE_SZ 1024 // must be a power of two
+jl_array_t *jl_intersect_cache_values = NULL; // [3*SZ]: a, b, result
+static jl_mutex_t intersect_cache_lock;
+
+STATIC_INLINE size_t intersect_cache_idx(jl_value_t *a, jl_value_t *b)
+{
+    uintptr_t h = ((uintptr_t)a >> 4) * 2654435761u + ((uintptr_t)b >> 4);
+    return h & (INTERSECT_CACHE_SZ - 1);
+}
+
 JL_DLLEXPORT jl_value_t *jl_type_intersection(jl_value_t *a, jl_value_t *b)
 {
+    int cacheable = !jl_has_typevars(a) && !jl_has_typevars(b);
+    size_t idx = 0;
+    if (cacheable) {
+        if (__unlikely(jl_intersect_cache_values == NULL)) {
+            jl_array_t *vals = jl_alloc_vec_any(3 * INTERSECT_CACHE_SZ);
+            JL_LOCK_NOGC(&intersect_cache_lock);
+            if (jl_intersect_cache_values == NULL)
+                jl_intersect_cache_values = vals;
+            JL_UNLOCK_NOGC(&intersect_cache_lock);
+        }
+        idx = intersect_cache_idx(a, b);
+        JL_LOCK_NOGC(&intersect_cache_lock);
+        if (jl_array_ptr_ref(jl_intersect_cache_values, 3 * idx) == a &&
+            jl_array_ptr_ref(jl_intersect_cache_values, 3 * idx + 1) == b) {
+            jl_value_t *res =
+                jl_array_ptr_ref(jl_intersect_cache_values, 3 * idx + 2);
+            JL_UNLOCK_NOGC(&intersect_cache_lock);
+            return res;
+        }
+        JL_UNLOCK_NOGC(&intersect_cache_lock);
+    }
     jl_svec_t *env = jl_emptysvec;
     JL_GC_PUSH1(&env);
     jl_value_t *ti = jl_type_intersection_matching(a, b, &env, jl_emptysvec);
     JL_GC_POP();
+    if (cacheable) {
+        JL_LOCK_NOGC(&intersect_cache_lock);
+        jl_array_ptr_set(jl_intersect_cache_values, 3 * idx, a);
+        jl_array_ptr_set(jl_intersect_cache_values, 3 * idx + 1, b);
+        jl_array_ptr_set(jl_intersect_cache_values, 3 * idx + 2, ti);
+        JL_UNLOCK_NOGC(&intersect_cache_lock);
+    }
     return ti;
 }
 
@@ -1932,11 +1980,10 @@ static int typekey_eq(jl_datatype_t *tt, jl_value_t **key, size_t n)
 // look up a type in a cache by binary or linear search.
 // if found, returns the index of the found item. if not found, returns
 // ~n, where n is the index where the type should be inserted.
-static ssize_t lookup_type_idx(jl_typename_t *tn, jl_value_t **key, size_t n, int ordered)
+static ssize_t lookup_type_idx(jl_svec_t *cache, jl_value_t **key, size_t n, int ordered)
 {
     if (n==0) return -1;
     if (ordered) {
-        jl_svec_t *cache = tn->cache;
         jl_value_t **data = jl_svec_data(cache);
         size_t cl = jl_svec_len(cache);
         ssize_t lo = -1;
@@ -1954,7 +2001,6 @@ static ssize_t lookup_type_idx(jl_typename_t *tn, jl_value_t **key, size_t n, in
         return ~hi;
     }
     else {
-        jl_svec_t *cache = tn->linearcache;
         jl_value_t **data = jl_svec_data(cache);
         size_t cl = jl_svec_len(cache);
         ssize_t i;
@@ -1971,11 +2017,15 @@ static ssize_t lookup_type_idx(jl_typename_t *tn, jl_value_t **key, size_t n, in
 static jl_value_t *lookup_type(jl_typename_t *tn, jl_value_t **key, size_t n)
 {
     int ord = is_typekey_ordered(key, n);
-    JL_LOCK(&typecache_lock); // Might GC
-    ssize_t idx = lookup_type_idx(tn, key, n, ord);
-    jl_value_t *t = (idx < 0) ? NULL : jl_svecref(ord ? tn->cache : tn->linearcache, idx);
-    JL_UNLOCK(&typecache_lock); // Might GC
-    return t;
+    // Lock-free: inserts always publish a fresh, immutable cache array
+    // with a release store (see cache_insert_type), so searching a
+    // snapshot needs no lock. A racing insert can make this miss; the
+    // caller ends up in jl_cache_type_, which re-checks under the lock
+    // before inserting.
+    jl_svec_t *cache = (jl_svec_t*)jl_atomic_load_acquire(
+        ord ? (jl_value_t**)&tn->cache : (jl_value_t**)&tn->linearcache);
+    ssize_t idx = lookup_type_idx(cache, key, n, ord);
+    return (idx < 0) ? NULL : jl_svecref(cache, idx);
 }
 
 static volatile int t_uid_ctr = 1;
@@ -2009,35 +2059,32 @@ static void cache_insert_type(jl_value_t *type, ssize_t insert_at, int ordered)
     // assign uid if it hasn't been done already
     if (!jl_is_abstracttype(type) && ((jl_datatype_t*)type)->uid==0)
         ((jl_datatype_t*)type)->uid = jl_assign_type_uid();
-    jl_svec_t *cache;
-    if (ordered)
-        cache = ((jl_datatype_t*)type)->name->cache;
-    else
-        cache = ((jl_datatype_t*)type)->name->linearcache;
+    jl_typename_t *tn = ((jl_datatype_t*)type)->name;
+    jl_svec_t *cache = ordered ? tn->cache : tn->linearcache;
     assert(jl_is_svec(cache));
     size_t n = jl_svec_len(cache);
-    if (n==0 || jl_svecref(cache,n-1) != NULL) {
-        jl_svec_t *nc = jl_alloc_svec(n < 8 ? 8 : (n*3)>>1);
-        memcpy(jl_svec_data(nc), jl_svec_data(cache), sizeof(void*) * n);
-        if (ordered)
-            ((jl_datatype_t*)type)->name->cache = nc;
-        else
-            ((jl_datatype_t*)type)->name->linearcache = nc;
-        jl_gc_wb(((jl_datatype_t*)type)->name, nc);
-        cache = nc;
-        n = jl_svec_len(nc);
-    }
-    jl_value_t **p = jl_svec_data(cache);
-    size_t i = insert_at;
-    jl_value_t *temp = p[i], *temp2;
-    jl_svecset(cache, insert_at, (jl_value_t*)type);
-    assert(i < n-1 || temp == NULL);
-    while (temp != NULL && i < n-1) {
-        i++;
-        temp2 = p[i];
-        p[i] = temp;
-        temp = temp2;
-    }
+    // number of slots in use (the tail is NULL padding)
+    size_t used = n;
+    while (used > 0 && jl_svecref(cache, used - 1) == NULL)
+        used--;
+    assert((size_t)insert_at <= used);
+    // Always build a new array instead of shifting in place, so that the
+    // lock-free readers in lookup_type keep searching a consistent
+    // snapshot. Grow it when the padding ran out.
+    size_t newn = used < n ? n : (n < 8 ? 8 : (n*3)>>1);
+    jl_svec_t *nc = jl_alloc_svec(newn);
+    memcpy(jl_svec_data(nc), jl_svec_data(cache),
+           sizeof(void*) * insert_at);
+    jl_svec_data(nc)[insert_at] = (jl_value_t*)type;
+    memcpy(jl_svec_data(nc) + insert_at + 1,
+           jl_svec_data(cache) + insert_at,
+           sizeof(void*) * (used - insert_at));
+    if (ordered)
+        jl_atomic_store_release((jl_value_t**)&tn->cache, (jl_value_t*)nc);
+    else
+        jl_atomic_store_release((jl_value_t**)&tn->linearcache,
+                                (jl_value_t*)nc);
+    jl_gc_wb(tn, nc);
 }
 
 jl_value_t *jl_cache_type_(jl_datatype_t *type)
@@ -2045,7 +2092,9 @@ jl_value_t *jl_cache_type_(jl_datatype_t *type)
     if (is_cacheable(type)) {
         int ord = is_typekey_ordered(jl_svec_data(type->parameters), jl_svec_len(type->parameters));
         JL_LOCK(&typecache_lock); // Might GC
-        ssize_t idx = lookup_type_idx(type->name, jl_svec_data(type->parameters),
+        ssize_t idx = lookup_type_idx(ord ? type->name->cache
+                                          : type->name->linearcache,
+                                      jl_svec_data(type->parameters),
                                       jl_svec_len(type->parameters), ord);
         if (idx >= 0)
             type = (jl_datatype_t*)jl_svecref(ord ? type->name->cache : type->name->linearcache, idx);
@@ -2220,6 +2269,8 @@ static jl_value_t *inst_datatype(jl_datatype_t *dt, jl_svec_t *p, jl_value_t **i
     ndt->instance = NULL;
     ndt->uid = 0;
     ndt->struct_decl = NULL;
+    ndt->ptroffsets = NULL;
+    ndt->nptrfields = -1;
     ndt->ditype = NULL;
     ndt->size = 0;
     ndt->alignment = 1;
@@ -2772,9 +2823,59 @@ int jl_subtype_le(jl_value_t *a, jl_value_t *b, int ta, int invariant)
     return jl_egal(a, b);
 }
 
+// Pair memoization for subtype queries, mirroring the
+// jl_type_intersection cache above: dispatch-miss scans and method
+// insertion ask the same ground-type questions over and over. Only
+// typevar-free pairs are cacheable; for those the answer is a property
+// of two immutable type objects and cannot change later (defining new
+// types cannot alter the relation between existing ones), so entries
+// never need invalidating. Keys are rooted through the cache array
+// (marked from pre_mark), so a slot can never hold a collected -- and
+// possibly reused -- type pointer.
+#define SUBTYPE_CACHE_SZ 1024 // must be a power of two
+jl_array_t *jl_subtype_cache_values = NULL; // [3*SZ]: a, b, true/false
+static jl_mutex_t subtype_cache_lock;
+
+STATIC_INLINE size_t subtype_cache_idx(jl_value_t *a, jl_value_t *b)
+{
+    uintptr_t h = ((uintptr_t)a >> 4) * 2654435761u + ((uintptr_t)b >> 4) * 40503u;
+    return h & (SUBTYPE_CACHE_SZ - 1);
+}
+
 JL_DLLEXPORT int jl_subtype(jl_value_t *a, jl_value_t *b, int ta)
 {
-    return jl_subtype_le(a, b, ta, 0);
+    int cacheable = !ta && jl_true != NULL &&
+        !jl_has_typevars(a) && !jl_has_typevars(b);
+    size_t idx = 0;
+    if (cacheable) {
+        if (__unlikely(jl_subtype_cache_values == NULL)) {
+            jl_array_t *vals = jl_alloc_vec_any(3 * SUBTYPE_CACHE_SZ);
+            JL_LOCK_NOGC(&subtype_cache_lock);
+            if (jl_subtype_cache_values == NULL)
+                jl_subtype_cache_values = vals;
+            JL_UNLOCK_NOGC(&subtype_cache_lock);
+        }
+        idx = subtype_cache_idx(a, b);
+        JL_LOCK_NOGC(&subtype_cache_lock);
+        if (jl_array_ptr_ref(jl_subtype_cache_values, 3 * idx) == a &&
+            jl_array_ptr_ref(jl_subtype_cache_values, 3 * idx + 1) == b) {
+            jl_value_t *res =
+                jl_array_ptr_ref(jl_subtype_cache_values, 3 * idx + 2);
+            JL_UNLOCK_NOGC(&subtype_cache_lock);
+            return res == jl_true;
+        }
+        JL_UNLOCK_NOGC(&subtype_cache_lock);
+    }
+    int res = jl_subtype_le(a, b, ta, 0);
+    if (cacheable) {
+        JL_LOCK_NOGC(&subtype_cache_lock);
+        jl_array_ptr_set(jl_subtype_cache_values, 3 * idx, a);
+        jl_array_ptr_set(jl_subtype_cache_values, 3 * idx + 1, b);
+        jl_array_ptr_set(jl_subtype_cache_values, 3 * idx + 2,
+                         res ? jl_true : jl_false);
+        JL_UNLOCK_NOGC(&subtype_cache_lock);
+    }
+    return res;
 }
 
 int jl_subtype_invariant(jl_value_t *a, jl_value_t *b, int ta)
@@ -3460,7 +3561,7 @@ void jl_init_types(void)
     // create base objects
     jl_datatype_type = jl_new_uninitialized_datatype(11, 1);
     jl_set_typeof(jl_datatype_type, jl_datatype_type);
-    jl_typename_type = jl_new_uninitialized_datatype(8, 1);
+    jl_typename_type = jl_new_uninitialized_datatype(9, 1);
     jl_sym_type = jl_new_uninitialized_datatype(0, 1);
     jl_symbol_type = jl_sym_type;
     jl_simplevector_type = jl_new_uninitialized_datatype(1, 1);
@@ -3500,6 +3601,8 @@ void jl_init_types(void)
     jl_datatype_type->instance = NULL;
     jl_datatype_type->uid = jl_assign_type_uid();
     jl_datatype_type->struct_decl = NULL;
+    jl_datatype_type->ptroffsets = NULL;
+    jl_datatype_type->nptrfields = -1;
     jl_datatype_type->ditype = NULL;
     jl_datatype_type->abstract = 0;
     jl_datatype_type->pointerfree = 0;
@@ -3513,16 +3616,19 @@ void jl_init_types(void)
     jl_typename_type->name->mt = jl_new_method_table(jl_typename_type->name->name, jl_current_module);
     jl_typename_type->super = jl_any_type;
     jl_typename_type->parameters = jl_emptysvec;
-    jl_typename_type->name->names = jl_svec(8, jl_symbol("name"), jl_symbol("module"),
+    jl_typename_type->name->names = jl_svec(9, jl_symbol("name"), jl_symbol("module"),
                                             jl_symbol("names"), jl_symbol("primary"),
                                             jl_symbol("cache"), jl_symbol("linearcache"),
-                                            jl_symbol("uid"), jl_symbol("mt"));
-    jl_typename_type->types = jl_svec(8, jl_sym_type, jl_any_type, jl_simplevector_type,
+                                            jl_symbol("uid"), jl_symbol("mt"),
+                                            jl_symbol("fcache"));
+    jl_typename_type->types = jl_svec(9, jl_sym_type, jl_any_type, jl_simplevector_type,
                                       jl_type_type, jl_simplevector_type, jl_simplevector_type,
-                                      jl_any_type, jl_any_type);
+                                      jl_any_type, jl_any_type, jl_any_type);
     jl_typename_type->uid = jl_assign_type_uid();
     jl_typename_type->instance = NULL;
     jl_typename_type->struct_decl = NULL;
+    jl_typename_type->ptroffsets = NULL;
+    jl_typename_type->nptrfields = -1;
     jl_typename_type->ditype = NULL;
     jl_typename_type->abstract = 0;
     jl_typename_type->pointerfree = 0;
@@ -3542,6 +3648,8 @@ void jl_init_types(void)
     jl_methtable_type->uid = jl_assign_type_uid();
     jl_methtable_type->instance = NULL;
     jl_methtable_type->struct_decl = NULL;
+    jl_methtable_type->ptroffsets = NULL;
+    jl_methtable_type->nptrfields = -1;
     jl_methtable_type->ditype = NULL;
     jl_methtable_type->abstract = 0;
     jl_methtable_type->pointerfree = 0;
@@ -3558,6 +3666,8 @@ void jl_init_types(void)
     jl_sym_type->instance = NULL;
     jl_sym_type->uid = jl_assign_type_uid();
     jl_sym_type->struct_decl = NULL;
+    jl_sym_type->ptroffsets = NULL;
+    jl_sym_type->nptrfields = -1;
     jl_sym_type->ditype = NULL;
     jl_sym_type->size = 0;
     jl_sym_type->abstract = 0;
@@ -3575,6 +3685,8 @@ void jl_init_types(void)
     jl_simplevector_type->uid = jl_assign_type_uid();
     jl_simplevector_type->instance = NULL;
     jl_simplevector_type->struct_decl = NULL;
+    jl_simplevector_type->ptroffsets = NULL;
+    jl_simplevector_type->nptrfields = -1;
     jl_simplevector_type->ditype = NULL;
     jl_simplevector_type->abstract = 0;
     jl_simplevector_type->pointerfree = 0;
@@ -3667,8 +3779,8 @@ void jl_init_types(void)
 
     jl_typemap_level_type =
         jl_new_datatype(jl_symbol("TypeMapLevel"), jl_any_type, jl_emptysvec,
-                        jl_svec(5, jl_symbol("arg1"), jl_symbol("targ"), jl_symbol("list"), jl_symbol("any"), jl_symbol("key")),
-                        jl_svec(5, jl_any_type,       jl_any_type,       jl_any_type,       jl_any_type,      jl_any_type),
+                        jl_svec(6, jl_symbol("arg1"), jl_symbol("targ"), jl_symbol("list"), jl_symbol("any"), jl_symbol("key"), jl_symbol("leafsigs")),
+                        jl_svec(6, jl_any_type,       jl_any_type,       jl_any_type,       jl_any_type,      jl_any_type,     jl_any_type),
                         0, 1, 4);
 
     jl_typemap_entry_type =
@@ -3818,7 +3930,7 @@ void jl_init_types(void)
     jl_lambda_info_type =
         jl_new_datatype(jl_symbol("LambdaInfo"),
                         jl_any_type, jl_emptysvec,
-                        jl_svec(26,
+                        jl_svec(27,
                                 jl_symbol("rettype"),
                                 jl_symbol("sparam_syms"),
                                 jl_symbol("sparam_vals"),
@@ -3842,8 +3954,9 @@ void jl_init_types(void)
                                 jl_symbol(""),
                                 jl_symbol("fptr"),
                                 jl_symbol(""), jl_symbol(""),
-                                jl_symbol(""), jl_symbol("")),
-                        jl_svec(26,
+                                jl_symbol(""), jl_symbol(""),
+                                jl_symbol("")),
+                        jl_svec(27,
                                 jl_any_type,
                                 jl_simplevector_type,
                                 jl_simplevector_type,
@@ -3867,7 +3980,8 @@ void jl_init_types(void)
                                 jl_bool_type,
                                 jl_any_type,
                                 jl_any_type, jl_any_type,
-                                jl_int32_type, jl_int32_type),
+                                jl_int32_type, jl_int32_type,
+                                jl_int32_type),
                         0, 1, 7);
     jl_svecset(jl_lambda_info_type->types, 9, jl_lambda_info_type);
     jl_svecset(jl_method_type->types, 8, jl_lambda_info_type);
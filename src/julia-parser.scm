@@ -1304,7 +1304,7 @@
               (take-token s)
               (let ((al (parse-arglist s #\))))
                 (if (and (length> al 1)
-                         (memq (cadr al) '(cdecl stdcall fastcall thiscall)))
+                         (memq (cadr al) '(cdecl stdcall fastcall thiscall gcsafe)))
                     ;; place (callingconv) at end of arglist
                     `(ccall ,(car al) ,@(cddr al) (,(cadr al)))
                     `(ccall ,.al))))))
@@ -266,6 +266,7 @@ typedef struct _jl_lambda_info_t {
     jl_llvm_functions_t functionObjectsDecls;
     int32_t functionID; // index that this function will have in the codegen table
     int32_t specFunctionID; // index that this specFunction will have in the codegen table
+    int32_t callcount; // calls run interpreted so far under --compile=tiered
 } jl_lambda_info_t;
 
 // all values are callable as Functions
@@ -298,6 +299,10 @@ typedef struct {
     jl_svec_t *linearcache;  // unsorted array
     intptr_t uid;
     struct _jl_methtable_t *mt;
+    // lazy field-name -> index table for wide types (nothing until the
+    // first dynamic lookup builds it; never serialized -- it holds raw
+    // symbol pointers)
+    jl_value_t *fcache;
 } jl_typename_t;
 
 typedef struct {
@@ -348,6 +353,12 @@ typedef struct _jl_datatype_t {
     uint32_t uid;
     void *struct_decl;  //llvm::Type*
     void *ditype; // llvm::MDNode* to be used as llvm::DIType(ditype)
+    // lazily built pointer-offset map driving the GC mark loop (gc.c):
+    // byte offsets of the pointer fields, so marking never interprets
+    // the field descriptors per object. NULL until an instance is
+    // marked; nptrfields is valid once set (0 = pointer-free)
+    int32_t *ptroffsets;
+    int32_t nptrfields;
     // Last field needs to be pointer size aligned
     // union {
     //     jl_fielddesc8_t field8[];
@@ -374,6 +385,9 @@ typedef struct {
     jl_sym_t *name;
     jl_value_t *value;
     jl_value_t *globalref;  // cached GlobalRef for this binding
+    // lambda infos whose generated code embedded this (const) binding's
+    // value as an immediate; invalidated on redefinition (module.c)
+    jl_value_t *dependents; // NULL or Vector{Any}
     struct _jl_module_t *owner;  // for individual imported bindings
     unsigned constp:1;
     unsigned exportp:1;
@@ -388,6 +402,12 @@ typedef struct _jl_module_t {
     htable_t bindings;
     arraylist_t usings;  // modules with all bindings potentially imported
     uint8_t istopmod;
+    // per-module math mode: overrides the global --math-mode for code
+    // whose enclosing module this is (see jl_module_set_fastmath)
+#define JL_MODULE_FASTMATH_DEFAULT 0 // follow jl_options.fast_math
+#define JL_MODULE_FASTMATH_ON 1
+#define JL_MODULE_FASTMATH_STRICT 2
+    uint8_t fastmath;
     uint64_t uuid;
     uint32_t counter;
 } jl_module_t;
@@ -420,6 +440,10 @@ typedef struct _jl_typemap_level_t {
     jl_typemap_entry_t *linear; // union jl_typemap_t (but no more levels)
     union jl_typemap_t any; // type at offs is Any
     jl_value_t *key; // [nullable]
+    // open addressed table over the full argument type vector of every
+    // leaf signature in the map; only maintained at root levels
+    // (key == NULL), see typemap.c
+    jl_array_t *leafsigs; // Array{jl_typemap_entry_t} or jl_nothing
 } jl_typemap_level_t;
 
 // contains the TypeMap for one Type
@@ -628,11 +652,102 @@ typedef struct _jl_gcframe_t {
 
 JL_DLLEXPORT int jl_gc_enable(int on);
 JL_DLLEXPORT int jl_gc_is_enabled(void);
+JL_DLLEXPORT int jl_gc_deferred_finalizers(int on);
+JL_DLLEXPORT void jl_gc_set_max_pause(uint64_t max_pause_ms);
+JL_DLLEXPORT void jl_gc_set_soft_heap_limit(uint64_t bytes);
+JL_DLLEXPORT uint64_t jl_gc_get_soft_heap_limit(void);
+
+// ---- inline pool-allocation fast path for C extensions ---------------
+//
+// Native code that allocates many small objects can skip the call into
+// the runtime on the common path, matching what emit_allocobj gives JIT
+// code: resolve the size class once with jl_gc_alloc_class, then bump
+// the thread-local pool cursor inline and fall into jl_gc_pool_alloc
+// only at a page boundary (or when allocation is instrumented). The
+// caller must set the type tag before the next safepoint makes the
+// object visible to the collector.
+#define JL_GC_PAGE_LG2 14 // log2 of the GC pool page size (gc.h mirrors)
+typedef struct {
+    uint32_t offset;     // byte offset of the pool in jl_tls_states_t
+    uint16_t osize;      // cell size (payload + tag)
+    uint16_t end_offset; // offset of the last cell in a page
+} jl_alloc_class_t;
+// resolve the allocation class for objects with `sz` payload bytes;
+// returns -1 (and leaves *cls untouched) when the size is not
+// pool-eligible and jl_gc_allocobj must be used instead
+JL_DLLEXPORT int jl_gc_alloc_class(size_t sz, jl_alloc_class_t *cls);
+JL_DLLEXPORT void *jl_gc_pool_alloc(jl_tls_states_t *ptls, jl_gc_pool_t *p,
+                                    int osize, int end_offset);
+JL_DLLEXPORT int64_t *jl_gc_allocd_counter(void);
+JL_DLLEXPORT uint64_t jl_gc_thread_allocd(int16_t tid);
+extern JL_DLLEXPORT volatile int jl_gc_alloc_instrumented;
+
+STATIC_INLINE jl_value_t *jl_gc_alloc_fast(jl_tls_states_t *ptls,
+                                           const jl_alloc_class_t *cls)
+{
+    jl_gc_pool_t *p = (jl_gc_pool_t*)((char*)ptls + cls->offset);
+    char *v = (char*)p->newpages;
+    if (v != NULL && !jl_gc_alloc_instrumented) {
+        char *end = (char*)((uintptr_t)v &
+                            ~(uintptr_t)((1 << JL_GC_PAGE_LG2) - 1)) +
+                    cls->end_offset;
+        int64_t na = ptls->gc_allocd_local + (int64_t)cls->osize;
+        if (v != end && na < 0) {
+            ptls->gc_allocd_local = na;
+            p->newpages = (jl_taggedvalue_t*)(v + cls->osize);
+            ((uintptr_t*)v)[0] = 0; // clear the header
+            jl_gc_safepoint_(ptls);
+            return (jl_value_t*)(v + sizeof(jl_taggedvalue_t));
+        }
+    }
+    // page boundary, empty cursor, collection due, or instrumentation:
+    // the runtime path handles all of it (freelists, refill, collect)
+    return (jl_value_t*)jl_gc_pool_alloc(ptls, p, cls->osize,
+                                         cls->end_offset);
+}
+JL_DLLEXPORT uint64_t jl_gc_get_max_pause(void);
+
+// one record per collection in the GC pause log. The log is a fixed size
+// ring that can be scraped from any thread without stopping the world with
+// jl_gc_get_pause_log.
+typedef struct {
+    uint64_t start_ns;   // jl_hrtime timestamp at the start of the pause
+    uint64_t pause_ns;   // total stop-the-world time
+    uint64_t mark_ns;    // time spent marking
+    uint64_t sweep_ns;   // time spent sweeping
+    int64_t pages_freed; // GC pages the sweep returned to the page allocator
+    int16_t tid;         // thread that triggered the collection
+    uint8_t full_sweep;
+    uint8_t incremental; // the pause was a bounded mark increment
+} jl_gc_pause_rec_t;
+JL_DLLEXPORT size_t jl_gc_get_pause_log(jl_gc_pause_rec_t *buf, size_t len);
+JL_DLLEXPORT void jl_gc_dump_heap(ios_t *out);
+
+// snapshot of the collector's tuning state, refreshed after every
+// collection (see jl_gc_stats_snapshot)
+typedef struct {
+    int64_t promoted_bytes;     // promoted to old gen since the last full sweep
+    int64_t live_bytes;         // the collector's live byte estimate
+    int64_t scanned_bytes;      // young bytes scanned by the last mark phase
+    int64_t perm_scanned_bytes; // old bytes scanned by the last mark phase
+    size_t interval;            // allocation budget until the next collection
+    size_t last_long_interval;  // interval restored after a large frontier
+    size_t max_interval;        // upper bound on the interval
+    int n_pools;                // number of valid entries in the arrays below
+    // objects alive in each pool size class as observed by the last sweep
+    uint64_t pool_survivors[JL_GC_N_POOLS];
+    // object size in bytes of each pool size class
+    uint16_t pool_sizes[JL_GC_N_POOLS];
+} jl_gc_stats_t;
+JL_DLLEXPORT void jl_gc_stats_snapshot(jl_gc_stats_t *stats);
 JL_DLLEXPORT int64_t jl_gc_total_bytes(void);
 JL_DLLEXPORT uint64_t jl_gc_total_hrtime(void);
 JL_DLLEXPORT int64_t jl_gc_diff_total_bytes(void);
 
 JL_DLLEXPORT void jl_gc_collect(int);
+JL_DLLEXPORT void jl_gc_census_start(void);
+JL_DLLEXPORT void jl_gc_census_stop(void);
+JL_DLLEXPORT jl_value_t *jl_gc_census_snapshot(void);
 
 JL_DLLEXPORT void jl_gc_add_finalizer(jl_value_t *v, jl_function_t *f);
 JL_DLLEXPORT void jl_finalize(jl_value_t *o);
@@ -641,8 +756,17 @@ JL_DLLEXPORT jl_value_t *jl_gc_alloc_0w(void);
 JL_DLLEXPORT jl_value_t *jl_gc_alloc_1w(void);
 JL_DLLEXPORT jl_value_t *jl_gc_alloc_2w(void);
 JL_DLLEXPORT jl_value_t *jl_gc_alloc_3w(void);
+JL_DLLEXPORT jl_value_t *jl_gc_alloc_4w(void);
+JL_DLLEXPORT jl_value_t *jl_gc_alloc_5w(void);
 JL_DLLEXPORT jl_value_t *jl_gc_allocobj(size_t sz);
 
+// arena allocator for short-lived native scratch memory (see gc-pages.c)
+typedef struct _jl_arena_t jl_arena_t;
+JL_DLLEXPORT jl_arena_t *jl_arena_create(void);
+JL_DLLEXPORT void *jl_arena_alloc(jl_arena_t *a, size_t sz);
+JL_DLLEXPORT void jl_arena_reset(jl_arena_t *a);
+JL_DLLEXPORT void jl_arena_destroy(jl_arena_t *a);
+
 JL_DLLEXPORT void jl_clear_malloc_data(void);
 
 // GC write barriers
@@ -668,6 +792,7 @@ STATIC_INLINE void jl_gc_wb_back(void *ptr) // ptr isa jl_value_t*
 JL_DLLEXPORT void *jl_gc_managed_malloc(size_t sz);
 JL_DLLEXPORT void *jl_gc_managed_realloc(void *d, size_t sz, size_t oldsz,
                                          int isaligned, jl_value_t *owner);
+JL_DLLEXPORT void jl_array_reserve(jl_array_t *a, size_t reserve_nel);
 
 // object accessors -----------------------------------------------------------
 
@@ -1016,6 +1141,10 @@ JL_DLLEXPORT jl_value_t *jl_new_bits(jl_value_t *bt, void *data);
 JL_DLLEXPORT jl_value_t *jl_new_struct(jl_datatype_t *type, ...);
 JL_DLLEXPORT jl_value_t *jl_new_structv(jl_datatype_t *type, jl_value_t **args,
                                         uint32_t na);
+JL_DLLEXPORT int jl_new_structs_bulk(jl_datatype_t *type, const char *src,
+                                     size_t count, jl_array_t *out,
+                                     size_t offset);
+JL_DLLEXPORT void jl_datatype_pack_layout(jl_datatype_t *st);
 JL_DLLEXPORT jl_value_t *jl_new_struct_uninit(jl_datatype_t *type);
 JL_DLLEXPORT jl_lambda_info_t *jl_new_lambda_info_uninit(void);
 JL_DLLEXPORT jl_lambda_info_t *jl_new_lambda_info_from_ast(jl_expr_t *ast);
@@ -1154,6 +1283,16 @@ JL_DLLEXPORT jl_array_t *jl_ptr_to_array(jl_value_t *atype, void *data,
                                          jl_value_t *dims, int own_buffer);
 
 JL_DLLEXPORT jl_array_t *jl_alloc_array_1d(jl_value_t *atype, size_t nr);
+JL_DLLEXPORT jl_array_t *jl_alloc_array_1d_aligned(jl_value_t *atype,
+                                                   size_t nel, size_t align);
+JL_DLLEXPORT void jl_array_copyto_buf(jl_array_t *a, size_t offs, void *buf,
+                                      size_t n);
+JL_DLLEXPORT void jl_array_fill_from_buf(jl_array_t *a, size_t offs,
+                                         const void *buf, size_t n);
+JL_DLLEXPORT jl_array_t *jl_stringbuilder_new(size_t sizehint);
+JL_DLLEXPORT void jl_stringbuilder_append(jl_array_t *sb, const char *data,
+                                          size_t len);
+JL_DLLEXPORT jl_value_t *jl_stringbuilder_take(jl_array_t *sb);
 JL_DLLEXPORT jl_array_t *jl_alloc_array_2d(jl_value_t *atype, size_t nr,
                                            size_t nc);
 JL_DLLEXPORT jl_array_t *jl_alloc_array_3d(jl_value_t *atype, size_t nr,
@@ -1261,6 +1400,7 @@ JL_DLLEXPORT void JL_NORETURN jl_bounds_error(jl_value_t *v, jl_value_t *t);
 JL_DLLEXPORT void JL_NORETURN jl_bounds_error_v(jl_value_t *v,
                                                 jl_value_t **idxs, size_t nidxs);
 JL_DLLEXPORT void JL_NORETURN jl_bounds_error_int(jl_value_t *v, size_t i);
+JL_DLLEXPORT int jl_boundserror_reuse(int enable);
 JL_DLLEXPORT void JL_NORETURN jl_bounds_error_tuple_int(jl_value_t **v,
                                                         size_t nv, size_t i);
 JL_DLLEXPORT void JL_NORETURN jl_bounds_error_unboxed_int(void *v, jl_value_t *vt, size_t i);
@@ -1293,6 +1433,9 @@ typedef enum {
 } JL_IMAGE_SEARCH;
 JL_DLLEXPORT void julia_init(JL_IMAGE_SEARCH rel);
 JL_DLLEXPORT void jl_init(const char *julia_home_dir);
+JL_DLLEXPORT void jl_init_minimal(const char *julia_home_dir);
+JL_DLLEXPORT void jl_module_set_fastmath(jl_module_t *m, int mode);
+extern JL_DLLEXPORT int jl_init_minimal_mode;
 JL_DLLEXPORT void jl_init_with_image(const char *julia_home_dir,
                                      const char *image_relative_path);
 JL_DLLEXPORT int jl_is_initialized(void);
@@ -1389,6 +1532,7 @@ STATIC_INLINE int jl_vinfo_usedundef(uint8_t vi)
 // calling into julia ---------------------------------------------------------
 
 JL_DLLEXPORT jl_value_t *jl_apply_generic(jl_value_t **args, uint32_t nargs);
+JL_DLLEXPORT void jl_call_cache_stats(uint64_t *hits, uint64_t *misses);
 JL_DLLEXPORT jl_value_t *jl_invoke(jl_lambda_info_t *meth, jl_value_t **args, uint32_t nargs);
 
 STATIC_INLINE
@@ -1399,7 +1543,17 @@ jl_value_t *jl_apply(jl_value_t **args, uint32_t nargs)
 
 JL_DLLEXPORT jl_value_t *jl_call(jl_function_t *f, jl_value_t **args, int32_t nargs);
 JL_DLLEXPORT jl_value_t *jl_call0(jl_function_t *f);
+JL_DLLEXPORT jl_value_t *jl_call_noexc(jl_function_t *f, jl_value_t **args,
+                                       int32_t nargs);
 JL_DLLEXPORT jl_value_t *jl_call1(jl_function_t *f, jl_value_t *a);
+// persistent compiled call handles: bind `f` to the specialization for
+// `argtypes` (a tuple type of the argument types, not including the
+// function) once, then call repeatedly without re-entering dispatch.
+// Handles survive method redefinition by re-resolving lazily.
+JL_DLLEXPORT void *jl_prepare_call(jl_function_t *f, jl_value_t *argtypes);
+JL_DLLEXPORT jl_value_t *jl_call_prepared(void *handle, jl_value_t **args,
+                                          uint32_t nargs);
+JL_DLLEXPORT void jl_release_prepared(void *handle);
 JL_DLLEXPORT jl_value_t *jl_call2(jl_function_t *f, jl_value_t *a, jl_value_t *b);
 JL_DLLEXPORT jl_value_t *jl_call3(jl_function_t *f, jl_value_t *a,
                                   jl_value_t *b, jl_value_t *c);
@@ -1446,6 +1600,10 @@ typedef struct _jl_task_t {
 
     size_t ssize;
     size_t started:1;
+    // with COPY_STACKS, whether this task switches by copying its stack in
+    // and out of the thread stack (the default) or runs on its own stack
+    // buffer (see the hybrid stack note in task.c)
+    size_t copy_stack:1;
 
     // current exception handler
     jl_handler_t *eh;
@@ -1572,6 +1730,28 @@ void jl_longjmp(jmp_buf _Buf,int _Value);
 
 #define JL_EH_POP() jl_eh_restore_state(&__eh)
 
+// Amortized exception handling for embedders: one handler (one
+// sigsetjmp) brackets a whole run of jl_call_noexc calls instead of
+// paying the setjmp per call as jl_call* do. On a throw anywhere in
+// the region, control returns to JL_NOTHROW_REGION_BEGIN with `failed`
+// set and jl_exception_occurred() reporting the exception; values from
+// calls issued after the throw point were never produced, so the
+// caller must treat the whole region as failed (or re-enter it).
+// Contract: the region must stay on one thread, must not return or
+// longjmp out between BEGIN and END, and arguments passed to
+// jl_call_noexc must be kept rooted by the caller across the region
+// (the callee roots them only for the duration of each call).
+#define JL_NOTHROW_REGION_BEGIN(failed)                           \
+    int failed = 0; jl_handler_t __eh_region;                     \
+    jl_enter_handler(&__eh_region);                               \
+    if (jl_setjmp(__eh_region.eh_ctx, 0)) {                       \
+        failed = 1;                                               \
+        jl_eh_restore_state(&__eh_region);                        \
+    }
+
+#define JL_NOTHROW_REGION_END()                                   \
+    do { jl_eh_restore_state(&__eh_region); } while (0)
+
 #ifdef _OS_WINDOWS_
 #define JL_CATCH                                                \
     else                                                        \
@@ -1595,6 +1775,8 @@ JL_DLLEXPORT int jl_run_once(uv_loop_t *loop);
 JL_DLLEXPORT int jl_process_events(uv_loop_t *loop);
 
 JL_DLLEXPORT uv_loop_t *jl_global_event_loop(void);
+JL_DLLEXPORT uv_loop_t *jl_thread_event_loop(void);
+JL_DLLEXPORT int jl_uv_post_to(int16_t tid, void (*cb)(void*), void *arg);
 
 JL_DLLEXPORT void jl_close_uv(uv_handle_t *handle);
 
@@ -1704,6 +1886,7 @@ JL_DLLEXPORT int jl_generating_output(void);
 #define JL_OPTIONS_COMPILE_ON  1
 #define JL_OPTIONS_COMPILE_ALL 2
 #define JL_OPTIONS_COMPILE_MIN 3
+#define JL_OPTIONS_COMPILE_TIERED 4
 
 #define JL_OPTIONS_COLOR_ON 1
 #define JL_OPTIONS_COLOR_OFF 2
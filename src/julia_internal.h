@@ -43,10 +43,10 @@ extern unsigned sig_stack_size;
 JL_DLLEXPORT extern int jl_lineno;
 JL_DLLEXPORT extern const char *jl_filename;
 
-JL_DLLEXPORT void *jl_gc_pool_alloc(jl_tls_states_t *ptls, jl_gc_pool_t *p,
-                                    int osize, int end_offset);
 JL_DLLEXPORT jl_value_t *jl_gc_big_alloc(jl_tls_states_t *ptls, size_t allocsz);
 int jl_gc_classify_pools(size_t sz, int *osize, int *end_offset);
+// JL_GC_PAGE_LG2, jl_gc_allocd_counter, and jl_gc_alloc_instrumented
+// moved to julia.h for the public inline allocation fast path
 
 STATIC_INLINE jl_value_t *newobj(jl_value_t *type, size_t nfields)
 {
@@ -60,6 +60,12 @@ STATIC_INLINE jl_value_t *newobj(jl_value_t *type, size_t nfields)
         jv = (jl_value_t*)jl_gc_alloc_2w(); break;
     case 3:
         jv = (jl_value_t*)jl_gc_alloc_3w(); break;
+    // 4 and 5 fields cover the 3 and 4 element svecs (length word + data)
+    // that type instantiation allocates by the million
+    case 4:
+        jv = (jl_value_t*)jl_gc_alloc_4w(); break;
+    case 5:
+        jv = (jl_value_t*)jl_gc_alloc_5w(); break;
     default:
         jv = (jl_value_t*)jl_gc_allocobj(nfields * sizeof(void*));
     }
@@ -78,19 +84,58 @@ jl_lambda_info_t *jl_type_infer(jl_lambda_info_t *li, int force);
 void jl_generate_fptr(jl_lambda_info_t *li);
 void jl_compile_linfo(jl_lambda_info_t *li);
 JL_DLLEXPORT int jl_compile_hint(jl_tupletype_t *types);
+JL_DLLEXPORT jl_value_t *jl_compile_hints_batch(jl_array_t *sigs);
 jl_lambda_info_t *jl_compile_for_dispatch(jl_lambda_info_t *li);
 JL_DLLEXPORT void jl_set_lambda_code_null(jl_lambda_info_t *li);
 
 // invoke (compiling if necessary) the jlcall function pointer for a method
 jl_lambda_info_t *jl_get_unspecialized(jl_lambda_info_t *method);
+extern JL_DLLEXPORT volatile uint64_t jl_methtable_world;
+JL_DLLEXPORT jl_value_t *jl_apply_generic_ic(void **site, jl_value_t **args,
+                                             uint32_t nargs);
+jl_value_t *jl_interpret_call(jl_lambda_info_t *lam, jl_value_t **args,
+                              uint32_t nargs, jl_svec_t *sparam_vals);
+extern jl_mutex_t codegen_lock;
+// whether the body of `meth` is something jl_interpret_call can execute
+STATIC_INLINE int jl_can_interpret(jl_lambda_info_t *meth)
+{
+    return meth->jlcall_api != 2 && !meth->inCompile &&
+        meth->code != jl_nothing && jl_typeis(meth->code, jl_array_any_type);
+}
+// 0 when re-optimization is off; otherwise the call count at which a
+// compiled method is regenerated through the hot pipeline (JULIA_REOPT_THRESHOLD)
+extern JL_DLLEXPORT int32_t jl_reopt_threshold;
+JL_DLLEXPORT void jl_reopt_linfo(jl_lambda_info_t *li);
+
 STATIC_INLINE jl_value_t *jl_call_method_internal(jl_lambda_info_t *meth, jl_value_t **args, uint32_t nargs)
 {
     jl_lambda_info_t *mfptr = meth;
     if (__unlikely(mfptr->fptr == NULL)) {
+        // Under --compile=tiered, run cold methods in the interpreter and
+        // only hand them to the JIT once they have been called
+        // JL_TIERED_COMPILE_THRESHOLD times. The counter increment is
+        // deliberately plain; lost increments just delay the handoff.
+        if (__unlikely(jl_options.compile_enabled == JL_OPTIONS_COMPILE_TIERED) &&
+            jl_can_interpret(meth) &&
+            meth->callcount++ < JL_TIERED_COMPILE_THRESHOLD)
+            return jl_interpret_call(meth, args, nargs, meth->sparam_vals);
+        // Don't stall dispatch behind another thread's compilation when the
+        // body can be interpreted instead; codegen is retried on the next
+        // call, once the lock is free.
+        if (__unlikely(jl_mutex_held_by_other(&codegen_lock)) &&
+            jl_can_interpret(meth))
+            return jl_interpret_call(meth, args, nargs, meth->sparam_vals);
         mfptr = jl_compile_for_dispatch(mfptr);
         if (!mfptr->fptr)
             jl_generate_fptr(mfptr);
     }
+    else if (__unlikely(jl_reopt_threshold != 0) &&
+             __unlikely(++meth->callcount == jl_reopt_threshold)) {
+        // still hot after compilation: regenerate once through the
+        // aggressive pipeline and swap the fresh pointer in
+        jl_reopt_linfo(meth);
+        mfptr = meth;
+    }
     if (mfptr->jlcall_api == 0)
         return mfptr->fptr(args[0], &args[1], nargs-1);
     else if (mfptr->jlcall_api == 1)
@@ -175,6 +220,9 @@ int jl_types_equal_generic(jl_value_t *a, jl_value_t *b, int useenv);
 jl_datatype_t *jl_inst_concrete_tupletype_v(jl_value_t **p, size_t np);
 jl_datatype_t *jl_inst_concrete_tupletype(jl_svec_t *p);
 void jl_method_table_insert(jl_methtable_t *mt, jl_method_t *method, jl_tupletype_t *simpletype);
+JL_DLLEXPORT void jl_method_batch_begin(void);
+void jl_binding_add_dependent(jl_binding_t *b, jl_value_t *li);
+JL_DLLEXPORT void jl_method_batch_end(void);
 jl_value_t *jl_mk_builtin_func(const char *name, jl_fptr_t fptr);
 STATIC_INLINE int jl_is_type(jl_value_t *v)
 {
@@ -248,6 +296,27 @@ void jl_init_serializer(void);
 void jl_gc_init(void);
 void jl_init_restored_modules(jl_array_t *init_order);
 void jl_init_signal_async(void);
+void jl_init_gc_safe_poll(void);
+void jl_init_uv_cmd_queue(void);
+// one record per profiler sample block (see signal-handling.c)
+typedef struct {
+    uint64_t tid;       // index of the sampled thread
+    uint64_t timestamp; // jl_hrtime at the sample
+} jl_profile_meta_t;
+void jl_profile_record_meta(uint64_t tid);
+JL_DLLEXPORT uint8_t *jl_profile_get_meta(void);
+JL_DLLEXPORT size_t jl_profile_len_meta(void);
+JL_DLLEXPORT int jl_uv_post(void (*cb)(void*), void *arg);
+JL_DLLEXPORT int8_t jl_cfunction_gc_unsafe_enter(void);
+JL_DLLEXPORT int8_t jl_ccall_gc_safe_enter(void);
+JL_DLLEXPORT void jl_ccall_gc_safe_leave(int8_t state);
+JL_DLLEXPORT void *jl_gc_managed_malloc_aligned(size_t sz, size_t align);
+extern jl_array_t *jl_match_cache_values; // gf.c method-match memoization
+extern jl_array_t *jl_subtype_cache_values; // jltypes.c subtype memoization
+extern jl_array_t *jl_prepared_call_values; // jlapi.c prepared-call handles
+extern jl_value_t *jl_eof_exception; // builtins.c preallocated EOFError
+extern jl_array_t *jl_intersect_cache_values; // jltypes.c intersection memoization
+JL_DLLEXPORT void jl_cfunction_gc_unsafe_leave(int8_t state);
 void jl_init_debuginfo(void);
 void jl_init_runtime_ccall(void);
 void jl_mk_thread_heap(jl_tls_states_t *ptls);
@@ -378,6 +447,11 @@ typedef unw_cursor_t bt_cursor_t;
 #define jl_bt_size (jl_get_ptls_states()->bt_size)
 size_t rec_backtrace(uintptr_t *data, size_t maxsize);
 size_t rec_backtrace_ctx(uintptr_t *data, size_t maxsize, bt_context_t *ctx);
+#if defined(_OS_LINUX_) && defined(_CPU_X86_64_)
+size_t rec_backtrace_ctx_fp(uintptr_t *data, size_t maxsize, bt_context_t *ctx,
+                            char *stack_hi);
+size_t rec_backtrace_fp_here(uintptr_t *data, size_t maxsize);
+#endif
 #ifdef LIBOSXUNWIND
 size_t rec_backtrace_ctx_dwarf(uintptr_t *data, size_t maxsize, bt_context_t *ctx);
 #endif
@@ -608,6 +682,7 @@ struct jl_typemap_info {
     jl_datatype_t **jl_contains; // the type that is being put in this
 };
 
+void jl_typemap_rebuild_leafsigs(union jl_typemap_t cache);
 jl_typemap_entry_t *jl_typemap_insert(union jl_typemap_t *cache, jl_value_t *parent,
                                       jl_tupletype_t *type, jl_svec_t *tvars,
                                       jl_tupletype_t *simpletype, jl_svec_t *guardsigs,
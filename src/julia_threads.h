@@ -49,11 +49,11 @@ typedef struct {
 
     // variables for tracking "remembered set"
     arraylist_t rem_bindings;
-    arraylist_t _remset[2]; // contains jl_value_t*
+    chunklist_t _remset[2]; // contains jl_value_t*
     // lower bound of the number of pointers inside remembered values
     int remset_nptr;
-    arraylist_t *remset;
-    arraylist_t *last_remset;
+    chunklist_t *remset;
+    chunklist_t *last_remset;
 
     // variables for allocating objects from pools
 #ifdef _P64
@@ -62,6 +62,14 @@ typedef struct {
 #define JL_GC_N_POOLS 43
 #endif
     jl_gc_pool_t norm_pools[JL_GC_N_POOLS];
+
+    // cache of pages batched out of the global page allocator so that
+    // allocation only rarely touches the page allocator lock. The cached
+    // pages are returned to the allocator when the pools are swept since
+    // their metadata is stale until they are handed to a pool.
+#define JL_GC_PAGE_CACHE_SZ 16
+    void *page_cache[JL_GC_PAGE_CACHE_SZ];
+    int n_cached_pages;
 } jl_thread_heap_t;
 
 // This includes all the thread local states we care about for a thread.
@@ -69,6 +77,23 @@ typedef struct {
 typedef struct _jl_tls_states_t {
     struct _jl_gcframe_t *pgcstack;
     struct _jl_value_t *exception_in_transit;
+    // reusable BoundsError machinery (jl_boundserror_reuse): preallocated
+    // error object and index box, engaged only while the flag is set
+    struct _jl_value_t *reusable_boundserr;
+    struct _jl_value_t *reusable_boundserr_idx;
+    volatile int8_t boundserr_reuse;
+    // this thread's private event loop (jl_thread_event_loop): NULL
+    // until first use; the master thread aliases the global loop
+    struct uv_loop_s *event_loop;
+    // MPSC handoff queue feeding that loop (see jl_uv_post_to)
+    void *volatile uv_cmd_head;
+    void *uv_cmd_async; // uv_async_t* poking this thread's loop
+    // sharded allocation accounting: hot allocation paths count into
+    // this thread-local quantum and fold it into the global trigger at
+    // most once per JL_GC_ALLOCD_QUANTUM bytes (see gc.c);
+    // gc_allocd_total accumulates this thread's lifetime bytes
+    int64_t gc_allocd_local;
+    uint64_t gc_allocd_total;
     volatile size_t *safepoint;
     // Whether it is safe to execute GC at the same time.
 #define JL_GC_STATE_WAITING 1
@@ -110,6 +135,13 @@ typedef struct _jl_tls_states_t {
     // Counter to disable finalizer **on the current thread**
     int finalizers_inhibited;
     arraylist_t finalizers;
+    // (buffer, size) pairs of stacks recycled from finished own-stack
+    // tasks; kept alive by the collector (see pre_mark) until reused
+    arraylist_t stack_pool;
+    // a finished task's stack awaiting recycling: it cannot enter the
+    // pool until the thread has switched off of it (see ctx_switch)
+    void *pending_dead_stack;
+    size_t pending_dead_stack_sz;
 } jl_tls_states_t;
 
 #ifdef __MIC__
@@ -449,6 +481,15 @@ static inline void jl_mutex_lock_nogc(jl_mutex_t *lock)
     jl_mutex_wait(lock, 0);
 }
 
+// whether `lock` is currently held by another thread. This is a racy probe
+// and can only be used as a heuristic (e.g. to pick a fallback path
+// instead of blocking).
+static inline int jl_mutex_held_by_other(jl_mutex_t *lock)
+{
+    unsigned long owner = jl_atomic_load_acquire(&lock->owner);
+    return owner != 0 && owner != jl_thread_self();
+}
+
 static inline void jl_mutex_lock(jl_mutex_t *lock)
 {
     JL_SIGATOMIC_BEGIN();
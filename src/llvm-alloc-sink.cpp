@@ -0,0 +1,294 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+// Rewrite pool allocations that provably do not escape the emitting
+// function into stack allocations.
+//
+// This runs on the emitted IR right before the GC frame is lowered
+// (finalize_gc_frame in codegen.cpp), while the `julia.gc_root_decl`
+// intrinsics are still present. An allocation can be sunk when every
+// transitive use of its result is one of:
+//
+//  - a bitcast or getelementptr (followed through),
+//  - a load (loads never capture),
+//  - a store *into* the object of a non-pointer value -- a stack box is
+//    never scanned by the collector, so it must not end up holding the
+//    only reference to a heap object. The type tag store (one word before
+//    the object) is exempt from that restriction,
+//  - a store of the object into a `julia.gc_root_decl` slot; stack boxes
+//    need no rooting, so these stores are rewritten to store null. (They
+//    must not stay: the collector would try to mark a stack address.)
+//
+// Everything else -- calls (which includes the write barrier emitted for
+// pointer stores into mutables), returns, phis, selects, comparisons,
+// ptrtoint, memory intrinsics -- conservatively counts as an escape.
+// Only pool allocations (`jl_gc_pool_alloc`, <= 2k) are considered: the
+// point of the exercise is the small wrapper boxes produced by numeric
+// kernels, and sinking big objects would risk blowing the stack in loops.
+//
+// emit_allocobj inlines a bump fast path around the slow call, so in
+// JIT mode the allocation's value is a phi merging the inline cursor
+// bump with the call:
+//     entry: ... br i1 %have_page, label %try, label %slow
+//     try:   ... br i1 %bail, label %slow, label %fast
+//     fast:  ... br label %cont
+//     slow:  %r = call jl_gc_pool_alloc(...) ; br label %cont
+//     cont:  %obj = phi [%fastval, %fast], [%r, %slow]
+// That exact diamond is recognized (anything else keeps the
+// conservative phi-is-an-escape rule): the analysis then runs on the
+// phi, and sinking bypasses the whole diamond by branching straight to
+// the continuation -- otherwise the inline fast path would keep
+// consuming a heap cell for every "sunk" allocation.
+
+#include "llvm-version.h"
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include "julia.h"
+#include "julia_internal.h"
+
+using namespace llvm;
+
+namespace {
+
+static Value *strip_casts(Value *v)
+{
+    while (BitCastInst *bc = dyn_cast<BitCastInst>(v))
+        v = bc->getOperand(0);
+    return v;
+}
+
+class AllocationSinker {
+public:
+    AllocationSinker(Function &F)
+        : F(F),
+          pool_alloc(F.getParent()->getFunction("jl_gc_pool_alloc")),
+          gcroot_decl(F.getParent()->getFunction("julia.gc_root_decl"))
+    {}
+
+    void run()
+    {
+        if (!pool_alloc)
+            return;
+        SmallVector<CallInst*, 8> candidates;
+        for (BasicBlock &bb : F) {
+            for (Instruction &inst : bb) {
+                CallInst *call = dyn_cast<CallInst>(&inst);
+                if (call && call->getCalledFunction() == pool_alloc &&
+                    isa<ConstantInt>(call->getArgOperand(2)))
+                    candidates.push_back(call);
+            }
+        }
+        for (CallInst *call : candidates) {
+            DiamondShape shape;
+            Value *obj = call;
+            if (match_alloc_diamond(call, shape))
+                obj = shape.phi;
+            SmallVector<StoreInst*, 4> root_stores;
+            if (escapes(obj, root_stores))
+                continue;
+            sink(call, shape, root_stores);
+        }
+    }
+
+private:
+    // the fast/slow allocation diamond (see the file comment); all
+    // fields null when the call is a plain allocation
+    struct DiamondShape {
+        PHINode *phi = nullptr;
+        BasicBlock *entry = nullptr;
+        BasicBlock *cont = nullptr;
+    };
+
+    // match the diamond emit_allocobj builds around `call`; fills
+    // `shape` and returns true on the exact expected structure
+    bool match_alloc_diamond(CallInst *call, DiamondShape &shape)
+    {
+        if (!call->hasOneUse())
+            return false;
+        PHINode *phi = dyn_cast<PHINode>(call->user_back());
+        if (!phi || phi->getNumIncomingValues() != 2)
+            return false;
+        BasicBlock *slowbb = call->getParent();
+        BasicBlock *contbb = phi->getParent();
+        BranchInst *sbr = dyn_cast<BranchInst>(slowbb->getTerminator());
+        if (!sbr || sbr->isConditional() || sbr->getSuccessor(0) != contbb)
+            return false;
+        BasicBlock *fastbb = phi->getIncomingBlock(0) == slowbb
+            ? phi->getIncomingBlock(1) : phi->getIncomingBlock(0);
+        if (phi->getIncomingValueForBlock(slowbb) != call)
+            return false;
+        BranchInst *fbr = dyn_cast<BranchInst>(fastbb->getTerminator());
+        if (!fbr || fbr->isConditional() || fbr->getSuccessor(0) != contbb)
+            return false;
+        BasicBlock *trybb = fastbb->getSinglePredecessor();
+        if (!trybb)
+            return false;
+        BranchInst *tbr = dyn_cast<BranchInst>(trybb->getTerminator());
+        if (!tbr || !tbr->isConditional())
+            return false;
+        if (!((tbr->getSuccessor(0) == slowbb && tbr->getSuccessor(1) == fastbb) ||
+              (tbr->getSuccessor(0) == fastbb && tbr->getSuccessor(1) == slowbb)))
+            return false;
+        BasicBlock *entry = trybb->getSinglePredecessor();
+        if (!entry)
+            return false;
+        BranchInst *ebr = dyn_cast<BranchInst>(entry->getTerminator());
+        if (!ebr || !ebr->isConditional())
+            return false;
+        if (!((ebr->getSuccessor(0) == slowbb && ebr->getSuccessor(1) == trybb) ||
+              (ebr->getSuccessor(0) == trybb && ebr->getSuccessor(1) == slowbb)))
+            return false;
+        // the continuation must have no other phis: rewiring the entry
+        // branch changes its predecessor set
+        if (&*contbb->begin() != phi ||
+            contbb->getFirstNonPHI() != phi->getNextNode())
+            return false;
+        shape.phi = phi;
+        shape.entry = entry;
+        shape.cont = contbb;
+        return true;
+    }
+
+    // whether `t` may be (or contain) a reference the collector would have
+    // to know about. Only plain integer, floating point and non-pointer
+    // vector stores are allowed into a sunk object.
+    static bool may_hold_gc_ref(Type *t)
+    {
+        if (t->isIntegerTy() || t->isFloatingPointTy())
+            return false;
+        if (t->isVectorTy())
+            return may_hold_gc_ref(t->getVectorElementType());
+        return true;
+    }
+
+    // the type tag lives one word before the object: a gep with the single
+    // index -1 on a pointer-element pointer to the object
+    bool is_tag_addr(Value *ptr, Value *obj)
+    {
+        GetElementPtrInst *gep = dyn_cast<GetElementPtrInst>(ptr);
+        if (!gep || gep->getNumIndices() != 1 || !gep->getType()->isPointerTy())
+            return false;
+        if (strip_casts(gep->getPointerOperand()) != obj)
+            return false;
+        ConstantInt *idx = dyn_cast<ConstantInt>(gep->getOperand(1));
+        return idx && idx->isMinusOne() &&
+            gep->getType()->getPointerElementType()->isPointerTy();
+    }
+
+    bool is_gcroot_slot(Value *ptr)
+    {
+        CallInst *call = dyn_cast<CallInst>(strip_casts(ptr));
+        return call && gcroot_decl &&
+            call->getCalledFunction() == gcroot_decl;
+    }
+
+    // conservative escape check for the allocation `obj`. Stores of the
+    // object into gc root slots are collected in `root_stores` so the
+    // caller can null them out.
+    bool escapes(Value *obj, SmallVectorImpl<StoreInst*> &root_stores)
+    {
+        SmallVector<Value*, 16> worklist;
+        SmallPtrSet<Value*, 16> visited;
+        worklist.push_back(obj);
+        visited.insert(obj);
+        while (!worklist.empty()) {
+            Value *v = worklist.pop_back_val();
+            for (User *user : v->users()) {
+                Instruction *inst = dyn_cast<Instruction>(user);
+                if (!inst)
+                    return true;
+                if (isa<BitCastInst>(inst) || isa<GetElementPtrInst>(inst)) {
+                    if (visited.insert(inst).second)
+                        worklist.push_back(inst);
+                }
+                else if (isa<LoadInst>(inst)) {
+                    // loads never capture
+                }
+                else if (StoreInst *store = dyn_cast<StoreInst>(inst)) {
+                    if (store->getValueOperand() == v) {
+                        // storing the object somewhere: only fine when
+                        // that somewhere is a root slot we can clear
+                        if (!is_gcroot_slot(store->getPointerOperand()))
+                            return true;
+                        root_stores.push_back(store);
+                    }
+                    else if (may_hold_gc_ref(
+                                 store->getValueOperand()->getType()) &&
+                             !is_tag_addr(store->getPointerOperand(), obj)) {
+                        return true;
+                    }
+                }
+                else {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void sink(CallInst *call, const DiamondShape &shape,
+              ArrayRef<StoreInst*> root_stores)
+    {
+        // `osize` counts from the tag word. Pool objects are 16 byte
+        // aligned with the tag immediately before them, and codegen relies
+        // on that alignment for wide field accesses, so place the object
+        // itself at a 16 byte boundary of the buffer.
+        uint64_t osize =
+            cast<ConstantInt>(call->getArgOperand(2))->getZExtValue();
+        const uint64_t obj_offset = JL_SMALL_BYTE_ALIGNMENT;
+        uint64_t bufsz = obj_offset + osize - sizeof(void*);
+        LLVMContext &ctx = F.getContext();
+        Type *T_int8 = Type::getInt8Ty(ctx);
+        Instruction *first = &*F.getEntryBlock().begin();
+        AllocaInst *buf = new AllocaInst(ArrayType::get(T_int8, bufsz),
+                                         "stackbox", first);
+        buf->setAlignment(JL_SMALL_BYTE_ALIGNMENT);
+        // the replacement must dominate the result's users: for a plain
+        // call build at the call, for the diamond at the head of the
+        // continuation (after its sole phi, which we erase)
+        Instruction *ip = shape.phi
+            ? shape.cont->getFirstNonPHI() : (Instruction*)call;
+        IRBuilder<> builder(ip);
+        Value *idxs[2] = {
+            ConstantInt::get(Type::getInt32Ty(ctx), 0),
+            ConstantInt::get(Type::getInt32Ty(ctx), obj_offset)
+        };
+        Value *objptr = builder.CreateInBoundsGEP(buf, idxs);
+        Value *obj = builder.CreateBitCast(objptr, call->getType());
+        if (shape.phi) {
+            // bypass the diamond: branch from its entry straight to the
+            // continuation; the dead blocks (and the call) fall to later
+            // cleanup, and the inline cursor is never bumped for an
+            // allocation that no longer exists
+            shape.phi->replaceAllUsesWith(obj);
+            shape.phi->eraseFromParent();
+            Instruction *ebr = shape.entry->getTerminator();
+            BranchInst::Create(shape.cont, ebr);
+            ebr->eraseFromParent();
+        }
+        else {
+            call->replaceAllUsesWith(obj);
+            call->eraseFromParent();
+        }
+        for (StoreInst *store : root_stores) {
+            store->setOperand(0, ConstantPointerNull::get(
+                cast<PointerType>(store->getValueOperand()->getType())));
+        }
+    }
+
+    Function &F;
+    Function *pool_alloc;
+    Function *gcroot_decl;
+};
+
+} // anonymous namespace
+
+void jl_sink_allocations(Function *F)
+{
+    AllocationSinker(*F).run();
+}
@@ -462,8 +462,69 @@ unsigned find_space_for(CallInst *callInst,
 }
 
 public:
+// Whether any instruction in the function can trigger a collection while
+// it is running. Calls into the runtime or to other julia functions can;
+// the gcroot bookkeeping pseudo-calls, the ptls getter and LLVM intrinsics
+// cannot. jlcall frames and gc_store markers imply a jlcall (a safepoint),
+// and are conservatively treated as one here so the frameless path below
+// never has to deal with them.
+bool has_safepoints()
+{
+    for (Function::iterator bb = F.begin(), be = F.end(); bb != be; ++bb) {
+        for (BasicBlock::iterator i = bb->begin(), ie = bb->end(); i != ie; ++i) {
+            if (isa<InvokeInst>(&*i))
+                return true;
+            CallInst *callInst = dyn_cast<CallInst>(&*i);
+            if (!callInst || callInst == ptlsStates)
+                continue;
+            Function *callee = callInst->getCalledFunction();
+            if (callee && (callee == gcroot_func || callee == gckill_func ||
+                           callee->isIntrinsic()))
+                continue;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Lowering for functions without safepoints: nothing can run the collector
+// while their roots are live, so the frame push/pop (and the frame itself)
+// is pure overhead. Root slots become plain stack slots, which the later
+// optimization passes usually promote away entirely.
+void lower_frameless()
+{
+    gcframe->eraseFromParent();
+    for (Function::iterator bb = F.begin(), be = F.end(); bb != be; ++bb) {
+        for (BasicBlock::iterator i = bb->begin(), ie = bb->end(); i != ie; ) {
+            Instruction *inst = &*i;
+            ++i;
+            CallInst *callInst = dyn_cast<CallInst>(inst);
+            if (!callInst)
+                continue;
+            Function *callee = callInst->getCalledFunction();
+            if (callee == gckill_func) {
+                callInst->eraseFromParent();
+            }
+            else if (callee == gcroot_func) {
+                AllocaInst *slot = new AllocaInst(V_null->getType(), "", callInst);
+                slot->takeName(callInst);
+                // keep the NULL initialization: the slot can be read back
+                // on paths that never stored to it
+                StoreInst *store = new StoreInst(V_null, slot);
+                store->insertAfter(slot);
+                callInst->replaceAllUsesWith(slot);
+                callInst->eraseFromParent();
+            }
+        }
+    }
+}
+
 void allocate_frame()
 {
+    if (!has_safepoints()) {
+        lower_frameless();
+        return;
+    }
     Instruction *last_gcframe_inst = gcframe;
     collapseRedundantRoots();
 
@@ -10,11 +10,13 @@
 #include "llvm-version.h"
 #include "support/dtypes.h"
 #include <llvm/Analysis/LoopPass.h>
+#include <llvm/IR/Constants.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Metadata.h>
 #include <llvm/Support/Debug.h>
 #include <cstdio>
+#include <cstdlib>
 
 namespace llvm {
 
@@ -140,6 +142,32 @@ void LowerSIMDLoop::enableUnsafeAlgebraIfReduction(PHINode *Phi, Loop *L) const
     }
 }
 
+// Reduction-kind notes: integer add/mul/and/or/xor reduction chains need
+// no flag from this pass -- once the loop is annotated parallel below,
+// the vectorizer's recurrence detection handles associative integer ops
+// by itself. Floating point min/max chains are a different story: in
+// this LLVM the vectorizer only accepts them with a whole-function
+// no-NaNs guarantee, and @simd licenses reassociation, not NaN absence,
+// so marking them here would be unsound rather than an extension.
+
+// diagnostics (JULIA_SIMDLOOP_DIAG=1): report each @simd loop as the
+// annotation is applied, so it's visible which loops were handed to the
+// vectorizer and with what interleave hint
+static int simdloop_diag = -1;
+// optional interleave hint attached to every @simd loop's id
+// (JULIA_SIMD_INTERLEAVE=N; 0 leaves the vectorizer's own choice)
+static int simdloop_interleave = -1;
+
+static void simdloop_read_env(void)
+{
+    if (simdloop_diag == -1) {
+        const char *cp = getenv("JULIA_SIMDLOOP_DIAG");
+        simdloop_diag = cp && strtol(cp, NULL, 10);
+        cp = getenv("JULIA_SIMD_INTERLEAVE");
+        simdloop_interleave = cp ? (int)strtol(cp, NULL, 10) : 0;
+    }
+}
+
 bool LowerSIMDLoop::runOnLoop(Loop *L, LPPassManager &LPM)
 {
     if (!simd_loop_mdkind)
@@ -148,6 +176,7 @@ bool LowerSIMDLoop::runOnLoop(Loop *L, LPPassManager &LPM)
     if (!hasSIMDLoopMetadata(L))
         return false;
 
+    simdloop_read_env();
     DEBUG(dbgs() << "LSL: simd_loop found\n");
     BasicBlock *Lh = L->getHeader();
     DEBUG(dbgs() << "LSL: loop header: " << *Lh << "\n");
@@ -163,6 +192,24 @@ bool LowerSIMDLoop::runOnLoop(Loop *L, LPPassManager &LPM)
         n->replaceOperandWith(0,n);
         L->setLoopID(n);
     }
+#ifdef LLVM36
+    if (simdloop_interleave > 0) {
+        // append an interleave-count hint to the loop id
+        LLVMContext &C = Lh->getContext();
+        Metadata *hint_ops[2] = {
+            MDString::get(C, "llvm.loop.interleave.count"),
+            ConstantAsMetadata::get(ConstantInt::get(
+                Type::getInt32Ty(C), simdloop_interleave))
+        };
+        MDNode *hint = MDNode::get(C, hint_ops);
+        SmallVector<Metadata*, 4> ops(n->op_begin(), n->op_end());
+        ops.push_back(hint);
+        MDNode *newid = MDNode::get(C, ops);
+        newid->replaceOperandWith(0, newid);
+        L->setLoopID(newid);
+        n = newid;
+    }
+#endif
 #else
     MDNode *n = MDNode::get(Lh->getContext(), ArrayRef<Value*>());
     L->getLoopLatch()->getTerminator()->setMetadata("llvm.loop.parallel", n);
@@ -185,6 +232,13 @@ bool LowerSIMDLoop::runOnLoop(Loop *L, LPPassManager &LPM)
         if (PHINode *Phi = dyn_cast<PHINode>(I))
             enableUnsafeAlgebraIfReduction(Phi,L);
 
+    if (simdloop_diag) {
+        fprintf(stderr, "simdloop: %s: parallel annotation applied"
+                " (interleave hint %d)\n",
+                Lh->getParent()->getName().str().c_str(),
+                simdloop_interleave);
+    }
+
     return true;
 }
 
@@ -16,15 +16,56 @@ jl_module_t *jl_core_module=NULL;
 jl_module_t *jl_base_module=NULL;
 jl_module_t *jl_top_module=NULL;
 
+// versioned binding lookup cache
+//
+// Resolving a global walks the usings list and probes binding tables
+// under the module lock on every unresolved access. Binding *structure*
+// changes (new bindings, imports, usings, exports, new modules) are rare
+// after warmup, so a monotonic world counter is bumped on each of them
+// and resolved (module, name) -> binding pairs are memoized in a small
+// direct mapped cache tagged with the counter: a repeat lookup is a few
+// loads and compares. Entries are filled seqlock-style (the world tag is
+// cleared first and published last with a release store), so a fill
+// racing with a reader can only cause a miss, never a wrong hit. The
+// cached pointers are never dereferenced without a world match, and
+// creating a module bumps the world, so a recycled module address cannot
+// revalidate a stale entry.
+JL_DLLEXPORT volatile uint64_t jl_binding_world = 1;
+
+STATIC_INLINE void jl_bump_binding_world(void)
+{
+    jl_atomic_fetch_add(&jl_binding_world, 1);
+}
+
+#define BINDING_CACHE_SZ 1024 // must be a power of two
+typedef struct {
+    jl_module_t *m;
+    jl_sym_t *var;
+    jl_binding_t *b; // may be NULL (memoized "unresolved")
+    volatile uint64_t world;
+} jl_binding_cache_ent_t;
+static jl_binding_cache_ent_t binding_cache[BINDING_CACHE_SZ];
+// serializes cache fills (the miss path): with a single writer at a time,
+// the seqlock tag protocol is sufficient for the lock-free readers
+static jl_mutex_t binding_cache_lock;
+
+STATIC_INLINE size_t jl_binding_cache_idx(jl_module_t *m, jl_sym_t *var)
+{
+    uintptr_t h = ((uintptr_t)m >> 4) ^ ((uintptr_t)var >> 3);
+    return h & (BINDING_CACHE_SZ - 1);
+}
+
 JL_DLLEXPORT jl_module_t *jl_new_module(jl_sym_t *name)
 {
     jl_module_t *m = (jl_module_t*)jl_gc_allocobj(sizeof(jl_module_t));
     jl_set_typeof(m, jl_module_type);
+    jl_bump_binding_world();
     JL_GC_PUSH1(&m);
     assert(jl_is_symbol(name));
     m->name = name;
     m->parent = NULL;
     m->istopmod = 0;
+    m->fastmath = JL_MODULE_FASTMATH_DEFAULT;
     m->uuid = uv_now(uv_default_loop());
     m->counter = 0;
     htable_new(&m->bindings, 0);
@@ -75,6 +116,7 @@ static jl_binding_t *new_binding(jl_sym_t *name)
     b->value = NULL;
     b->owner = NULL;
     b->globalref = NULL;
+    b->dependents = NULL;
     b->constp = 0;
     b->exportp = 0;
     b->imported = 0;
@@ -83,6 +125,14 @@ static jl_binding_t *new_binding(jl_sym_t *name)
 }
 
 // get binding for assignment
+// Scope the math mode to one module: newly compiled code whose enclosing
+// module is `m` uses this instead of the global --math-mode (already
+// compiled specializations keep the flags they were built with).
+JL_DLLEXPORT void jl_module_set_fastmath(jl_module_t *m, int mode)
+{
+    m->fastmath = (uint8_t)mode;
+}
+
 JL_DLLEXPORT jl_binding_t *jl_get_binding_wr(jl_module_t *m, jl_sym_t *var)
 {
     jl_binding_t **bp = (jl_binding_t**)ptrhash_bp(&m->bindings, var);
@@ -107,6 +157,7 @@ JL_DLLEXPORT jl_binding_t *jl_get_binding_wr(jl_module_t *m, jl_sym_t *var)
     b->owner = m;
     *bp = b;
     jl_gc_wb_buf(m, b, sizeof(jl_binding_t));
+    jl_bump_binding_world();
     return *bp;
 }
 
@@ -147,6 +198,7 @@ JL_DLLEXPORT jl_binding_t *jl_get_binding_for_method_def(jl_module_t *m, jl_sym_
     b->owner = m;
     *bp = b;
     jl_gc_wb_buf(m, b, sizeof(jl_binding_t));
+    jl_bump_binding_world();
     return *bp;
 }
 
@@ -212,7 +264,25 @@ static jl_binding_t *jl_get_binding_(jl_module_t *m, jl_sym_t *var, modstack_t *
 
 JL_DLLEXPORT jl_binding_t *jl_get_binding(jl_module_t *m, jl_sym_t *var)
 {
-    return jl_get_binding_(m, var, NULL);
+    jl_binding_cache_ent_t *ent = &binding_cache[jl_binding_cache_idx(m, var)];
+    uint64_t world = jl_binding_world;
+    if (jl_atomic_load_acquire(&ent->world) == world &&
+        ent->m == m && ent->var == var) {
+        jl_binding_t *b = ent->b;
+        // a racing fill invalidates the tag before touching the fields,
+        // so re-checking it validates what was just read
+        if (jl_atomic_load_acquire(&ent->world) == world)
+            return b;
+    }
+    jl_binding_t *b = jl_get_binding_(m, var, NULL);
+    JL_LOCK_NOGC(&binding_cache_lock);
+    ent->world = 0;
+    ent->m = m;
+    ent->var = var;
+    ent->b = b;
+    jl_atomic_store_release(&ent->world, world);
+    JL_UNLOCK_NOGC(&binding_cache_lock);
+    return b;
 }
 
 void jl_binding_deprecation_warning(jl_binding_t *b);
@@ -260,6 +330,7 @@ JL_DLLEXPORT int jl_is_imported(jl_module_t *m, jl_sym_t *s)
 static void module_import_(jl_module_t *to, jl_module_t *from, jl_sym_t *s,
                            int explici)
 {
+    jl_bump_binding_world();
     if (to == from)
         return;
     jl_binding_t *b = jl_get_binding(from, s);
@@ -377,6 +448,7 @@ JL_DLLEXPORT void jl_module_using(jl_module_t *to, jl_module_t *from)
     }
 
     arraylist_push(&to->usings, from);
+    jl_bump_binding_world();
 }
 
 JL_DLLEXPORT void jl_module_export(jl_module_t *from, jl_sym_t *s)
@@ -391,6 +463,7 @@ JL_DLLEXPORT void jl_module_export(jl_module_t *from, jl_sym_t *s)
     }
     assert(*bp != HT_NOTFOUND);
     (*bp)->exportp = 1;
+    jl_bump_binding_world();
 }
 
 JL_DLLEXPORT int jl_boundp(jl_module_t *m, jl_sym_t *var)
@@ -501,6 +574,50 @@ void jl_binding_deprecation_warning(jl_binding_t *b)
     }
 }
 
+// record that `li`'s generated code embedded this binding's value as an
+// immediate (called from codegen under codegen_lock)
+void jl_binding_add_dependent(jl_binding_t *b, jl_value_t *li)
+{
+    size_t i, l;
+    if (b->dependents == NULL) {
+        b->dependents = (jl_value_t*)jl_alloc_vec_any(0);
+        jl_gc_wb_binding(b, b->dependents);
+    }
+    for (i = 0, l = jl_array_len(b->dependents); i < l; i++) {
+        if (jl_array_ptr_ref(b->dependents, i) == li)
+            return;
+    }
+    jl_array_ptr_1d_push((jl_array_t*)b->dependents, li);
+}
+
+// a const binding was redefined: drop the compiled code of every method
+// specialization that embedded the old value, so the next call
+// regenerates against the new one. In-flight frames keep running the
+// old code, as before.
+static void jl_binding_invalidate_dependents(jl_binding_t *b)
+{
+    if (b->dependents == NULL)
+        return;
+    jl_value_t *deps = b->dependents;
+    b->dependents = NULL;
+    JL_LOCK(&codegen_lock);
+    size_t i, l;
+    for (i = 0, l = jl_array_len(deps); i < l; i++) {
+        jl_lambda_info_t *li =
+            (jl_lambda_info_t*)jl_array_ptr_ref(deps, i);
+        if (li->inCompile || li->code == jl_nothing)
+            continue; // can't regenerate; keep the old code
+        li->functionObjectsDecls.functionObject = NULL;
+        li->functionObjectsDecls.specFunctionObject = NULL;
+        li->functionID = 0;
+        li->specFunctionID = 0;
+        if (li->jlcall_api == 2)
+            li->jlcall_api = 0; // no longer folded to the old constant
+        li->fptr = NULL;
+    }
+    JL_UNLOCK(&codegen_lock);
+}
+
 JL_DLLEXPORT void jl_checked_assignment(jl_binding_t *b, jl_value_t *rhs)
 {
     if (b->constp && b->value != NULL) {
@@ -512,6 +629,7 @@ JL_DLLEXPORT void jl_checked_assignment(jl_binding_t *b, jl_value_t *rhs)
             }
             jl_printf(JL_STDERR, "WARNING: redefining constant %s\n",
                       jl_symbol_name(b->name));
+            jl_binding_invalidate_dependents(b);
         }
     }
     b->value = rhs;
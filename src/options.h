@@ -18,6 +18,36 @@
 
 // codegen options ------------------------------------------------------------
 
+// under --compile=tiered, the number of interpreted calls after which a
+// method is handed to the JIT
+#define JL_TIERED_COMPILE_THRESHOLD 32
+
+// directory for the on-disk JIT object cache (see jitlayers.cpp)
+#define CODE_CACHE_NAME                 "JULIA_CODE_CACHE"
+
+// set to 1 to make runtime-JITted code target the host CPU even when
+// --cpu-target is a conservative baseline (see jl_init_codegen)
+#define JIT_NATIVE_NAME                 "JULIA_JIT_NATIVE"
+
+// counter-driven re-optimization: when set, compiled methods count their
+// calls and are regenerated once through the aggressive pipeline (with a
+// hot attribute) after this many calls; 1 selects the default threshold
+#define REOPT_NAME                      "JULIA_REOPT_THRESHOLD"
+#define JL_REOPT_DEFAULT_THRESHOLD      50000
+
+// set to 1 to profile with the cheap frame-pointer chain unwinder
+// (linux x86-64; see rec_backtrace_ctx_fp in stackwalk.c)
+#define PROFILE_FP_NAME                 "JULIA_PROFILE_FP"
+
+// JULIA_FAST_EXCEPTIONS=1 captures throw-time backtraces with the
+// frame-pointer chain walker instead of the full unwinder (see
+// record_backtrace in task.c)
+#define FAST_EXCEPTIONS_NAME            "JULIA_FAST_EXCEPTIONS"
+
+// set to 1 to write /tmp/perf-<pid>.map entries for JITted functions
+// (linux; see debuginfo.cpp)
+#define PERF_MAP_NAME                   "JULIA_PERF_MAP"
+
 // (Experimental) Use MCJIT ELF, even where it's not the native format
 //#define FORCE_ELF
 
@@ -94,11 +124,20 @@
 #define COPY_STACKS
 #endif
 
+// with COPY_STACKS, tasks whose start function has previously needed more
+// stack than this switch to a private stack buffer (no copying on switch)
+#define JL_TASK_COPY_STACK_MAX (64*1024)
+
 // threading options ----------------------------------------------------------
 
 // controls for when threads sleep
 #define THREAD_SLEEP_THRESHOLD_NAME     "JULIA_THREAD_SLEEP_THRESHOLD"
-#define DEFAULT_THREAD_SLEEP_THRESHOLD  1e9    // cycles (1e9==1sec@1GHz)
+// upper bound of the adaptive spin window before a waiting thread parks.
+// The old default of a full second burned every waiting core whenever the
+// process idled between parallel regions.
+#define DEFAULT_THREAD_SLEEP_THRESHOLD  4000000  // ns (4ms)
+// lower bound of the adaptive spin window (ns)
+#define THREAD_MIN_SPIN_NS              100000
 
 // defaults for # threads
 #define NUM_THREADS_NAME                "JULIA_NUM_THREADS"
@@ -110,6 +149,25 @@
 #define MACHINE_EXCLUSIVE_NAME          "JULIA_EXCLUSIVE"
 #define DEFAULT_MACHINE_EXCLUSIVE       0
 
+// thread placement policy over the package/core topology (linux):
+// "compact", "scatter", or "onepercore" (implies affinitization)
+#define THREAD_PLACEMENT_NAME           "JULIA_THREAD_PLACEMENT"
+
+// # threads running the GC mark phase (defaults to JULIA_NUM_THREADS)
+#define MARK_THREADS_NAME               "JULIA_GC_MARK_THREADS"
+
+// set to 1 to sweep big objects on a background thread instead of
+// inside the stop-the-world window
+#define SWEEP_THREAD_NAME               "JULIA_GC_SWEEP_THREAD"
+
+// hugepage backing for the GC page regions (linux): 1 advises transparent
+// hugepages, 2 tries explicit MAP_HUGETLB first with fallback to 1
+#define GC_HUGEPAGES_NAME               "JULIA_GC_HUGEPAGES"
+
+// set to 1 to decommit quarantined GC pages from a background thread
+// (MADV_FREE) instead of synchronously when the quarantine fills up
+#define GC_PAGE_LAUNDRY_NAME            "JULIA_GC_PAGE_LAUNDRY"
+
 // sanitizer defaults ---------------------------------------------------------
 
 // Automatically enable MEMDEBUG and KEEP_BODIES for the sanitizers
@@ -131,8 +131,12 @@ extern "C" void jl_init_runtime_ccall(void)
 }
 #endif
 
-// map from user-specified lib names to handles
+// map from user-specified lib names to handles. Misses are cached too:
+// a library that failed to load once keeps failing fast instead of
+// re-probing every extension/path combination on every attempt.
 static std::map<std::string, void*> libMap;
+static jl_mutex_t libmap_lock;
+#define LIB_LOAD_FAILED ((void*)(intptr_t)-1)
 
 extern "C"
 void *jl_get_library(const char *f_lib)
@@ -146,12 +150,27 @@ void *jl_get_library(const char *f_lib)
 #endif
     if (f_lib == NULL)
         return jl_RTLD_DEFAULT_handle;
+    // The lock makes concurrent first-loads safe (the map was previously
+    // mutated with no synchronization at all); the load itself runs
+    // outside it, so two racing first-loads at worst dlopen twice (the
+    // loader refcounts, one handle wins the map). This path only runs
+    // until the emitted ccall slot caches the resolved pointer.
+    JL_LOCK_NOGC(&libmap_lock);
     hnd = libMap[f_lib];
+    JL_UNLOCK_NOGC(&libmap_lock);
+    if (hnd == LIB_LOAD_FAILED)
+        jl_errorf("could not load library \"%s\"", f_lib);
     if (hnd != NULL)
         return hnd;
-    hnd = jl_load_dynamic_library(f_lib, JL_RTLD_DEFAULT);
-    if (hnd != NULL)
-        libMap[f_lib] = hnd;
+    hnd = jl_load_dynamic_library_e(f_lib, JL_RTLD_DEFAULT);
+    JL_LOCK_NOGC(&libmap_lock);
+    libMap[f_lib] = hnd == NULL ? LIB_LOAD_FAILED : hnd;
+    JL_UNLOCK_NOGC(&libmap_lock);
+    if (hnd == NULL) {
+        // probe once more through the throwing loader so the error
+        // carries the loader's own detail message
+        jl_load_dynamic_library(f_lib, JL_RTLD_DEFAULT);
+    }
     return hnd;
 }
 
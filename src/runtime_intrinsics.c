@@ -409,9 +409,37 @@ static inline jl_value_t *jl_fintrinsic_1(jl_value_t *ty, jl_value_t *a, const c
 
 typedef void (*intrinsic_2_t)(unsigned, void*, void*, void*);
 SELECTOR_FUNC(intrinsic_2)
+// The generic path below re-derives sizes, widens operands through
+// alloca temporaries, and boxes through newstruct on every call. The
+// overwhelmingly common operand pairs when inference failed are plain
+// Int64/UInt64/Int32 (and Float64/Float32 on the float side), so those
+// get a direct route: one type-tag compare, the already-generated
+// fixed-width kernel on the unboxed payloads, and the ordinary box
+// constructors -- which consult the small-int cache for the result.
+// The kernel choice matches the generic selector exactly (it selects by
+// size alone; the operation's signedness is baked into the kernel), so
+// behavior is identical.
 #define bi_iintrinsic(name, u, cvtb) \
 JL_DLLEXPORT jl_value_t *jl_##name(jl_value_t *a, jl_value_t *b) \
 { \
+    jl_value_t *ty = jl_typeof(a); \
+    if (ty == jl_typeof(b)) { \
+        if (ty == (jl_value_t*)jl_int64_type) { \
+            int64_t r; \
+            jl_##name##64(64, jl_data_ptr(a), jl_data_ptr(b), &r); \
+            return jl_box_int64(r); \
+        } \
+        if (ty == (jl_value_t*)jl_uint64_type) { \
+            uint64_t r; \
+            jl_##name##64(64, jl_data_ptr(a), jl_data_ptr(b), &r); \
+            return jl_box_uint64(r); \
+        } \
+        if (ty == (jl_value_t*)jl_int32_type) { \
+            int32_t r; \
+            jl_##name##32(32, jl_data_ptr(a), jl_data_ptr(b), &r); \
+            return jl_box_int32(r); \
+        } \
+    } \
     return jl_iintrinsic_2(a, b, #name, u##signbitbyte, jl_intrinsiclambda_2, name##_list, cvtb); \
 }
 #define bi_iintrinsic_cnvtb_fast(LLVMOP, OP, name, u, cvtb) \
@@ -435,6 +463,17 @@ SELECTOR_FUNC(intrinsic_cmp)
 #define cmp_iintrinsic(name, u) \
 JL_DLLEXPORT jl_value_t *jl_##name(jl_value_t *a, jl_value_t *b) \
 { \
+    jl_value_t *ty = jl_typeof(a); \
+    if (ty == jl_typeof(b)) { \
+        if (ty == (jl_value_t*)jl_int64_type || \
+            ty == (jl_value_t*)jl_uint64_type) \
+            return jl_##name##64(64, jl_data_ptr(a), jl_data_ptr(b)) ? \
+                jl_true : jl_false; \
+        if (ty == (jl_value_t*)jl_int32_type || \
+            ty == (jl_value_t*)jl_uint32_type) \
+            return jl_##name##32(32, jl_data_ptr(a), jl_data_ptr(b)) ? \
+                jl_true : jl_false; \
+    } \
     return jl_iintrinsic_2(a, b, #name, u##signbitbyte, jl_intrinsiclambda_cmp, name##_list, 0); \
 }
 #define bool_iintrinsic_fast(LLVMOP, OP, name, u) \
@@ -554,6 +593,16 @@ JL_DLLEXPORT jl_value_t *jl_##name(jl_value_t *a, jl_value_t *b) \
     jl_value_t *ty = jl_typeof(a); \
     if (jl_typeof(b) != ty) \
         jl_error(#name ": types of a and b must match"); \
+    if (ty == (jl_value_t*)jl_float64_type) { \
+        double r; \
+        jl_##name##64(64, jl_data_ptr(a), jl_data_ptr(b), &r); \
+        return jl_box_float64(r); \
+    } \
+    if (ty == (jl_value_t*)jl_float32_type) { \
+        float r; \
+        jl_##name##32(32, jl_data_ptr(a), jl_data_ptr(b), &r); \
+        return jl_box_float32(r); \
+    } \
     if (!jl_is_bitstype(ty)) \
         jl_error(#name ": values are not bitstypes"); \
     jl_value_t *newv = newstruct((jl_datatype_t*)ty); \
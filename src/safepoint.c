@@ -2,6 +2,7 @@
 
 #include "julia.h"
 #include "julia_internal.h"
+#include "uprobes.h"
 #include "threading.h"
 #ifndef _OS_WINDOWS_
 #include <sys/mman.h>
@@ -14,6 +15,39 @@
 extern "C" {
 #endif
 
+// GC state transitions for the cfunction wrappers: a C caller can be in
+// any GC state (e.g. a libuv callback invoked while the event loop polls
+// in the GC-safe state), so entering julia code has to switch the thread
+// to GC-unsafe and leaving has to restore the previous state (which
+// includes waiting at the safepoint when a collection is running).
+JL_DLLEXPORT int8_t jl_cfunction_gc_unsafe_enter(void)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    return jl_gc_unsafe_enter(ptls);
+}
+
+JL_DLLEXPORT void jl_cfunction_gc_unsafe_leave(int8_t state)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    jl_gc_unsafe_leave(ptls, state);
+}
+
+// The reverse transition, for foreign calls annotated `gcsafe` in
+// ccall: the thread sits in the GC-safe state while it blocks in the
+// callee, so collections no longer wait for it; re-entering julia on
+// the way out waits at the safepoint if a collection is running.
+JL_DLLEXPORT int8_t jl_ccall_gc_safe_enter(void)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    return jl_gc_safe_enter(ptls);
+}
+
+JL_DLLEXPORT void jl_ccall_gc_safe_leave(int8_t state)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    jl_gc_safe_leave(ptls, state);
+}
+
 // 0: no sigint is pending
 // 1: at least one sigint is pending, only the sigint page is enabled.
 // 2: at least one sigint is pending, both safepoint pages are enabled.
@@ -158,6 +192,7 @@ void jl_safepoint_end_gc(void)
 
 void jl_safepoint_wait_gc(void)
 {
+    JL_PROBE_SAFEPOINT_WAIT();
 #ifdef JULIA_ENABLE_THREADING
     // The thread should have set this is already
     assert(jl_get_ptls_states()->gc_state != 0);
@@ -16,6 +16,86 @@ extern "C" {
 static volatile intptr_t *bt_data_prof = NULL;
 static volatile size_t bt_size_max = 0;
 static volatile size_t bt_size_cur = 0;
+
+// ---- delta-encoded sample storage ------------------------------------
+//
+// Consecutive samples share most of their outer frames, so the profile
+// buffer does not store full traces. Each sample is encoded as
+//     [n_shared][n_new][n_new innermost ips ...]
+// where n_shared counts the frames reused from the outermost end of the
+// previous sample. The signal handlers walk into `prof_scratch` and
+// hand the trace to jl_profile_record_trace (no allocation, bounded
+// work, signal-safe); jl_profile_get_data/len_data expand back into the
+// classic "ips then 0" format on demand, so consumers are unchanged.
+// For steady profiles the common case stores a handful of words per
+// sample instead of the whole stack.
+static uintptr_t *prof_scratch = NULL;   // raw walk destination
+static uintptr_t *prof_prev = NULL;      // previous sample, fully expanded
+static size_t prof_prev_len = 0;
+static size_t prof_data_end = 0;         // end of the last complete sample
+static uint8_t *prof_expanded = NULL;    // cached expansion for get_data
+static size_t prof_expanded_len = 0;
+static size_t prof_expanded_at = (size_t)-1; // prof_data_end it matches
+
+static void jl_profile_record_trace(uintptr_t *bt, size_t n)
+{
+    size_t shared = 0, nnew, i;
+    while (shared < n && shared < prof_prev_len &&
+           bt[n - 1 - shared] == prof_prev[prof_prev_len - 1 - shared])
+        shared++;
+    nnew = n - shared;
+    if (bt_size_cur + nnew + 2 >= bt_size_max - 1) {
+        // no room for this sample: mark the buffer full so the caller
+        // stops the timer; prof_data_end still ends a complete sample
+        bt_size_cur = bt_size_max;
+        return;
+    }
+    bt_data_prof[bt_size_cur++] = (intptr_t)shared;
+    bt_data_prof[bt_size_cur++] = (intptr_t)nnew;
+    for (i = 0; i < nnew; i++)
+        bt_data_prof[bt_size_cur++] = (intptr_t)bt[i];
+    prof_data_end = bt_size_cur;
+    memcpy(prof_prev, bt, n * sizeof(uintptr_t));
+    prof_prev_len = n;
+}
+
+// expand the delta samples into the classic flat format; cached until
+// more samples arrive
+static void jl_profile_expand(void)
+{
+    if (prof_expanded_at == prof_data_end)
+        return;
+    free(prof_expanded);
+    size_t cap = prof_data_end * 2 + 64;
+    uintptr_t *out = (uintptr_t*)malloc(cap * sizeof(uintptr_t));
+    uintptr_t *prev = (uintptr_t*)malloc((JL_MAX_BT_SIZE + 1) *
+                                         sizeof(uintptr_t));
+    size_t prevlen = 0, outlen = 0, p = 0;
+    while (p + 2 <= prof_data_end) {
+        size_t shared = (size_t)bt_data_prof[p++];
+        size_t nnew = (size_t)bt_data_prof[p++];
+        size_t len = shared + nnew, i;
+        if (outlen + len + 1 > cap) {
+            cap = (outlen + len + 1) * 2;
+            out = (uintptr_t*)realloc(out, cap * sizeof(uintptr_t));
+        }
+        // rebuild the full trace: new innermost frames, then the shared
+        // tail of the previous sample
+        for (i = 0; i < nnew; i++)
+            out[outlen + i] = (uintptr_t)bt_data_prof[p + i];
+        memcpy(&out[outlen + nnew], &prev[prevlen - shared],
+               shared * sizeof(uintptr_t));
+        memcpy(prev, &out[outlen], len * sizeof(uintptr_t));
+        prevlen = len;
+        p += nnew;
+        outlen += len;
+        out[outlen++] = 0;
+    }
+    free(prev);
+    prof_expanded = (uint8_t*)out;
+    prof_expanded_len = outlen;
+    prof_expanded_at = prof_data_end;
+}
 static volatile uint64_t nsecprof = 0;
 static volatile int running = 0;
 static const    uint64_t GIGA = 1000000000ULL;
@@ -87,6 +167,35 @@ void jl_critical_error(int sig, bt_context_t *context, uintptr_t *bt_data, size_
 ///////////////////////
 // Utility functions //
 ///////////////////////
+// Per-block sample metadata: the thread that was sampled and when. Kept
+// in a buffer parallel to bt_data_prof (record k belongs to the k-th
+// zero-terminated block) so the existing consumers of the ip stream keep
+// working unchanged; every block is at least two words, so maxsize/2
+// records always suffice.
+static jl_profile_meta_t *bt_meta_prof = NULL;
+static volatile size_t bt_meta_cur = 0;
+static size_t bt_meta_max = 0;
+
+// called by the platform samplers right before they write a block
+void jl_profile_record_meta(uint64_t tid)
+{
+    if (bt_meta_prof != NULL && bt_meta_cur < bt_meta_max) {
+        bt_meta_prof[bt_meta_cur].tid = tid;
+        bt_meta_prof[bt_meta_cur].timestamp = jl_hrtime();
+        bt_meta_cur++;
+    }
+}
+
+JL_DLLEXPORT uint8_t *jl_profile_get_meta(void)
+{
+    return (uint8_t*)bt_meta_prof;
+}
+
+JL_DLLEXPORT size_t jl_profile_len_meta(void)
+{
+    return bt_meta_cur;
+}
+
 JL_DLLEXPORT int jl_profile_init(size_t maxsize, uint64_t delay_nsec)
 {
     bt_size_max = maxsize;
@@ -97,17 +206,38 @@ JL_DLLEXPORT int jl_profile_init(size_t maxsize, uint64_t delay_nsec)
     if (bt_data_prof == NULL && maxsize > 0)
         return -1;
     bt_size_cur = 0;
+    prof_data_end = 0;
+    prof_prev_len = 0;
+    prof_expanded_at = (size_t)-1;
+    if (prof_scratch == NULL) {
+        prof_scratch = (uintptr_t*)malloc((JL_MAX_BT_SIZE + 1) *
+                                          sizeof(uintptr_t));
+        prof_prev = (uintptr_t*)malloc((JL_MAX_BT_SIZE + 1) *
+                                       sizeof(uintptr_t));
+        if (prof_scratch == NULL || prof_prev == NULL)
+            return -1;
+    }
+    if (bt_meta_prof != NULL)
+        free((void*)bt_meta_prof);
+    bt_meta_max = maxsize / 2 + 1;
+    bt_meta_prof = (jl_profile_meta_t*) calloc(bt_meta_max,
+                                               sizeof(jl_profile_meta_t));
+    if (bt_meta_prof == NULL)
+        return -1;
+    bt_meta_cur = 0;
     return 0;
 }
 
 JL_DLLEXPORT uint8_t *jl_profile_get_data(void)
 {
-    return (uint8_t*) bt_data_prof;
+    jl_profile_expand();
+    return prof_expanded;
 }
 
 JL_DLLEXPORT size_t jl_profile_len_data(void)
 {
-    return bt_size_cur;
+    jl_profile_expand();
+    return prof_expanded_len;
 }
 
 JL_DLLEXPORT size_t jl_profile_maxlen_data(void)
@@ -115,6 +245,15 @@ JL_DLLEXPORT size_t jl_profile_maxlen_data(void)
     return bt_size_max;
 }
 
+// whether sampling stopped because the (delta-encoded) buffer filled;
+// the expanded length jl_profile_len_data reports no longer relates to
+// bt_size_max, so consumers must ask explicitly instead of comparing
+// len against maxlen
+JL_DLLEXPORT int jl_profile_data_full(void)
+{
+    return bt_size_max > 0 && bt_size_cur >= bt_size_max - 1;
+}
+
 JL_DLLEXPORT uint64_t jl_profile_delay_nsec(void)
 {
     return nsecprof;
@@ -122,7 +261,11 @@ JL_DLLEXPORT uint64_t jl_profile_delay_nsec(void)
 
 JL_DLLEXPORT void jl_profile_clear_data(void)
 {
+    bt_meta_cur = 0;
     bt_size_cur = 0;
+    prof_data_end = 0;
+    prof_prev_len = 0;
+    prof_expanded_at = (size_t)-1;
 }
 
 JL_DLLEXPORT int jl_profile_is_running(void)
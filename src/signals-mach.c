@@ -382,6 +382,8 @@ void *mach_profile_listener(void *arg)
 
             unw_context_t *uc;
             jl_thread_suspend_and_get_state(i, &uc);
+            // attribute the block to the sampled thread
+            jl_profile_record_meta(i);
 
 #ifdef LIBOSXUNWIND
             /*
@@ -401,12 +403,13 @@ void *mach_profile_listener(void *arg)
             forceDwarf = 0;
             unw_getcontext(&profiler_uc); // will resume from this point if the next lines segfault at any point
 
+            size_t prof_n = 0;
             if (forceDwarf == 0) {
                 // Save the backtrace
-                bt_size_cur += rec_backtrace_ctx((uintptr_t*)bt_data_prof + bt_size_cur, bt_size_max - bt_size_cur - 1, uc);
+                prof_n = rec_backtrace_ctx(prof_scratch, JL_MAX_BT_SIZE, uc);
             }
             else if (forceDwarf == 1) {
-                bt_size_cur += rec_backtrace_ctx_dwarf((uintptr_t*)bt_data_prof + bt_size_cur, bt_size_max - bt_size_cur - 1, uc);
+                prof_n = rec_backtrace_ctx_dwarf(prof_scratch, JL_MAX_BT_SIZE, uc);
             }
             else if (forceDwarf == -1) {
                 jl_safe_printf("WARNING: profiler attempt to access an invalid memory location\n");
@@ -414,11 +417,11 @@ void *mach_profile_listener(void *arg)
 
             forceDwarf = -2;
 #else
-            bt_size_cur += rec_backtrace_ctx((uintptr_t*)bt_data_prof + bt_size_cur, bt_size_max - bt_size_cur - 1, uc);
+            size_t prof_n = rec_backtrace_ctx(prof_scratch, JL_MAX_BT_SIZE, uc);
 #endif
 
-            // Mark the end of this block with 0
-            bt_data_prof[bt_size_cur++] = 0;
+            // store as a delta against the previous sample
+            jl_profile_record_trace(prof_scratch, prof_n);
 
             // We're done! Resume the thread.
             jl_thread_resume(i, 0);
@@ -421,11 +421,32 @@ static void *signal_listener(void *arg)
             // do backtrace for profiler
             if (profile && running) {
                 if (bt_size_cur < bt_size_max - 1) {
+                    // attribute the block to the sampled thread
+                    jl_profile_record_meta(i);
                     // Get backtrace data
-                    bt_size_cur += rec_backtrace_ctx((uintptr_t*)bt_data_prof + bt_size_cur,
-                            bt_size_max - bt_size_cur - 1, signal_context);
-                    // Mark the end of this block with 0
-                    bt_data_prof[bt_size_cur++] = 0;
+                    size_t prof_n;
+#if defined(_OS_LINUX_) && defined(_CPU_X86_64_)
+                    static int profile_fp = -1;
+                    if (profile_fp == -1) {
+                        char *cp = getenv(PROFILE_FP_NAME);
+                        profile_fp = cp && strtol(cp, NULL, 10);
+                    }
+                    // the walk needs the top of the thread stack as its
+                    // upper bound; without one (or with the task running
+                    // on a private stack buffer, where stackbase doesn't
+                    // apply) fall back to libunwind
+                    if (profile_fp && jl_all_tls_states[i]->stackbase) {
+                        prof_n = rec_backtrace_ctx_fp(
+                                prof_scratch, JL_MAX_BT_SIZE,
+                                signal_context,
+                                (char*)jl_all_tls_states[i]->stackbase);
+                    }
+                    else
+#endif
+                    prof_n = rec_backtrace_ctx(prof_scratch, JL_MAX_BT_SIZE,
+                                               signal_context);
+                    // store as a delta against the previous sample
+                    jl_profile_record_trace(prof_scratch, prof_n);
                 }
                 if (bt_size_cur >= bt_size_max - 1) {
                     // Buffer full: Delete the timer
@@ -334,11 +334,11 @@ static DWORD WINAPI profile_bt( LPVOID lparam )
                 break;
             }
             // Get backtrace data
-            bt_size_cur += rec_backtrace_ctx((uintptr_t*)bt_data_prof + bt_size_cur,
-                bt_size_max - bt_size_cur - 1, &ctxThread);
-            // Mark the end of this block with 0
-            bt_data_prof[bt_size_cur] = 0;
-            bt_size_cur++;
+            jl_profile_record_meta(0);
+            size_t prof_n = rec_backtrace_ctx(prof_scratch, JL_MAX_BT_SIZE,
+                                              &ctxThread);
+            // store as a delta against the previous sample
+            jl_profile_record_trace(prof_scratch, prof_n);
             if ((DWORD)-1 == ResumeThread(hMainThread)) {
                 fputs("failed to resume main thread! aborting.",stderr);
                 gc_debug_critical_error();
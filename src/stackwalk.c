@@ -65,6 +65,97 @@ size_t jl_unw_stepn(bt_cursor_t *cursor, uintptr_t *ip, uintptr_t *sp, size_t ma
     return n;
 }
 
+#if defined(_OS_LINUX_) && defined(_CPU_X86_64_)
+#include <sys/ucontext.h>
+// Frame-pointer chain unwinder (JULIA_PROFILE_FP=1): an order of
+// magnitude cheaper per frame than unw_step, which makes high-frequency
+// profiling feasible. All JIT-compiled frames keep their frame pointers
+// (codegen sets no-frame-pointer-elim on every function), so chains
+// through julia code are intact; the walk simply stops at the first
+// frame that doesn't look like one -- typically C code built without
+// frame pointers -- trading tail depth below the JIT/native boundary for
+// speed. Candidate frame pointers are bounds checked against the sampled
+// thread's stack region; like every frame-pointer unwinder this trusts
+// the chain itself, so it is opt-in.
+// Capture the calling thread's own frame-pointer chain, with no context
+// and no libunwind -- the throw-path variant of the profiler's FP
+// unwinder above. The walk is bounded by the stack actually under our
+// feet: the current thread's system stack for copying tasks, the task's
+// own buffer for private-stack tasks (bounding those by the thread's
+// stack top would let a broken chain wander through whatever is mapped
+// between the heap buffer and the stack). Returns 0 whenever the bounds
+// don't check out, letting the caller fall back to the full unwinder.
+size_t rec_backtrace_fp_here(uintptr_t *data, size_t maxsize)
+{
+    jl_tls_states_t *ptls = jl_get_ptls_states();
+    jl_task_t *t = ptls->current_task;
+    uintptr_t fp = (uintptr_t)__builtin_frame_address(0);
+    uintptr_t stack_lo = (uintptr_t)&fp;
+    uintptr_t stack_hi = (uintptr_t)ptls->stack_hi;
+    size_t n = 0;
+    int ontask = 0;
+#ifdef COPY_STACKS
+    if (t != NULL && !t->copy_stack)
+        ontask = 1;
+#else
+    if (t != NULL && t != ptls->root_task)
+        ontask = 1;
+#endif
+    if (ontask) {
+        char *stk = (char*)t->stkbuf;
+        if (stk == NULL || stk == (char*)(intptr_t)-1)
+            return 0;
+        if (stack_lo < (uintptr_t)stk ||
+            stack_lo >= (uintptr_t)stk + t->ssize)
+            return 0; // not running where the task says; don't guess
+        stack_hi = (uintptr_t)stk + t->ssize;
+    }
+    if (stack_hi == 0 || stack_hi <= stack_lo)
+        return 0;
+    while (n < maxsize) {
+        if (fp < stack_lo || fp + 2 * sizeof(void*) > stack_hi ||
+            (fp & (sizeof(void*) - 1)))
+            break;
+        uintptr_t ret = ((uintptr_t*)fp)[1];
+        if (ret == 0)
+            break;
+        data[n++] = ret;
+        uintptr_t next = ((uintptr_t*)fp)[0];
+        if (next <= fp)
+            break;
+        fp = next;
+    }
+    return n;
+}
+
+size_t rec_backtrace_ctx_fp(uintptr_t *data, size_t maxsize,
+                            bt_context_t *ctx, char *stack_hi)
+{
+    ucontext_t *uc = (ucontext_t*)ctx;
+    uintptr_t ip = (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+    uintptr_t fp = (uintptr_t)uc->uc_mcontext.gregs[REG_RBP];
+    // live frame pointers sit between the interrupted stack pointer and
+    // the top of the thread stack
+    uintptr_t stack_lo = (uintptr_t)uc->uc_mcontext.gregs[REG_RSP];
+    size_t n = 0;
+    while (n < maxsize && ip != 0) {
+        data[n++] = ip;
+        if (fp < stack_lo ||
+            fp + 2 * sizeof(void*) > (uintptr_t)stack_hi ||
+            (fp & (sizeof(void*) - 1)))
+            break;
+        // with frame pointers: [fp] is the caller's fp, [fp+8] the
+        // return address
+        uintptr_t next_fp = ((uintptr_t*)fp)[0];
+        ip = ((uintptr_t*)fp)[1];
+        if (next_fp <= fp) // must strictly move up the stack
+            break;
+        fp = next_fp;
+    }
+    return n;
+}
+#endif
+
 size_t rec_backtrace_ctx(uintptr_t *data, size_t maxsize,
                          bt_context_t *context)
 {
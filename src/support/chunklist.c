@@ -0,0 +1,80 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+/*
+  chunked pointer list (see chunklist.h)
+*/
+
+#include <stdlib.h>
+#include <assert.h>
+
+#include "dtypes.h"
+#include "chunklist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void chunklist_new(chunklist_t *cl)
+{
+    cl->head = NULL;
+    cl->tail = NULL;
+    cl->spare = NULL;
+    cl->len = 0;
+}
+
+static void chunklist_free_chain(chunklist_chunk_t *c)
+{
+    while (c != NULL) {
+        chunklist_chunk_t *next = c->next;
+        LLT_FREE(c);
+        c = next;
+    }
+}
+
+void chunklist_free(chunklist_t *cl)
+{
+    chunklist_free_chain(cl->head);
+    chunklist_free_chain(cl->spare);
+    chunklist_new(cl);
+}
+
+void chunklist_clear(chunklist_t *cl)
+{
+    chunklist_chunk_t *c = cl->head;
+    while (c != NULL) {
+        chunklist_chunk_t *next = c->next;
+        c->n = 0;
+        c->next = cl->spare;
+        cl->spare = c;
+        c = next;
+    }
+    cl->head = NULL;
+    cl->tail = NULL;
+    cl->len = 0;
+}
+
+void chunklist_push_slow(chunklist_t *cl, void *v)
+{
+    chunklist_chunk_t *c = cl->spare;
+    if (c != NULL) {
+        cl->spare = c->next;
+    }
+    else {
+        c = (chunklist_chunk_t*)LLT_ALLOC(sizeof(chunklist_chunk_t));
+        if (c == NULL)
+            abort(); // matches arraylist_grow's behavior on OOM for the GC
+        c->n = 0;
+    }
+    c->next = NULL;
+    if (cl->tail != NULL)
+        cl->tail->next = c;
+    else
+        cl->head = c;
+    cl->tail = c;
+    c->items[c->n++] = v;
+    cl->len++;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,63 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+#ifndef CHUNKLIST_H
+#define CHUNKLIST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+  chunked pointer list: fixed-size blocks linked together, so append is
+  O(1) and -- unlike arraylist_t -- growth never reallocates or copies
+  existing elements. Built for lists that grow at unpredictable moments
+  inside time-critical sections (the GC remsets): extending a multi-MB
+  arraylist mid-pause costs a full copy, extending a chunklist costs one
+  chunk allocation. Chunks are recycled through a spare list on clear,
+  so a steady-state collection cycle allocates nothing.
+*/
+
+// chunk payload count; sized so a chunk is about 4KB
+#define CHUNKLIST_NELTS 509
+
+typedef struct _chunklist_chunk_t {
+    struct _chunklist_chunk_t *next;
+    size_t n;
+    void *items[CHUNKLIST_NELTS];
+} chunklist_chunk_t;
+
+typedef struct {
+    chunklist_chunk_t *head; // first chunk, for iteration
+    chunklist_chunk_t *tail; // append target
+    chunklist_chunk_t *spare; // cleared chunks kept for reuse
+    size_t len;
+} chunklist_t;
+
+JL_DLLEXPORT void chunklist_new(chunklist_t *cl);
+JL_DLLEXPORT void chunklist_free(chunklist_t *cl);
+// retire all elements; chunks are kept on the spare list
+JL_DLLEXPORT void chunklist_clear(chunklist_t *cl);
+// out-of-line slow path: append a fresh (or spare) chunk and push
+JL_DLLEXPORT void chunklist_push_slow(chunklist_t *cl, void *v);
+
+STATIC_INLINE void chunklist_push(chunklist_t *cl, void *v)
+{
+    chunklist_chunk_t *t = cl->tail;
+    if (t != NULL && t->n < CHUNKLIST_NELTS) {
+        t->items[t->n++] = v;
+        cl->len++;
+        return;
+    }
+    chunklist_push_slow(cl, v);
+}
+
+// iterate the chunks of `cl`; elements of chunk `ck` are
+// ck->items[0 .. ck->n-1]
+#define chunklist_foreach(cl, ck)                                   \
+    for (chunklist_chunk_t *ck = (cl)->head; ck != NULL; ck = ck->next)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,6 +4,7 @@
   Hashing
 */
 #include <stdlib.h>
+#include <string.h>
 #include "dtypes.h"
 #include "utils.h"
 #include "hashing.h"
@@ -65,33 +66,143 @@ uint32_t int64to32hash(uint64_t key)
 
 #define _MHASH_SEED_ 0xcafe8881
 
-uint64_t memhash(const char *buf, size_t n)
-{
-    uint64_t out[2];
+/*
+  memhash: a wyhash-style wide-block hash. The mixer is a 64x64->128
+  multiply folded to 64 bits, so every input bit reaches the full output
+  width in one step; bulk input is consumed in three independent 16-byte
+  lanes to keep the multiplies pipelined. At the 20-200 byte sizes Dict
+  hashes most (strings, bits values over 8 bytes), this is several times
+  faster than the MurmurHash3 code below, which is kept as memhash_mm3/
+  memhash32_mm3 for consumers that have stored its values externally.
+  Like its predecessor the result depends on byte order; hashes are not
+  meant to be portable across platforms.
+*/
 
-    // TODO: expose 128-bit hash
-#ifdef _P64
-    MurmurHash3_x64_128(buf, n, _MHASH_SEED_, out);
+static inline uint64_t hash_mum(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__) && !defined(HASH_NO_INT128)
+    __uint128_t p = (__uint128_t)a * b;
+    return (uint64_t)p ^ (uint64_t)(p >> 64);
 #else
-    MurmurHash3_x86_128(buf, n, _MHASH_SEED_, out);
+    // portable 64x64->128: schoolbook on 32-bit halves
+    uint64_t ha = a >> 32, la = (uint32_t)a;
+    uint64_t hb = b >> 32, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
 #endif
-    return out[1];
 }
 
+static inline uint64_t hash_read8(const char *p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t hash_read4(const char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// 1-3 bytes: first, middle, last (reads no byte twice for n==3)
+static inline uint64_t hash_read3(const char *p, size_t n)
+{
+    return (((uint64_t)(uint8_t)p[0]) << 16) |
+           (((uint64_t)(uint8_t)p[n >> 1]) << 8) |
+           ((uint64_t)(uint8_t)p[n - 1]);
+}
+
+#define HASH_P0 0xa0761d6478bd642fULL
+#define HASH_P1 0xe7037ed1a0b428dbULL
+#define HASH_P2 0x8ebc6af09c88c6e3ULL
+#define HASH_P3 0x589965cc75374cc3ULL
+
 uint64_t memhash_seed(const char *buf, size_t n, uint32_t seed)
+{
+    const char *p = buf;
+    uint64_t s = HASH_P0 ^ seed;
+    uint64_t a, b;
+    size_t k = n;
+    if (__likely(k <= 16)) {
+        if (k >= 4) {
+            // two overlapping 4-byte pairs cover the whole input
+            a = (hash_read4(p) << 32) | hash_read4(p + ((k >> 3) << 2));
+            b = (hash_read4(p + k - 4) << 32) |
+                hash_read4(p + k - 4 - ((k >> 3) << 2));
+        }
+        else if (k > 0) {
+            a = hash_read3(p, k);
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        if (k > 48) {
+            uint64_t s1 = s, s2 = s;
+            do {
+                s  = hash_mum(hash_read8(p) ^ HASH_P1,
+                              hash_read8(p + 8) ^ s);
+                s1 = hash_mum(hash_read8(p + 16) ^ HASH_P2,
+                              hash_read8(p + 24) ^ s1);
+                s2 = hash_mum(hash_read8(p + 32) ^ HASH_P3,
+                              hash_read8(p + 40) ^ s2);
+                p += 48;
+                k -= 48;
+            } while (k > 48);
+            s ^= s1 ^ s2;
+        }
+        while (k > 16) {
+            s = hash_mum(hash_read8(p) ^ HASH_P1, hash_read8(p + 8) ^ s);
+            p += 16;
+            k -= 16;
+        }
+        // final (possibly overlapping) 16 bytes
+        a = hash_read8(p + k - 16);
+        b = hash_read8(p + k - 8);
+    }
+    return hash_mum(HASH_P1 ^ n, hash_mum(a ^ HASH_P1, b ^ s));
+}
+
+uint64_t memhash(const char *buf, size_t n)
+{
+    return memhash_seed(buf, n, _MHASH_SEED_);
+}
+
+uint32_t memhash32_seed(const char *buf, size_t n, uint32_t seed)
+{
+    uint64_t h = memhash_seed(buf, n, seed);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+uint32_t memhash32(const char *buf, size_t n)
+{
+    return memhash32_seed(buf, n, _MHASH_SEED_);
+}
+
+// the historical MurmurHash3-based hashes; only for consumers that have
+// stored hash values computed by the old memhash outside the process
+uint64_t memhash_mm3(const char *buf, size_t n)
 {
     uint64_t out[2];
 
     // TODO: expose 128-bit hash
 #ifdef _P64
-    MurmurHash3_x64_128(buf, n, seed, out);
+    MurmurHash3_x64_128(buf, n, _MHASH_SEED_, out);
 #else
-    MurmurHash3_x86_128(buf, n, seed, out);
+    MurmurHash3_x86_128(buf, n, _MHASH_SEED_, out);
 #endif
     return out[1];
 }
 
-uint32_t memhash32(const char *buf, size_t n)
+uint32_t memhash32_mm3(const char *buf, size_t n)
 {
     uint32_t out;
 
@@ -99,14 +210,6 @@ uint32_t memhash32(const char *buf, size_t n)
     return out;
 }
 
-uint32_t memhash32_seed(const char *buf, size_t n, uint32_t seed)
-{
-    uint32_t out;
-
-    MurmurHash3_x86_32(buf, n, seed, &out);
-    return out;
-}
-
 #ifdef __cplusplus
 }
 #endif
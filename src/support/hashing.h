@@ -20,6 +20,8 @@ JL_DLLEXPORT uint64_t memhash(const char *buf, size_t n);
 JL_DLLEXPORT uint64_t memhash_seed(const char *buf, size_t n, uint32_t seed);
 JL_DLLEXPORT uint32_t memhash32(const char *buf, size_t n);
 JL_DLLEXPORT uint32_t memhash32_seed(const char *buf, size_t n, uint32_t seed);
+JL_DLLEXPORT uint64_t memhash_mm3(const char *buf, size_t n);
+JL_DLLEXPORT uint32_t memhash32_mm3(const char *buf, size_t n);
 
 #ifdef __cplusplus
 }
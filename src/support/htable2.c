@@ -0,0 +1,288 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+/*
+  group-probing pointer hash table (see htable2.h)
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "dtypes.h"
+#include "htable2.h"
+#include "hashing.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static uint8_t ht2_h2(uintptr_t hv)
+{
+    // the index uses the low bits; take the tag from higher ones
+    return (hv >> 8) & 0x7f;
+}
+
+static int ht2_alloc(htable2_t *h, size_t nslots)
+{
+    h->ctrl = (uint8_t*)LLT_ALLOC(nslots + HT2_GROUP_SZ);
+    h->keys = (void**)LLT_ALLOC(nslots * sizeof(void*));
+    h->vals = (void**)LLT_ALLOC(nslots * sizeof(void*));
+    if (h->ctrl == NULL || h->keys == NULL || h->vals == NULL) {
+        LLT_FREE(h->ctrl);
+        LLT_FREE(h->keys);
+        LLT_FREE(h->vals);
+        h->ctrl = NULL;
+        h->keys = NULL;
+        h->vals = NULL;
+        return 0;
+    }
+    memset(h->ctrl, HT2_EMPTY, nslots + HT2_GROUP_SZ);
+    h->size = nslots;
+    h->count = 0;
+    h->octrl = NULL;
+    h->okeys = NULL;
+    h->ovals = NULL;
+    h->osize = 0;
+    h->omigrated = 0;
+    return 1;
+}
+
+static void ht2_drop_old(htable2_t *h)
+{
+    LLT_FREE(h->octrl);
+    LLT_FREE(h->okeys);
+    LLT_FREE(h->ovals);
+    h->octrl = NULL;
+    h->okeys = NULL;
+    h->ovals = NULL;
+    h->osize = 0;
+    h->omigrated = 0;
+}
+
+htable2_t *htable2_new(htable2_t *h, size_t size)
+{
+    size_t nslots = HT2_GROUP_SZ;
+    // keep the load factor at or below 7/8
+    while (nslots < size + (size >> 3) + 1)
+        nslots *= 2;
+    if (!ht2_alloc(h, nslots))
+        return NULL;
+    return h;
+}
+
+void htable2_free(htable2_t *h)
+{
+    ht2_drop_old(h);
+    LLT_FREE(h->ctrl);
+    LLT_FREE(h->keys);
+    LLT_FREE(h->vals);
+    h->ctrl = NULL;
+    h->keys = NULL;
+    h->vals = NULL;
+    h->size = 0;
+    h->count = 0;
+}
+
+void htable2_reset(htable2_t *h, size_t size)
+{
+    ht2_drop_old(h);
+    size_t needed = HT2_GROUP_SZ;
+    while (needed < size + (size >> 3) + 1)
+        needed *= 2;
+    if (h->ctrl != NULL && h->size >= needed) {
+        memset(h->ctrl, HT2_EMPTY, h->size + HT2_GROUP_SZ);
+        h->count = 0;
+        return;
+    }
+    htable2_free(h);
+    htable2_new(h, size);
+}
+
+// set the control byte, keeping the wrap-around mirror of the first group
+// in sync
+static void ht2_set_ctrl(htable2_t *h, size_t slot, uint8_t c)
+{
+    h->ctrl[slot] = c;
+    if (slot < HT2_GROUP_SZ)
+        h->ctrl[h->size + slot] = c;
+}
+
+// find the slot of `key`, or (when absent) the empty slot where it would
+// be inserted
+static size_t ht2_find(htable2_t *h, void *key, uintptr_t hv)
+{
+    size_t mask = h->size - 1;
+    uint8_t h2 = ht2_h2(hv);
+    size_t g = hv & mask;
+    while (1) {
+#if defined(__SSE2__)
+        __m128i ctrl = _mm_loadu_si128((const __m128i*)&h->ctrl[g]);
+        unsigned match = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+        while (match) {
+            size_t slot = (g + __builtin_ctz(match)) & mask;
+            if (h->keys[slot] == key)
+                return slot;
+            match &= match - 1;
+        }
+        unsigned empty = (unsigned)_mm_movemask_epi8(ctrl);
+        if (empty)
+            return (g + __builtin_ctz(empty)) & mask;
+#else
+        size_t i;
+        for (i = 0; i < HT2_GROUP_SZ; i++) {
+            uint8_t c = h->ctrl[g + i];
+            size_t slot = (g + i) & mask;
+            if (c == h2 && h->keys[slot] == key)
+                return slot;
+            if (c == HT2_EMPTY)
+                return slot;
+        }
+#endif
+        g = (g + HT2_GROUP_SZ) & mask;
+    }
+}
+
+// copy one old slot's entry into the new table unless a newer value for
+// the key was already inserted there
+static void ht2_migrate_slot(htable2_t *h, size_t i)
+{
+    if (h->octrl[i] == HT2_EMPTY)
+        return;
+    uintptr_t hv = inthash((uintptr_t)h->okeys[i]);
+    size_t slot = ht2_find(h, h->okeys[i], hv);
+    if (h->ctrl[slot] != HT2_EMPTY)
+        return; // the key was re-inserted after the growth started
+    ht2_set_ctrl(h, slot, ht2_h2(hv));
+    h->keys[slot] = h->okeys[i];
+    h->vals[slot] = h->ovals[i];
+}
+
+// move a bounded number of old slots; called once per table operation so
+// the migration cost is spread out instead of stalling one operation
+#define HT2_MIGRATE_STEP (2 * HT2_GROUP_SZ)
+static void ht2_migrate_some(htable2_t *h)
+{
+    if (h->octrl == NULL)
+        return;
+    size_t end = h->omigrated + HT2_MIGRATE_STEP;
+    if (end > h->osize)
+        end = h->osize;
+    while (h->omigrated < end) {
+        ht2_migrate_slot(h, h->omigrated);
+        h->omigrated++;
+    }
+    if (h->omigrated == h->osize)
+        ht2_drop_old(h);
+}
+
+static void ht2_grow(htable2_t *h)
+{
+    // an in-flight migration drains 32 slots per operation while inserts
+    // add at most one, so it finishes long before the doubled table fills
+    // up again; finish it off defensively all the same
+    while (h->octrl != NULL)
+        ht2_migrate_some(h);
+    size_t oldsize = h->size;
+    size_t oldcount = h->count;
+    uint8_t *octrl = h->ctrl;
+    void **okeys = h->keys;
+    void **ovals = h->vals;
+    if (!ht2_alloc(h, oldsize * 2)) {
+        // restore and hope a later insert has more luck; matches the
+        // keep-going-on-OOM behavior of htable_rehash
+        h->ctrl = octrl;
+        h->keys = okeys;
+        h->vals = ovals;
+        h->size = oldsize;
+        h->count = oldcount;
+        return;
+    }
+    h->count = oldcount; // migrated entries are already included
+    h->octrl = octrl;
+    h->okeys = okeys;
+    h->ovals = ovals;
+    h->osize = oldsize;
+    h->omigrated = 0;
+}
+
+// lookup in the not-yet-migrated old arrays
+static void *ht2_old_get(htable2_t *h, void *key, uintptr_t hv)
+{
+    size_t mask = h->osize - 1;
+    uint8_t h2 = ht2_h2(hv);
+    size_t g = hv & mask;
+    while (1) {
+        size_t i;
+        for (i = 0; i < HT2_GROUP_SZ; i++) {
+            uint8_t c = h->octrl[g + i];
+            size_t slot = (g + i) & mask;
+            if (c == h2 && h->okeys[slot] == key)
+                return h->ovals[slot];
+            if (c == HT2_EMPTY)
+                return HT_NOTFOUND;
+        }
+        g = (g + HT2_GROUP_SZ) & mask;
+    }
+}
+
+void *htable2_get(htable2_t *h, void *key)
+{
+    ht2_migrate_some(h);
+    uintptr_t hv = inthash((uintptr_t)key);
+    size_t slot = ht2_find(h, key, hv);
+    if (h->ctrl[slot] != HT2_EMPTY)
+        return h->vals[slot];
+    if (h->octrl != NULL)
+        return ht2_old_get(h, key, hv);
+    return HT_NOTFOUND;
+}
+
+void **htable2_bp(htable2_t *h, void *key)
+{
+    ht2_migrate_some(h);
+    if (h->count >= h->size - (h->size >> 3))
+        ht2_grow(h);
+    uintptr_t hv = inthash((uintptr_t)key);
+    size_t slot = ht2_find(h, key, hv);
+    if (h->ctrl[slot] == HT2_EMPTY) {
+        ht2_set_ctrl(h, slot, ht2_h2(hv));
+        h->keys[slot] = key;
+        h->vals[slot] = HT_NOTFOUND;
+        h->count++;
+        if (h->octrl != NULL) {
+            // a stale copy in the old arrays must not shadow or later
+            // clobber this entry: the new table wins both in lookups
+            // (checked first) and in migration (occupied slots are kept),
+            // but the value has to start from the old copy so updates
+            // through the returned pointer build on it
+            void *oval = ht2_old_get(h, key, hv);
+            if (oval != HT_NOTFOUND) {
+                h->vals[slot] = oval;
+                h->count--; // already counted when the growth started
+            }
+        }
+    }
+    return &h->vals[slot];
+}
+
+void htable2_put(htable2_t *h, void *key, void *val)
+{
+    *htable2_bp(h, key) = val;
+}
+
+// drain any in-flight migration; required before iterating the table's
+// arrays directly
+void htable2_finish_migration(htable2_t *h)
+{
+    while (h->octrl != NULL)
+        ht2_migrate_some(h);
+}
+
+#ifdef __cplusplus
+}
+#endif
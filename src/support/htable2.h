@@ -0,0 +1,72 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+#ifndef HTABLE2_H
+#define HTABLE2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "htable.h" // for HT_NOTFOUND
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Open addressing hash table for pointer keys with 16-way control byte
+// group probing (scanned with SSE2 where available, scalar otherwise),
+// in the style of SwissTable. Compared to htable.h it touches one cache
+// line of metadata for up to 16 probes instead of one slot per probe.
+//
+// Limitations, chosen for the hot users (the serializer's backref table):
+//  - keys are pointers, compared by identity
+//  - no deletion
+//  - like htable_bp, a pointer obtained from htable2_bp is invalidated by
+//    the next insertion (the table may grow); lookups and the incremental
+//    migration never move the value array, so they keep it valid
+
+#define HT2_GROUP_SZ 16
+// control byte values: 0x80 = empty, otherwise the low 7 hash bits
+#define HT2_EMPTY 0x80
+
+typedef struct {
+    size_t size;   // number of slots, a power of two >= HT2_GROUP_SZ
+    size_t count;  // number of used slots (including not-yet-migrated ones)
+    uint8_t *ctrl; // [size + HT2_GROUP_SZ]; tail mirrors the first group
+    void **keys;   // [size]
+    void **vals;   // [size]
+
+    // Growth is incremental: the old arrays are kept and every operation
+    // migrates a bounded number of slots into the new ones, so growing a
+    // table of millions of entries never causes a multi-ms stall on the
+    // operation that happens to trip the load factor. `octrl` is NULL
+    // when no migration is in flight. Lookups check the new table first,
+    // then the old one.
+    uint8_t *octrl;
+    void **okeys;
+    void **ovals;
+    size_t osize;
+    size_t omigrated; // old slots processed so far
+} htable2_t;
+
+// initialize the table with space for about `size` expected elements.
+// Returns NULL on allocation failure.
+htable2_t *htable2_new(htable2_t *h, size_t size);
+void htable2_free(htable2_t *h);
+// clear the table, keeping (or growing to) capacity for `size` elements
+void htable2_reset(htable2_t *h, size_t size);
+
+// get the value for `key`, or HT_NOTFOUND
+void *htable2_get(htable2_t *h, void *key);
+// get a pointer to the value slot for `key`, inserting it with the value
+// HT_NOTFOUND first when absent
+void **htable2_bp(htable2_t *h, void *key);
+void htable2_put(htable2_t *h, void *key, void *val);
+// drain any in-flight incremental migration (required before walking the
+// ctrl/keys/vals arrays directly)
+void htable2_finish_migration(htable2_t *h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
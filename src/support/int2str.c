@@ -28,6 +28,49 @@ char *uint2str(char *dest, size_t len, uint64_t num, uint32_t base)
     return &dest[i+1];
 }
 
+// Decimal formatting fast paths for bulk numeric output. uint2str above
+// stays the generic any-base routine; these write base-10 only, two
+// digits per division using a table, which roughly halves the divides
+// and turns the rest into table loads.
+static const char two_digits[200] =
+    "00010203040506070809101112131415161718192021222324"
+    "25262728293031323334353637383940414243444546474849"
+    "50515253545556575859606162636465666768697071727374"
+    "75767778798081828384858687888990919293949596979899";
+
+// Write the decimal form of `num` into `dest` (which must have room for
+// at least 21 bytes), NUL terminated. Returns the number of characters
+// written, not counting the NUL.
+JL_DLLEXPORT size_t jl_i64toa(char *dest, int64_t num)
+{
+    char buf[20]; // digits, reversed
+    uint64_t u = (uint64_t)num;
+    char *p = dest;
+    if (num < 0) {
+        *p++ = '-';
+        u = (uint64_t)(-(num + 1)) + 1; // avoid overflow on INT64_MIN
+    }
+    int n = 0;
+    while (u >= 100) {
+        const char *d = &two_digits[(u % 100) * 2];
+        buf[n++] = d[1];
+        buf[n++] = d[0];
+        u /= 100;
+    }
+    if (u >= 10) {
+        const char *d = &two_digits[u * 2];
+        buf[n++] = d[1];
+        buf[n++] = d[0];
+    }
+    else {
+        buf[n++] = (char)('0' + u);
+    }
+    while (n > 0)
+        *p++ = buf[--n];
+    *p = '\0';
+    return (size_t)(p - dest);
+}
+
 int isdigit_base(char c, int base)
 {
     if (base < 11)
@@ -22,7 +22,10 @@
 #include <sys/time.h>
 #include <sys/select.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #include <fcntl.h>
+#include <limits.h>
 #endif
 
 #include "utils.h"
@@ -116,6 +119,168 @@ static int _os_read(long fd, void *buf, size_t n, size_t *nread)
     return 0;
 }
 
+// readahead pipeline
+//
+// ios_set_readahead turns a readable fd-backed stream into a pipeline: a
+// reader thread keeps up to `nbufs` 1MB buffers full so that the
+// consumer's refills are memcpys from memory instead of synchronous fd
+// reads, overlapping the CPU work with the I/O. The stream must then be
+// consumed strictly sequentially (seeking is refused) and is meant for
+// bulk ingest; the pipeline is torn down by ios_close.
+#ifndef _OS_WINDOWS_
+#include <pthread.h>
+
+#define RA_BUFSZ (1 << 20) // bytes per readahead buffer
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    char *data;     // nbufs * RA_BUFSZ
+    size_t *lens;   // filled length of each buffer
+    int nbufs;
+    int head;       // next buffer the consumer drains
+    size_t headpos; // bytes of the head buffer already consumed
+    int count;      // number of full buffers
+    int eof;
+    int err;
+    int stop;
+    long fd;
+} ios_readahead_t;
+
+static int _os_read_all(long fd, void *buf, size_t n, size_t *nread);
+
+static void *_ios_readahead_thread(void *arg)
+{
+    ios_readahead_t *ra = (ios_readahead_t*)arg;
+    pthread_mutex_lock(&ra->lock);
+    while (!ra->stop) {
+        if (ra->count == ra->nbufs || ra->eof || ra->err) {
+            pthread_cond_wait(&ra->cond, &ra->lock);
+            continue;
+        }
+        int slot = (ra->head + ra->count) % ra->nbufs;
+        pthread_mutex_unlock(&ra->lock);
+        size_t got = 0;
+        int err = _os_read_all(ra->fd, ra->data + (size_t)slot * RA_BUFSZ,
+                               RA_BUFSZ, &got);
+        pthread_mutex_lock(&ra->lock);
+        ra->lens[slot] = got;
+        if (err)
+            ra->err = err;
+        if (got < RA_BUFSZ)
+            ra->eof = 1;
+        if (got)
+            ra->count++;
+        pthread_cond_broadcast(&ra->cond);
+    }
+    pthread_mutex_unlock(&ra->lock);
+    return NULL;
+}
+
+// consumer side: like _os_read_all against the pipeline (blocks until n
+// bytes, EOF, or an error)
+static int _ra_read(ios_t *s, void *buf, size_t n, size_t *nread)
+{
+    ios_readahead_t *ra = (ios_readahead_t*)s->ra;
+    size_t got = 0;
+    int err = 0;
+    pthread_mutex_lock(&ra->lock);
+    while (got < n) {
+        if (ra->count == 0) {
+            if (ra->eof || ra->err) {
+                err = got ? 0 : ra->err;
+                break;
+            }
+            pthread_cond_wait(&ra->cond, &ra->lock);
+            continue;
+        }
+        size_t avail = ra->lens[ra->head] - ra->headpos;
+        size_t take = n - got < avail ? n - got : avail;
+        memcpy((char*)buf + got,
+               ra->data + (size_t)ra->head * RA_BUFSZ + ra->headpos, take);
+        got += take;
+        ra->headpos += take;
+        if (ra->headpos == ra->lens[ra->head]) {
+            ra->headpos = 0;
+            ra->head = (ra->head + 1) % ra->nbufs;
+            ra->count--;
+            pthread_cond_broadcast(&ra->cond);
+        }
+    }
+    pthread_mutex_unlock(&ra->lock);
+    *nread = got;
+    return err;
+}
+
+static void _ios_readahead_stop(ios_t *s)
+{
+    ios_readahead_t *ra = (ios_readahead_t*)s->ra;
+    if (ra == NULL)
+        return;
+    pthread_mutex_lock(&ra->lock);
+    ra->stop = 1;
+    pthread_cond_broadcast(&ra->cond);
+    pthread_mutex_unlock(&ra->lock);
+    pthread_join(ra->thread, NULL);
+    pthread_mutex_destroy(&ra->lock);
+    pthread_cond_destroy(&ra->cond);
+    LLT_FREE(ra->data);
+    LLT_FREE(ra->lens);
+    LLT_FREE(ra);
+    s->ra = NULL;
+}
+
+JL_DLLEXPORT int ios_set_readahead(ios_t *s, int nbufs)
+{
+    if (s->ra || s->fd == -1 || !s->readable || s->writable || nbufs < 1)
+        return -1;
+    ios_readahead_t *ra = (ios_readahead_t*)LLT_ALLOC(sizeof(ios_readahead_t));
+    if (ra == NULL)
+        return -1;
+    memset(ra, 0, sizeof(ios_readahead_t));
+    ra->nbufs = nbufs;
+    ra->fd = s->fd;
+    ra->data = (char*)LLT_ALLOC((size_t)nbufs * RA_BUFSZ);
+    ra->lens = (size_t*)LLT_ALLOC(nbufs * sizeof(size_t));
+    if (ra->data == NULL || ra->lens == NULL) {
+        LLT_FREE(ra->data);
+        LLT_FREE(ra->lens);
+        LLT_FREE(ra);
+        return -1;
+    }
+    pthread_mutex_init(&ra->lock, NULL);
+    pthread_cond_init(&ra->cond, NULL);
+    if (pthread_create(&ra->thread, NULL, _ios_readahead_thread, ra)) {
+        pthread_mutex_destroy(&ra->lock);
+        pthread_cond_destroy(&ra->cond);
+        LLT_FREE(ra->data);
+        LLT_FREE(ra->lens);
+        LLT_FREE(ra);
+        return -1;
+    }
+    s->ra = ra;
+    return 0;
+}
+#else
+JL_DLLEXPORT int ios_set_readahead(ios_t *s, int nbufs)
+{
+    (void)s;
+    (void)nbufs;
+    return -1;
+}
+#endif
+
+// route a stream's fd reads through the readahead pipeline when enabled
+static int _ios_fd_read(ios_t *s, void *buf, size_t n, size_t *nread)
+{
+#ifndef _OS_WINDOWS_
+    if (s->ra)
+        return _ra_read(s, buf, n, nread);
+#endif
+    return _os_read(s->fd, buf, n, nread);
+}
+
 static int _os_read_all(long fd, void *buf, size_t n, size_t *nread)
 {
     size_t got;
@@ -171,6 +336,156 @@ int _os_write_all(long fd, const void *buf, size_t n, size_t *nwritten)
     return 0;
 }
 
+// ---- write-behind buffering (bm_writebehind) -------------------------
+//
+// Double-buffered asynchronous output. ios_flush hands the stream's
+// dirty buffer to a per-stream writer thread and swaps in the idle
+// buffer, so the caller keeps filling memory while the write() runs; a
+// disk hiccup stalls the writer thread, not the caller. Total dirty
+// bytes are bounded by the two buffers: a caller that outruns the disk
+// blocks in the hand-off until the previous write finishes. ios_drain
+// is the barrier that waits for everything handed over to reach the fd.
+// The mode is meant for pure output streams; operations that need a
+// stable fd position (reads, seeks, trunc) drain first.
+typedef struct {
+    uv_mutex_t lock;
+    uv_cond_t work_c;   // wakes the writer: buffer handed off / shutdown
+    uv_cond_t done_c;   // wakes the caller: previous write retired
+    uv_thread_t thread;
+    char *wbuf;         // buffer being written; NULL when idle
+    size_t wlen;
+    char *freebuf;      // idle buffer ready to swap in; NULL while busy
+    long fd;
+    int err;            // first asynchronous write error (sticky)
+    int shutdown;
+} ios_wb_t;
+
+static void ios_wb_threadfun(void *arg)
+{
+    ios_wb_t *wb = (ios_wb_t*)arg;
+    uv_mutex_lock(&wb->lock);
+    for (;;) {
+        while (wb->wbuf == NULL && !wb->shutdown)
+            uv_cond_wait(&wb->work_c, &wb->lock);
+        if (wb->wbuf == NULL) // shutdown and nothing left to write
+            break;
+        char *buf = wb->wbuf;
+        size_t n = wb->wlen;
+        uv_mutex_unlock(&wb->lock);
+        size_t nw;
+        int err = _os_write_all(wb->fd, buf, n, &nw);
+        if (!err && nw < n)
+            err = -1;
+        uv_mutex_lock(&wb->lock);
+        if (err && !wb->err)
+            wb->err = err;
+        wb->freebuf = buf;
+        wb->wbuf = NULL;
+        uv_cond_signal(&wb->done_c);
+    }
+    uv_mutex_unlock(&wb->lock);
+}
+
+// wait until the writer has retired any in-flight buffer.
+// assumes wb->lock is held.
+static void ios_wb_wait_idle(ios_wb_t *wb)
+{
+    while (wb->wbuf != NULL)
+        uv_cond_wait(&wb->done_c, &wb->lock);
+}
+
+// hand the dirty prefix of s->buf to the writer and swap in the idle
+// buffer. Only valid in the plain streaming-output state; callers check.
+static int ios_wb_handoff(ios_t *s)
+{
+    ios_wb_t *wb = (ios_wb_t*)s->wb;
+    int err;
+    uv_mutex_lock(&wb->lock);
+    ios_wb_wait_idle(wb); // bounded dirty: at most the two buffers
+    wb->wbuf = s->buf;
+    wb->wlen = (size_t)s->ndirty;
+    s->buf = wb->freebuf;
+    wb->freebuf = NULL;
+    err = wb->err;
+    uv_cond_signal(&wb->work_c);
+    uv_mutex_unlock(&wb->lock);
+    s->fpos = -1;
+    s->ndirty = 0;
+    s->size = 0;
+    s->bpos = 0;
+    return err;
+}
+
+int ios_drain(ios_t *s)
+{
+    if (s->wb == NULL)
+        return 0;
+    if (s->ndirty > 0)
+        ios_flush(s);
+    ios_wb_t *wb = (ios_wb_t*)s->wb;
+    uv_mutex_lock(&wb->lock);
+    ios_wb_wait_idle(wb);
+    int err = wb->err;
+    uv_mutex_unlock(&wb->lock);
+    if (err)
+        s->errcode = err;
+    return err;
+}
+
+static int ios_wb_setup(ios_t *s)
+{
+    ios_wb_t *wb = (ios_wb_t*)LLT_ALLOC(sizeof(ios_wb_t));
+    if (wb == NULL)
+        return -1;
+    wb->freebuf = (char*)LLT_ALLOC((size_t)s->maxsize);
+    if (wb->freebuf == NULL) {
+        LLT_FREE(wb);
+        return -1;
+    }
+    uv_mutex_init(&wb->lock);
+    uv_cond_init(&wb->work_c);
+    uv_cond_init(&wb->done_c);
+    wb->wbuf = NULL;
+    wb->wlen = 0;
+    wb->fd = s->fd;
+    wb->err = 0;
+    wb->shutdown = 0;
+    if (uv_thread_create(&wb->thread, ios_wb_threadfun, wb) != 0) {
+        LLT_FREE(wb->freebuf);
+        uv_mutex_destroy(&wb->lock);
+        uv_cond_destroy(&wb->work_c);
+        uv_cond_destroy(&wb->done_c);
+        LLT_FREE(wb);
+        return -1;
+    }
+    s->wb = wb;
+    return 0;
+}
+
+// drain, stop the writer thread, and free the second buffer
+static int ios_wb_teardown(ios_t *s)
+{
+    ios_wb_t *wb = (ios_wb_t*)s->wb;
+    int err = ios_drain(s);
+    uv_mutex_lock(&wb->lock);
+    wb->shutdown = 1;
+    uv_cond_signal(&wb->work_c);
+    uv_mutex_unlock(&wb->lock);
+    uv_thread_join(&wb->thread);
+    s->wb = NULL;
+    LLT_FREE(wb->freebuf);
+    uv_mutex_destroy(&wb->lock);
+    uv_cond_destroy(&wb->work_c);
+    uv_cond_destroy(&wb->done_c);
+    LLT_FREE(wb);
+    return err;
+}
+
+// barrier used by operations that need a quiescent fd (reads, seeks,
+// trunc, buffer replacement); no-op unless write-behind is active
+#define ios_wb_barrier(s) do { if ((s)->wb) ios_drain(s); } while (0)
+
+
 
 /* internal utility functions */
 
@@ -284,6 +599,7 @@ static size_t _ios_read(ios_t *s, char *dest, size_t n, int all)
 
         if (didread && !all) return tot;
 
+        ios_wb_barrier(s);
         ios_flush(s);
         s->bpos = s->size = 0;
         s->fpos = -1;
@@ -291,11 +607,11 @@ static size_t _ios_read(ios_t *s, char *dest, size_t n, int all)
             // doesn't fit comfortably in buffer; go direct
             if (all) {
                 //result = _os_read_all(s->fd, dest, n, &got);
-                _os_read_all(s->fd, dest, n, &got);
+                _ios_fd_read(s, dest, n, &got);
             }
             else {
                 //result = _os_read(s->fd, dest, n, &got);
-                _os_read(s->fd, dest, n, &got);
+                _ios_fd_read(s, dest, n, &got);
             }
             tot += got;
             if (got == 0)
@@ -304,7 +620,7 @@ static size_t _ios_read(ios_t *s, char *dest, size_t n, int all)
         }
         else {
             // refill buffer
-            if (_os_read(s->fd, s->buf, (size_t)s->maxsize, &got)) {
+            if (_ios_fd_read(s, s->buf, (size_t)s->maxsize, &got)) {
                 s->_eof = 1;
                 return tot;
             }
@@ -330,6 +646,41 @@ size_t ios_readall(ios_t *s, char *dest, size_t n)
     return _ios_read(s, dest, n, 1);
 }
 
+// Return the next line directly out of the stream's buffer, zero-copy:
+// *pstart / *plen describe the line including its trailing '\n' (absent
+// only for a final unterminated fragment). The pointers stay valid until
+// the next operation on the stream. Returns 1 when a line was produced
+// and 0 at end of stream. A line that crosses the buffered window is
+// stitched by widening the buffer, so arbitrarily long records work --
+// they just pay the growth instead of staying zero-copy warm.
+JL_DLLEXPORT int ios_nextline(ios_t *s, char **pstart, size_t *plen)
+{
+    size_t n = 128;
+    while (1) {
+        size_t avail = ios_readprep(s, n);
+        if (avail == 0)
+            return 0;
+        char *start = s->buf + s->bpos;
+        char *nl = (char*)memchr(start, '\n', avail);
+        if (nl != NULL) {
+            *pstart = start;
+            *plen = (size_t)(nl - start) + 1;
+            s->bpos += *plen;
+            return 1;
+        }
+        if (avail < n) {
+            // end of stream without a terminator: emit the remainder
+            *pstart = start;
+            *plen = avail;
+            s->bpos += avail;
+            return 1;
+        }
+        // the line crosses the buffered window: widen and restitch
+        // (readprep may move the buffered data, so recompute everything)
+        n *= 2;
+    }
+}
+
 size_t ios_readprep(ios_t *s, size_t n)
 {
     if (s->state == bst_wr && s->bm != bm_mem) {
@@ -355,7 +706,7 @@ size_t ios_readprep(ios_t *s, size_t n)
     }
     size_t got;
     s->fpos = -1;
-    int result = _os_read(s->fd, s->buf+s->size, (size_t)(s->maxsize - s->size), &got);
+    int result = _ios_fd_read(s, s->buf+s->size, (size_t)(s->maxsize - s->size), &got);
     if (result)
         return space;
     s->size += got;
@@ -420,6 +771,9 @@ size_t ios_write(ios_t *s, const char *data, size_t n)
     else {
         ios_flush(s);
         if (n > MOST_OF(s->maxsize)) {
+            // ordering: a direct write may not overtake buffers already
+            // handed to the background writer
+            ios_wb_barrier(s);
             _os_write_all(s->fd, data, n, &wrote);
             return wrote;
         }
@@ -434,6 +788,11 @@ size_t ios_write(ios_t *s, const char *data, size_t n)
 //        -2 on error which doesn't set errno.
 int64_t ios_seek(ios_t *s, int64_t pos)
 {
+    // a readahead stream has consumed the fd past the visible position
+    // and can only be read sequentially
+    if (s->ra)
+        return -1;
+    ios_wb_barrier(s);
     s->_eof = 0;
     if (s->bm == bm_mem) {
         if (pos < 0 || pos > s->size)
@@ -453,6 +812,7 @@ int64_t ios_seek(ios_t *s, int64_t pos)
 
 int64_t ios_seek_end(ios_t *s)
 {
+    ios_wb_barrier(s);
     s->_eof = 1;
     if (s->bm == bm_mem) {
         s->bpos = s->size;
@@ -474,6 +834,7 @@ int64_t ios_seek_end(ios_t *s)
 int64_t ios_skip(ios_t *s, int64_t offs)
 {
     if (offs != 0) {
+        ios_wb_barrier(s);
         if (offs > 0) {
             if (offs <= (s->size - s->bpos)) {
                 s->bpos += offs;
@@ -513,6 +874,7 @@ int64_t ios_pos(ios_t *s)
 {
     if (s->bm == bm_mem)
         return s->bpos;
+    ios_wb_barrier(s);
 
     int64_t fdpos = s->fpos;
     if (fdpos == (int64_t)-1) {
@@ -535,6 +897,7 @@ int64_t ios_pos(ios_t *s)
 
 int ios_trunc(ios_t *s, size_t size)
 {
+    ios_wb_barrier(s);
     if (s->bm == bm_mem) {
         if (size == s->size)
             return 0;
@@ -601,6 +964,23 @@ int ios_eof_blocking(ios_t *s)
 
 int ios_flush(ios_t *s)
 {
+    if (s->wb != NULL && s->ndirty > 0) {
+        // the streaming-output case hands off asynchronously; anything
+        // fancier (read-back data in the buffer, a read state needing
+        // the lseek dance below) waits for the writer and runs the
+        // synchronous path so the fd position is coherent
+        if (s->state == bst_wr && s->size == s->ndirty &&
+            s->bpos == s->ndirty) {
+            int err = ios_wb_handoff(s);
+            if (err)
+                s->errcode = err;
+            return err;
+        }
+        ios_wb_t *wb = (ios_wb_t*)s->wb;
+        uv_mutex_lock(&wb->lock);
+        ios_wb_wait_idle(wb);
+        uv_mutex_unlock(&wb->lock);
+    }
     if (s->ndirty == 0 || s->bm == bm_mem || s->buf == NULL)
         return 0;
     if (s->fd == -1)
@@ -646,10 +1026,22 @@ int ios_flush(ios_t *s)
 
 void ios_close(ios_t *s)
 {
+    if (s->wb != NULL)
+        ios_wb_teardown(s);
+#ifndef _OS_WINDOWS_
+    _ios_readahead_stop(s);
+#endif
     ios_flush(s);
     if (s->fd != -1 && s->ownfd)
         close(s->fd);
     s->fd = -1;
+#ifndef _OS_WINDOWS_
+    if (s->mmapped && s->buf != NULL) {
+        munmap(s->buf, (size_t)s->maxsize);
+        s->buf = NULL;
+        s->mmapped = 0;
+    }
+#endif
     if (s->buf!=NULL && s->ownbuf && s->buf!=&s->local[0]) {
         LLT_FREE(s->buf);
     }
@@ -679,6 +1071,7 @@ static void _buf_init(ios_t *s, bufmode_t bm)
 
 char *ios_takebuf(ios_t *s, size_t *psize)
 {
+    ios_wb_barrier(s);
     char *buf;
 
     ios_flush(s);
@@ -708,6 +1101,11 @@ char *ios_takebuf(ios_t *s, size_t *psize)
 
 int ios_setbuf(ios_t *s, char *buf, size_t size, int own)
 {
+    // replacing the buffer invalidates the write-behind pair; rebuild it
+    if (s->wb != NULL) {
+        ios_wb_teardown(s);
+        s->bm = bm_block;
+    }
     ios_flush(s);
     size_t nvalid=0;
 
@@ -734,6 +1132,18 @@ int ios_bufmode(ios_t *s, bufmode_t mode)
     // no fd; can only do mem-only buffering
     if (s->fd == -1 && mode != bm_mem)
         return -1;
+    if (mode == bm_writebehind) {
+        if (!s->writable)
+            return -1;
+        if (s->wb == NULL) {
+            ios_flush(s);
+            if (ios_wb_setup(s))
+                return -1;
+        }
+    }
+    else if (s->wb != NULL) {
+        ios_wb_teardown(s);
+    }
     s->bm = mode;
     return 0;
 }
@@ -791,6 +1201,47 @@ size_t ios_copy(ios_t *to, ios_t *from, size_t nbytes)
 
 size_t ios_copyall(ios_t *to, ios_t *from)
 {
+#if defined(_OS_LINUX_) && defined(__NR_copy_file_range)
+    // kernel-to-kernel fast path: when both ends are plain fds, drain the
+    // already-buffered bytes through the normal path to line the file
+    // offset up with the logical position, then let the kernel move the
+    // rest without bouncing through user space. Any error (e.g. one end
+    // is a socket or an old kernel) falls back to the buffer loop.
+    if (from->bm != bm_mem && from->fd != -1 && !from->ra &&
+        from->state != bst_wr && from->ndirty == 0 &&
+        to->bm != bm_mem && to->fd != -1) {
+        size_t total = 0;
+        size_t buffered = (size_t)(from->size - from->bpos);
+        if (buffered) {
+            size_t written = ios_write(to, from->buf + from->bpos, buffered);
+            from->bpos += written;
+            total += written;
+            if (written < buffered)
+                return total;
+        }
+        ios_flush(to);
+        from->fpos = -1;
+        to->fpos = -1;
+        int fellback = 0;
+        while (1) {
+            ssize_t n = syscall(__NR_copy_file_range, (int)from->fd, NULL,
+                                (int)to->fd, NULL, (size_t)SSIZE_MAX, 0);
+            if (n == 0)
+                return total; // end of input
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                // not supported for this fd pair; finish generically
+                fellback = 1;
+                break;
+            }
+            total += (size_t)n;
+        }
+        if (fellback)
+            return total + ios_copy_(to, from, 0, 1);
+        return total;
+    }
+#endif
     return ios_copy_(to, from, 0, 1);
 }
 
@@ -842,6 +1293,9 @@ static void _ios_init(ios_t *s)
     s->ownbuf = 1;
     s->ownfd = 0;
     s->_eof = 0;
+    s->mmapped = 0;
+    s->ra = NULL;
+    s->wb = NULL;
     s->readable = 1;
     s->writable = 1;
     s->rereadable = 0;
@@ -966,6 +1420,53 @@ ios_t *ios_static_buffer(ios_t *s, char *buf, size_t sz)
     return s;
 }
 
+// Map `fname` read-only and expose it as a memory stream: reads and
+// ios_readprep work straight out of the page cache with no read syscalls
+// or buffer copies. `advice` is one of the IOS_MMAP_* values. Returns
+// NULL when the file cannot be opened or mapped (the caller can fall
+// back to ios_file).
+JL_DLLEXPORT ios_t *ios_mmap(ios_t *s, const char *fname, int advice)
+{
+#ifdef _OS_WINDOWS_
+    (void)s;
+    (void)fname;
+    (void)advice;
+    return NULL;
+#else
+    int fd = open(fname, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 || !S_ISREG(sb.st_mode)) {
+        close(fd);
+        return NULL;
+    }
+    if (sb.st_size == 0) {
+        // mmap refuses empty mappings; an empty static buffer behaves
+        // the same
+        close(fd);
+        ios_static_buffer(s, &s->local[0], 0);
+        return s;
+    }
+    // writable + private: readers that alias the mapping (e.g. the
+    // sysimg deserializer's zero-copy method bodies) may be mutated by
+    // user code, and those writes must COW instead of faulting
+    void *mem = mmap(NULL, (size_t)sb.st_size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE, fd, 0);
+    // the mapping keeps the pages; the descriptor is not needed anymore
+    close(fd);
+    if (mem == MAP_FAILED)
+        return NULL;
+    if (advice == IOS_MMAP_SEQUENTIAL)
+        madvise(mem, (size_t)sb.st_size, MADV_SEQUENTIAL);
+    else if (advice == IOS_MMAP_WILLNEED)
+        madvise(mem, (size_t)sb.st_size, MADV_WILLNEED);
+    ios_static_buffer(s, (char*)mem, (size_t)sb.st_size);
+    s->mmapped = 1;
+    return s;
+#endif
+}
+
 ios_t *ios_fd(ios_t *s, long fd, int isfile, int own)
 {
     _ios_init(s);
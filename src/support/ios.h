@@ -15,7 +15,8 @@ extern "C" {
 // never moves out.
 
 //make it compatible with UV Handles
-typedef enum { bm_none=UV_HANDLE_TYPE_MAX+1, bm_line, bm_block, bm_mem } bufmode_t;
+typedef enum { bm_none=UV_HANDLE_TYPE_MAX+1, bm_line, bm_block, bm_mem,
+               bm_writebehind } bufmode_t;
 typedef enum { bst_none, bst_rd, bst_wr } bufstate_t;
 
 #define IOS_INLSIZE 54
@@ -57,6 +58,16 @@ typedef struct {
     // again any number of times. usually only true for files and strings.
     unsigned char rereadable:1;
 
+    // buffer is a memory mapping owned by the stream; unmapped on close
+    unsigned char mmapped:1;
+
+    // opaque readahead pipeline state (see ios_set_readahead); NULL when
+    // readahead is off
+    void *ra;
+
+    // opaque write-behind state (bm_writebehind); NULL otherwise
+    void *wb;
+
     // this enables "stenciled writes". you can alternately write and
     // seek without flushing in between. this performs read-before-write
     // to populate the buffer, so "rereadable" capability is required.
@@ -83,6 +94,10 @@ JL_DLLEXPORT int ios_trunc(ios_t *s, size_t size);
 JL_DLLEXPORT int ios_eof(ios_t *s);
 JL_DLLEXPORT int ios_eof_blocking(ios_t *s);
 JL_DLLEXPORT int ios_flush(ios_t *s);
+// write-behind barrier: block until everything handed to the background
+// writer (bm_writebehind) has reached the fd; returns the first error
+// the writer hit, if any. A no-op in the other buffering modes.
+JL_DLLEXPORT int ios_drain(ios_t *s);
 JL_DLLEXPORT void ios_close(ios_t *s);
 JL_DLLEXPORT int ios_isopen(ios_t *s);
 JL_DLLEXPORT char *ios_takebuf(ios_t *s, size_t *psize);  // release buffer to caller
@@ -105,6 +120,12 @@ JL_DLLEXPORT ios_t *ios_mkstemp(ios_t *f, char *fname);
 JL_DLLEXPORT ios_t *ios_mem(ios_t *s, size_t initsize);
 ios_t *ios_str(ios_t *s, char *str);
 ios_t *ios_static_buffer(ios_t *s, char *buf, size_t sz);
+// mmap-backed read-only stream over a whole file; ios_readprep exposes
+// the mapped pages directly (no copies, no read syscalls)
+#define IOS_MMAP_NONE       0
+#define IOS_MMAP_SEQUENTIAL 1
+#define IOS_MMAP_WILLNEED   2
+JL_DLLEXPORT ios_t *ios_mmap(ios_t *s, const char *fname, int advice);
 JL_DLLEXPORT ios_t *ios_fd(ios_t *s, long fd, int isfile, int own);
 // todo: ios_socket
 extern JL_DLLEXPORT ios_t *ios_stdin;
@@ -121,6 +142,8 @@ JL_DLLEXPORT int ios_vprintf(ios_t *s, const char *format, va_list args);
 JL_DLLEXPORT int ios_getutf8(ios_t *s, uint32_t *pwc);
 JL_DLLEXPORT int ios_peekutf8(ios_t *s, uint32_t *pwc);
 JL_DLLEXPORT char *ios_readline(ios_t *s);
+JL_DLLEXPORT int ios_set_readahead(ios_t *s, int nbufs);
+JL_DLLEXPORT int ios_nextline(ios_t *s, char **pstart, size_t *plen);
 
 // discard data buffered for reading
 JL_DLLEXPORT void ios_purge(ios_t *s);
@@ -16,6 +16,7 @@
 #include "hashing.h"
 #include "ptrhash.h"
 #include "bitvector.h"
+#include "chunklist.h"
 #include "dirpath.h"
 #include "strtod.h"
 
@@ -0,0 +1,210 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+/*
+  Small self-contained implementation of LZ4 block compression, used to
+  compress system image segments (see dump.c). The format follows the LZ4
+  block spec: a token byte holding the literal length (high nibble) and
+  match length - 4 (low nibble), 255-extension bytes for either length,
+  the literals, then a 2-byte little-endian match offset. The compressor
+  is a greedy single-pass with a small position hash -- the goal is cutting
+  image page-in I/O several-fold at memory-like decompression speed, not
+  competing with the reference implementation's ratios.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "dtypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LZ4_MIN_MATCH 4
+// matches may not start closer than this to the end of the input, and the
+// final bytes are always emitted as literals (mirrors the reference
+// encoder's end conditions, which keep wide-copy decoders in bounds)
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_SAFE_END 12
+#define LZ4_MAX_OFFSET 65535
+
+#define LZ4_HASH_LOG 13
+#define LZ4_HASH_SZ (1 << LZ4_HASH_LOG)
+
+JL_DLLEXPORT size_t jl_lz4_compress_bound(size_t n)
+{
+    return n + n / 255 + 16;
+}
+
+static uint32_t lz4_read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static uint32_t lz4_hash(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - LZ4_HASH_LOG);
+}
+
+// write a length in token-nibble + 255-extension form
+static unsigned char *lz4_write_len(unsigned char *op, size_t len)
+{
+    while (len >= 255) {
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = (unsigned char)len;
+    return op;
+}
+
+// Compress `n` bytes from `src` into `dst` (which must have room for
+// jl_lz4_compress_bound(n) bytes). Returns the compressed size, or 0 when
+// the input is incompressible enough to overflow the bound (callers then
+// store the block raw).
+JL_DLLEXPORT size_t jl_lz4_compress(const char *src, size_t n, char *dst,
+                                    size_t cap)
+{
+    const unsigned char *ip = (const unsigned char*)src;
+    const unsigned char *iend = ip + n;
+    const unsigned char *match_limit =
+        n > LZ4_MATCH_SAFE_END ? iend - LZ4_MATCH_SAFE_END : ip;
+    const unsigned char *copy_limit =
+        n > LZ4_LAST_LITERALS ? iend - LZ4_LAST_LITERALS : ip;
+    unsigned char *op = (unsigned char*)dst;
+    unsigned char *oend = op + cap;
+    const unsigned char *anchor = ip;
+    uint32_t htab[LZ4_HASH_SZ];
+    memset(htab, 0, sizeof(htab));
+
+    if (n > LZ4_MATCH_SAFE_END) {
+        ip++; // position 0 stays a literal; also keeps 0 as "empty" in htab
+        while (ip < match_limit) {
+            // find a match candidate
+            uint32_t h = lz4_hash(lz4_read32(ip));
+            const unsigned char *ref = (const unsigned char*)src + htab[h];
+            htab[h] = (uint32_t)(ip - (const unsigned char*)src);
+            if (ref >= ip || ip - ref > LZ4_MAX_OFFSET ||
+                lz4_read32(ref) != lz4_read32(ip)) {
+                ip++;
+                continue;
+            }
+            // extend the match forward (staying clear of the tail)
+            const unsigned char *mstart = ip;
+            const unsigned char *r = ref + LZ4_MIN_MATCH;
+            ip += LZ4_MIN_MATCH;
+            while (ip < copy_limit && *ip == *r) {
+                ip++;
+                r++;
+            }
+            size_t mlen = (size_t)(ip - mstart);
+            size_t litlen = (size_t)(mstart - anchor);
+            // emit the sequence: worst case token + two extended lengths
+            // + literals + offset
+            if (op + litlen + litlen / 255 + mlen / 255 + 8 > oend)
+                return 0;
+            unsigned char *token = op++;
+            if (litlen >= 15) {
+                *token = 15 << 4;
+                op = lz4_write_len(op, litlen - 15);
+            }
+            else {
+                *token = (unsigned char)(litlen << 4);
+            }
+            memcpy(op, anchor, litlen);
+            op += litlen;
+            size_t off = (size_t)(mstart - ref);
+            *op++ = (unsigned char)(off & 0xff);
+            *op++ = (unsigned char)(off >> 8);
+            if (mlen - LZ4_MIN_MATCH >= 15) {
+                *token |= 15;
+                op = lz4_write_len(op, mlen - LZ4_MIN_MATCH - 15);
+            }
+            else {
+                *token |= (unsigned char)(mlen - LZ4_MIN_MATCH);
+            }
+            anchor = ip;
+        }
+    }
+    // trailing literals
+    {
+        size_t litlen = (size_t)(iend - anchor);
+        if (op + litlen + litlen / 255 + 2 > oend)
+            return 0;
+        unsigned char *token = op++;
+        if (litlen >= 15) {
+            *token = 15 << 4;
+            op = lz4_write_len(op, litlen - 15);
+        }
+        else {
+            *token = (unsigned char)(litlen << 4);
+        }
+        memcpy(op, anchor, litlen);
+        op += litlen;
+    }
+    return (size_t)(op - (unsigned char*)dst);
+}
+
+// Decompress exactly `cap` bytes into `dst` from the `n` compressed bytes
+// at `src`. Returns the number of bytes produced, or 0 on malformed input
+// (truncated sequences, out-of-range offsets, or output overflow).
+JL_DLLEXPORT size_t jl_lz4_decompress(const char *src, size_t n, char *dst,
+                                      size_t cap)
+{
+    const unsigned char *ip = (const unsigned char*)src;
+    const unsigned char *iend = ip + n;
+    unsigned char *op = (unsigned char*)dst;
+    unsigned char *oend = op + cap;
+
+    while (ip < iend) {
+        unsigned token = *ip++;
+        // literals
+        size_t litlen = token >> 4;
+        if (litlen == 15) {
+            unsigned char c;
+            do {
+                if (ip >= iend)
+                    return 0;
+                c = *ip++;
+                litlen += c;
+            } while (c == 255);
+        }
+        if (litlen > (size_t)(iend - ip) || litlen > (size_t)(oend - op))
+            return 0;
+        memcpy(op, ip, litlen);
+        ip += litlen;
+        op += litlen;
+        if (ip == iend)
+            break; // final sequence has no match part
+        // match
+        if (iend - ip < 2)
+            return 0;
+        size_t off = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (off == 0 || off > (size_t)(op - (unsigned char*)dst))
+            return 0;
+        size_t mlen = (token & 15) + LZ4_MIN_MATCH;
+        if ((token & 15) == 15) {
+            unsigned char c;
+            do {
+                if (ip >= iend)
+                    return 0;
+                c = *ip++;
+                mlen += c;
+            } while (c == 255);
+        }
+        if (mlen > (size_t)(oend - op))
+            return 0;
+        // byte-wise copy: the match may overlap its own output
+        const unsigned char *r = op - off;
+        while (mlen--)
+            *op++ = *r++;
+    }
+    return (size_t)(op - (unsigned char*)dst);
+}
+
+#ifdef __cplusplus
+}
+#endif
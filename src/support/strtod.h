@@ -8,6 +8,7 @@ extern "C" {
 #endif
 
 JL_DLLEXPORT double jl_strtod_c(const char *nptr, char **endptr);
+JL_DLLEXPORT double jl_strtod_fast(const char *nptr, char **endptr);
 JL_DLLEXPORT float jl_strtof_c(const char *nptr, char **endptr);
 
 #ifdef __cplusplus
@@ -37,6 +37,10 @@
 
 #include "utf8.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -97,6 +101,34 @@ size_t u8_toucs(uint32_t *dest, size_t sz, const char *src, size_t srcsz)
         return 0;
 
     while (i < sz) {
+#if defined(__SSE2__)
+        // ASCII fast path: widen 16 bytes per iteration; the first
+        // non-ASCII byte drops back to the scalar decoder
+        while (i + 16 <= sz && src + 16 <= src_end) {
+            __m128i b = _mm_loadu_si128((const __m128i*)src);
+            if (_mm_movemask_epi8(b) != 0)
+                break;
+            __m128i z = _mm_setzero_si128();
+            __m128i lo = _mm_unpacklo_epi8(b, z);
+            __m128i hi = _mm_unpackhi_epi8(b, z);
+            _mm_storeu_si128((__m128i*)&dest[i], _mm_unpacklo_epi16(lo, z));
+            _mm_storeu_si128((__m128i*)&dest[i + 4],
+                             _mm_unpackhi_epi16(lo, z));
+            _mm_storeu_si128((__m128i*)&dest[i + 8],
+                             _mm_unpacklo_epi16(hi, z));
+            _mm_storeu_si128((__m128i*)&dest[i + 12],
+                             _mm_unpackhi_epi16(hi, z));
+            i += 16;
+            src += 16;
+        }
+        if (i >= sz)
+            break;
+#endif
+        // don't read past the input when it is exhausted but output
+        // capacity remains (previously this could emit a replacement
+        // char synthesized from out-of-bounds bytes)
+        if (src >= src_end)
+            break;
         if (!isutf(*src)) {     // invalid sequence
             dest[i++] = 0xFFFD;
             src++;
@@ -136,6 +168,30 @@ size_t u8_toutf8(char *dest, size_t sz, const uint32_t *src, size_t srcsz)
     char *dest_end = dest + sz;
 
     while (i < srcsz) {
+#if defined(__SSE2__)
+        // ASCII fast path: narrow 16 code points per iteration; any
+        // lane with bits above 0x7F drops back to the scalar encoder
+        while (i + 16 <= srcsz && dest + 16 <= dest_end) {
+            __m128i a = _mm_loadu_si128((const __m128i*)&src[i]);
+            __m128i b = _mm_loadu_si128((const __m128i*)&src[i + 4]);
+            __m128i c = _mm_loadu_si128((const __m128i*)&src[i + 8]);
+            __m128i d = _mm_loadu_si128((const __m128i*)&src[i + 12]);
+            __m128i all = _mm_or_si128(_mm_or_si128(a, b),
+                                       _mm_or_si128(c, d));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(
+                    _mm_and_si128(all, _mm_set1_epi32((int)0xFFFFFF80)),
+                    _mm_setzero_si128())) != 0xFFFF)
+                break;
+            // all values < 0x80: the saturating packs are exact
+            _mm_storeu_si128((__m128i*)dest,
+                             _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                              _mm_packs_epi32(c, d)));
+            dest += 16;
+            i += 16;
+        }
+        if (i >= srcsz)
+            break;
+#endif
         ch = src[i];
         if (ch < 0x80) {
             if (dest >= dest_end)
@@ -224,6 +280,19 @@ size_t u8_offset(const char *s, size_t charnum)
 size_t u8_charnum(const char *s, size_t offset)
 {
     size_t charnum = 0;
+#if defined(__SSE2__)
+    // count the non-continuation bytes 16 at a time: continuation bytes
+    // are exactly the ones in [0x80,0xbf], i.e. smaller than -64 as
+    // signed bytes
+    const __m128i cont = _mm_set1_epi8(-64);
+    while (offset >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)s);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmplt_epi8(v, cont));
+        charnum += 16 - __builtin_popcount(mask);
+        s += 16;
+        offset -= 16;
+    }
+#endif
     if (offset) {
        do {
           // Simply not count continuation bytes
@@ -538,6 +607,36 @@ size_t u8_printf(const char *fmt, ...)
 
    length is in bytes, since without knowing whether the string is valid
    it's hard to know how many characters there are! */
+#if defined(__SSE2__)
+// advance *ppnt to the first byte with the high bit set, 16 bytes at a
+// time; returns 0 when there is none before pend. The validation state
+// machine below stays scalar: the multi-byte sequences it handles are a
+// small fraction of the mostly-ASCII text this function is hot on, and
+// the ASCII scanning between them is where the time goes.
+static int u8_scan_ascii(const unsigned char **ppnt, const unsigned char *pend)
+{
+    const unsigned char *pnt = *ppnt;
+    while (pnt + 16 <= pend) {
+        __m128i v = _mm_loadu_si128((const __m128i*)pnt);
+        unsigned mask = (unsigned)_mm_movemask_epi8(v);
+        if (mask) {
+            *ppnt = pnt + __builtin_ctz(mask);
+            return 1;
+        }
+        pnt += 16;
+    }
+    while (pnt < pend) {
+        if (*pnt & 0x80) {
+            *ppnt = pnt;
+            return 1;
+        }
+        pnt++;
+    }
+    *ppnt = pnt;
+    return 0;
+}
+#endif
+
 int u8_isvalid(const char *str, size_t len)
 {
     const unsigned char *pnt;   // Current pointer in string
@@ -549,10 +648,16 @@ int u8_isvalid(const char *str, size_t len)
     pnt = (unsigned char *)str;
     pend = (unsigned char *)str + len;
     // First scan for non-ASCII characters as fast as possible
+#if defined(__SSE2__)
+    if (!u8_scan_ascii(&pnt, pend))
+        return 1;
+    pnt++;
+#else
     do {
         if (*pnt++ & 0x80) goto chkutf8;
     } while (pnt < pend);
     return 1;
+#endif
 
     // Check validity of UTF-8 sequences
 chkutf8:
@@ -587,10 +692,17 @@ chkutf8:
         pnt += 3;
     }
     // Find next non-ASCII characters as fast as possible
+#if defined(__SSE2__)
+    if (!u8_scan_ascii(&pnt, pend))
+        return 2;   // Valid UTF-8
+    pnt++;
+    goto chkutf8;
+#else
     while (pnt < pend) {
         if (*pnt++ & 0x80) goto chkutf8;
     }
     return 2;   // Valid UTF-8
+#endif
 }
 #ifdef __cplusplus
 }
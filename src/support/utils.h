@@ -8,6 +8,8 @@ extern "C" {
 #endif
 
 JL_DLLEXPORT char *uint2str(char *dest, size_t len, uint64_t num, uint32_t base);
+JL_DLLEXPORT size_t jl_i64toa(char *dest, int64_t num);
+JL_DLLEXPORT size_t jl_dtoa_shortest(char *dest, size_t len, double x);
 int str2int(char *str, size_t len, int64_t *res, uint32_t base);
 int isdigit_base(char c, int base);
 
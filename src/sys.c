@@ -117,7 +117,45 @@ JL_DLLEXPORT int jl_uv_fs_result(uv_fs_t *f) { return f->result; }
 // --- stat ---
 JL_DLLEXPORT int jl_sizeof_stat(void) { return sizeof(uv_stat_t); }
 
-JL_DLLEXPORT int32_t jl_stat(const char *path, char *statbuf)
+// opt-in stat cache
+//
+// The load-path search loops stat the same directories hundreds of times
+// during package loading. When enabled (jl_statcache_enable), results --
+// including failures -- are remembered in a small direct mapped table
+// until jl_statcache_invalidate wipes it; callers that mutate the
+// filesystem mid-search are expected to invalidate (which is why the
+// cache is opt-in, scoped to the loading code). Entries own copies of
+// their path strings; a hash slot collision simply replaces the entry.
+#define STATCACHE_SZ 512 // must be a power of two
+typedef struct {
+    char *path; // malloc'd; NULL = empty
+    int32_t ret;
+    char statbuf[sizeof(uv_stat_t)];
+} jl_statcache_ent_t;
+static jl_statcache_ent_t statcache[STATCACHE_SZ];
+static int statcache_enabled = 0;
+static jl_mutex_t statcache_lock;
+
+JL_DLLEXPORT void jl_statcache_invalidate(void)
+{
+    JL_LOCK_NOGC(&statcache_lock);
+    for (int i = 0; i < STATCACHE_SZ; i++) {
+        free(statcache[i].path);
+        statcache[i].path = NULL;
+    }
+    JL_UNLOCK_NOGC(&statcache_lock);
+}
+
+JL_DLLEXPORT int jl_statcache_enable(int on)
+{
+    int prev = statcache_enabled;
+    statcache_enabled = (on != 0);
+    if (!on && prev)
+        jl_statcache_invalidate();
+    return prev;
+}
+
+static int32_t jl_stat_uncached(const char *path, char *statbuf)
 {
     uv_fs_t req;
     int ret;
@@ -131,6 +169,36 @@ JL_DLLEXPORT int32_t jl_stat(const char *path, char *statbuf)
     return ret;
 }
 
+JL_DLLEXPORT int32_t jl_stat(const char *path, char *statbuf)
+{
+    if (__likely(!statcache_enabled))
+        return jl_stat_uncached(path, statbuf);
+    uint64_t h = memhash(path, strlen(path));
+    size_t idx = (size_t)h & (STATCACHE_SZ - 1);
+    JL_LOCK_NOGC(&statcache_lock);
+    jl_statcache_ent_t *ent = &statcache[idx];
+    if (ent->path != NULL && strcmp(ent->path, path) == 0) {
+        int32_t ret = ent->ret;
+        if (ret == 0)
+            memcpy(statbuf, ent->statbuf, sizeof(uv_stat_t));
+        JL_UNLOCK_NOGC(&statcache_lock);
+        return ret;
+    }
+    JL_UNLOCK_NOGC(&statcache_lock);
+    int32_t ret = jl_stat_uncached(path, statbuf);
+    char *pathcopy = strdup(path);
+    if (pathcopy != NULL) {
+        JL_LOCK_NOGC(&statcache_lock);
+        free(ent->path);
+        ent->path = pathcopy;
+        ent->ret = ret;
+        if (ret == 0)
+            memcpy(ent->statbuf, statbuf, sizeof(uv_stat_t));
+        JL_UNLOCK_NOGC(&statcache_lock);
+    }
+    return ret;
+}
+
 JL_DLLEXPORT int32_t jl_lstat(const char *path, char *statbuf)
 {
     uv_fs_t req;
@@ -37,6 +37,21 @@ void jl_idtable_rehash(jl_array_t **pa, size_t newsz)
     JL_GC_POP();
 }
 
+// On upgrading this scheme (robin-hood probing, incremental growth):
+// the (key, value) pair array IS the table's public representation --
+// Base's ObjectIdDict iterates, serializes, and deletes through the
+// raw array, and the serializer walks it too -- which pins the design
+// harder than it looks. Robin-hood displacement needs every displaced
+// key's hash, and with no room for stored hashes in the pair layout
+// that means recomputing jl_object_id (a content hash for immutables)
+// per displaced entry per insert, easily costing more than the probe
+// shortening saves. Incremental migration needs old and new arrays
+// live simultaneously, but consumers hold and iterate the single
+// array directly, so a split table would be visible to them mid-
+// migration. Within the fixed layout, pairs already pack four to a
+// cacheline and probing is linear over adjacent pairs; the remaining
+// wins require giving ObjectIdDict an opaque representation first,
+// which is a Base ABI change beyond this table.
 static void **jl_table_lookup_bp(jl_array_t **pa, void *key)
 {
     // pa points to a **rooted** gc frame slot
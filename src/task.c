@@ -14,6 +14,7 @@
 #include <inttypes.h>
 #include "julia.h"
 #include "julia_internal.h"
+#include "uprobes.h"
 #include "threading.h"
 
 #ifdef __cplusplus
@@ -140,6 +141,44 @@ jl_datatype_t *jl_task_type;
 #define ASM_COPY_STACKS
 #endif
 
+// Hybrid stacks: most tasks copy their stack in and out of the thread
+// stack on every switch, but a task whose start function has historically
+// needed a big stack (recorded below) gets its own stack buffer up front
+// and switches with a plain longjmp, no copying. The cache is a small
+// direct mapped table keyed on the start function's address; the pointers
+// are never dereferenced, only compared, so a stale entry is merely a
+// wrong sizing hint.
+#ifdef ASM_COPY_STACKS
+#define TASK_HW_CACHE_SZ 256 // must be a power of two
+static struct {
+    jl_value_t *f;
+    size_t hw;
+} task_hw_cache[TASK_HW_CACHE_SZ];
+
+STATIC_INLINE size_t task_hw_idx(jl_value_t *f)
+{
+    return (((uintptr_t)f) >> 4) & (TASK_HW_CACHE_SZ - 1);
+}
+
+static void task_hw_record(jl_task_t *t, size_t nb)
+{
+    if (t->start == NULL)
+        return;
+    size_t idx = task_hw_idx((jl_value_t*)t->start);
+    if (task_hw_cache[idx].f != (jl_value_t*)t->start ||
+        task_hw_cache[idx].hw < nb) {
+        task_hw_cache[idx].f = (jl_value_t*)t->start;
+        task_hw_cache[idx].hw = nb;
+    }
+}
+
+static size_t task_hw_lookup(jl_function_t *f)
+{
+    size_t idx = task_hw_idx((jl_value_t*)f);
+    return task_hw_cache[idx].f == (jl_value_t*)f ? task_hw_cache[idx].hw : 0;
+}
+#endif
+
 static void NOINLINE save_stack(jl_tls_states_t *ptls, jl_task_t *t)
 {
     if (t->state == done_sym || t->state == failed_sym)
@@ -147,6 +186,9 @@ static void NOINLINE save_stack(jl_tls_states_t *ptls, jl_task_t *t)
     char *frame_addr = (char*)jl_get_frame_addr();
     size_t nb = (char*)ptls->stackbase - frame_addr;
     char *buf;
+#ifdef ASM_COPY_STACKS
+    task_hw_record(t, nb);
+#endif
     if (t->stkbuf == NULL || t->bufsz < nb) {
         buf = (char*)allocb(nb);
         t->stkbuf = buf;
@@ -183,6 +225,10 @@ static void NOINLINE restore_stack(jl_tls_states_t *ptls, jl_task_t *t,
 
 static jl_function_t *task_done_hook_func=NULL;
 
+#if defined(COPY_STACKS) && defined(ASM_COPY_STACKS)
+static void flush_pending_dead_stack(jl_tls_states_t *ptls);
+#endif
+
 static void JL_NORETURN finish_task(jl_task_t *t, jl_value_t *resultval)
 {
     if (t->exception != jl_nothing)
@@ -193,6 +239,20 @@ static void JL_NORETURN finish_task(jl_task_t *t, jl_value_t *resultval)
     jl_gc_wb(t, t->result);
     // TODO: early free of t->stkbuf
 #ifdef COPY_STACKS
+#ifdef ASM_COPY_STACKS
+    // Recycle private stacks: creating one per short-lived task costs a
+    // big allocation each time, so dead stacks are reused by jl_new_task.
+    // We are still *running on* this stack (the done hooks below execute
+    // here too), so it only becomes poolable after the thread has
+    // switched off of it -- stash it and let ctx_switch's arrival side
+    // move it into the pool.
+    if (!t->copy_stack && t->stkbuf != NULL &&
+        t->stkbuf != (void*)(intptr_t)-1) {
+        jl_tls_states_t *ptls = jl_get_ptls_states();
+        ptls->pending_dead_stack = t->stkbuf;
+        ptls->pending_dead_stack_sz = t->bufsz;
+    }
+#endif
     t->stkbuf = (void*)(intptr_t)-1;
 #endif
     if (ti_tid != 0) {
@@ -223,13 +283,47 @@ static void throw_if_exception_set(jl_task_t *t)
     }
 }
 
+// Exceptions used as control flow are thrown and caught a few frames
+// apart at high rates, and a full unwinder pass per throw dominates such
+// workloads. The stack is gone by the time a handler could ask for the
+// trace (throw_internal longjmps away), so the capture itself cannot be
+// deferred; what can be made cheap is the walk. With
+// JULIA_FAST_EXCEPTIONS=1 the throw path records the frame-pointer
+// chain (see rec_backtrace_fp_here) -- an order of magnitude cheaper
+// per frame than unw_step and bounded in depth -- and symbolization
+// stays lazy as always (frames are only looked up when a trace is
+// displayed). Chains that don't check out (a task on a private stack
+// buffer, or C frames without frame pointers near the top) fall back to
+// the full unwinder so error display never regresses to an empty trace.
+#define BT_FAST_MAX_DEPTH 256
 static void record_backtrace(void)
 {
+#if defined(_OS_LINUX_) && defined(_CPU_X86_64_)
+    static int fast_exc = -1;
+    if (fast_exc == -1) {
+        char *cp = getenv(FAST_EXCEPTIONS_NAME);
+        fast_exc = (cp != NULL && strtol(cp, NULL, 10) != 0);
+    }
+    if (fast_exc) {
+        size_t n = rec_backtrace_fp_here(jl_bt_data, BT_FAST_MAX_DEPTH);
+        if (n >= 2) {
+            jl_bt_size = n;
+            return;
+        }
+    }
+#endif
     jl_bt_size = rec_backtrace(jl_bt_data, JL_MAX_BT_SIZE);
 }
 
 static void NOINLINE JL_NORETURN start_task(void)
 {
+#if defined(COPY_STACKS) && defined(ASM_COPY_STACKS)
+    {
+        jl_tls_states_t *ptls0 = jl_get_ptls_states();
+        // see ctx_switch: we just arrived on this (fresh) task's stack
+        flush_pending_dead_stack(ptls0);
+    }
+#endif
     // this runs the first time we switch to a task
     jl_task_t *t = jl_current_task;
     jl_value_t *res;
@@ -281,16 +375,65 @@ JL_DLLEXPORT void julia_init(JL_IMAGE_SEARCH rel)
 #endif
 }
 
+#if defined(COPY_STACKS) && defined(ASM_COPY_STACKS)
+#define TASK_STACK_POOL_MAX 4 // recycled stack buffers kept per thread
+// move a finished task's stack into the recycle pool. Runs on the arrival
+// side of a context switch, i.e. never on the stack being pooled.
+// Resident cost of private stacks tracks actual depth, not capacity:
+// fresh stack buffers are demand paged by the OS (only the pages a
+// task's deepest frame reached ever become resident), and when a dead
+// stack enters the reuse pool we hand its pages back with MADV_FREE so
+// a pooled deep stack does not pin megabytes until its next use. The
+// first pages are kept: every reuse touches them immediately anyway.
+#define TASK_STACK_KEEP_BYTES (64 * 1024)
+
+static void task_stack_decommit(void *stk, size_t sz)
+{
+#if !defined(_OS_WINDOWS_)
+    size_t pagesz = jl_page_size;
+    uintptr_t lo = LLT_ALIGN((uintptr_t)stk + TASK_STACK_KEEP_BYTES, pagesz);
+    uintptr_t hi = ((uintptr_t)stk + sz) & ~(pagesz - 1);
+    if (hi > lo) {
+#ifdef MADV_FREE
+        madvise((void*)lo, hi - lo, MADV_FREE);
+#else
+        madvise((void*)lo, hi - lo, MADV_DONTNEED);
+#endif
+    }
+#else
+    (void)stk;
+    (void)sz;
+#endif
+}
+
+static void flush_pending_dead_stack(jl_tls_states_t *ptls)
+{
+    if (__likely(ptls->pending_dead_stack == NULL))
+        return;
+    if (ptls->stack_pool.len < 2 * TASK_STACK_POOL_MAX) {
+        task_stack_decommit(ptls->pending_dead_stack,
+                            ptls->pending_dead_stack_sz);
+        arraylist_push(&ptls->stack_pool, ptls->pending_dead_stack);
+        arraylist_push(&ptls->stack_pool,
+                       (void*)(uintptr_t)ptls->pending_dead_stack_sz);
+    }
+    ptls->pending_dead_stack = NULL;
+    ptls->pending_dead_stack_sz = 0;
+}
+#endif
+
 static void ctx_switch(jl_tls_states_t *ptls, jl_task_t *t, jl_jmp_buf *where)
 {
     if (t == ptls->current_task)
         return;
+    JL_PROBE_TASK_SWITCH(ptls->current_task, t);
     if (!jl_setjmp(ptls->current_task->ctx, 0)) {
         // backtraces don't survive task switches, see e.g. issue #12485
         ptls->bt_size = 0;
 #ifdef COPY_STACKS
         jl_task_t *lastt = ptls->current_task;
-        save_stack(ptls, lastt);
+        if (lastt->copy_stack)
+            save_stack(ptls, lastt);
 #endif
 
         // set up global state for new task
@@ -319,13 +462,27 @@ static void ctx_switch(jl_tls_states_t *ptls, jl_task_t *t, jl_jmp_buf *where)
         ptls->current_task = t;
 
 #ifdef COPY_STACKS
-        if (t->stkbuf) {
-            restore_stack(ptls, t, where, NULL);
+        if (t->started && !t->copy_stack) {
+            // the task runs on its own stack buffer: no copying needed
+            ptls->jmp_target = where;
+            jl_longjmp(*ptls->jmp_target, 1);
+        }
+        else if (t->stkbuf && t->copy_stack) {
+            // when this code runs on a private stack buffer it cannot
+            // overlap the restore target on the thread stack, so the
+            // frame moving dance in restore_stack is unnecessary (and
+            // its address arithmetic meaningless); any non-NULL token
+            // skips it
+            restore_stack(ptls, t, where,
+                          lastt->copy_stack ? NULL : (char*)1);
         }
         else {
 #ifdef ASM_COPY_STACKS
-            // Start the task without `setjmp`
+            // Start the task without `setjmp`, on its own stack when it
+            // has one
             void *stackbase = ptls->stackbase;
+            if (!t->copy_stack)
+                stackbase = (char*)t->stkbuf + t->ssize;
 #ifdef _CPU_X86_64_
 #ifdef _OS_WINDOWS_
             stackbase = (char*)stackbase - 0x20;
@@ -361,6 +518,11 @@ static void ctx_switch(jl_tls_states_t *ptls, jl_task_t *t, jl_jmp_buf *where)
         jl_longjmp(*where, 1);
 #endif
     }
+#if defined(COPY_STACKS) && defined(ASM_COPY_STACKS)
+    // we arrived here on the (re)entered task's stack; a stack left
+    // behind by a finished task is now safe to recycle
+    flush_pending_dead_stack(ptls);
+#endif
 }
 
 JL_DLLEXPORT jl_value_t *jl_switchto(jl_task_t *t, jl_value_t *arg)
@@ -564,7 +726,45 @@ JL_DLLEXPORT jl_task_t *jl_new_task(jl_function_t *start, size_t ssize)
 
 #ifdef COPY_STACKS
     t->bufsz = 0;
+    t->copy_stack = 1;
+#ifdef ASM_COPY_STACKS
+    // hybrid stacks: when earlier tasks running this function needed a big
+    // stack, give this one its own buffer up front. Like the non-copying
+    // build this has no guard page, so the headroom is generous.
+    size_t hw = task_hw_lookup(start);
+    if (hw > JL_TASK_COPY_STACK_MAX) {
+        JL_GC_PUSH1(&t);
+        size_t bufsz = LLT_ALIGN(4 * hw + 262144, pagesz);
+        char *stk = NULL;
+        // reuse a pooled dead stack when one is big enough (but not
+        // wastefully so)
+        jl_tls_states_t *ptls = jl_get_ptls_states();
+        for (size_t pi = 0; pi + 1 < ptls->stack_pool.len; pi += 2) {
+            size_t psz = (size_t)(uintptr_t)ptls->stack_pool.items[pi + 1];
+            if (psz >= bufsz && psz <= 4 * bufsz) {
+                stk = (char*)ptls->stack_pool.items[pi];
+                bufsz = psz;
+                // swap-remove the pair
+                size_t last = ptls->stack_pool.len - 2;
+                ptls->stack_pool.items[pi] = ptls->stack_pool.items[last];
+                ptls->stack_pool.items[pi + 1] =
+                    ptls->stack_pool.items[last + 1];
+                ptls->stack_pool.len -= 2;
+                break;
+            }
+        }
+        if (stk == NULL)
+            stk = (char*)allocb(bufsz);
+        t->copy_stack = 0;
+        t->ssize = bufsz;
+        t->bufsz = bufsz;
+        t->stkbuf = stk;
+        jl_gc_wb_buf(t, t->stkbuf, bufsz);
+        JL_GC_POP();
+    }
+#endif
 #else
+    t->copy_stack = 0;
     JL_GC_PUSH1(&t);
 
     size_t stkbuf_sz = ssize + pagesz + (pagesz - 1);
@@ -655,9 +855,11 @@ void jl_init_root_task(void *stack, size_t ssize)
     jl_current_task->ssize = 0;  // size of saved piece
     jl_current_task->bufsz = 0;
     jl_current_task->stkbuf = NULL;
+    jl_current_task->copy_stack = 1;
 #else
     jl_current_task->ssize = ssize;
     jl_current_task->stkbuf = stack;
+    jl_current_task->copy_stack = 0;
 #endif
     jl_current_task->started = 1;
     jl_current_task->parent = jl_current_task;
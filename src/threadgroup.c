@@ -42,6 +42,12 @@ int ti_threadgroup_create(uint8_t num_sockets, uint8_t num_cores,
     for (i = 0;  i < num_threads;  i++)
         tg->thread_sense[i] = NULL;
     tg->group_sense = 0;
+    tg->join_nodes = NULL;
+    tg->join_parent = NULL;
+    tg->join_expected = NULL;
+    tg->join_leaf = NULL;
+    tg->n_join_nodes = -1; // tree not built yet
+    tg->join_root = -1;
 
     uv_mutex_init(&tg->alarm_lock);
     uv_cond_init(&tg->alarm);
@@ -90,6 +96,9 @@ int ti_threadgroup_initthread(ti_threadgroup_t *tg, int16_t ext_tid)
 
     ts = (ti_thread_sense_t*)jl_malloc_aligned(sizeof(ti_thread_sense_t), 64);
     ts->sense = 1;
+    ts->spin_ns_limit = tg->sleep_threshold;
+    ts->sleeps = 0;
+    ts->wake_ns = 0;
     tg->thread_sense[tg->tid_map[ext_tid]] = ts;
 
     return 0;
@@ -121,10 +130,59 @@ int ti_threadgroup_size(ti_threadgroup_t *tg, int16_t *tgsize)
 }
 
 
+// build the radix-4 join tree over the group's workers. Called by the
+// master before the first broadcast, while every worker still spins in
+// its first fork, so no synchronization is needed.
+static void ti_build_join_tree(ti_threadgroup_t *tg)
+{
+    int nw = tg->num_threads - 1;
+    int total = 0, c = nw, i;
+    if (nw > 0) {
+        do {
+            c = (c + TI_JOIN_RADIX - 1) / TI_JOIN_RADIX;
+            total += c;
+        } while (c > 1);
+    }
+    tg->n_join_nodes = (int16_t)total;
+    tg->join_root = (int16_t)(total - 1);
+    if (total == 0)
+        return;
+    tg->join_nodes = (ti_join_node_t*)jl_malloc_aligned(
+        total * sizeof(ti_join_node_t), 64);
+    tg->join_parent = (int16_t*)malloc(total * sizeof(int16_t));
+    tg->join_expected = (uint8_t*)malloc(total * sizeof(uint8_t));
+    tg->join_leaf = (int16_t*)malloc(nw * sizeof(int16_t));
+    for (i = 0; i < total; i++) {
+        tg->join_nodes[i].count = 0;
+        tg->join_parent[i] = -1;
+        tg->join_expected[i] = 0;
+    }
+    // level 0: workers feed leaves
+    int base = 0, nlevel = (nw + TI_JOIN_RADIX - 1) / TI_JOIN_RADIX;
+    for (i = 0; i < nw; i++) {
+        tg->join_leaf[i] = (int16_t)(base + i / TI_JOIN_RADIX);
+        tg->join_expected[base + i / TI_JOIN_RADIX]++;
+    }
+    // upper levels: nodes feed their parents
+    while (nlevel > 1) {
+        int nup = (nlevel + TI_JOIN_RADIX - 1) / TI_JOIN_RADIX;
+        for (i = 0; i < nlevel; i++) {
+            tg->join_parent[base + i] =
+                (int16_t)(base + nlevel + i / TI_JOIN_RADIX);
+            tg->join_expected[base + nlevel + i / TI_JOIN_RADIX]++;
+        }
+        base += nlevel;
+        nlevel = nup;
+    }
+}
+
 int ti_threadgroup_fork(ti_threadgroup_t *tg, int16_t ext_tid, void **bcast_val)
 {
     if (tg->tid_map[ext_tid] == 0) {
+        if (tg->n_join_nodes < 0)
+            ti_build_join_tree(tg);
         tg->envelope = bcast_val ? *bcast_val : NULL;
+        tg->fork_time = uv_hrtime();
         // synchronize `tg->envelope` and `tg->group_sense`
         jl_atomic_store_release(&tg->group_sense, tg->thread_sense[0]->sense);
 
@@ -136,12 +194,16 @@ int ti_threadgroup_fork(ti_threadgroup_t *tg, int16_t ext_tid, void **bcast_val)
         }
     }
     else {
-        // spin up to threshold ns (count sheep), then sleep
+        // adaptive wait: spin up to the thread's current spin window, then
+        // park on the alarm. Parking shrinks the window (spinning longer
+        // would only have burned the core), work arriving during the spin
+        // grows it back, up to sleep_threshold.
+        ti_thread_sense_t *ts = tg->thread_sense[tg->tid_map[ext_tid]];
         uint64_t spin_ns;
         uint64_t spin_start = 0;
+        int parked = 0;
         // synchronize `tg->envelope` and `tg->group_sense`
-        while (jl_atomic_load_acquire(&tg->group_sense) !=
-               tg->thread_sense[tg->tid_map[ext_tid]]->sense) {
+        while (jl_atomic_load_acquire(&tg->group_sense) != ts->sense) {
             if (tg->sleep_threshold) {
                 if (!spin_start) {
                     // Lazily initialize spin_start since uv_hrtime is expensive
@@ -150,19 +212,31 @@ int ti_threadgroup_fork(ti_threadgroup_t *tg, int16_t ext_tid, void **bcast_val)
                 }
                 spin_ns = uv_hrtime() - spin_start;
                 // In case uv_hrtime is not monotonic, we'll sleep earlier
-                if (spin_ns >= tg->sleep_threshold) {
+                if (spin_ns >= ts->spin_ns_limit) {
                     uv_mutex_lock(&tg->alarm_lock);
-                    if (tg->group_sense !=
-                        tg->thread_sense[tg->tid_map[ext_tid]]->sense) {
+                    if (tg->group_sense != ts->sense) {
                         uv_cond_wait(&tg->alarm, &tg->alarm_lock);
                     }
                     uv_mutex_unlock(&tg->alarm_lock);
+                    parked = 1;
+                    ts->spin_ns_limit =
+                        ts->spin_ns_limit / 2 > THREAD_MIN_SPIN_NS ?
+                        ts->spin_ns_limit / 2 : THREAD_MIN_SPIN_NS;
                     spin_start = 0;
                     continue;
                 }
             }
             jl_cpu_pause();
         }
+        if (parked) {
+            ts->sleeps++;
+            ts->wake_ns += uv_hrtime() - tg->fork_time;
+        }
+        else if (spin_start && ts->spin_ns_limit < tg->sleep_threshold) {
+            uint64_t grown = ts->spin_ns_limit * 2;
+            ts->spin_ns_limit =
+                grown < tg->sleep_threshold ? grown : tg->sleep_threshold;
+        }
         if (bcast_val)
             *bcast_val = tg->envelope;
     }
@@ -173,20 +247,59 @@ int ti_threadgroup_fork(ti_threadgroup_t *tg, int16_t ext_tid, void **bcast_val)
 
 int ti_threadgroup_join(ti_threadgroup_t *tg, int16_t ext_tid)
 {
-    int i;
-
-    tg->thread_sense[tg->tid_map[ext_tid]]->sense
-        = !tg->thread_sense[tg->tid_map[ext_tid]]->sense;
-    if (tg->tid_map[ext_tid] == 0) {
-        for (i = 1;  i < tg->num_threads;  ++i) {
-            while (tg->thread_sense[i]->sense == tg->group_sense)
-                jl_cpu_pause();
+    int16_t tid = tg->tid_map[ext_tid];
+
+    // the per-thread sense still gates the next fork broadcast
+    tg->thread_sense[tid]->sense = !tg->thread_sense[tid]->sense;
+    if (tid == 0) {
+        if (tg->n_join_nodes <= 0)
+            return 0;
+        ti_join_node_t *root = &tg->join_nodes[tg->join_root];
+        uint32_t expect = tg->join_expected[tg->join_root];
+        // one line to watch, however wide the group is
+        while (jl_atomic_load_acquire(&root->count) != expect)
+            jl_cpu_pause();
+        // reset for the next phase: workers cannot touch the tree again
+        // until the master broadcasts the next fork
+        int i;
+        for (i = 0; i < tg->n_join_nodes; i++)
+            tg->join_nodes[i].count = 0;
+    }
+    else {
+        // bump the leaf; the arrival completing a node carries the
+        // signal one level up, so each join does O(log4 n) increments
+        // in the worst case and one in the common case
+        int node = tg->join_leaf[tid - 1];
+        while (node >= 0) {
+            uint32_t c = jl_atomic_fetch_add(&tg->join_nodes[node].count, 1);
+            if (c + 1 < tg->join_expected[node])
+                break;
+            node = tg->join_parent[node];
         }
     }
 
     return 0;
 }
 
+// sum the park counts and cumulative wake latency over the group's
+// threads (the caller exposes these; see jl_threadgroup_wake_stats)
+int ti_threadgroup_wake_stats(ti_threadgroup_t *tg, uint64_t *nsleeps,
+                              uint64_t *wake_ns)
+{
+    int i;
+    uint64_t n = 0, ns = 0;
+    for (i = 0; i < tg->num_threads; i++) {
+        ti_thread_sense_t *ts = tg->thread_sense[i];
+        if (ts) {
+            n += ts->sleeps;
+            ns += ts->wake_ns;
+        }
+    }
+    *nsleeps = n;
+    *wake_ns = ns;
+    return 0;
+}
+
 int ti_threadgroup_destroy(ti_threadgroup_t *tg)
 {
     int i;
@@ -198,6 +311,12 @@ int ti_threadgroup_destroy(ti_threadgroup_t *tg)
         jl_free_aligned(tg->thread_sense[i]);
     jl_free_aligned(tg->thread_sense);
     jl_free_aligned(tg->tid_map);
+    if (tg->join_nodes != NULL) {
+        jl_free_aligned(tg->join_nodes);
+        free(tg->join_parent);
+        free(tg->join_expected);
+        free(tg->join_leaf);
+    }
     jl_free_aligned(tg);
 
     return 0;
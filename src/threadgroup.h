@@ -9,9 +9,29 @@
 // for the barrier
 typedef struct {
     volatile int sense;
+
+    // adaptive wait policy: how long this thread spins in
+    // ti_threadgroup_fork before parking on the alarm condition. Shrinks
+    // every time the thread had to park, grows (up to sleep_threshold)
+    // when work arrived during the spin.
+    uint64_t spin_ns_limit;
+    // number of times the thread parked, and the cumulative latency from
+    // the fork broadcast to the thread picking the work up after waking;
+    // for tuning the spin window (see jl_threadgroup_wake_stats)
+    uint64_t sleeps;
+    uint64_t wake_ns;
 } ti_thread_sense_t;
 
 
+// combining-tree node for the join gather: one cacheline each so
+// arrival traffic from different subtrees never shares a line
+typedef struct {
+    volatile uint32_t count;
+    char _pad[64 - sizeof(uint32_t)];
+} ti_join_node_t;
+
+#define TI_JOIN_RADIX 4
+
 // thread group
 typedef struct {
     int16_t             *tid_map, num_threads, added_threads;
@@ -22,10 +42,23 @@ typedef struct {
     ti_thread_sense_t  **thread_sense;
     void                *envelope;
 
+    // radix-4 combining tree for the join gather (built lazily at the
+    // first fork): workers bump their leaf's counter and the completer
+    // of each node propagates one level up, so the master spins on a
+    // single root line instead of polling every worker's flag
+    ti_join_node_t     *join_nodes;
+    int16_t            *join_parent;   // node -> parent node (-1 at root)
+    uint8_t            *join_expected; // node -> number of children
+    int16_t            *join_leaf;     // worker index -> leaf node
+    int16_t             n_join_nodes;
+    int16_t             join_root;
+
     // to let threads sleep
     uv_mutex_t  alarm_lock;
     uv_cond_t   alarm;
     uint64_t    sleep_threshold;
+    // timestamp of the last fork broadcast, for wake latency accounting
+    uint64_t    fork_time;
 } ti_threadgroup_t;
 
 
@@ -41,6 +74,8 @@ int  ti_threadgroup_size(ti_threadgroup_t *tg, int16_t *tgsize);
 int  ti_threadgroup_fork(ti_threadgroup_t *tg, int16_t ext_tid,
                          void **bcast_val);
 int  ti_threadgroup_join(ti_threadgroup_t *tg, int16_t ext_tid);
+int  ti_threadgroup_wake_stats(ti_threadgroup_t *tg, uint64_t *nsleeps,
+                               uint64_t *wake_ns);
 int  ti_threadgroup_destroy(ti_threadgroup_t *tg);
 
 #endif  /* THREADGROUP_H */
@@ -22,6 +22,7 @@ TODO:
 
 #include "julia.h"
 #include "julia_internal.h"
+#include "uprobes.h"
 
 #ifdef _OS_LINUX_
 #  if defined(_CPU_X86_64_) || defined(_CPU_X86_)
@@ -320,6 +321,71 @@ static jl_value_t *ti_run_fun(jl_svec_t *args)
 jl_mutex_t codegen_lock;
 jl_mutex_t typecache_lock;
 
+// dynamic chunk scheduler for parallel regions
+//
+// The threadgroup fork runs the same function on every thread, so load
+// balancing is up to that function. For irregular workloads, carving the
+// iteration space into many more chunks than threads and having every
+// thread pull the next chunk from this shared counter gets the core
+// benefit of a work-stealing scheduler -- threads that finish early keep
+// pulling work -- without per-thread deques: the work items are just
+// chunk indices of a single range. The counter is reset at each fork;
+// parallel regions cannot nest (there is one thread group), so one
+// counter suffices.
+static volatile uint64_t next_chunk_id;
+
+// returns the next chunk index in [0, nchunks), or -1 once the current
+// region's chunks are exhausted
+JL_DLLEXPORT int64_t jl_threading_next_chunk(int64_t nchunks)
+{
+    uint64_t c = jl_atomic_fetch_add(&next_chunk_id, 1);
+    if (c >= (uint64_t)nchunks)
+        return -1;
+    return (int64_t)c;
+}
+
+// iteration cursor for the range-claiming policies below; reset at the
+// same points as next_chunk_id
+static volatile uint64_t next_iter_lo;
+
+// Claim the next run of iterations of a [0, n) space from the shared
+// cursor. policy 1 (dynamic) hands out fixed runs of `grain`
+// iterations; policy 2 (guided) starts at remaining/(2*nthreads) and
+// decays toward `grain`, paying less scheduling overhead up front while
+// keeping small chunks for tail balance. Returns the first iteration of
+// the claimed run and stores its length through `plen`, or -1 when the
+// space is exhausted.
+JL_DLLEXPORT int64_t jl_threading_claim_range(int64_t n, int64_t grain,
+                                              int policy, int64_t *plen)
+{
+    if (grain < 1)
+        grain = 1;
+    if (policy == 2) {
+        while (1) {
+            uint64_t lo = next_iter_lo;
+            if ((int64_t)lo >= n)
+                return -1;
+            int64_t remaining = n - (int64_t)lo;
+            int64_t chunk = remaining / (2 * jl_n_threads);
+            if (chunk < grain)
+                chunk = grain;
+            if (chunk > remaining)
+                chunk = remaining;
+            if (jl_atomic_compare_exchange(&next_iter_lo, lo,
+                                           lo + (uint64_t)chunk) == lo) {
+                *plen = chunk;
+                return (int64_t)lo;
+            }
+        }
+    }
+    uint64_t lo = jl_atomic_fetch_add(&next_iter_lo, (uint64_t)grain);
+    if ((int64_t)lo >= n)
+        return -1;
+    int64_t len = n - (int64_t)lo;
+    *plen = len < grain ? len : grain;
+    return (int64_t)lo;
+}
+
 #ifdef JULIA_ENABLE_THREADING
 
 // only one thread group for now
@@ -335,6 +401,66 @@ uint64_t *user_ns;
 uint64_t *join_ns;
 #endif
 
+// per-thread trace of parallel regions
+//
+// Every thread records, for each region it takes part in, the uv_hrtime
+// timestamps of when it picked the work up and when it finished it. The
+// trace is a fixed size per-thread ring (old regions get overwritten) and
+// can be flushed to a binary file with jl_dump_region_trace for offline
+// conversion (e.g. to the chrome tracing format); unlike the aggregate
+// PROFILE_JL_THREADING counters this shows the imbalance of each region.
+// The flush is meant to be called between parallel regions: records being
+// written concurrently with it can come out torn.
+typedef struct {
+    uint64_t t0; // work picked up
+    uint64_t t1; // work finished
+} jl_region_rec_t;
+#define JL_REGION_TRACE_LEN 1024 // regions remembered per thread
+static jl_region_rec_t *region_trace; // [jl_n_threads * JL_REGION_TRACE_LEN]
+static uint32_t *region_trace_n; // # regions ever recorded, per thread
+
+static void ti_trace_region(int16_t tid, uint64_t t0, uint64_t t1)
+{
+    if (!region_trace)
+        return;
+    jl_region_rec_t *rec = &region_trace[tid * JL_REGION_TRACE_LEN +
+                                         region_trace_n[tid] % JL_REGION_TRACE_LEN];
+    rec->t0 = t0;
+    rec->t1 = t1;
+    region_trace_n[tid]++;
+}
+
+// Flush the region trace to `fname` and reset it. Binary layout: a header
+// of 4 uint64 fields (magic 'jltr', number of threads, ring length, record
+// size in bytes), then per thread one uint64 record count followed by the
+// min(count, ring length) most recent records, oldest first, as pairs of
+// uint64 nanosecond timestamps.
+JL_DLLEXPORT int jl_dump_region_trace(const char *fname)
+{
+    if (!region_trace)
+        return -1;
+    ios_t f;
+    if (ios_file(&f, fname, 0, 1, 1, 1) == NULL)
+        return -1;
+    uint64_t hdr[4] = {0x72746c6a, (uint64_t)jl_n_threads,
+                       JL_REGION_TRACE_LEN, sizeof(jl_region_rec_t)};
+    ios_write(&f, (char*)hdr, sizeof(hdr));
+    for (int t = 0; t < jl_n_threads; t++) {
+        uint64_t n = region_trace_n[t];
+        ios_write(&f, (char*)&n, sizeof(n));
+        uint64_t avail = n > JL_REGION_TRACE_LEN ? JL_REGION_TRACE_LEN : n;
+        uint64_t first = n - avail;
+        for (uint64_t i = 0; i < avail; i++) {
+            jl_region_rec_t *rec = &region_trace[t * JL_REGION_TRACE_LEN +
+                                                 (first + i) % JL_REGION_TRACE_LEN];
+            ios_write(&f, (char*)rec, sizeof(*rec));
+        }
+        region_trace_n[t] = 0;
+    }
+    ios_close(&f);
+    return 0;
+}
+
 static uv_barrier_t thread_init_done;
 
 // thread function: used by all except the main thread
@@ -395,6 +521,7 @@ void ti_threadfun(void *arg)
                 //       the work, and after we have proper GC transition
                 //       support in the codegen and runtime we don't need to
                 //       enter GC unsafe region when starting the work.
+                uint64_t trace_t0 = uv_hrtime();
                 int8_t gc_state = jl_gc_unsafe_enter(ptls);
                 // This is probably always NULL for now
                 jl_module_t *last_m = jl_current_module;
@@ -404,6 +531,7 @@ void ti_threadfun(void *arg)
                 jl_current_module = last_m;
                 JL_GC_POP();
                 jl_gc_unsafe_leave(ptls, gc_state);
+                ti_trace_region(ti_tid, trace_t0, uv_hrtime());
             }
         }
 
@@ -555,12 +683,118 @@ void jl_init_threading(void)
     ti_init_master_thread();
 }
 
+// topology aware placement (linux)
+//
+// The default exclusive pinning maps thread i to logical cpu i, which on
+// multi-socket boxes can split collaborating threads across packages and
+// pair them onto hyperthread siblings. When JULIA_THREAD_PLACEMENT names
+// a policy, the package/core hierarchy is read from sysfs and the pin
+// order is rearranged:
+//   compact    - fill one package at a time, SMT siblings adjacent
+//   scatter    - round-robin across packages
+//   onepercore - one thread per physical core, skipping SMT siblings
+#if defined(_OS_LINUX_)
+typedef struct {
+    int cpu;
+    int package;
+    int core;
+    int smt; // position among the core's siblings, 0 = primary
+} jl_cpu_topo_t;
+
+static int topo_read_int(int cpu, const char *leaf)
+{
+    char path[128];
+    char buf[32];
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, leaf);
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return -1;
+    int v = -1;
+    if (fgets(buf, sizeof(buf), f))
+        v = atoi(buf);
+    fclose(f);
+    return v;
+}
+
+static int topo_cmp_compact(const void *pa, const void *pb)
+{
+    const jl_cpu_topo_t *a = (const jl_cpu_topo_t*)pa;
+    const jl_cpu_topo_t *b = (const jl_cpu_topo_t*)pb;
+    if (a->package != b->package) return a->package - b->package;
+    if (a->core != b->core) return a->core - b->core;
+    return a->cpu - b->cpu;
+}
+
+static int topo_cmp_scatter(const void *pa, const void *pb)
+{
+    const jl_cpu_topo_t *a = (const jl_cpu_topo_t*)pa;
+    const jl_cpu_topo_t *b = (const jl_cpu_topo_t*)pb;
+    // primaries of all cores first (round-robin over packages), then
+    // siblings
+    if (a->smt != b->smt) return a->smt - b->smt;
+    if (a->core != b->core) return a->core - b->core;
+    if (a->package != b->package) return a->package - b->package;
+    return a->cpu - b->cpu;
+}
+
+// fill `order` with the cpu ids to pin to, in policy order; returns the
+// number of usable entries (can be < ncpus for onepercore)
+static int jl_build_cpu_order(int *order, int ncpus, const char *policy)
+{
+    jl_cpu_topo_t *topo =
+        (jl_cpu_topo_t*)malloc(ncpus * sizeof(jl_cpu_topo_t));
+    if (topo == NULL)
+        return 0;
+    int i;
+    for (i = 0; i < ncpus; i++) {
+        topo[i].cpu = i;
+        topo[i].package = topo_read_int(i, "physical_package_id");
+        topo[i].core = topo_read_int(i, "core_id");
+        topo[i].smt = 0;
+        if (topo[i].package < 0 || topo[i].core < 0) {
+            free(topo); // no topology information; keep the identity order
+            return 0;
+        }
+    }
+    // compute each cpu's position among its core's siblings
+    for (i = 0; i < ncpus; i++) {
+        int smt = 0;
+        for (int j = 0; j < i; j++)
+            if (topo[j].package == topo[i].package &&
+                topo[j].core == topo[i].core)
+                smt++;
+        topo[i].smt = smt;
+    }
+    int n = ncpus;
+    if (strcmp(policy, "scatter") == 0) {
+        qsort(topo, ncpus, sizeof(jl_cpu_topo_t), topo_cmp_scatter);
+    }
+    else if (strcmp(policy, "onepercore") == 0) {
+        qsort(topo, ncpus, sizeof(jl_cpu_topo_t), topo_cmp_compact);
+        n = 0;
+        for (i = 0; i < ncpus; i++)
+            if (topo[i].smt == 0)
+                topo[n++] = topo[i];
+    }
+    else { // compact (also the fallback for unknown policy names)
+        qsort(topo, ncpus, sizeof(jl_cpu_topo_t), topo_cmp_compact);
+    }
+    for (i = 0; i < n; i++)
+        order[i] = topo[i].cpu;
+    free(topo);
+    return n;
+}
+#endif
+
 void jl_start_threads(void)
 {
     char *cp, mask[UV_CPU_SETSIZE];
     int i, exclusive;
     uv_thread_t uvtid;
     ti_threadarg_t **targs;
+    int cpu_order[UV_CPU_SETSIZE];
+    int n_order = 0;
 
     // do we have exclusive use of the machine? default is no
     exclusive = DEFAULT_MACHINE_EXCLUSIVE;
@@ -568,12 +802,30 @@ void jl_start_threads(void)
     if (cp)
         exclusive = strtol(cp, NULL, 10);
 
+    // identity placement by default
+    for (i = 0; i < UV_CPU_SETSIZE; i++)
+        cpu_order[i] = i;
+    n_order = UV_CPU_SETSIZE;
+#if defined(_OS_LINUX_)
+    cp = getenv(THREAD_PLACEMENT_NAME);
+    if (cp != NULL) {
+        int ncpus = jl_cpu_cores();
+        if (ncpus > UV_CPU_SETSIZE)
+            ncpus = UV_CPU_SETSIZE;
+        int n = jl_build_cpu_order(cpu_order, ncpus, cp);
+        if (n > 0) {
+            n_order = n;
+            exclusive = 1; // a placement policy implies affinitization
+        }
+    }
+#endif
+
     // exclusive use: affinitize threads, master thread on proc 0, rest
     // according to a 'compact' policy
     // non-exclusive: no affinity settings; let the kernel move threads about
     if (exclusive) {
         memset(mask, 0, UV_CPU_SETSIZE);
-        mask[0] = 1;
+        mask[cpu_order[0]] = 1;
         uvtid = (uv_thread_t)uv_thread_self();
         uv_thread_setaffinity(&uvtid, mask, NULL, UV_CPU_SETSIZE);
     }
@@ -581,6 +833,10 @@ void jl_start_threads(void)
     // create threads
     targs = (ti_threadarg_t **)malloc((jl_n_threads - 1) * sizeof (ti_threadarg_t *));
 
+    region_trace = (jl_region_rec_t*)calloc(
+        jl_n_threads * JL_REGION_TRACE_LEN, sizeof(jl_region_rec_t));
+    region_trace_n = (uint32_t*)calloc(jl_n_threads, sizeof(uint32_t));
+
     uv_barrier_init(&thread_init_done, jl_n_threads);
 
     for (i = 0;  i < jl_n_threads - 1;  ++i) {
@@ -590,7 +846,7 @@ void jl_start_threads(void)
         uv_thread_create(&uvtid, ti_threadfun, targs[i]);
         if (exclusive) {
             memset(mask, 0, UV_CPU_SETSIZE);
-            mask[i+1] = 1;
+            mask[cpu_order[(i + 1) % n_order]] = 1;
             uv_thread_setaffinity(&uvtid, mask, NULL, UV_CPU_SETSIZE);
         }
         uv_thread_detach(&uvtid);
@@ -639,6 +895,18 @@ void jl_shutdown_threading(void)
 // return thread's thread group
 JL_DLLEXPORT void *jl_threadgroup(void) { return (void *)tgworld; }
 
+// how often the worker threads had to park waiting for a fork, and their
+// cumulative broadcast-to-work wake latency; for tuning
+// JULIA_THREAD_SLEEP_THRESHOLD
+JL_DLLEXPORT void jl_threadgroup_wake_stats(uint64_t *nsleeps,
+                                            uint64_t *wake_ns)
+{
+    *nsleeps = 0;
+    *wake_ns = 0;
+    if (tgworld)
+        ti_threadgroup_wake_stats(tgworld, nsleeps, wake_ns);
+}
+
 // interface to user code: specialize and compile the user thread function
 // and run it in all threads
 JL_DLLEXPORT jl_value_t *jl_threading_run(jl_svec_t *args)
@@ -657,6 +925,8 @@ JL_DLLEXPORT jl_value_t *jl_threading_run(jl_svec_t *args)
     argtypes = arg_type_tuple(jl_svec_data(args), jl_svec_len(args));
     jl_compile_hint(argtypes);
 
+    next_chunk_id = 0;
+    next_iter_lo = 0;
     threadwork.command = TI_THREADWORK_RUN;
     // TODO jb/functions: lookup and store jlcall fptr here
     threadwork.fun = NULL;
@@ -670,6 +940,7 @@ JL_DLLEXPORT jl_value_t *jl_threading_run(jl_svec_t *args)
 #endif
 
     // fork the world thread group
+    JL_PROBE_REGION_FORK();
     ti_threadwork_t *tw = &threadwork;
     ti_threadgroup_fork(tgworld, ti_tid, (void **)&tw);
 
@@ -679,7 +950,9 @@ JL_DLLEXPORT jl_value_t *jl_threading_run(jl_svec_t *args)
 #endif
 
     // this thread must do work too (TODO: reduction?)
+    uint64_t trace_t0 = uv_hrtime();
     tw->ret = ti_run_fun(args);
+    ti_trace_region(ti_tid, trace_t0, uv_hrtime());
 
 #if PROFILE_JL_THREADING
     uint64_t trun = uv_hrtime();
@@ -689,6 +962,7 @@ JL_DLLEXPORT jl_value_t *jl_threading_run(jl_svec_t *args)
     jl_gc_state_set(ptls, JL_GC_STATE_SAFE, 0);
     // wait for completion (TODO: nowait?)
     ti_threadgroup_join(tgworld, ti_tid);
+    JL_PROBE_REGION_JOIN();
     jl_gc_state_set(ptls, 0, JL_GC_STATE_SAFE);
 
 #if PROFILE_JL_THREADING
@@ -761,6 +1035,8 @@ JL_DLLEXPORT void jl_threading_profile(void)
 JL_DLLEXPORT jl_value_t *jl_threading_run(jl_svec_t *args)
 {
     JL_TYPECHK(jl_threading_run, simplevector, (jl_value_t*)args);
+    next_chunk_id = 0;
+    next_iter_lo = 0;
     return ti_run_fun(args);
 }
 
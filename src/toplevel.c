@@ -160,6 +160,8 @@ jl_value_t *jl_eval_module_expr(jl_expr_t *ex)
     }
 
     jl_array_t *exprs = ((jl_expr_t*)jl_exprarg(ex, 2))->args;
+    // method definitions in this module body use bulk registration
+    jl_method_batch_begin();
     JL_TRY {
         for(int i=0; i < jl_array_len(exprs); i++) {
             // process toplevel form
@@ -168,12 +170,14 @@ jl_value_t *jl_eval_module_expr(jl_expr_t *ex)
         }
     }
     JL_CATCH {
+        jl_method_batch_end();
         jl_current_module = last_module;
         jl_current_task->current_module = task_last_m;
         outermost = prev_outermost;
         module_stack.len = stackidx;
         jl_rethrow();
     }
+    jl_method_batch_end();
     JL_GC_POP();
     jl_current_module = last_module;
     jl_current_task->current_module = task_last_m;
@@ -415,6 +419,112 @@ int jl_is_toplevel_only_expr(jl_value_t *e)
          ((jl_expr_t*)e)->head == toplevel_sym);
 }
 
+// ---- trivial-shape fast path -----------------------------------------
+//
+// REPL-driven tooling and config files are dominated by expressions
+// like `a = 1`, `x = f(y, z)`, and `obj.field` whose full trip through
+// flisp lowering (and often codegen) costs orders of magnitude more
+// than the evaluation itself. Shapes built only from literals, symbols,
+// quotes, and field access are recognized here and evaluated directly
+// against the module bindings; everything else -- macro calls, splats,
+// keywords, any head not matched below -- takes the ordinary expansion
+// path. The semantics mirror what the interpreter does for the lowered
+// forms: global reads throw UndefVarError, assignment goes through
+// jl_checked_assignment, and field access is the getfield builtin.
+
+static int jl_is_simple_operand(jl_value_t *v)
+{
+    if (jl_is_expr(v)) {
+        jl_expr_t *e = (jl_expr_t*)v;
+        return e->head == dot_sym && jl_expr_nargs(e) == 2 &&
+               jl_is_simple_operand(jl_exprarg(e, 0)) &&
+               jl_is_quotenode(jl_exprarg(e, 1)) &&
+               jl_is_symbol(jl_quotenode_value(jl_exprarg(e, 1)));
+    }
+    // symbols, globalrefs, quote nodes, and plain literal values
+    return !jl_is_linenode(v);
+}
+
+static jl_value_t *jl_eval_simple_operand(jl_value_t *v)
+{
+    if (jl_is_symbol(v))
+        return jl_eval_global_var(jl_current_module, (jl_sym_t*)v);
+    if (jl_is_quotenode(v))
+        return jl_quotenode_value(v);
+    if (jl_is_globalref(v))
+        return jl_eval_global_var(jl_globalref_mod(v), jl_globalref_name(v));
+    if (jl_is_expr(v)) { // a.b
+        static jl_value_t *getfield_func = NULL;
+        jl_sym_t *fld = (jl_sym_t*)jl_quotenode_value(jl_exprarg(v, 1));
+        jl_value_t *argv[3];
+        jl_value_t *res;
+        argv[0] = NULL;
+        argv[1] = NULL;
+        argv[2] = (jl_value_t*)fld;
+        JL_GC_PUSH2(&argv[0], &argv[1]);
+        argv[1] = jl_eval_simple_operand(jl_exprarg(v, 0));
+        if (jl_is_module(argv[1])) {
+            res = jl_eval_global_var((jl_module_t*)argv[1], fld);
+        }
+        else {
+            if (getfield_func == NULL) // rooted by its Core binding
+                getfield_func = jl_get_global(jl_core_module,
+                                              jl_symbol("getfield"));
+            argv[0] = getfield_func;
+            res = jl_apply(argv, 3);
+        }
+        JL_GC_POP();
+        return res;
+    }
+    return v; // literal
+}
+
+// evaluate `ex` directly if it has one of the recognized trivial
+// shapes; returns NULL when it doesn't (caller falls back to expansion)
+static jl_value_t *jl_eval_simple_expr(jl_expr_t *ex)
+{
+    size_t i, na = jl_expr_nargs(ex);
+    if (ex->head == assign_sym && na == 2 &&
+        jl_is_symbol(jl_exprarg(ex, 0))) {
+        jl_value_t *rhsex = jl_exprarg(ex, 1);
+        jl_value_t *rhs;
+        // rhs may itself be a simple call (`x = f(y, z)`) or operand
+        if (jl_is_expr(rhsex) && ((jl_expr_t*)rhsex)->head == call_sym) {
+            rhs = jl_eval_simple_expr((jl_expr_t*)rhsex);
+            if (rhs == NULL)
+                return NULL;
+        }
+        else if (jl_is_simple_operand(rhsex)) {
+            rhs = jl_eval_simple_operand(rhsex);
+        }
+        else {
+            return NULL;
+        }
+        JL_GC_PUSH1(&rhs);
+        jl_binding_t *b = jl_get_binding_wr(jl_current_module,
+                                            (jl_sym_t*)jl_exprarg(ex, 0));
+        jl_checked_assignment(b, rhs);
+        JL_GC_POP();
+        return rhs;
+    }
+    if (ex->head == call_sym && na >= 1) {
+        for (i = 0; i < na; i++) {
+            if (!jl_is_simple_operand(jl_exprarg(ex, i)))
+                return NULL;
+        }
+        jl_value_t **argv;
+        JL_GC_PUSHARGS(argv, na);
+        for (i = 0; i < na; i++)
+            argv[i] = jl_eval_simple_operand(jl_exprarg(ex, i));
+        jl_value_t *res = jl_apply(argv, (uint32_t)na);
+        JL_GC_POP();
+        return res;
+    }
+    if (ex->head == dot_sym && jl_is_simple_operand((jl_value_t*)ex))
+        return jl_eval_simple_operand((jl_value_t*)ex);
+    return NULL;
+}
+
 jl_value_t *jl_toplevel_eval_flex(jl_value_t *e, int fast, int expanded)
 {
     //jl_show(ex);
@@ -485,6 +595,13 @@ jl_value_t *jl_toplevel_eval_flex(jl_value_t *e, int fast, int expanded)
         return jl_nothing;
     }
 
+    if (!expanded && (ex->head == assign_sym || ex->head == call_sym ||
+                      ex->head == dot_sym)) {
+        jl_value_t *res = jl_eval_simple_expr(ex);
+        if (res != NULL)
+            return res;
+    }
+
     jl_value_t *thunk=NULL;
     jl_value_t *result;
     jl_lambda_info_t *thk=NULL;
@@ -12,6 +12,22 @@
 #define MAX_METHLIST_COUNT 12 // this can strongly affect the sysimg size and speed!
 #define INIT_CACHE_SIZE 8 // must be a power-of-two
 
+/*
+ * Note about concurrent access:
+ *
+ * Lookups (`jl_typemap_assoc_exact` and friends) can run concurrently with
+ * a single inserter without taking any lock. The structures are mutated in
+ * an RCU fashion: a node (entry list head, level node, or rehashed cache
+ * array) is fully constructed before it is published with a single release
+ * store, and the structure it replaces is left intact for readers that are
+ * still traversing it. In particular, converting an overlong entry list
+ * into a `jl_typemap_level_t` works on copies of the entries. Readers pair
+ * these with acquire loads on the cache array slots; the remaining
+ * traversal loads are data dependent and need no explicit ordering on the
+ * supported targets. Mutation itself is single-writer and remains
+ * serialized by the callers (method table / codegen locking conventions).
+ */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -179,7 +195,9 @@ union jl_typemap_t mtcache_hash_lookup(jl_array_t *a, jl_value_t *ty, int8_t tpa
     ml.unknown = jl_nothing;
     if (!uid)
         return ml;
-    ml.unknown = jl_array_ptr_ref(a, uid & (a->nrows-1));
+    // pairs with the release publication of the slot (see note at the top)
+    ml.unknown = jl_atomic_load_acquire(
+        &((jl_value_t**)jl_array_data(a))[uid & (a->nrows - 1)]);
     if (ml.unknown != NULL && ml.unknown != jl_nothing) {
         jl_value_t *t;
         if (jl_typeof(ml.unknown) == (jl_value_t*)jl_typemap_level_type) {
@@ -242,7 +260,8 @@ static void mtcache_rehash(jl_array_t **pa, jl_value_t *parent, int8_t tparam, i
             }
         }
     }
-    *pa = n;
+    // publish the rehashed cache; the old array stays valid for readers
+    jl_atomic_store_release((jl_value_t**)pa, (jl_value_t*)n);
     jl_gc_wb(parent, n);
 }
 
@@ -265,9 +284,149 @@ void jl_typemap_rehash(union jl_typemap_t ml, int8_t offs) {
         if (ml.node->arg1 != (void*)jl_nothing)
             jl_typemap_rehash_array(&ml.node->arg1, ml.unknown, 0, offs);
         jl_typemap_rehash(ml.node->any, offs+1);
+        if (ml.node->key == NULL)
+            jl_typemap_rebuild_leafsigs(ml);
+    }
+}
+
+// ----- Full signature hash for leaf signatures ----- //
+//
+// The per-slot caches above only help when the signature is a leaf type at
+// the indexed argument slot; signatures whose discriminating argument sits
+// elsewhere degenerate into a linear scan of `linear`. The root level of a
+// typemap (key == NULL) therefore also carries `leafsigs`: an open
+// addressed table keyed on the full argument type vector of every leaf
+// signature in the map, giving O(1) exact matches no matter which argument
+// discriminates. The table only indexes entries that live elsewhere in the
+// map; it is rebuilt by jl_typemap_rebuild_leafsigs after entries are
+// invalidated and after deserialization (type uids are not stable across
+// processes). Inserts keep every entry within LEAFSIG_MAX_PROBE slots of
+// its home (growing the table like mtcache_rehash otherwise) so lookups
+// never probe more than that.
+
+#ifdef _P64
+#define bitmix(a,b) int64hash((a)^bswap_64(b))
+#else
+#define bitmix(a,b) int64to32hash((((uint64_t)a)<<32)|((uint64_t)b))
+#endif
+
+#define LEAFSIG_INIT_SIZE 16 // must be a power-of-two
+#define LEAFSIG_MAX_PROBE 8
+
+static uintptr_t leafsig_hash_sig(jl_tupletype_t *sig)
+{
+    size_t i, n = jl_datatype_nfields(sig);
+    uintptr_t h = n;
+    for (i = 0; i < n; i++)
+        h = bitmix(h, ((jl_datatype_t*)jl_tparam(sig, i))->uid);
+    return h;
+}
+
+static uintptr_t leafsig_hash_args(jl_value_t **args, size_t n)
+{
+    size_t i;
+    uintptr_t h = n;
+    for (i = 0; i < n; i++)
+        h = bitmix(h, ((jl_datatype_t*)jl_typeof(args[i]))->uid);
+    return h;
+}
+
+static int leafsig_tryinsert(jl_array_t *a, jl_typemap_entry_t *newrec)
+{
+    size_t sz = jl_array_len(a);
+    size_t idx = leafsig_hash_sig(newrec->sig) & (sz - 1);
+    size_t i;
+    for (i = 0; i < LEAFSIG_MAX_PROBE; i++) {
+        jl_value_t **slot = &((jl_value_t**)jl_array_data(a))[idx];
+        jl_typemap_entry_t *ml = (jl_typemap_entry_t*)*slot;
+        if (ml == NULL || ml == (jl_typemap_entry_t*)jl_nothing ||
+            ml->sig == newrec->sig) {
+            // publish the fully initialized record (or replace the record
+            // for the same signature, e.g. after a list-to-level copy)
+            jl_atomic_store_release(slot, (jl_value_t*)newrec);
+            jl_gc_wb(a, newrec);
+            return 1;
+        }
+        idx = (idx + 1) & (sz - 1);
+    }
+    return 0;
+}
+
+static void leafsig_insert(jl_typemap_level_t *cache, jl_typemap_entry_t *newrec)
+{
+    if (cache->leafsigs == (void*)jl_nothing) {
+        cache->leafsigs = jl_alloc_vec_any(LEAFSIG_INIT_SIZE);
+        jl_gc_wb(cache, cache->leafsigs);
+    }
+    while (!leafsig_tryinsert(cache->leafsigs, newrec)) {
+        // the probe run is too long: rehash into a bigger table, doubling
+        // again whenever an entry doesn't find a close slot (see
+        // mtcache_rehash)
+        jl_array_t *old = cache->leafsigs;
+        size_t i, len = jl_array_len(old);
+        size_t newlen = len * 2;
+        while (1) {
+            jl_array_t *n = jl_alloc_vec_any(newlen);
+            for (i = 0; i < len; i++) {
+                jl_typemap_entry_t *ml =
+                    (jl_typemap_entry_t*)jl_array_ptr_ref(old, i);
+                if (ml == NULL || ml == (jl_typemap_entry_t*)jl_nothing)
+                    continue;
+                if (!leafsig_tryinsert(n, ml))
+                    break;
+            }
+            if (i == len) {
+                // publish; the old table stays valid for readers
+                jl_atomic_store_release((jl_value_t**)&cache->leafsigs,
+                                        (jl_value_t*)n);
+                jl_gc_wb(cache, n);
+                break;
+            }
+            newlen *= 2;
+        }
     }
 }
 
+static jl_typemap_entry_t *leafsig_lookup(jl_array_t *a, jl_value_t **args,
+                                          size_t n)
+{
+    size_t sz = jl_array_len(a);
+    size_t idx = leafsig_hash_args(args, n) & (sz - 1);
+    size_t i;
+    for (i = 0; i < LEAFSIG_MAX_PROBE; i++) {
+        // pairs with the release stores in leafsig_tryinsert
+        jl_typemap_entry_t *ml = (jl_typemap_entry_t*)jl_atomic_load_acquire(
+            &((jl_value_t**)jl_array_data(a))[idx]);
+        if (ml == NULL || ml == (jl_typemap_entry_t*)jl_nothing)
+            return NULL;
+        if (jl_datatype_nfields(ml->sig) == n &&
+            sig_match_leaf(args, jl_svec_data(ml->sig->parameters), n))
+            return ml;
+        idx = (idx + 1) & (sz - 1);
+    }
+    return NULL;
+}
+
+static int leafsig_rebuild_visitor(jl_typemap_entry_t *ml, void *closure)
+{
+    jl_typemap_level_t *root = (jl_typemap_level_t*)closure;
+    if (ml->isleafsig && ml->simplesig == (void*)jl_nothing &&
+        ml->guardsigs == jl_emptysvec)
+        leafsig_insert(root, ml);
+    return 1;
+}
+
+// (re)build the full signature index of a root level from the entries in
+// the map
+void jl_typemap_rebuild_leafsigs(union jl_typemap_t cache)
+{
+    if (jl_typeof(cache.unknown) != (jl_value_t*)jl_typemap_level_type)
+        return;
+    jl_typemap_level_t *node = cache.node;
+    node->leafsigs = (jl_array_t*)jl_nothing;
+    jl_typemap_visitor(cache, leafsig_rebuild_visitor, (void*)node);
+}
+
 static union jl_typemap_t *mtcache_hash_bp(jl_array_t **pa, jl_value_t *ty,
                                                  int8_t tparam, int8_t offs, jl_value_t *parent)
 {
@@ -707,10 +866,22 @@ jl_typemap_entry_t *jl_typemap_assoc_by_type(union jl_typemap_t ml_or_cache, jl_
     }
 }
 
+#if defined(__GNUC__)
+#define tm_prefetch(p) __builtin_prefetch(p)
+#else
+#define tm_prefetch(p) ((void)(p))
+#endif
+
 jl_typemap_entry_t *jl_typemap_entry_assoc_exact(jl_typemap_entry_t *ml, jl_value_t **args, size_t n)
 {
+    // The entries are individually allocated list nodes, so the scan is a
+    // pointer chase through scattered heap; prefetching the next entry
+    // while testing the current one hides most of that latency. (Leaf
+    // signatures don't usually get here at all anymore -- the root
+    // level's full-signature hash resolves them first.)
     // some manually-unrolled common special cases
     while (ml->simplesig == (void*)jl_nothing && ml->guardsigs == jl_emptysvec && ml->isleafsig) {
+        tm_prefetch(ml->next);
         // use a tight loop for a long as possible
         if (n == jl_datatype_nfields(ml->sig) && jl_typeof(args[0]) == jl_tparam(ml->sig, 0)) {
             if (n == 1)
@@ -735,6 +906,7 @@ jl_typemap_entry_t *jl_typemap_entry_assoc_exact(jl_typemap_entry_t *ml, jl_valu
     }
 
     while (ml != (void*)jl_nothing) {
+        tm_prefetch(ml->next);
         size_t lensig = jl_datatype_nfields(ml->sig);
         if (lensig == n || (ml->va && lensig <= n+1)) {
             if (ml->simplesig != (void*)jl_nothing) {
@@ -783,6 +955,12 @@ nomatch:
 
 jl_typemap_entry_t *jl_typemap_level_assoc_exact(jl_typemap_level_t *cache, jl_value_t **args, size_t n, int8_t offs)
 {
+    // the full signature index covers every leaf signature of the map,
+    // wherever its discriminating argument sits (root levels only)
+    if (cache->leafsigs != (void*)jl_nothing) {
+        jl_typemap_entry_t *ml = leafsig_lookup(cache->leafsigs, args, n);
+        if (ml) return ml;
+    }
     if (n > offs) {
         jl_value_t *a1 = args[offs];
         jl_value_t *ty = (jl_value_t*)jl_typeof(a1);
@@ -833,6 +1011,7 @@ static jl_typemap_level_t *jl_new_typemap_level(void)
     cache->any.unknown = jl_nothing;
     cache->arg1 = (jl_array_t*)jl_nothing;
     cache->targ = (jl_array_t*)jl_nothing;
+    cache->leafsigs = (jl_array_t*)jl_nothing;
     return cache;
 }
 
@@ -841,11 +1020,18 @@ static jl_typemap_level_t *jl_method_convert_list_to_cache(jl_typemap_entry_t *m
     jl_typemap_level_t *cache = jl_new_typemap_level();
     cache->key = key;
     jl_typemap_entry_t *next = NULL;
-    JL_GC_PUSH3(&cache, &next, &ml);
+    jl_typemap_entry_t *clone = NULL;
+    JL_GC_PUSH4(&cache, &next, &ml, &clone);
     while (ml != (void*)jl_nothing) {
         next = ml->next;
-        ml->next = (jl_typemap_entry_t*)jl_nothing;
-        jl_typemap_level_insert_(cache, ml, offs, 0);
+        // insert a copy of the entry so that the list being replaced stays
+        // intact for the readers still traversing it; the new level is
+        // published with a single release store by the caller
+        clone = (jl_typemap_entry_t*)jl_gc_allocobj(sizeof(jl_typemap_entry_t));
+        jl_set_typeof(clone, jl_typemap_entry_type);
+        memcpy(clone, ml, sizeof(jl_typemap_entry_t));
+        clone->next = (jl_typemap_entry_t*)jl_nothing;
+        jl_typemap_level_insert_(cache, clone, offs, 0);
         ml = next;
     }
     JL_GC_POP();
@@ -858,7 +1044,8 @@ static void jl_typemap_list_insert_(jl_typemap_entry_t **pml, jl_value_t *parent
     if (*pml == (void*)jl_nothing || newrec->isleafsig) {
         newrec->next = *pml;
         jl_gc_wb(newrec, newrec->next);
-        *pml = newrec;
+        // publish the fully initialized record (see note at the top)
+        jl_atomic_store_release((jl_value_t**)pml, (jl_value_t*)newrec);
         jl_gc_wb(parent, newrec);
     }
     else {
@@ -877,9 +1064,18 @@ static void jl_typemap_insert_generic(union jl_typemap_t *pml, jl_value_t *paren
 
     unsigned count = jl_typemap_list_count(pml->leaf);
     if (count > MAX_METHLIST_COUNT) {
-        pml->node = jl_method_convert_list_to_cache(pml->leaf, key, offs);
+        jl_typemap_level_t *node =
+            jl_method_convert_list_to_cache(pml->leaf, key, offs);
+        jl_typemap_level_insert_(node, newrec, offs, tparams);
+        // publish the level only once it contains everything, so readers
+        // switch from the (intact) old list straight to the complete level
+        jl_atomic_store_release((jl_value_t**)&pml->node, (jl_value_t*)node);
         jl_gc_wb(parent, pml->node);
-        jl_typemap_level_insert_(pml->node, newrec, offs, tparams);
+        // the conversion cloned every entry and orphaned the originals;
+        // inline caches hold raw entry pointers guarded only by this
+        // counter, so they must revalidate before the orphans can be
+        // collected out from under them
+        jl_atomic_fetch_add(&jl_methtable_world, 1);
         return;
     }
 
@@ -899,6 +1095,12 @@ static int jl_typemap_array_insert_(jl_array_t **cache, jl_value_t *key, jl_type
 static void jl_typemap_level_insert_(jl_typemap_level_t *cache, jl_typemap_entry_t *newrec, int8_t offs,
         const struct jl_typemap_info *tparams)
 {
+    // root levels additionally index leaf signatures by their full
+    // argument type vector
+    if (cache->key == NULL && newrec->isleafsig &&
+        newrec->simplesig == (void*)jl_nothing &&
+        newrec->guardsigs == jl_emptysvec)
+        leafsig_insert(cache, newrec);
     size_t l = jl_datatype_nfields(newrec->sig);
     // compute the type at offset `offs` into `sig`, which may be a Vararg
     jl_value_t *t1 = NULL;
@@ -0,0 +1,36 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+#ifndef JL_UPROBES_H
+#define JL_UPROBES_H
+
+// Static tracepoints (USDT) over the runtime's hot transitions, so
+// bpftrace/systemtap can correlate GC, compilation, task, and threading
+// events with kernel and service traces without attaching a profiler.
+// Built with WITH_USDT=1 (requires <sys/sdt.h> from systemtap-sdt-dev);
+// each probe then compiles to a single nop plus an ELF note, and to
+// nothing at all otherwise.
+#ifdef WITH_USDT
+#include <sys/sdt.h>
+#define JL_PROBE_GC_BEGIN(full) DTRACE_PROBE1(julia, gc__begin, (full))
+#define JL_PROBE_GC_END(pause_ns, full) \
+    DTRACE_PROBE2(julia, gc__end, (pause_ns), (full))
+#define JL_PROBE_COMPILE_BEGIN(li, name) \
+    DTRACE_PROBE2(julia, compile__begin, (li), (name))
+#define JL_PROBE_COMPILE_END(li) DTRACE_PROBE1(julia, compile__end, (li))
+#define JL_PROBE_TASK_SWITCH(from, to) \
+    DTRACE_PROBE2(julia, task__switch, (from), (to))
+#define JL_PROBE_REGION_FORK() DTRACE_PROBE(julia, region__fork)
+#define JL_PROBE_REGION_JOIN() DTRACE_PROBE(julia, region__join)
+#define JL_PROBE_SAFEPOINT_WAIT() DTRACE_PROBE(julia, safepoint__wait)
+#else
+#define JL_PROBE_GC_BEGIN(full) do {} while (0)
+#define JL_PROBE_GC_END(pause_ns, full) do {} while (0)
+#define JL_PROBE_COMPILE_BEGIN(li, name) do {} while (0)
+#define JL_PROBE_COMPILE_END(li) do {} while (0)
+#define JL_PROBE_TASK_SWITCH(from, to) do {} while (0)
+#define JL_PROBE_REGION_FORK() do {} while (0)
+#define JL_PROBE_REGION_JOIN() do {} while (0)
+#define JL_PROBE_SAFEPOINT_WAIT() do {} while (0)
+#endif
+
+#endif
@@ -4456,3 +4456,20 @@ end
 f17147(::Tuple) = 1
 f17147{N}(::Vararg{Tuple,N}) = 2
 @test f17147((), ()) == 2
+
+# packlayout!: alignment-sorted offsets shrink padded mutables and keep
+# field semantics; immutables are rejected
+type PackLayoutT
+    a::Int8
+    b::Int64
+    c::Int32
+end
+packlayout!(PackLayoutT)
+@test sizeof(PackLayoutT) == 16
+@test fieldoffset(PackLayoutT, 2) == 0 # Int64 first after the sort
+let p = PackLayoutT(Int8(1), 2, Int32(3))
+    @test p.a === Int8(1) && p.b === 2 && p.c === Int32(3)
+    p.a = Int8(7); p.c = Int32(9)
+    @test p.a === Int8(7) && p.b === 2 && p.c === Int32(9)
+end
+@test_throws ErrorException packlayout!(Complex{Int})
@@ -0,0 +1,122 @@
+# This file is a part of Julia. License is MIT: http://julialang.org/license
+
+# GC stress suite: controlled heap shapes with pause-time percentile
+# reporting scraped from the collector's pause log (jl_gc_get_pause_log).
+# Each workload prints one line:
+#   julia,gc_<name>,<collections>,<p50_ms>,<p90_ms>,<p99_ms>,<max_ms>
+# so regressions in either pause time or collection count show up in
+# tracking runs.
+
+# layout of jl_gc_pause_rec_t (julia.h): 5 x UInt64/Int64, Int16, 2 x
+# UInt8, padded to 48 bytes; pause_ns sits at byte offset 8
+const PAUSE_REC_SZ = 48
+const PAUSE_LOG_CAP = 4096
+
+function pause_log()
+    buf = zeros(UInt8, PAUSE_REC_SZ * PAUSE_LOG_CAP)
+    n = ccall(:jl_gc_get_pause_log, Csize_t, (Ptr{UInt8}, Csize_t),
+              buf, PAUSE_LOG_CAP)
+    [unsafe_load(Ptr{UInt64}(pointer(buf) + (i-1)*PAUSE_REC_SZ + 8))
+     for i in 1:Int(n)]
+end
+
+function percentile(sorted, p)
+    isempty(sorted) && return 0.0
+    sorted[clamp(ceil(Int, p * length(sorted)), 1, length(sorted))] / 1e6
+end
+
+function report(name, before::Int)
+    log = pause_log()
+    pauses = sort(log[(before+1):end])
+    n = length(pauses)
+    @printf("julia,gc_%s,%d,%.3f,%.3f,%.3f,%.3f\n", name, n,
+            percentile(pauses, 0.50), percentile(pauses, 0.90),
+            percentile(pauses, 0.99), percentile(pauses, 1.0))
+end
+
+function run_shape(f, name)
+    gc()
+    before = length(pause_log())
+    f()
+    report(name, before)
+end
+
+# deep graph: long chains force deep recursive marking
+type Node
+    next
+    payload::Vector{Int}
+end
+
+function deep_graph()
+    for rep = 1:8
+        head = Node(nothing, zeros(Int, 8))
+        for i = 1:200_000
+            head = Node(head, zeros(Int, 4))
+        end
+        # churn while the chain is live so marks repeat
+        for i = 1:200_000
+            Node(nothing, zeros(Int, 4))
+        end
+    end
+end
+
+# large remset: a long-lived (old) array is re-pointed at fresh young
+# objects between collections, so every quick sweep rescans it
+function remset_churn()
+    old = Vector{Any}(100_000)
+    fill!(old, nothing)
+    gc(); gc() # promote `old`
+    for rep = 1:50
+        for i = 1:length(old)
+            old[i] = [i]
+        end
+        gc(false)
+    end
+end
+
+# weak reference churn
+function weak_refs()
+    refs = Vector{Any}(0)
+    for rep = 1:20
+        for i = 1:50_000
+            push!(refs, WeakRef(zeros(Int, 4)))
+        end
+        gc(false)
+        empty!(refs)
+    end
+end
+
+# finalizer storm
+function finalizer_storm()
+    count = Ref(0)
+    for rep = 1:10
+        for i = 1:50_000
+            x = zeros(Int, 4)
+            finalizer(x, y -> (count[] += 1))
+        end
+        gc(false)
+    end
+    gc()
+end
+
+# fragmented pools: keep every 17th object across several size classes
+# so swept pages stay partially occupied
+function fragmented_pools()
+    kept = Vector{Any}(0)
+    for rep = 1:10
+        for sz in (1, 4, 12, 28, 60)
+            for i = 1:100_000
+                v = zeros(Int, sz)
+                i % 17 == 0 && push!(kept, v)
+            end
+        end
+        gc(false)
+        rep % 3 == 0 && empty!(kept)
+    end
+end
+
+run_shape(deep_graph, "deep_graph")
+run_shape(remset_churn, "remset_churn")
+run_shape(weak_refs, "weak_refs")
+run_shape(finalizer_storm, "finalizer_storm")
+run_shape(fragmented_pools, "fragmented_pools")
@@ -0,0 +1,111 @@
+// This file is a part of Julia. License is MIT: http://julialang.org/license
+
+/*
+  C-level microbenchmarks for the runtime primitives the perf suite's
+  julia-level benchmarks can only measure indirectly: generic dispatch,
+  pool allocation, typemap lookup, hash table probes and task switching.
+  Built by `make -C test/perf runtime` against libjulia; prints one JSON
+  object per benchmark so regressions can be tracked mechanically.
+
+  Methodology: every benchmark runs WARMUP iterations untimed (to fault
+  code and warm caches), then REPS batches; the minimum batch time is
+  reported (least-noise estimator), in nanoseconds per operation from
+  jl_hrtime.
+*/
+
+#include <julia.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define WARMUP 10000
+#define BATCH  100000
+#define REPS   10
+
+static double bench_report(const char *name, uint64_t best_ns, size_t per_batch)
+{
+    double nsop = (double)best_ns / per_batch;
+    printf("{\"benchmark\":\"runtime_%s\",\"ns_per_op\":%.3f}\n", name, nsop);
+    fflush(stdout);
+    return nsop;
+}
+
+#define RUN_BENCH(name, setup, op)                                     \
+    do {                                                               \
+        setup;                                                         \
+        for (int i_ = 0; i_ < WARMUP; i_++) {                          \
+            op;                                                        \
+        }                                                              \
+        uint64_t best_ = (uint64_t)-1;                                 \
+        for (int r_ = 0; r_ < REPS; r_++) {                            \
+            uint64_t t0_ = jl_hrtime();                                \
+            for (int i_ = 0; i_ < BATCH; i_++) {                       \
+                op;                                                    \
+            }                                                          \
+            uint64_t dt_ = jl_hrtime() - t0_;                          \
+            if (dt_ < best_)                                           \
+                best_ = dt_;                                           \
+        }                                                              \
+        bench_report(name, best_, BATCH);                              \
+    } while (0)
+
+static jl_value_t *volatile sink; // defeat dead-code elimination
+
+int main(int argc, char *argv[])
+{
+    jl_init(NULL);
+
+    // generic dispatch: f(x) = x through jl_apply_generic
+    jl_value_t *f = jl_eval_string("let f(x) = x; f; end");
+    jl_value_t *one = jl_box_int64(1);
+    JL_GC_PUSH2(&f, &one);
+    {
+        jl_value_t *args[2];
+        args[0] = f;
+        args[1] = one;
+        RUN_BENCH("apply_generic", (void)0,
+                  sink = jl_apply_generic(args, 2));
+    }
+
+    // pool allocation: a 2-word box per iteration
+    RUN_BENCH("pool_alloc", (void)0, sink = jl_box_int64((int64_t)0x12345));
+
+    // method cache lookup via repeated first-arg dispatch to a 2-arg
+    // method (exercises jl_typemap_assoc_exact behind the call cache)
+    jl_value_t *g = jl_eval_string("let g(x, y) = x; g; end");
+    jl_value_t *flt = jl_box_float64(2.0);
+    JL_GC_PUSH2(&g, &flt);
+    {
+        jl_value_t *args[3];
+        args[0] = g;
+        args[1] = one;
+        args[2] = flt;
+        RUN_BENCH("dispatch_2arg", (void)0,
+                  sink = jl_apply_generic(args, 3));
+    }
+
+    // symbol interning (hash index + tree backstop)
+    RUN_BENCH("jl_symbol",
+              char symname[32],
+              (snprintf(symname, sizeof(symname), "bench_sym_%d", i_ & 1023),
+               sink = (jl_value_t*)jl_symbol(symname)));
+
+    // task switch: ping-pong with a yielding task
+    jl_value_t *pingpong = jl_eval_string(
+        "let other = @task while true; yieldto(current_task().storage); end\n"
+        "    other.storage = current_task()\n"
+        "    other\n"
+        "end");
+    JL_GC_PUSH1(&pingpong);
+    RUN_BENCH("task_switch", (void)0,
+              sink = jl_switchto((jl_task_t*)pingpong, jl_nothing));
+    JL_GC_POP();
+
+    JL_GC_POP();
+    JL_GC_POP();
+    (void)sink;
+    (void)argc;
+    (void)argv;
+    jl_atexit_hook(0);
+    return 0;
+}
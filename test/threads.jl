@@ -33,6 +33,56 @@ end
 
 test_threaded_loop_and_atomic_add()
 
+# dynamically scheduled loop covers every iteration exactly once
+function threaded_loop_dynamic(a, r, x)
+    @threads :dynamic for i in r
+        a[i] = 1 + atomic_add!(x, 1)
+    end
+end
+
+function test_threaded_loop_dynamic()
+    x = Atomic()
+    a = zeros(Int,10000)
+    threaded_loop_dynamic(a,1:10000,x)
+    found = zeros(Bool,10000)
+    for i=1:length(a)
+        found[a[i]] = true
+    end
+    @test x[] == 10000
+    @test findfirst(found,false) == 0
+end
+
+test_threaded_loop_dynamic()
+
+# guided scheduling (and an explicit grainsize) also cover every
+# iteration exactly once
+function threaded_loop_guided(a, r, x)
+    @threads :guided for i in r
+        a[i] = 1 + atomic_add!(x, 1)
+    end
+end
+
+function threaded_loop_grain(a, r, x)
+    @threads :dynamic 16 for i in r
+        a[i] = 1 + atomic_add!(x, 1)
+    end
+end
+
+function test_threaded_loop_sched(loop!)
+    x = Atomic()
+    a = zeros(Int,10000)
+    loop!(a,1:10000,x)
+    found = zeros(Bool,10000)
+    for i=1:length(a)
+        found[a[i]] = true
+    end
+    @test x[] == 10000
+    @test findfirst(found,false) == 0
+end
+
+test_threaded_loop_sched(threaded_loop_guided)
+test_threaded_loop_sched(threaded_loop_grain)
+
 # Helper for test_threaded_atomic_minmax that verifies sequential consistency.
 function check_minmax_consistency{T}(old::Array{T,1}, m::T, start::T, o::Base.Ordering)
     for v in old
@@ -83,7 +83,9 @@ static const char opts[]  =
     " --history-file={yes|no}   Load or save history\n\n"
 
     // code generation options
-    " --compile={yes|no|all|min}Enable or disable JIT compiler, or request exhaustive compilation\n"
+    " --compile={yes|no|all|min|tiered}\n"
+    "                           Enable or disable JIT compiler, request exhaustive compilation,\n"
+    "                           or interpret methods until they have run enough times to be worth compiling\n"
     " -C, --cpu-target <target> Limit usage of cpu features up to <target>\n"
     " -O, --optimize={0,1,2,3}  Set the optimization level (default 2 if unspecified or 3 if specified as -O)\n"
     " --inline={yes|no}         Control whether inlining is permitted (overrides functions declared as @inline)\n"
@@ -330,6 +332,8 @@ restart_switch:
                 jl_options.compile_enabled = JL_OPTIONS_COMPILE_ALL;
             else if (!strcmp(optarg,"min"))
                 jl_options.compile_enabled = JL_OPTIONS_COMPILE_MIN;
+            else if (!strcmp(optarg,"tiered"))
+                jl_options.compile_enabled = JL_OPTIONS_COMPILE_TIERED;
             else
                 jl_errorf("julia: invalid argument to --compile (%s)", optarg);
             break;